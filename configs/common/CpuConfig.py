@@ -34,6 +34,8 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from m5 import fatal
+from m5.defines import buildEnv
+from m5.params import NULL
 import m5.objects
 
 def config_etrace(cpu_cls, cpu_list, options):
@@ -59,3 +61,39 @@ def config_etrace(cpu_cls, cpu_list, options):
     else:
         fatal("%s does not support data dependency tracing. Use a CPU model of"
               " type or inherited from DerivO3CPU.", cpu_cls)
+
+def config_translation(cpu_list, options):
+    if not (options.l2_tlb_size or options.page_walk_cache or
+            options.num_page_walkers > 1 or options.coalesce_walks):
+        return
+    if buildEnv['TARGET_ISA'] != 'x86':
+        fatal("The L2 TLB and page walker options are only supported on "
+              "x86.")
+    for cpu in cpu_list:
+        mmu = cpu.mmu
+        # The instruction and data sides share the L2 TLB and the page
+        # walk cache, as on most current cores.
+        if options.l2_tlb_size:
+            mmu.l2tb = m5.objects.X86TLB(size = options.l2_tlb_size,
+                                         walker = NULL)
+            mmu.itb.next_level = mmu.l2tb
+            mmu.dtb.next_level = mmu.l2tb
+        if options.page_walk_cache:
+            mmu.pwc = m5.objects.X86PageWalkCache()
+        for tlb in (mmu.itb, mmu.dtb):
+            if options.page_walk_cache:
+                tlb.walker.page_walk_cache = mmu.pwc
+            tlb.walker.num_walkers = options.num_page_walkers
+            tlb.walker.coalesce_walks = options.coalesce_walks
+
+def config_branch_trace(cpu_cls, cpu_list, options):
+    if not issubclass(cpu_cls, m5.objects.BaseSimpleCPU):
+        fatal("%s does not support branch tracing. Use a simple CPU model.",
+              cpu_cls)
+    for cpu in cpu_list:
+        # One trace per cpu, named after it when there are several
+        trace_file = options.branch_trace_file
+        if len(cpu_list) > 1:
+            trace_file = "cpu%d.%s" % (cpu.cpu_id, trace_file)
+        cpu.branchTraceListener = m5.objects.BranchTrace(
+                                  trace_file = trace_file)
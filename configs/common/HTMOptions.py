@@ -41,8 +41,16 @@ def setHTMOptions(htm, options):
         if (htm.reload_if_stale and not \
             htm.precise_read_set_tracking):
             m5.util.panic("reload-if-stale requires precise-read-set-tracking")
+    if options.htm_eager_register_checkpoint != None:
+        htm.cow_register_checkpoint = \
+        not options.htm_eager_register_checkpoint
     if options.htm_fallbacklock_addr != None:
         htm.fallbacklock_addr = options.htm_fallbacklock_addr
+    if options.htm_fallback_lock_wait != None:
+        htm.fallback_lock_wait = options.htm_fallback_lock_wait
+    if options.htm_fallback_lock_poll_latency != None:
+        htm.fallback_lock_poll_latency = \
+        options.htm_fallback_lock_poll_latency
     if options.htm_value_checker != None:
         htm.value_checker = options.htm_value_checker
     if options.htm_isolation_checker != None:
@@ -116,8 +124,19 @@ def addHTMOptions(parser):
                       action="store_true", default=False,
                       help="Re-execute loads that may have obtained"
                       " stale data (observed conflicting inv)")
+    parser.add_argument("--htm-eager-register-checkpoint",
+                      action="store_true", default=None,
+                      help="Copy the register file upon transaction begin"
+                      " (default: save registers on first write)")
     parser.add_argument("--htm-fallbacklock-addr", action="store", default=None,
                       help="Address of the fallback lock (HTM)")
+    parser.add_argument("--htm-fallback-lock-wait",
+                      action="store_true", default=None,
+                      help="Transactions aborted by the fallback lock wait"
+                      " for its release before starting again")
+    parser.add_argument("--htm-fallback-lock-poll-latency", type=int,
+                      default=None,
+                      help="Cycles between checks of a held fallback lock")
     parser.add_argument("--htm-value-checker", action="store_true", default=None,
                       help="Enable transaction value checker")
     parser.add_argument("--htm-isolation-checker", action="store_true", default=None,
@@ -209,6 +209,19 @@ def addCommonOptions(parser):
                         choices=ObjectList.indirect_bp_list.get_names(),
                         help="type of indirect branch predictor to run with")
 
+    parser.add_argument("--l2-tlb-size", type=int, default=0,
+                        help="""Entries of an L2 TLB shared by the
+                        instruction and data TLBs of each x86 CPU""")
+    parser.add_argument("--page-walk-cache", action="store_true",
+                        help="""Add a page walk cache shared by the
+                        instruction and data walkers of each x86 CPU""")
+    parser.add_argument("--num-page-walkers", type=int, default=1,
+                        help="""Page table walks that each x86 walker can
+                        have in progress at once""")
+    parser.add_argument("--coalesce-walks", action="store_true",
+                        help="""Let x86 TLB misses join a pending walk to
+                        the same page""")
+
     parser.add_argument("--list-rp-types",
                         action=ListRP, nargs=0,
                         help="List available replacement policy types")
@@ -259,6 +272,10 @@ def addCommonOptions(parser):
                         help="""Data dependency trace file input to
                       Elastic Trace probe in a capture simulation and
                       Trace CPU in a replay simulation""", default="")
+    parser.add_argument("--branch-trace-file", action="store", type=str,
+                        help="""Capture the branches committed by a simple
+                      CPU into this file, for replay with
+                      bp_trace_replay.py""", default="")
 
     parser.add_argument("-l", "--lpae", action="store_true")
     parser.add_argument("-V", "--virtualisation", action="store_true")
@@ -336,6 +353,26 @@ def addCommonOptions(parser):
                         help="restore from a simpoint checkpoint taken with " +
                         "--take-simpoint-checkpoints")
 
+    # LoopPoint options (sampling of multi-threaded workloads)
+    parser.add_argument("--looppoint-profile", action="store_true",
+                        help="Collect multi-threaded BBVs and region "
+                        "boundaries for LoopPoint-style sampling")
+    parser.add_argument("--looppoint-interval", type=int, default=100000000,
+                        help="LoopPoint region size in num of instructions "
+                        "(all threads)")
+    parser.add_argument("--looppoint-markers", action="store", type=str,
+                        default="",
+                        help="Comma-separated PCs of region markers, e.g. "
+                        "loop headers (transaction commits are also "
+                        "markers)")
+    parser.add_argument(
+        "--take-looppoint-checkpoints", action="store", type=str,
+        help="<simpoint file,weight file,region file>")
+    parser.add_argument("--restore-looppoint-checkpoint",
+                        action="store_true", default=False,
+                        help="restore from a looppoint checkpoint taken "
+                        "with --take-looppoint-checkpoints")
+
     # Checkpointing options
     # Note that performing checkpointing via python script files will override
     # checkpoint instructions built into binaries.
@@ -391,6 +428,22 @@ def addCommonOptions(parser):
     parser.add_argument(
         "-F", "--fast-forward", action="store", type=str, default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_argument(
+        "--parallel-fast-forward", action="store_true", default=False,
+        help="""Fast forward with one NonCachingSimpleCPU per host thread,
+                synchronizing at system calls and pseudo instructions
+                (requires --fast-forward)""")
+    parser.add_argument(
+        "--parallel-ff-quantum", action="store", type=str, default="10us",
+        help="""Simulated time between the synchronizations of the host
+                threads during a parallel fast forward""")
+    parser.add_argument(
+        "--ff-block-insts", action="store", type=int, default=0,
+        help="""Let the fast-forward CPUs execute up to this many
+                instructions per event while no other event is due, reuse
+                instruction fetch translations within a page, and replay
+                the instructions they decoded before without fetching
+                them""")
     parser.add_argument(
         "-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
@@ -80,6 +80,9 @@ def setCPUClass(options):
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
+        if options.parallel_fast_forward:
+            TmpClass = NonCachingSimpleCPU
+            test_mem_mode = 'atomic_noncaching'
 
     # Ruby only supports atomic accesses in noncaching mode
     if test_mem_mode == 'atomic' and options.ruby:
@@ -188,6 +191,42 @@ def findCptDir(options, cptdir, testsys):
         print("#%d, start_inst:%d, weight:%f, interval:%d, warmup:%d" %
             (index, start_inst, weight_inst, interval_length, warmup_length))
 
+    elif options.restore_looppoint_checkpoint:
+        # Restore from LoopPoint checkpoints, named as follows:
+        dirs = listdir(cptdir)
+        expr = re.compile('cpt\.looppoint_(\d+)_region_(\d+)' +
+                    '_weight_([\d\.e\-]+)_start_(0x[\da-f]+)_(\d+)' +
+                    '_end_(0x[\da-f]+)_(\d+)')
+        cpts = []
+        for dir in dirs:
+            match = expr.match(dir)
+            if match:
+                cpts.append(dir)
+        cpts.sort()
+
+        cpt_num = options.checkpoint_restore
+        if cpt_num > len(cpts):
+            fatal('Checkpoint %d not found', cpt_num)
+        checkpoint_dir = joinpath(cptdir, cpts[cpt_num - 1])
+        match = expr.match(cpts[cpt_num - 1])
+        region = int(match.group(2))
+        weight = float(match.group(3))
+        start = (int(match.group(4), 16), int(match.group(5)))
+        end = (int(match.group(6), 16), int(match.group(7)))
+
+        # Exit at the end of the warmup (start of the region) and at the
+        # end of the region. Markers with pc 0 stand for the start and
+        # the end of the whole run.
+        exits = [marker for marker in (start, end) if marker[0] != 0]
+        testsys.looppoint.marker_pcs = [pc for pc, count in exits]
+        testsys.looppoint.exit_pcs = [pc for pc, count in exits]
+        testsys.looppoint.exit_counts = [count for pc, count in exits]
+        options.looppoint_bounds = (start, end)
+
+        print("Resuming from LoopPoint", end=' ')
+        print("#%d, weight:%f, start:%#x:%d, end:%#x:%d" %
+            (region, weight, start[0], start[1], end[0], end[1]))
+
     else:
         dirs = listdir(cptdir)
         expr = re.compile('cpt\.([0-9]+)')
@@ -412,6 +451,158 @@ def restoreSimpointCheckpoint():
     print('Exiting @ tick %i because %s' % (m5.curTick(), exit_cause))
     sys.exit(exit_event.getCode())
 
+# LoopPoint-style sampling of multi-threaded workloads: regions are
+# delimited by markers, i.e. (pc, global execution count) pairs, found by
+# a profiling run (--looppoint-profile). Expecting SimPoint files
+# generated by SimPoint 3.2 from the profiled BBVs.
+def addLooppoint(options, testsys, cpus):
+    testsys.looppoint = LoopPoint(cpus=cpus)
+    if options.looppoint_markers:
+        testsys.looppoint.marker_pcs = \
+            [int(pc, 0) for pc in options.looppoint_markers.split(",")]
+
+    if options.looppoint_profile:
+        for cpu in cpus:
+            if not isinstance(cpu, BaseSimpleCPU):
+                fatal("LoopPoint profiling should be done with a simple cpu")
+        testsys.looppoint.profile = True
+        testsys.looppoint.interval = options.looppoint_interval
+
+def parseLooppointRegionFile(region_filename):
+    """Returns a dict of region boundaries and sizes, indexed by region:
+       (start pc, start count, end pc, end count, insts)"""
+    regions = {}
+    for line in open(region_filename):
+        if line.startswith("#"):
+            continue
+        fields = line.split()
+        regions[int(fields[0])] = (int(fields[1], 16), int(fields[2]),
+                                   int(fields[3], 16), int(fields[4]),
+                                   int(fields[5]))
+    return regions
+
+def parseLooppointAnalysisFile(options, testsys):
+    import re
+
+    simpoint_filename, weight_filename, region_filename = \
+        options.take_looppoint_checkpoints.split(",", 2)
+    print("simpoint analysis file:", simpoint_filename)
+    print("simpoint weight file:", weight_filename)
+    print("looppoint region file:", region_filename)
+
+    regions = parseLooppointRegionFile(region_filename)
+
+    looppoints = []
+    simpoint_file = open(simpoint_filename)
+    weight_file = open(weight_filename)
+    while True:
+        line = simpoint_file.readline()
+        if not line:
+            break
+        m = re.match("(\d+)\s+(\d+)", line)
+        if m:
+            region = int(m.group(1))
+        else:
+            fatal('unrecognized line in simpoint file!')
+
+        line = weight_file.readline()
+        if not line:
+            fatal('not enough lines in simpoint weight file!')
+        m = re.match("([0-9\.e\-]+)\s+(\d+)", line)
+        if m:
+            weight = float(m.group(1))
+        else:
+            fatal('unrecognized line in simpoint weight file!')
+
+        if region not in regions:
+            fatal('region %d not in looppoint region file!' % region)
+
+        # The preceding region is simulated in detail to warm up
+        # caches, predictors and HTM state; checkpoint at its start
+        if region > 0:
+            warmup = regions[region - 1][0:2]
+        else:
+            warmup = (0, 0)
+        start = regions[region][0:2]
+        end = regions[region][2:4]
+        looppoints.append((region, weight, warmup, start, end))
+
+    looppoints.sort(key=lambda obj: obj[0])
+
+    # Track the counts of every region marker, so that they are
+    # available in the checkpoints, and exit at each warmup start
+    markers = set()
+    for region, weight, warmup, start, end in looppoints:
+        markers.update(pc for pc, count in (start, end) if pc != 0)
+        print(region, weight, "warmup %#x:%d start %#x:%d end %#x:%d" %
+            (warmup + start + end))
+    exits = [lp[2] for lp in looppoints if lp[2][0] != 0]
+    markers.update(pc for pc, count in exits)
+    testsys.looppoint.marker_pcs = sorted(markers)
+    testsys.looppoint.exit_pcs = [pc for pc, count in exits]
+    testsys.looppoint.exit_counts = [count for pc, count in exits]
+
+    print("Total # of looppoints:", len(looppoints))
+    return looppoints
+
+def takeLooppointCheckpoints(looppoints, cptdir):
+    num_checkpoints = 0
+    exit_cause = "looppoint marker reached"
+    code = 0
+    for index, looppoint in enumerate(looppoints):
+        region, weight, warmup, start, end = looppoint
+        if warmup[0] != 0:
+            exit_event = m5.simulate()
+
+            # skip checkpoint instructions should they exist
+            while exit_event.getCause() == "checkpoint":
+                print("Found 'checkpoint' exit event...ignoring...")
+                exit_event = m5.simulate()
+
+            exit_cause = exit_event.getCause()
+            code = exit_event.getCode()
+
+        if exit_cause == "looppoint marker reached":
+            # The restored run starts at the warmup, so that the region
+            # start is the first exit marker
+            m5.checkpoint(joinpath(cptdir,
+                "cpt.looppoint_%02d_region_%d_weight_%f_start_%#x_%d"
+                "_end_%#x_%d" % (index, region, weight, start[0], start[1],
+                end[0], end[1])))
+            print("Checkpoint #%d written. region:%d weight:%f" %
+                (num_checkpoints, region, weight))
+            num_checkpoints += 1
+        else:
+            break
+
+    print('Exiting @ tick %i because %s' % (m5.curTick(), exit_cause))
+    print("%d checkpoints taken" % num_checkpoints)
+    sys.exit(code)
+
+def restoreLooppointCheckpoint(options):
+    start, end = options.looppoint_bounds
+    if start[0] == 0:
+        # Region starting the run, no warmup
+        m5.stats.reset()
+
+    # The first stats dump covers the region only (used to extrapolate)
+    while True:
+        exit_event = m5.simulate()
+        exit_cause = exit_event.getCause()
+        if exit_cause != "looppoint marker reached":
+            break
+
+        if exit_event.getCode() == 0 and start[0] != 0:
+            print("Warmed up! Resetting stats!")
+            m5.stats.reset()
+        else:
+            print("Done running LoopPoint region!")
+            m5.stats.dump()
+            sys.exit(0)
+
+    print('Exiting @ tick %i because %s' % (m5.curTick(), exit_cause))
+    sys.exit(exit_event.getCode())
+
 def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
     print("starting switch loop")
     while True:
@@ -452,6 +643,17 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.parallel_fast_forward:
+        if not options.fast_forward:
+            fatal("--parallel-fast-forward requires --fast-forward")
+        if options.standard_switch or options.repeat_switch:
+            fatal("Can't specify --parallel-fast-forward with "
+                  "--standard-switch or --repeat-switch")
+        # Only the x86 decoder keeps instruction caches private to a CPU,
+        # the others share them between host threads
+        if buildEnv['TARGET_ISA'] != 'x86':
+            fatal("--parallel-fast-forward is only supported on x86")
+
     # Setup global stat filtering.
     stat_root_simobjs = []
     for stat_root_str in options.stats_root:
@@ -469,6 +671,25 @@ def run(options, root, testsys, cpu_class):
         for i in range(np):
             testsys.cpu[i].max_insts_any_thread = options.maxinsts
 
+    if options.parallel_fast_forward:
+        # Each fast-forward CPU gets an event queue, and thus a host
+        # thread, of its own. Everything else, including the children
+        # of the CPUs and the CPUs switched in later, stays on the
+        # event queue of the system.
+        for i in range(np):
+            for obj in testsys.cpu[i].descendants():
+                obj.eventq_index = 0
+            testsys.cpu[i].eventq_index = i + 1
+            testsys.cpu[i].parallel = True
+        root.sim_quantum = m5.ticks.fromSeconds(
+            m5.util.convert.anyToLatency(options.parallel_ff_quantum))
+
+    if options.fast_forward and options.ff_block_insts:
+        for i in range(np):
+            testsys.cpu[i].max_block_insts = options.ff_block_insts
+            testsys.cpu[i].cache_fetch_translation = True
+            testsys.cpu[i].block_cache = True
+
     if cpu_class:
         switch_cpus = [cpu_class(switched_out=True, cpu_id=(i))
                        for i in range(np)]
@@ -593,6 +814,13 @@ def run(options, root, testsys, cpu_class):
             (switch_cpus[i], switch_cpus_1[i]) for i in range(np)
         ]
 
+    if options.looppoint_profile or options.take_looppoint_checkpoints or \
+            options.restore_looppoint_checkpoint:
+        looppoint_cpus = list(testsys.cpu)
+        if switch_cpus != None:
+            looppoint_cpus += switch_cpus
+        addLooppoint(options, testsys, looppoint_cpus)
+
     # set the checkpoint in the cpu before m5.instantiate is called
     if options.take_checkpoints != None and \
            (options.simpoint or options.at_instruction):
@@ -616,6 +844,9 @@ def run(options, root, testsys, cpu_class):
     if options.take_simpoint_checkpoints != None:
         simpoints, interval_length = parseSimpointAnalysisFile(options, testsys)
 
+    if options.take_looppoint_checkpoints != None:
+        looppoints = parseLooppointAnalysisFile(options, testsys)
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
@@ -716,8 +947,8 @@ def run(options, root, testsys, cpu_class):
     # option only for finding the checkpoints to restore from.  This
     # lets us test checkpointing by restoring from one set of
     # checkpoints, generating a second set, and then comparing them.
-    if (options.take_checkpoints or options.take_simpoint_checkpoints) \
-        and options.checkpoint_restore:
+    if (options.take_checkpoints or options.take_simpoint_checkpoints or
+        options.take_looppoint_checkpoints) and options.checkpoint_restore:
 
         if m5.options.outdir:
             cptdir = m5.options.outdir
@@ -739,6 +970,14 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint:
         restoreSimpointCheckpoint()
 
+    # Take LoopPoint checkpoints
+    elif options.take_looppoint_checkpoints != None:
+        takeLooppointCheckpoints(looppoints, cptdir)
+
+    # Restore from LoopPoint checkpoints
+    elif options.restore_looppoint_checkpoint:
+        restoreLooppointCheckpoint(options)
+
     else:
         if options.fast_forward:
             m5.stats.reset()
@@ -0,0 +1,86 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replays a branch trace captured with --branch-trace-file through one or
+# more branch predictors. Each predictor gets its own player on a separate
+# event queue, so several configurations are evaluated in parallel over a
+# single read of the workload's execution. Predictors draw from random
+# number generators of their own, so the results don't depend on how the
+# players interleave.
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import ObjectList
+
+parser = argparse.ArgumentParser()
+parser.add_argument("trace_file", type=str,
+                    help="Branch trace captured from a simple CPU")
+parser.add_argument("--bp-types", type=str, default="TournamentBP",
+                    help="Comma-separated list of branch predictors to "
+                    "evaluate. Choices: %s" %
+                    ", ".join(ObjectList.bp_list.get_names()))
+parser.add_argument("--num-threads", type=int, default=1,
+                    help="Number of hardware threads in the trace")
+parser.add_argument("--max-insts", type=int, default=0,
+                    help="Stop replaying after this many instructions")
+parser.add_argument("--batch-size", type=int, default=10000,
+                    help="Branches replayed per event")
+parser.add_argument("--sim-quantum", type=str, default="1us",
+                    help="Synchronisation quantum of the players")
+
+args = parser.parse_args()
+
+bp_types = [bp for bp in args.bp_types.split(",") if bp]
+if not bp_types:
+    fatal("No branch predictor to evaluate")
+
+players = []
+for i, bp_type in enumerate(bp_types):
+    bp_class = ObjectList.bp_list.get(bp_type)
+    players.append(BranchTracePlayer(
+        eventq_index = i,
+        numThreads = args.num_threads,
+        trace_file = args.trace_file,
+        branch_pred = bp_class(numThreads = args.num_threads),
+        batch_size = args.batch_size,
+        max_insts = args.max_insts))
+
+root = Root(full_system = False, players = players)
+if len(players) > 1:
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(args.sim_quantum))
+
+m5.instantiate()
+
+exit_event = m5.simulate()
+print('Exiting @ tick %i because %s' %
+      (m5.curTick(), exit_event.getCause()))
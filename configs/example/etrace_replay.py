@@ -46,14 +46,13 @@ from common import Simulation
 from common import CacheConfig
 from common import MemConfig
 from common.Caches import *
+from ruby import Ruby
 
 parser = argparse.ArgumentParser()
 Options.addCommonOptions(parser)
 
 if '--ruby' in sys.argv:
-    print("This script does not support Ruby configuration, mainly"
-    " because Trace CPU has been tested only with classic memory system")
-    sys.exit(1)
+    Ruby.define_options(parser)
 
 args = parser.parse_args()
 
@@ -63,15 +62,21 @@ if args.cpu_type != "TraceCPU":
     fatal("This is a script for elastic trace replay simulation, use "\
             "--cpu-type=TraceCPU\n");
 
-if args.num_cpus > 1:
-    fatal("This script does not support multi-processor trace replay.\n")
+# Multi-core replays take one trace per core, separated by semicolons, in
+# the same order as the cores that captured them (see se.py --cmd).
+np = args.num_cpus
+inst_traces = args.inst_trace_file.split(';')
+data_traces = args.data_trace_file.split(';')
+if len(inst_traces) != np or len(data_traces) != np:
+    fatal("Expected %d instruction and data trace files, got %d and %d.\n",
+          np, len(inst_traces), len(data_traces))
 
 # In this case FutureClass will be None as there is not fast forwarding or
 # switching
 (CPUClass, test_mem_mode, FutureClass) = Simulation.setCPUClass(args)
 CPUClass.numThreads = numThreads
 
-system = System(cpu = CPUClass(cpu_id=0),
+system = System(cpu = [CPUClass(cpu_id=i) for i in range(np)],
                 mem_mode = test_mem_mode,
                 mem_ranges = [AddrRange(args.mem_size)],
                 cache_line_size = args.cacheline_size)
@@ -103,16 +108,30 @@ for cpu in system.cpu:
 for cpu in system.cpu:
     cpu.createThreads()
 
-# Assign input trace files to the Trace CPU
-system.cpu.instTraceFile=args.inst_trace_file
-system.cpu.dataTraceFile=args.data_trace_file
-
-# Configure the classic memory system args
-MemClass = Simulation.setMemClass(args)
-system.membus = SystemXBar()
-system.system_port = system.membus.slave
-CacheConfig.config_cache(args, system)
-MemConfig.config_mem(args, system)
+# Assign input trace files to the Trace CPUs
+for i in range(np):
+    system.cpu[i].instTraceFile = inst_traces[i]
+    system.cpu[i].dataTraceFile = data_traces[i]
+
+if args.ruby:
+    # Ruby also instantiates the HTM model when the protocol supports it,
+    # which lets the Trace CPUs replay the captured transactions.
+    Ruby.create_system(args, False, system)
+    assert(np == len(system.ruby._cpu_ports))
+
+    system.ruby.clk_domain = SrcClockDomain(clock = args.ruby_clock,
+                                        voltage_domain = system.voltage_domain)
+    for i in range(np):
+        ruby_port = system.ruby._cpu_ports[i]
+        system.cpu[i].createInterruptController()
+        ruby_port.connectCpuPorts(system.cpu[i])
+else:
+    # Configure the classic memory system args
+    MemClass = Simulation.setMemClass(args)
+    system.membus = SystemXBar()
+    system.system_port = system.membus.slave
+    CacheConfig.config_cache(args, system)
+    MemConfig.config_mem(args, system)
 
 root = Root(full_system = False, system = system)
 Simulation.run(args, root, system, FutureClass)
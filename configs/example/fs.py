@@ -202,6 +202,8 @@ def build_test_system(np):
                         IndirectBPClass()
             test_sys.cpu[i].createThreads()
 
+        CpuConfig.config_translation(test_sys.cpu, args)
+
         # If elastic tracing is enabled when not restoring from checkpoint and
         # when not fast forwarding using the atomic cpu, then check that the
         # TestCPUClass is DerivO3CPU or inherits from DerivO3CPU. If the check
@@ -191,6 +191,11 @@ system.cpu_clk_domain = SrcClockDomain(clock = args.cpu_clock,
 if args.elastic_trace_en:
     CpuConfig.config_etrace(CPUClass, system.cpu, args)
 
+if args.branch_trace_file:
+    CpuConfig.config_branch_trace(CPUClass, system.cpu, args)
+
+CpuConfig.config_translation(system.cpu, args)
+
 # All cpus belong to a common cpu_clk_domain, therefore running at a common
 # frequency.
 for cpu in system.cpu:
@@ -0,0 +1,192 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script drives the memory system at increasing injection rates
+# with a number of synthetic traffic generators, one per requestor, to
+# characterise the bandwidth and latency curves of the memory
+# controllers or of a Ruby memory system without simulating any cores.
+# Every injection rate is a phase of the same simulation, and the
+# statistics are dumped and reset at the end of each phase, so the
+# readBW and avgReadLatency of the generators (and the controller and
+# network statistics) give one point of the curve per dump.
+#
+# Example: sweep 8 Zipfian generators over the default DDR3 channel
+#   build/X86/gem5.opt configs/example/traffic_sweep.py -n 8 \
+#       --kernel zipf --itt-max 64000 --itt-min 1000
+
+import argparse
+import math
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+from m5.stats import periodicStatDump
+
+addToPath('../')
+
+from common import Options
+from common import MemConfig
+from ruby import Ruby
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+Options.addNoISAOptions(parser)
+
+kernels = [ 'linear', 'random', 'pointer_chase', 'gather_scatter', 'zipf',
+            'binary_trace' ]
+
+parser.add_argument("--kernel", default="random", choices=kernels,
+                    help="Address stream generated by every requestor "
+                    "(-n sets the number of requestors)")
+parser.add_argument("--trace-file", type=str, default="",
+                    help="Binary trace replayed by the binary_trace kernel, "
+                    "see util/encode_binary_trace.py")
+parser.add_argument("--block-size", type=int, default=64,
+                    help="Size of the requests in bytes")
+parser.add_argument("--rd-perc", type=int, default=100,
+                    help="Percentage of read requests")
+parser.add_argument("--itt-max", type=int, default=64000,
+                    help="Inter-transaction time (ps) of the first phase")
+parser.add_argument("--itt-min", type=int, default=1000,
+                    help="Inter-transaction time (ps) of the last phase")
+parser.add_argument("--itt-steps", type=int, default=7,
+                    help="Number of injection rates, spaced geometrically "
+                    "between --itt-max and --itt-min")
+parser.add_argument("--phase-duration", type=str, default="100us",
+                    help="Time spent at each injection rate")
+parser.add_argument("--max-outstanding", type=int, default=16,
+                    help="Outstanding requests per requestor, 0 for no "
+                    "limit")
+parser.add_argument("--batch-size", type=int, default=16,
+                    help="Packets a requestor may issue per update event")
+parser.add_argument("--private", action="store_true",
+                    help="Give every requestor a disjoint slice of the "
+                    "memory instead of sharing all of it")
+parser.add_argument("--num-chains", type=int, default=1,
+                    help="Parallel chains of the pointer_chase kernel")
+parser.add_argument("--vector-length", type=int, default=8,
+                    help="Elements per index block of the gather_scatter "
+                    "kernel")
+parser.add_argument("--zipf-alpha", type=float, default=0.99,
+                    help="Skew of the zipf kernel")
+
+Ruby.define_options(parser)
+
+args = parser.parse_args()
+
+if args.kernel == 'binary_trace' and not args.trace_file:
+    fatal("The binary_trace kernel needs a --trace-file")
+
+num_tgens = args.num_cpus
+tgens = [ PyTrafficGen(max_outstanding_reqs = args.max_outstanding,
+                       batch_size = args.batch_size,
+                       cpu_id = i)
+          for i in range(num_tgens) ]
+
+mem_range = AddrRange(args.mem_size)
+system = System(cpu = tgens, mem_ranges = [mem_range])
+system.voltage_domain = VoltageDomain(voltage = args.sys_voltage)
+system.clk_domain = SrcClockDomain(clock = args.sys_clock,
+                                   voltage_domain = system.voltage_domain)
+
+# do not worry about reserving space for the backing store
+system.mmap_using_noreserve = True
+
+if args.ruby:
+    Ruby.create_system(args, False, system)
+    system.ruby.clk_domain = SrcClockDomain(clock = args.ruby_clock,
+                                    voltage_domain = system.voltage_domain)
+    assert(len(tgens) == len(system.ruby._cpu_ports))
+    for (i, tgen) in enumerate(tgens):
+        tgen.port = system.ruby._cpu_ports[i].in_ports
+        # saturating the network makes for long queueing delays
+        system.ruby._cpu_ports[i].deadlock_threshold = 5000000
+else:
+    system.membus = SystemXBar()
+    system.system_port = system.membus.cpu_side_ports
+    MemConfig.config_mem(args, system)
+    for tgen in tgens:
+        tgen.port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+period = m5.ticks.fromSeconds(m5.util.convert.anyToLatency(
+    args.phase_duration))
+periodicStatDump(period)
+
+slice_size = mem_range.size()
+if args.private:
+    slice_size //= num_tgens
+
+def itt_sweep():
+    if args.itt_steps == 1:
+        return [ args.itt_max ]
+    ratio = math.pow(float(args.itt_min) / args.itt_max,
+                     1.0 / (args.itt_steps - 1))
+    return [ int(args.itt_max * ratio ** i) for i in range(args.itt_steps) ]
+
+def phases(tgen, idx):
+    start = idx * slice_size if args.private else 0
+    end = start + slice_size
+    if args.kernel == 'binary_trace':
+        # the trace sets its own injection rate, replay it once
+        yield tgen.createBinaryTrace(period, args.trace_file, start)
+        yield tgen.createExit(0)
+        return
+
+    for itt in itt_sweep():
+        if args.kernel == 'linear':
+            yield tgen.createLinear(period, start, end, args.block_size,
+                                    itt, itt, args.rd_perc, 0)
+        elif args.kernel == 'random':
+            yield tgen.createRandom(period, start, end, args.block_size,
+                                    itt, itt, args.rd_perc, 0)
+        elif args.kernel == 'pointer_chase':
+            yield tgen.createPointerChase(period, start, end,
+                                          args.block_size, args.num_chains,
+                                          itt, itt, args.rd_perc, 0)
+        elif args.kernel == 'gather_scatter':
+            # keep the indices in the first sixteenth of the slice
+            index_end = start + max(slice_size // 16, args.block_size)
+            yield tgen.createGatherScatter(period, index_end, end,
+                                           args.block_size, start,
+                                           index_end, args.vector_length,
+                                           itt, itt, args.rd_perc, 0)
+        else:
+            yield tgen.createZipf(period, start, end, args.block_size,
+                                  args.zipf_alpha, itt, itt, args.rd_perc, 0)
+    # all the requestors change phase in lockstep, so the first one to
+    # run out of phases ends the simulation
+    yield tgen.createExit(0)
+
+for (i, tgen) in enumerate(tgens):
+    tgen.start(phases(tgen, i))
+
+exit_event = m5.simulate()
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
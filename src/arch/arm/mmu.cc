@@ -131,6 +131,7 @@ MMU::translateTiming(const RequestPtr &req, ThreadContext *tc,
 void
 MMU::invalidateMiscReg(TLBType type)
 {
+    _flushCount++;
     if (type & TLBType::I_TLBS) {
         getITBPtr()->invalidateMiscReg();
     }
@@ -133,6 +133,7 @@ class MMU : public BaseMMU
     void
     flushStage2(const OP &tlbi_op)
     {
+        _flushCount++;
         itbStage2->flush(tlbi_op);
         dtbStage2->flush(tlbi_op);
     }
@@ -141,6 +142,7 @@ class MMU : public BaseMMU
     void
     iflush(const OP &tlbi_op)
     {
+        _flushCount++;
         getITBPtr()->flush(tlbi_op);
     }
 
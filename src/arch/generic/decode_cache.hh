@@ -58,20 +58,24 @@ class BasicDecodeCache
     StaticInstPtr
     decode(Decoder *const decoder, EMI mach_inst, Addr addr)
     {
+        decode_cache::Counts &counts = decoder->decodeCounts();
+
         auto &entry = decodePages.lookup(addr);
-        if (entry.inst && (entry.machInst == mach_inst))
+        if (entry.inst && (entry.machInst == mach_inst)) {
+            counts.addrHits++;
             return entry.inst;
+        }
 
         entry.machInst = mach_inst;
 
-        auto iter = instMap.find(mach_inst);
-        if (iter != instMap.end()) {
-            entry.inst = iter->second;
-            return entry.inst;
+        StaticInstPtr &si = instMap[mach_inst];
+        if (si) {
+            counts.instHits++;
+        } else {
+            counts.misses++;
+            si = decoder->decodeInst(mach_inst);
         }
-
-        entry.inst = decoder->decodeInst(mach_inst);
-        instMap[mach_inst] = entry.inst;
+        entry.inst = si;
         return entry.inst;
     }
 };
@@ -31,6 +31,7 @@
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base/types.hh"
+#include "cpu/decode_cache.hh"
 #include "cpu/static_inst_fwd.hh"
 
 namespace gem5
@@ -43,6 +44,8 @@ class InstDecoder
     size_t _moreBytesSize;
     Addr _pcMask;
 
+    decode_cache::Counts _decodeCounts;
+
   public:
     template <typename MoreBytesType>
     InstDecoder(MoreBytesType *mb_buf) :
@@ -53,9 +56,20 @@ class InstDecoder
     virtual StaticInstPtr fetchRomMicroop(
             MicroPC micropc, StaticInstPtr curMacroop);
 
+    /**
+     * Don't share decoded instructions with the other decoders, which
+     * may run on other host threads, as static instructions are not
+     * reference counted atomically. Decoders that never share their
+     * instructions can ignore this.
+     */
+    virtual void usePrivateCaches() {}
+
     void *moreBytesPtr() const { return _moreBytesPtr; }
     size_t moreBytesSize() const { return _moreBytesSize; }
     Addr pcMask() const { return _pcMask; }
+
+    /// Number of decodes served by each level of the decode caches.
+    decode_cache::Counts &decodeCounts() { return _decodeCounts; }
 };
 
 } // namespace gem5
@@ -123,6 +123,7 @@ namespace gem5
 
 class ThreadContext;
 class BaseHTMCheckpoint;
+class RegId;
 
 typedef std::unique_ptr<BaseHTMCheckpoint> BaseHTMCheckpointPtr;
 
@@ -136,7 +137,8 @@ class BaseHTMCheckpoint
     uint64_t localHtmUid;
 
   public:
-    BaseHTMCheckpoint() : localHtmUid(0), _valid(false)
+    BaseHTMCheckpoint()
+      : localHtmUid(0), _valid(false), copyOnWrite(false), _tracking(false)
     {
         reset();
     }
@@ -173,6 +175,36 @@ class BaseHTMCheckpoint
 
     bool valid() const { return _valid; }
 
+    /**
+     * Enables copy-on-write checkpointing. Thread contexts which see
+     * every architectural register write (or commit) enable it, so that
+     * save only needs to start tracking writes and each register is
+     * saved, through saveRegOnWrite, right before its first write within
+     * the transaction. Aborts then only restore the registers written.
+     *
+     * @param cow: whether registers may be saved lazily
+     */
+    void setCopyOnWrite(bool cow) { copyOnWrite = cow; }
+
+    /**
+     * Whether register writes must be reported to saveRegOnWrite, i.e.
+     * a copy-on-write checkpoint has been saved and not yet restored.
+     */
+    bool tracksRegWrites() const { return _tracking; }
+
+    /**
+     * ISAs supporting copy-on-write checkpoints should override this
+     * method, which is called before a flattened register is overwritten
+     * while tracksRegWrites() holds.
+     *
+     * @param tc: thread context holding the current register value
+     * @param flat_reg: the register about to be written
+     */
+    virtual void
+    saveRegOnWrite(ThreadContext *tc, const RegId &flat_reg)
+    {
+    }
+
     /**
      * Generates a new HTM identifier (used when starting a new transaction)
      */
@@ -210,8 +242,18 @@ class BaseHTMCheckpoint
      * override this method so that they can reset their own
      * ISA specific state.
      */
-    virtual void reset() { _valid = false; }
+    virtual void
+    reset()
+    {
+        _valid = false;
+        _tracking = false;
+    }
     bool _valid;
+
+    /** Save registers lazily, see setCopyOnWrite */
+    bool copyOnWrite;
+    /** Register writes are being reported, see tracksRegWrites */
+    bool _tracking;
 };
 
 } // namespace gem5
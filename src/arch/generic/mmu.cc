@@ -50,6 +50,7 @@ namespace gem5
 void
 BaseMMU::flushAll()
 {
+    _flushCount++;
     dtb->flushAll();
     itb->flushAll();
 }
@@ -57,6 +58,7 @@ BaseMMU::flushAll()
 void
 BaseMMU::demapPage(Addr vaddr, uint64_t asn)
 {
+    _flushCount++;
     itb->demapPage(vaddr, asn);
     dtb->demapPage(vaddr, asn);
 }
@@ -92,6 +94,8 @@ BaseMMU::finalizePhysical(const RequestPtr &req, ThreadContext *tc,
 void
 BaseMMU::takeOverFrom(BaseMMU *old_mmu)
 {
+    _flushCount++;
+
     Port *old_itb_port = old_mmu->itb->getTableWalkerPort();
     Port *old_dtb_port = old_mmu->dtb->getTableWalkerPort();
     Port *new_itb_port = itb->getTableWalkerPort();
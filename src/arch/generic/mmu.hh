@@ -116,9 +116,18 @@ class BaseMMU : public SimObject
 
     virtual void takeOverFrom(BaseMMU *old_mmu);
 
+    /**
+     * Number of flushes and demaps so far, to tell users caching
+     * translations when theirs may have gone stale.
+     */
+    uint64_t flushCount() const { return _flushCount; }
+
   public:
     BaseTLB* dtb;
     BaseTLB* itb;
+
+  protected:
+    uint64_t _flushCount = 0;
 };
 
 } // namespace gem5
@@ -88,8 +88,12 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
             mach_inst, addr);
 
     StaticInstPtr &si = instMap[mach_inst];
-    if (!si)
+    if (si) {
+        _decodeCounts.instHits++;
+    } else {
+        _decodeCounts.misses++;
         si = decodeInst(mach_inst);
+    }
 
     DPRINTF(Decode, "Decode: Decoded %s instruction: %#x\n",
             si->getName(), mach_inst);
@@ -33,12 +33,22 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
 from m5.objects.BaseTLB import BaseTLB
 from m5.objects.ClockedObject import ClockedObject
 
+class X86PageWalkCache(SimObject):
+    type = 'X86PageWalkCache'
+    cxx_class = 'gem5::X86ISA::PageWalkCache'
+    cxx_header = 'arch/x86/page_walk_cache.hh'
+
+    pml4_entries = Param.Unsigned(2, "Cached PML4 entries")
+    pdp_entries = Param.Unsigned(4, "Cached PDP entries")
+    pd_entries = Param.Unsigned(32, "Cached non-leaf PD entries")
+
 class X86PagetableWalker(ClockedObject):
     type = 'X86PagetableWalker'
     cxx_class = 'gem5::X86ISA::Walker'
@@ -48,6 +58,14 @@ class X86PagetableWalker(ClockedObject):
     system = Param.System(Parent.any, "system object")
     num_squash_per_cycle = Param.Unsigned(4,
             "Number of outstanding walks that can be squashed per cycle")
+    num_walkers = Param.Unsigned(1,
+            "Number of page table walks that can be in progress at once")
+    coalesce_walks = Param.Bool(False, "Attach misses to a walk already "
+            "pending for the same page instead of walking again")
+    page_walk_cache = Param.X86PageWalkCache(NULL,
+            "Cache of non-leaf long mode entries, may be shared")
+    next_level_tlb_latency = Param.Cycles(8,
+            "Latency of a hit in the next level TLB")
 
 class X86TLB(BaseTLB):
     type = 'X86TLB'
@@ -58,3 +76,5 @@ class X86TLB(BaseTLB):
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
+    next_level = Param.X86TLB(NULL, "Next level TLB looked up on a miss, "
+            "may be shared by several TLBs. Its walker should be NULL")
@@ -48,7 +48,14 @@ Decoder::doResetState()
 {
     origPC = basePC + offset;
     DPRINTF(Decoder, "Setting origPC to %#x\n", origPC);
-    instBytes = &decodePages->lookup(origPC);
+    if (ignoreLockElisionOnce && origPC == lockElisionPC) {
+        // The decode cache holds the eliding version of this
+        // instruction, so decode it again from its bytes
+        lockElisionBytes = InstBytes();
+        instBytes = &lockElisionBytes;
+    } else {
+        instBytes = &decodePages->lookup(origPC);
+    }
     chunkIdx = 0;
 
     emi.rex = 0;
@@ -675,17 +682,55 @@ Decoder::doImmediateState()
 Decoder::InstBytes Decoder::dummy;
 Decoder::InstCacheMap Decoder::instCacheMap;
 
+void
+Decoder::selectCaches(CacheKey key)
+{
+    cacheKey = key;
+
+    AddrCacheMap::iterator amIter = addrCacheMap.find(key);
+    if (amIter != addrCacheMap.end()) {
+        decodePages = amIter->second;
+    } else {
+        decodePages = new DecodePages;
+        addrCacheMap[key] = decodePages;
+    }
+
+    InstCacheMap::iterator imIter = instCaches->find(key);
+    if (imIter != instCaches->end()) {
+        instMap = imIter->second;
+    } else {
+        instMap = new decode_cache::InstMap<ExtMachInst>;
+        (*instCaches)[key] = instMap;
+    }
+}
+
+void
+Decoder::usePrivateCaches()
+{
+    if (instCaches == &privateInstCacheMap)
+        return;
+    instCaches = &privateInstCacheMap;
+
+    // The decode pages point to instructions of the shared caches
+    for (auto &pages : addrCacheMap)
+        delete pages.second;
+    addrCacheMap.clear();
+    instBytes = &dummy;
+    reset();
+
+    if (instMap)
+        selectCaches(cacheKey);
+}
+
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
-    StaticInstPtr si;
-
-    auto iter = instMap->find(mach_inst);
-    if (iter != instMap->end()) {
-        si = iter->second;
+    StaticInstPtr &si = (*instMap)[mach_inst];
+    if (si) {
+        _decodeCounts.instHits++;
     } else {
+        _decodeCounts.misses++;
         si = decodeInst(mach_inst);
-        (*instMap)[mach_inst] = si;
     }
 
     DPRINTF(Decode, "Decode: Decoded %s instruction: %#x\n",
@@ -701,9 +746,20 @@ Decoder::decode(PCState &nextPC)
     instDone = false;
     updateNPC(nextPC);
 
+    if (instBytes == &lockElisionBytes) {
+        ignoreLockElisionOnce = false;
+        emi.legacy.rep = 0;
+        emi.legacy.repne = 0;
+        DPRINTF(Decoder, "Ignoring lock elision prefixes at %#x\n",
+                origPC);
+        return decode(emi, origPC);
+    }
+
     StaticInstPtr &si = instBytes->si;
-    if (si)
+    if (si) {
+        _decodeCounts.addrHits++;
         return si;
+    }
 
     // We didn't match in the AddrMap, but we still populated an entry. Fix
     // up its byte masks.
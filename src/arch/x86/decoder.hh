@@ -110,6 +110,14 @@ class Decoder : public InstDecoder
     uint8_t defAddr = 0;
     uint8_t stack = 0;
 
+    // Hardware lock elision: the instruction at lockElisionPC is decoded
+    // with its XACQUIRE/XRELEASE prefixes ignored, so that a lock
+    // acquire restarted by an aborted elision takes the lock.
+    bool ignoreLockElisionOnce = false;
+    Addr lockElisionPC = 0;
+    // Decoding state of that instruction, kept out of the decode cache
+    InstBytes lockElisionBytes;
+
     uint8_t
     getNextByte()
     {
@@ -246,6 +254,15 @@ class Decoder : public InstDecoder
     typedef std::unordered_map<
             CacheKey, decode_cache::InstMap<ExtMachInst> *> InstCacheMap;
     static InstCacheMap instCacheMap;
+    // The instruction caches in use, either the ones shared by all
+    // decoders or the private ones of this decoder
+    InstCacheMap *instCaches = &instCacheMap;
+    InstCacheMap privateInstCacheMap;
+    // The mode the caches are currently selected for
+    CacheKey cacheKey = 0;
+
+    /// Select the decode caches of a mode.
+    void selectCaches(CacheKey key);
 
     StaticInstPtr decodeInst(ExtMachInst mach_inst);
 
@@ -275,23 +292,11 @@ class Decoder : public InstDecoder
         defAddr = m5Reg.defAddr;
         stack = m5Reg.stack;
 
-        AddrCacheMap::iterator amIter = addrCacheMap.find(m5Reg);
-        if (amIter != addrCacheMap.end()) {
-            decodePages = amIter->second;
-        } else {
-            decodePages = new DecodePages;
-            addrCacheMap[m5Reg] = decodePages;
-        }
-
-        InstCacheMap::iterator imIter = instCacheMap.find(m5Reg);
-        if (imIter != instCacheMap.end()) {
-            instMap = imIter->second;
-        } else {
-            instMap = new decode_cache::InstMap<ExtMachInst>;
-            instCacheMap[m5Reg] = instMap;
-        }
+        selectCaches(m5Reg);
     }
 
+    void usePrivateCaches() override;
+
     void
     takeOverFrom(Decoder *old)
     {
@@ -308,6 +313,25 @@ class Decoder : public InstDecoder
 
     void reset() { state = ResetState; }
 
+    /**
+     * Decode XACQUIRE/XRELEASE prefixed instructions as lock elision
+     * instructions. Otherwise, as on processors without HLE, the
+     * prefixes are ignored and the lock is always taken.
+     */
+    void setLockElision(bool enable) { emi.mode.lockElision = enable; }
+
+    /**
+     * Decode the next instruction at the given address without lock
+     * elision. Called when a transaction started by an XACQUIRE
+     * instruction aborts and execution restarts at that instruction.
+     */
+    void
+    ignoreLockElision(Addr pc)
+    {
+        ignoreLockElisionOnce = true;
+        lockElisionPC = pc;
+    }
+
     void process();
 
     // Use this to give data to the decoder. This should be used
@@ -7,6 +7,10 @@
 
 #include "arch/x86/htm.hh"
 
+#include <algorithm>
+
+#include "arch/x86/decoder.hh"
+#include "cpu/reg_class.hh"
 #include "cpu/thread_context.hh"
 
 namespace gem5
@@ -17,9 +21,14 @@ X86ISA::HTMCheckpoint::reset()
 {
     nPc = 0;
     abortReason = 0;
-    shadowIntRegs.fill(0);
-    shadowFPRegs.fill(0);
+    // Shadow values are only meaningful once saved, so there is no need
+    // to clear them (which would cost a register file copy per abort)
+    savedIntRegs.reset();
+    savedFPRegs.reset();
+    savedCCRegs.reset();
     pcstateckpt = PCState();
+    lockElision = false;
+    elidedLocks.clear();
 
     BaseHTMCheckpoint::reset();
 }
@@ -27,24 +36,93 @@ X86ISA::HTMCheckpoint::reset()
 void
 X86ISA::HTMCheckpoint::save(ThreadContext *tc)
 {
-    for (auto n = 0; n < NumIntRegs; n++) {
-        shadowIntRegs[n] = tc->readIntRegFlat(n);
-    }
-    for (auto n = 0; n < NumFloatRegs; n++) {
-        shadowFPRegs[n] = tc->readFloatRegFlat(n);
+    savedIntRegs.reset();
+    savedFPRegs.reset();
+    savedCCRegs.reset();
+
+    if (copyOnWrite) {
+        // Registers are saved by saveRegOnWrite as they get written
+        _tracking = true;
+    } else {
+        for (auto n = 0; n < NumIntRegs; n++) {
+            shadowIntRegs[n] = tc->readIntRegFlat(n);
+        }
+        for (auto n = 0; n < NumFloatRegs; n++) {
+            shadowFPRegs[n] = tc->readFloatRegFlat(n);
+        }
+        for (auto n = 0; n < NUM_CCREGS; n++) {
+            shadowCCRegs[n] = tc->readCCRegFlat(n);
+        }
+        savedIntRegs.set();
+        savedFPRegs.set();
+        savedCCRegs.set();
     }
     pcstateckpt = tc->pcState();
+    lockElision = false;
+    elidedLocks.clear();
     BaseHTMCheckpoint::save(tc);
 }
 
+void
+X86ISA::HTMCheckpoint::saveRegOnWrite(ThreadContext *tc,
+                                      const RegId &flat_reg)
+{
+    const RegIndex n = flat_reg.index();
+
+    switch (flat_reg.classValue()) {
+      case IntRegClass:
+        if (!savedIntRegs[n]) {
+            shadowIntRegs[n] = tc->readIntRegFlat(n);
+            savedIntRegs.set(n);
+        }
+        break;
+      case FloatRegClass:
+        if (!savedFPRegs[n]) {
+            shadowFPRegs[n] = tc->readFloatRegFlat(n);
+            savedFPRegs.set(n);
+        }
+        break;
+      case CCRegClass:
+        if (!savedCCRegs[n]) {
+            shadowCCRegs[n] = tc->readCCRegFlat(n);
+            savedCCRegs.set(n);
+        }
+        break;
+      default:
+        // Misc registers are not part of the checkpoint, and x86 has no
+        // vector register file (XMM state lives in the float registers)
+        break;
+    }
+}
+
 void
 X86ISA::HTMCheckpoint::restore(ThreadContext *tc, HtmFailureFaultCause cause)
 {
+    // Stop tracking writes before rolling back the registers
+    _tracking = false;
+
     for (auto n = 0; n < NumIntRegs; n++) {
-        tc->setIntRegFlat(n, shadowIntRegs[n]);
+        if (savedIntRegs[n])
+            tc->setIntRegFlat(n, shadowIntRegs[n]);
     }
     for (auto n = 0; n < NumFloatRegs; n++) {
-        tc->setFloatRegFlat(n, shadowFPRegs[n]);
+        if (savedFPRegs[n])
+            tc->setFloatRegFlat(n, shadowFPRegs[n]);
+    }
+    for (auto n = 0; n < NUM_CCREGS; n++) {
+        if (savedCCRegs[n])
+            tc->setCCRegFlat(n, shadowCCRegs[n]);
+    }
+
+    if (lockElision) {
+        // HLE aborts leave no status behind: restart the XACQUIRE
+        // instruction, which takes the lock this time
+        pcstateckpt.uReset();
+        tc->pcState(pcstateckpt);
+        tc->getDecoderPtr()->ignoreLockElision(pcstateckpt.instAddr());
+
+        BaseHTMCheckpoint::restore(tc, cause);
+        return;
     }
 
     bool retry = false;
@@ -110,4 +188,23 @@ X86ISA::HTMCheckpoint::setAbortReason(uint16_t reason)
     abortReason = reason;
 }
 
+void
+X86ISA::HTMCheckpoint::elideLock(Addr lock_addr)
+{
+    elidedLocks.push_back(lock_addr);
+}
+
+bool
+X86ISA::HTMCheckpoint::releaseLock(Addr lock_addr)
+{
+    // Nested elisions of the same lock are released innermost first
+    auto it = std::find(elidedLocks.rbegin(), elidedLocks.rend(),
+                        lock_addr);
+    if (it == elidedLocks.rend())
+        return false;
+
+    elidedLocks.erase(std::next(it).base());
+    return true;
+}
+
 } // namespace gem5
@@ -12,7 +12,12 @@
  * ISA-specific types for hardware transactional memory.
  */
 
+#include <array>
+#include <bitset>
+#include <vector>
+
 #include "arch/generic/htm.hh"
+#include "arch/x86/regs/ccr.hh"
 #include "arch/x86/regs/float.hh"
 #include "arch/x86/regs/int.hh"
 #include "base/types.hh"
@@ -35,15 +40,41 @@ class HTMCheckpoint : public BaseHTMCheckpoint
     void reset() override;
     void save(ThreadContext *tc) override;
     void restore(ThreadContext *tc, HtmFailureFaultCause cause) override;
+    void saveRegOnWrite(ThreadContext *tc, const RegId &flat_reg) override;
     void setAbortReason(uint16_t reason);
 
+    /**
+     * Hardware lock elision (HLE). A transaction started by an XACQUIRE
+     * instruction is marked so that aborting it restarts that
+     * instruction without elision, rather than resuming after it with
+     * an abort status in EAX as RTM does.
+     */
+    void setLockElision() { lockElision = true; }
+    /** Record the address of a lock whose acquisition was elided */
+    void elideLock(Addr lock_addr);
+    /**
+     * Forget an elided lock upon its release.
+     * @return Whether the lock was elided by the current transaction.
+     */
+    bool releaseLock(Addr lock_addr);
+
   private:
     Addr nPc; // Fallback instruction address
     std::array<RegVal, NumIntRegs> shadowIntRegs;
-    std::array<RegVal, NumFloatRegs> shadowFPRegs;
+    std::array<RegVal, NumFloatRegs> shadowFPRegs; // x87, MMX and XMM
+    std::array<RegVal, NUM_CCREGS> shadowCCRegs;
+    // Which shadow registers hold a saved value: all of them after an
+    // eager save, those written so far when saving copy-on-write
+    std::bitset<NumIntRegs> savedIntRegs;
+    std::bitset<NumFloatRegs> savedFPRegs;
+    std::bitset<NUM_CCREGS> savedCCRegs;
     //Addr sp; // Stack Pointer at current EL
     uint16_t abortReason; // XABORT reason
     PCState pcstateckpt;
+    // Whether the outer transaction was started by XACQUIRE
+    bool lockElision = false;
+    // Locks elided so far within the transaction
+    std::vector<Addr> elidedLocks;
 
 };
 
@@ -39,6 +39,7 @@
 #include "cpu/thread_context.hh"
 #include "params/X86ISA.hh"
 #include "sim/serialize.hh"
+#include "sim/system.hh"
 
 namespace gem5
 {
@@ -503,6 +504,11 @@ ISA::setThreadContext(ThreadContext *_tc)
 {
     BaseISA::setThreadContext(_tc);
     tc->getDecoderPtr()->setM5Reg(regVal[MISCREG_M5_REG]);
+
+    // Lock elision needs transactional memory, which only timing CPUs
+    // drive (atomic CPUs can't start a transaction)
+    const System *sys = tc->getSystemPtr();
+    tc->getDecoderPtr()->setLockElision(sys->getHTM() && sys->isTimingMode());
 }
 
 std::string
@@ -43,6 +43,7 @@ categories = ["arithmetic",
               "input_output",
               "load_effective_address",
               "load_segment_registers",
+              "lock_elision",
               "logical",
               "no_operation",
               "rotate_and_shift",
@@ -0,0 +1,188 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Hardware lock elision (HLE). An XACQUIRE-prefixed lock acquire
+# starts a transaction and only reads the lock, so threads that elide
+# the same lock run their critical sections concurrently. The matching
+# XRELEASE-prefixed store commits the transaction instead of writing
+# the lock. If the transaction aborts, the checkpoint restarts the
+# acquire with the prefix ignored, so it takes the lock for real.
+#
+# The elided lock address is recorded in the HTM checkpoint (hleacq),
+# and an XRELEASE only ends the transaction if it targets a lock
+# elided by it (rdhle). Otherwise, as with forms not listed here, the
+# prefixes are ignored as on processors without HLE.
+
+microcode = '''
+def macroop XACQUIRE_XCHG_M_R
+{
+    hlebegin
+    ld t1, seg, sib, disp
+    lea t2, seg, sib, disp, dataSize=asz
+    hleacq t2
+    mov reg, reg, t1
+};
+
+def macroop XACQUIRE_XCHG_P_R
+{
+    rdip t7
+    hlebegin
+    ld t1, seg, riprel, disp
+    lea t2, seg, riprel, disp, dataSize=asz
+    hleacq t2
+    mov reg, reg, t1
+};
+
+def macroop XACQUIRE_CMPXCHG_M_R
+{
+    hlebegin
+    ld t1, seg, sib, disp
+    sub t0, rax, t1, flags=(OF, SF, ZF, AF, PF, CF)
+    lea t2, seg, sib, disp, dataSize=asz
+    hleacq t2
+    mov rax, rax, t1, flags=(nCZF,)
+};
+
+def macroop XACQUIRE_CMPXCHG_P_R
+{
+    rdip t7
+    hlebegin
+    ld t1, seg, riprel, disp
+    sub t0, rax, t1, flags=(OF, SF, ZF, AF, PF, CF)
+    lea t2, seg, riprel, disp, dataSize=asz
+    hleacq t2
+    mov rax, rax, t1, flags=(nCZF,)
+};
+
+def macroop XRELEASE_MOV_M_R
+{
+    lea t2, seg, sib, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_mov_m_r_elided"), flags=(nCEZF,)
+    st reg, seg, sib, disp
+    br label("xrelease_mov_m_r_end")
+xrelease_mov_m_r_elided:
+    htmfence
+    xend
+xrelease_mov_m_r_end:
+    fault "NoFault"
+};
+
+def macroop XRELEASE_MOV_P_R
+{
+    rdip t7
+    lea t2, seg, riprel, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_mov_p_r_elided"), flags=(nCEZF,)
+    st reg, seg, riprel, disp
+    br label("xrelease_mov_p_r_end")
+xrelease_mov_p_r_elided:
+    htmfence
+    xend
+xrelease_mov_p_r_end:
+    fault "NoFault"
+};
+
+def macroop XRELEASE_MOV_M_I
+{
+    lea t2, seg, sib, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_mov_m_i_elided"), flags=(nCEZF,)
+    limm t1, imm
+    st t1, seg, sib, disp
+    br label("xrelease_mov_m_i_end")
+xrelease_mov_m_i_elided:
+    htmfence
+    xend
+xrelease_mov_m_i_end:
+    fault "NoFault"
+};
+
+def macroop XRELEASE_MOV_P_I
+{
+    rdip t7
+    lea t2, seg, riprel, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_mov_p_i_elided"), flags=(nCEZF,)
+    limm t1, imm
+    st t1, seg, riprel, disp
+    br label("xrelease_mov_p_i_end")
+xrelease_mov_p_i_elided:
+    htmfence
+    xend
+xrelease_mov_p_i_end:
+    fault "NoFault"
+};
+
+# The elided release returns the value the lock held in memory, i.e.
+# the value read by the matching acquire
+def macroop XRELEASE_XCHG_M_R
+{
+    lea t2, seg, sib, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_xchg_m_r_elided"), flags=(nCEZF,)
+    mfence
+    ldstl t1, seg, sib, disp
+    stul reg, seg, sib, disp
+    mfence
+    mov reg, reg, t1
+    br label("xrelease_xchg_m_r_end")
+xrelease_xchg_m_r_elided:
+    ld t1, seg, sib, disp
+    mov reg, reg, t1
+    htmfence
+    xend
+xrelease_xchg_m_r_end:
+    fault "NoFault"
+};
+
+def macroop XRELEASE_XCHG_P_R
+{
+    rdip t7
+    lea t2, seg, riprel, disp, dataSize=asz
+    rdhle t1, t2
+    andi t0, t1, 1, flags=(EZF,)
+    br label("xrelease_xchg_p_r_elided"), flags=(nCEZF,)
+    mfence
+    ldstl t1, seg, riprel, disp
+    stul reg, seg, riprel, disp
+    mfence
+    mov reg, reg, t1
+    br label("xrelease_xchg_p_r_end")
+xrelease_xchg_p_r_elided:
+    ld t1, seg, riprel, disp
+    mov reg, reg, t1
+    htmfence
+    xend
+xrelease_xchg_p_r_end:
+    fault "NoFault"
+};
+'''
@@ -58,6 +58,7 @@ class MMU : public BaseMMU
     void
     flushNonGlobal()
     {
+        _flushCount++;
         static_cast<TLB*>(itb)->flushNonGlobal();
         static_cast<TLB*>(dtb)->flushNonGlobal();
     }
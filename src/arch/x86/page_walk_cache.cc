@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/x86/page_walk_cache.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/PageTableWalker.hh"
+
+namespace gem5
+{
+
+namespace X86ISA
+{
+
+PageWalkCache::PageWalkCache(const Params &p)
+    : SimObject(p), lruSeq(0), stats(this)
+{
+    entries[PML4].resize(p.pml4_entries);
+    entries[PDP].resize(p.pdp_entries);
+    entries[PD].resize(p.pd_entries);
+}
+
+const PageWalkCache::Entry *
+PageWalkCache::lookup(Addr cr3, Addr vaddr, Level &level)
+{
+    stats.accesses++;
+    for (int l = NumLevels - 1; l >= 0; l--) {
+        Addr tag = tagOf(vaddr, (Level)l);
+        for (auto &entry : entries[l]) {
+            if (entry.valid && entry.cr3 == cr3 && entry.tag == tag) {
+                DPRINTF(PageTableWalker, "Page walk cache hit at level %d "
+                        "for %#x.\n", l, vaddr);
+                entry.lruSeq = ++lruSeq;
+                stats.hits[l]++;
+                level = (Level)l;
+                return &entry;
+            }
+        }
+    }
+    stats.misses++;
+    return nullptr;
+}
+
+void
+PageWalkCache::insert(Addr cr3, Addr vaddr, Level level, const Entry &entry)
+{
+    auto &set = entries[level];
+    if (set.empty())
+        return;
+
+    Addr tag = tagOf(vaddr, level);
+    Entry *victim = &set[0];
+    for (auto &e : set) {
+        if (e.valid && e.cr3 == cr3 && e.tag == tag) {
+            victim = &e;
+            break;
+        }
+        if (!e.valid) {
+            victim = &e;
+        } else if (victim->valid && e.lruSeq < victim->lruSeq) {
+            victim = &e;
+        }
+    }
+
+    *victim = entry;
+    victim->valid = true;
+    victim->cr3 = cr3;
+    victim->tag = tag;
+    victim->lruSeq = ++lruSeq;
+}
+
+void
+PageWalkCache::flushAll()
+{
+    stats.flushes++;
+    for (auto &set : entries) {
+        for (auto &entry : set)
+            entry.valid = false;
+    }
+}
+
+PageWalkCache::PageWalkCacheStats::PageWalkCacheStats(
+        statistics::Group *parent)
+  : statistics::Group(parent),
+    ADD_STAT(accesses, statistics::units::Count::get(),
+             "Page table walks that looked up the page walk cache"),
+    ADD_STAT(hits, statistics::units::Count::get(),
+             "Page walk cache hits, by deepest level hit"),
+    ADD_STAT(misses, statistics::units::Count::get(),
+             "Page walk cache lookups that hit in no level"),
+    ADD_STAT(flushes, statistics::units::Count::get(),
+             "Page walk cache invalidations"),
+    ADD_STAT(hitRate, statistics::units::Ratio::get(),
+             "Fraction of walks that skipped at least one level",
+             sum(hits) / accesses)
+{
+    hits
+        .init(NumLevels)
+        .flags(statistics::total);
+    hits.subname(PML4, "PML4");
+    hits.subname(PDP, "PDP");
+    hits.subname(PD, "PD");
+
+    hitRate.flags(statistics::nozero | statistics::nonan);
+}
+
+} // namespace X86ISA
+} // namespace gem5
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __ARCH_X86_PAGE_WALK_CACHE_HH__
+#define __ARCH_X86_PAGE_WALK_CACHE_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "params/X86PageWalkCache.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace X86ISA
+{
+
+/**
+ * Cache of the non-leaf entries read by the long mode page table walker.
+ *
+ * Each level is a small fully associative array with LRU replacement,
+ * tagged by the CR3 of the walk and the virtual address bits translated
+ * down to that level. A hit gives the physical address of the next table
+ * to read, so the walk skips the memory reads of the levels above it. The
+ * permissions accumulated along the skipped levels are kept with the
+ * entry. A single instance can be shared by the instruction and data
+ * walkers of an MMU.
+ */
+class PageWalkCache : public SimObject
+{
+  public:
+    enum Level
+    {
+        PML4,
+        PDP,
+        PD,
+        NumLevels
+    };
+
+    struct Entry
+    {
+        bool valid = false;
+        Addr cr3 = 0;
+        Addr tag = 0;
+        uint64_t lruSeq = 0;
+
+        /** Physical address of the table the cached entry points to. */
+        Addr table = 0;
+        bool uncacheable = false;
+        bool writable = false;
+        bool user = false;
+        bool noExec = false;
+        /** Whether any of the levels down to this one had NX set. */
+        bool pathNX = false;
+    };
+
+    using Params = X86PageWalkCacheParams;
+    PageWalkCache(const Params &p);
+
+    /**
+     * Find the deepest cached level for a walk.
+     *
+     * @param cr3 CR3 value of the walk.
+     * @param vaddr Virtual address being translated.
+     * @param level Set to the level of the returned entry.
+     * @return The entry, or nullptr if no level hits.
+     */
+    const Entry *lookup(Addr cr3, Addr vaddr, Level &level);
+
+    /** Fill the entry read by a walk at the given level. */
+    void insert(Addr cr3, Addr vaddr, Level level, const Entry &entry);
+
+    void flushAll();
+
+  protected:
+    static Addr
+    tagOf(Addr vaddr, Level level)
+    {
+        // The PML4, PDP and PD entries translate down to bits 39, 30
+        // and 21 respectively.
+        return vaddr >> (39 - 9 * level);
+    }
+
+    std::vector<Entry> entries[NumLevels];
+    uint64_t lruSeq;
+
+    struct PageWalkCacheStats : public statistics::Group
+    {
+        PageWalkCacheStats(statistics::Group *parent);
+
+        statistics::Scalar accesses;
+        statistics::Vector hits;
+        statistics::Scalar misses;
+        statistics::Scalar flushes;
+        statistics::Formula hitRate;
+    } stats;
+};
+
+} // namespace X86ISA
+} // namespace gem5
+
+#endif // __ARCH_X86_PAGE_WALK_CACHE_HH__
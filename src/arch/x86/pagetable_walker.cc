@@ -52,6 +52,7 @@
 #include <memory>
 
 #include "arch/x86/faults.hh"
+#include "arch/x86/page_size.hh"
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
 #include "base/bitfield.hh"
@@ -71,15 +72,46 @@ Fault
 Walker::start(ThreadContext * _tc, BaseMMU::Translation *_translation,
               const RequestPtr &_req, BaseMMU::Mode _mode)
 {
-    // TODO: in timing mode, instead of blocking when there are other
-    // outstanding requests, see if this request can be coalesced with
-    // another one (i.e. either coalesce or start walk)
+    // A hit in the next level TLB refills the TLB without walking. The
+    // entry may be evicted before the refill latency is over, so the
+    // translation finishes from a copy of it.
+    if (TlbEntry *next_level_entry =
+            tlb->lookupNextLevel(_req->getVaddr(), _mode)) {
+        stats.nextLevelHits++;
+        if (sys->isTimingMode()) {
+            const TlbEntry entry = *next_level_entry;
+            pendingNextLevelHits++;
+            schedule(new EventFunctionWrapper(
+                    [this, _tc, _translation, _req, _mode, entry]
+                    { finishNextLevelHit(_tc, _translation, _req, _mode,
+                                         entry); },
+                    name() + ".nextLevelHit", true),
+                clockEdge(nextLevelLatency));
+        }
+        return NoFault;
+    }
+
+    if (coalesceWalks && sys->isTimingMode()) {
+        for (auto walkerState : currStates) {
+            if (walkerState->samePage(_tc, _req->getVaddr())) {
+                DPRINTF(PageTableWalker, "Coalescing walk for %#x.\n",
+                        _req->getVaddr());
+                walkerState->coalesce(_translation, _req, _mode);
+                stats.walksCoalesced++;
+                return NoFault;
+            }
+        }
+    }
+
     WalkerState * newState = new WalkerState(this, _translation, _req);
     newState->initState(_tc, _mode, sys->isTimingMode());
     if (currStates.size()) {
         assert(newState->isTiming());
         DPRINTF(PageTableWalker, "Walks in progress: %d\n", currStates.size());
         currStates.push_back(newState);
+        if (numActiveWalks() < numWalkers &&
+                !startWalkWrapperEvent.scheduled())
+            schedule(startWalkWrapperEvent, clockEdge());
         return NoFault;
     } else {
         currStates.push_back(newState);
@@ -92,6 +124,14 @@ Walker::start(ThreadContext * _tc, BaseMMU::Translation *_translation,
     }
 }
 
+DrainState
+Walker::drain()
+{
+    // Refills from the next level TLB are still to finish their
+    // translations
+    return pendingNextLevelHits ? DrainState::Draining : DrainState::Drained;
+}
+
 Fault
 Walker::startFunctional(ThreadContext * _tc, Addr &addr, unsigned &logBytes,
               BaseMMU::Mode _mode)
@@ -123,6 +163,10 @@ Walker::recvTimingResp(PacketPtr pkt)
                 break;
             }
         }
+        if (!senderWalk->squashed) {
+            stats.walkServiceTime.sample(curTick() - senderWalk->startTick);
+            finishCoalesced(senderWalk);
+        }
         delete senderWalk;
         // Since we block requests when another is outstanding, we
         // need to check if there is a waiting request to be serviced
@@ -192,37 +236,114 @@ void
 Walker::startWalkWrapper()
 {
     unsigned num_squashed = 0;
-    WalkerState *currState = currStates.front();
-    while ((num_squashed < numSquashable) && currState &&
-        currState->translation->squashed()) {
-        currStates.pop_front();
-        num_squashed++;
-
-        DPRINTF(PageTableWalker, "Squashing table walk for address %#x\n",
-            currState->req->getVaddr());
-
-        // finish the translation which will delete the translation object
-        currState->translation->finish(
-            std::make_shared<UnimpFault>("Squashed Inst"),
-            currState->req, currState->tc, currState->mode);
-
-        // delete the current request if there are no inflight packets.
-        // if there is something in flight, delete when the packets are
-        // received and inflight is zero.
-        if (currState->numInflight() == 0) {
+    unsigned num_active = numActiveWalks();
+    auto iter = currStates.begin();
+    while (iter != currStates.end() && num_active < numWalkers) {
+        WalkerState *currState = *iter;
+        if (currState->wasStarted()) {
+            iter++;
+            continue;
+        }
+        if (num_squashed < numSquashable &&
+                currState->translation->squashed()) {
+            iter = currStates.erase(iter);
+            num_squashed++;
+            stats.squashedBefore++;
+
+            DPRINTF(PageTableWalker, "Squashing table walk for address "
+                    "%#x\n", currState->req->getVaddr());
+
+            // finish the translation which will delete the translation
+            // object
+            currState->translation->finish(
+                std::make_shared<UnimpFault>("Squashed Inst"),
+                currState->req, currState->tc, currState->mode);
+
+            // the misses that joined this walk still need their own
+            requeueCoalesced(currState);
+
+            // the walk was not started, so nothing can be in flight
+            assert(currState->numInflight() == 0);
             delete currState;
-        } else {
-            currState->squash();
+            continue;
         }
+        currState->startWalk();
+        num_active++;
+        iter++;
+    }
+}
 
-        // check the next translation request, if it exists
-        if (currStates.size())
-            currState = currStates.front();
-        else
-            currState = NULL;
+unsigned
+Walker::numActiveWalks() const
+{
+    unsigned active = 0;
+    for (auto walkerState : currStates) {
+        if (walkerState->started)
+            active++;
     }
-    if (currState && !currState->wasStarted())
-        currState->startWalk();
+    return active;
+}
+
+void
+Walker::finishNextLevelHit(ThreadContext *tc,
+        BaseMMU::Translation *translation, const RequestPtr &req,
+        BaseMMU::Mode mode, const TlbEntry &entry)
+{
+    finishTranslation(tc, translation, req, mode, entry);
+
+    assert(pendingNextLevelHits);
+    if (--pendingNextLevelHits == 0 &&
+            drainState() == DrainState::Draining) {
+        signalDrainDone();
+    }
+}
+
+void
+Walker::finishTranslation(ThreadContext *tc,
+        BaseMMU::Translation *translation, const RequestPtr &req,
+        BaseMMU::Mode mode, const TlbEntry &entry)
+{
+    if (translation->squashed()) {
+        translation->finish(std::make_shared<UnimpFault>("Squashed Inst"),
+                            req, tc, mode);
+        return;
+    }
+
+    // The TLB access of the request was already counted, and the entry
+    // found for it may have been evicted since, so finish from a copy.
+    bool delayedResponse;
+    Fault fault = tlb->translate(req, tc, NULL, mode, delayedResponse, true,
+                                 &entry);
+    assert(!delayedResponse);
+    translation->finish(fault, req, tc, mode);
+}
+
+void
+Walker::finishCoalesced(WalkerState *walk)
+{
+    if (walk->timingFault != NoFault) {
+        // The fault was raised for the request that started the walk,
+        // the others walk again to get their own.
+        requeueCoalesced(walk);
+        return;
+    }
+    for (auto &coalesced : walk->coalesced) {
+        finishTranslation(walk->tc, coalesced.translation, coalesced.req,
+                          coalesced.mode, walk->entry);
+    }
+    walk->coalesced.clear();
+}
+
+void
+Walker::requeueCoalesced(WalkerState *walk)
+{
+    for (auto &coalesced : walk->coalesced) {
+        WalkerState *newState =
+            new WalkerState(this, coalesced.translation, coalesced.req);
+        newState->initState(walk->tc, coalesced.mode, true);
+        currStates.push_back(newState);
+    }
+    walk->coalesced.clear();
 }
 
 Fault
@@ -231,8 +352,11 @@ Walker::WalkerState::startWalk()
     Fault fault = NoFault;
     assert(!started);
     started = true;
+    walker->stats.walks++;
     setupWalk(req->getVaddr());
     if (timing) {
+        startTick = curTick();
+        walker->stats.walkWaitTime.sample(startTick - queuedTick);
         nextState = state;
         state = Waiting;
         timingFault = NoFault;
@@ -312,6 +436,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
         }
         entry.noExec = pte.nx;
         nextState = LongPDP;
+        cacheTable(PageWalkCache::PML4, pte);
         break;
       case LongPDP:
         DPRINTF(PageTableWalker,
@@ -327,6 +452,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             break;
         }
         nextState = LongPD;
+        cacheTable(PageWalkCache::PDP, pte);
         break;
       case LongPD:
         DPRINTF(PageTableWalker,
@@ -346,6 +472,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             nextRead =
                 ((uint64_t)pte & (mask(40) << 12)) + vaddr.longl1 * dataSize;
             nextState = LongPTE;
+            cacheTable(PageWalkCache::PD, pte);
             break;
         } else {
             // 2 MB page
@@ -539,6 +666,24 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
     return fault;
 }
 
+void
+Walker::WalkerState::cacheTable(PageWalkCache::Level level,
+                                PageTableEntry pte)
+{
+    pathNX = pathNX || pte.nx;
+    if (!walker->pwc || functional)
+        return;
+
+    PageWalkCache::Entry cached;
+    cached.table = (uint64_t)pte & (mask(40) << 12);
+    cached.uncacheable = pte.pcd;
+    cached.writable = entry.writable;
+    cached.user = entry.user;
+    cached.noExec = entry.noExec;
+    cached.pathNX = pathNX;
+    walker->pwc->insert(walkCr3, entry.vaddr, level, cached);
+}
+
 void
 Walker::WalkerState::endWalk()
 {
@@ -585,9 +730,43 @@ Walker::WalkerState::setupWalk(Addr vaddr)
 
     nextState = Ready;
     entry.vaddr = vaddr;
+    walkCr3 = cr3;
+    pathNX = false;
+    bool uncacheable = cr3.pcd;
+
+    // Skip the levels the page walk cache has the next table for. A fetch
+    // through a cached NX level takes a full walk to raise its fault.
+    const PageWalkCache::Entry *cached = NULL;
+    PageWalkCache::Level level = PageWalkCache::PML4;
+    if (efer.lma && walker->pwc && !functional)
+        cached = walker->pwc->lookup(walkCr3, vaddr, level);
+    if (cached && !(cached->pathNX && mode == BaseMMU::Execute && enableNX)) {
+        switch (level) {
+          case PageWalkCache::PML4:
+            state = LongPDP;
+            topAddr = cached->table + addr.longl3 * dataSize;
+            break;
+          case PageWalkCache::PDP:
+            state = LongPD;
+            topAddr = cached->table + addr.longl2 * dataSize;
+            break;
+          case PageWalkCache::PD:
+            state = LongPTE;
+            topAddr = cached->table + addr.longl1 * dataSize;
+            entry.logBytes = 12;
+            break;
+          default:
+            panic("Unknown page walk cache level %d!\n", level);
+        }
+        uncacheable = cached->uncacheable;
+        entry.writable = cached->writable;
+        entry.user = cached->user;
+        entry.noExec = cached->noExec;
+        pathNX = cached->pathNX;
+    }
 
     Request::Flags flags = Request::PHYSICAL;
-    if (cr3.pcd)
+    if (uncacheable)
         flags.set(Request::UNCACHEABLE);
 
     RequestPtr request = std::make_shared<Request>(
@@ -708,6 +887,19 @@ Walker::WalkerState::isTiming()
     return timing;
 }
 
+bool
+Walker::WalkerState::samePage(ThreadContext *_tc, Addr vaddr) const
+{
+    return tc == _tc && (req->getVaddr() >> PageShift) == (vaddr >> PageShift);
+}
+
+void
+Walker::WalkerState::coalesce(BaseMMU::Translation *_translation,
+                              const RequestPtr &_req, BaseMMU::Mode _mode)
+{
+    coalesced.push_back({_translation, _req, _mode});
+}
+
 bool
 Walker::WalkerState::wasStarted()
 {
@@ -727,6 +919,34 @@ Walker::WalkerState::retry()
     sendPackets();
 }
 
+Walker::WalkerStats::WalkerStats(statistics::Group *parent)
+  : statistics::Group(parent),
+    ADD_STAT(walks, statistics::units::Count::get(),
+             "Page table walks started"),
+    ADD_STAT(walksCoalesced, statistics::units::Count::get(),
+             "TLB misses that joined a pending walk to the same page"),
+    ADD_STAT(nextLevelHits, statistics::units::Count::get(),
+             "TLB misses served by the next level TLB"),
+    ADD_STAT(squashedBefore, statistics::units::Count::get(),
+             "Page table walks squashed before starting"),
+    ADD_STAT(walkWaitTime, statistics::units::Tick::get(),
+             "Page table walk wait (enqueue to start) latency"),
+    ADD_STAT(walkServiceTime, statistics::units::Tick::get(),
+             "Page table walk service (start to completion) latency")
+{
+    walksCoalesced.flags(statistics::nozero);
+    nextLevelHits.flags(statistics::nozero);
+    squashedBefore.flags(statistics::nozero);
+
+    walkWaitTime
+        .init(16)
+        .flags(statistics::pdf | statistics::nozero | statistics::nonan);
+
+    walkServiceTime
+        .init(16)
+        .flags(statistics::pdf | statistics::nozero | statistics::nonan);
+}
+
 Fault
 Walker::WalkerState::pageFault(bool present)
 {
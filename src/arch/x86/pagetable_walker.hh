@@ -38,11 +38,14 @@
 #ifndef __ARCH_X86_PAGE_TABLE_WALKER_HH__
 #define __ARCH_X86_PAGE_TABLE_WALKER_HH__
 
+#include <list>
 #include <vector>
 
 #include "arch/generic/mmu.hh"
+#include "arch/x86/page_walk_cache.hh"
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/packet.hh"
 #include "params/X86PagetableWalker.hh"
@@ -115,6 +118,21 @@ namespace X86ISA
             bool retrying;
             bool started;
             bool squashed;
+            /** CR3 and NX state of the walk, for the page walk cache. */
+            Addr walkCr3;
+            bool pathNX;
+            Tick queuedTick;
+            Tick startTick;
+
+            /** Misses to the same page that wait for this walk. */
+            struct CoalescedReq
+            {
+                BaseMMU::Translation *translation;
+                RequestPtr req;
+                BaseMMU::Mode mode;
+            };
+            std::vector<CoalescedReq> coalesced;
+
           public:
             WalkerState(Walker * _walker, BaseMMU::Translation *_translation,
                         const RequestPtr &_req, bool _isFunctional = false) :
@@ -122,7 +140,8 @@ namespace X86ISA
                 nextState(Ready), inflight(0),
                 translation(_translation),
                 functional(_isFunctional), timing(false),
-                retrying(false), started(false), squashed(false)
+                retrying(false), started(false), squashed(false),
+                walkCr3(0), pathNX(false), queuedTick(curTick()), startTick(0)
             {
             }
             void initState(ThreadContext * _tc, BaseMMU::Mode _mode,
@@ -134,12 +153,16 @@ namespace X86ISA
             bool isRetrying();
             bool wasStarted();
             bool isTiming();
+            bool samePage(ThreadContext *_tc, Addr vaddr) const;
+            void coalesce(BaseMMU::Translation *_translation,
+                          const RequestPtr &_req, BaseMMU::Mode _mode);
             void retry();
             void squash();
             std::string name() const {return walker->name();}
 
           private:
             void setupWalk(Addr vaddr);
+            void cacheTable(PageWalkCache::Level level, PageTableEntry pte);
             Fault stepWalk(PacketPtr &write);
             void sendPackets();
             void endWalk();
@@ -169,6 +192,8 @@ namespace X86ISA
         Port &getPort(const std::string &if_name,
                       PortID idx=InvalidPortID) override;
 
+        DrainState drain() override;
+
       protected:
         // The TLB we're supposed to load.
         TLB * tlb;
@@ -178,9 +203,41 @@ namespace X86ISA
         // The number of outstanding walks that can be squashed per cycle.
         unsigned numSquashable;
 
+        // The number of walks that can be in progress at once.
+        unsigned numWalkers;
+
+        // Whether misses to a page that is being walked join that walk.
+        bool coalesceWalks;
+
+        // Non-leaf entry cache, possibly shared with other walkers.
+        PageWalkCache *pwc;
+
+        // Latency of refilling the TLB from the next level TLB.
+        Cycles nextLevelLatency;
+
         // Wrapper for checking for squashes before starting a translation.
         void startWalkWrapper();
 
+        // Number of walks in currStates that have been started.
+        unsigned numActiveWalks() const;
+
+        // Number of next level TLB hits waiting for their refill latency.
+        unsigned pendingNextLevelHits;
+
+        // Finish a translation that hit in the next level TLB.
+        void finishNextLevelHit(ThreadContext *tc,
+                BaseMMU::Translation *translation, const RequestPtr &req,
+                BaseMMU::Mode mode, const TlbEntry &entry);
+
+        // Finish a translation from the entry found for it.
+        void finishTranslation(ThreadContext *tc,
+                BaseMMU::Translation *translation, const RequestPtr &req,
+                BaseMMU::Mode mode, const TlbEntry &entry);
+
+        // Finish or queue again the misses that joined a finished walk.
+        void finishCoalesced(WalkerState *walk);
+        void requeueCoalesced(WalkerState *walk);
+
         /**
          * Event used to call startWalkWrapper.
          **/
@@ -191,8 +248,27 @@ namespace X86ISA
         void recvReqRetry();
         bool sendTiming(WalkerState * sendingState, PacketPtr pkt);
 
+        struct WalkerStats : public statistics::Group
+        {
+            WalkerStats(statistics::Group *parent);
+
+            statistics::Scalar walks;
+            statistics::Scalar walksCoalesced;
+            statistics::Scalar nextLevelHits;
+            statistics::Scalar squashedBefore;
+            statistics::Histogram walkWaitTime;
+            statistics::Histogram walkServiceTime;
+        } stats;
+
       public:
 
+        void
+        flushPageWalkCache()
+        {
+            if (pwc)
+                pwc->flushAll();
+        }
+
         void setTLB(TLB * _tlb)
         {
             tlb = _tlb;
@@ -205,8 +281,16 @@ namespace X86ISA
             funcState(this, NULL, NULL, true), tlb(NULL), sys(params.system),
             requestorId(sys->getRequestorId(this)),
             numSquashable(params.num_squash_per_cycle),
-            startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
+            numWalkers(params.num_walkers),
+            coalesceWalks(params.coalesce_walks),
+            pwc(params.page_walk_cache),
+            nextLevelLatency(params.next_level_tlb_latency),
+            pendingNextLevelHits(0),
+            startWalkWrapperEvent([this]{ startWalkWrapper(); }, name()),
+            stats(this)
         {
+            fatal_if(!numWalkers, "%s: num_walkers must be at least 1.\n",
+                     name());
         }
     };
 
@@ -74,8 +74,14 @@ TLB::TLB(const Params &p)
         freeList.push_back(&tlb[x]);
     }
 
+    // A next level TLB is only filled and looked up by the TLBs above it,
+    // so it has no walker of its own.
     walker = p.walker;
-    walker->setTLB(this);
+    if (walker)
+        walker->setTLB(this);
+
+    nextLevel = p.next_level;
+    fatal_if(nextLevel == this, "A TLB cannot be its own next level.\n");
 }
 
 void
@@ -117,6 +123,9 @@ TLB::insert(Addr vpn, const TlbEntry &entry)
     newEntry->vaddr = vpn;
     newEntry->trieHandle =
     trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
+
+    if (nextLevel)
+        nextLevel->insert(vpn, entry);
     return newEntry;
 }
 
@@ -129,6 +138,35 @@ TLB::lookup(Addr va, bool update_lru)
     return entry;
 }
 
+TlbEntry *
+TLB::lookupNextLevel(Addr va, BaseMMU::Mode mode)
+{
+    if (!nextLevel)
+        return NULL;
+
+    TlbEntry *entry = nextLevel->lookup(va);
+    // Entries filled by a data walk don't carry the NX checks of an
+    // instruction fetch walk, so leave those to the walker.
+    if (entry && mode == BaseMMU::Execute && entry->noExec)
+        entry = NULL;
+
+    if (mode == BaseMMU::Read) {
+        nextLevel->stats.rdAccesses++;
+        if (!entry)
+            nextLevel->stats.rdMisses++;
+    } else {
+        nextLevel->stats.wrAccesses++;
+        if (!entry)
+            nextLevel->stats.wrMisses++;
+    }
+    if (!entry)
+        return NULL;
+
+    DPRINTF(TLB, "Next level hit for %#x.\n", va);
+    stats.nextLevelHits++;
+    return insert(entry->vaddr, *entry);
+}
+
 void
 TLB::flushAll()
 {
@@ -140,6 +178,10 @@ TLB::flushAll()
             freeList.push_back(&tlb[i]);
         }
     }
+    if (nextLevel)
+        nextLevel->flushAll();
+    if (walker)
+        walker->flushPageWalkCache();
 }
 
 void
@@ -159,6 +201,10 @@ TLB::flushNonGlobal()
             freeList.push_back(&tlb[i]);
         }
     }
+    if (nextLevel)
+        nextLevel->flushNonGlobal();
+    if (walker)
+        walker->flushPageWalkCache();
 }
 
 void
@@ -170,6 +216,12 @@ TLB::demapPage(Addr va, uint64_t asn)
         entry->trieHandle = NULL;
         freeList.push_back(entry);
     }
+    // INVLPG may drop any paging-structure cache entry, so flushing the
+    // whole page walk cache is correct and keeps it simple.
+    if (nextLevel)
+        nextLevel->demapPage(va, asn);
+    if (walker)
+        walker->flushPageWalkCache();
 }
 
 namespace
@@ -309,7 +361,8 @@ TLB::finalizePhysical(const RequestPtr &req,
 Fault
 TLB::translate(const RequestPtr &req,
         ThreadContext *tc, BaseMMU::Translation *translation,
-        BaseMMU::Mode mode, bool &delayedResponse, bool timing)
+        BaseMMU::Mode mode, bool &delayedResponse, bool timing,
+        const TlbEntry *walked_entry)
 {
     Request::Flags flags = req->getFlags();
     int seg = flags & SegmentFlagMask;
@@ -373,12 +426,16 @@ TLB::translate(const RequestPtr &req,
         // If paging is enabled, do the translation.
         if (m5Reg.paging) {
             DPRINTF(TLB, "Paging enabled.\n");
-            // The vaddr already has the segment base applied.
-            TlbEntry *entry = lookup(vaddr);
-            if (mode == BaseMMU::Read) {
-                stats.rdAccesses++;
-            } else {
-                stats.wrAccesses++;
+            // The vaddr already has the segment base applied. The access
+            // of a translation finished by the walker was already counted.
+            const TlbEntry *entry = walked_entry;
+            if (!entry) {
+                entry = lookup(vaddr);
+                if (mode == BaseMMU::Read) {
+                    stats.rdAccesses++;
+                } else {
+                    stats.wrAccesses++;
+                }
             }
             if (!entry) {
                 DPRINTF(TLB, "Handling a TLB miss for "
@@ -398,6 +455,8 @@ TLB::translate(const RequestPtr &req,
                     }
                     entry = lookup(vaddr);
                     assert(entry);
+                } else if ((entry = lookupNextLevel(vaddr, mode))) {
+                    DPRINTF(TLB, "Miss was serviced by the next level.\n");
                 } else {
                     Process *p = tc->getProcessPtr();
                     const EmulationPageTable::Entry *pte =
@@ -533,8 +592,11 @@ TLB::TlbStats::TlbStats(statistics::Group *parent)
     ADD_STAT(rdMisses, statistics::units::Count::get(),
              "TLB misses on read requests"),
     ADD_STAT(wrMisses, statistics::units::Count::get(),
-             "TLB misses on write requests")
+             "TLB misses on write requests"),
+    ADD_STAT(nextLevelHits, statistics::units::Count::get(),
+             "TLB misses that hit in the next level TLB")
 {
+    nextLevelHits.flags(statistics::nozero);
 }
 
 void
@@ -577,7 +639,7 @@ TLB::unserialize(CheckpointIn &cp)
 Port *
 TLB::getTableWalkerPort()
 {
-    return &walker->getPort("port");
+    return walker ? &walker->getPort("port") : NULL;
 }
 
 } // namespace X86ISA
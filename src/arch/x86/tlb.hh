@@ -75,6 +75,14 @@ namespace X86ISA
 
         TlbEntry *lookup(Addr va, bool update_lru = true);
 
+        /**
+         * Look up a missing translation in the next level TLB, if any.
+         * A hit is copied into this TLB.
+         *
+         * @return The entry inserted in this TLB, or nullptr on a miss.
+         */
+        TlbEntry *lookupNextLevel(Addr va, BaseMMU::Mode mode);
+
         void setConfigAddress(uint32_t addr);
 
       protected:
@@ -83,6 +91,9 @@ namespace X86ISA
 
         Walker * walker;
 
+        /** Larger TLB, possibly shared, that backs this one. */
+        TLB * nextLevel;
+
       public:
         Walker *getWalker();
 
@@ -112,13 +123,19 @@ namespace X86ISA
             statistics::Scalar wrAccesses;
             statistics::Scalar rdMisses;
             statistics::Scalar wrMisses;
+            statistics::Scalar nextLevelHits;
         } stats;
 
         Fault translateInt(bool read, RequestPtr req, ThreadContext *tc);
 
+        /**
+         * Translate a request, looking it up in the TLB unless the walker
+         * passes the entry it found for it in walked_entry.
+         */
         Fault translate(const RequestPtr &req, ThreadContext *tc,
                 BaseMMU::Translation *translation, BaseMMU::Mode mode,
-                bool &delayedResponse, bool timing);
+                bool &delayedResponse, bool timing,
+                const TlbEntry *walked_entry = nullptr);
 
       public:
 
@@ -183,6 +183,8 @@ BitUnion8(Opcode)
 EndBitUnion(Opcode)
 
 BitUnion8(OperatingMode)
+    // Whether XACQUIRE/XRELEASE prefixes elide locks, set by the decoder
+    Bitfield<4> lockElision;
     Bitfield<3> mode;
     Bitfield<2,0> submode;
 EndBitUnion(OperatingMode)
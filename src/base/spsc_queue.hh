@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_SPSC_QUEUE_HH__
+#define __BASE_SPSC_QUEUE_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+/**
+ * A bounded, lock-free queue with a single producer thread and a single
+ * consumer thread. The capacity is rounded up to a power of two, so that
+ * the positions can be wrapped with a mask.
+ *
+ * Each side only ever writes its own position, and reads the position of
+ * the other side to know how many items it can access, so that pushes and
+ * pops never wait for each other. Both positions live in different cache
+ * lines to avoid false sharing.
+ */
+template <class T>
+class SPSCQueue
+{
+  private:
+    /** Storage for the items. */
+    std::vector<T> items;
+
+    /** Mask to turn a position into an index of the storage. */
+    const std::size_t mask;
+
+    /** Position of the next item to be popped. Written by the consumer. */
+    alignas(64) std::atomic<std::size_t> head;
+
+    /** Position of the next item to be pushed. Written by the producer. */
+    alignas(64) std::atomic<std::size_t> tail;
+
+  public:
+    /**
+     * @param capacity Minimum number of items that can be queued at once.
+     */
+    explicit SPSCQueue(std::size_t capacity)
+      : items(capacity > 1 ? (std::size_t(1) << ceilLog2(capacity)) : 1),
+        mask(items.size() - 1), head(0), tail(0)
+    {
+        fatal_if(capacity == 0, "A queue needs space for an item.");
+    }
+
+    /** @return The number of items that can be queued at once. */
+    std::size_t capacity() const { return items.size(); }
+
+    /**
+     * Get an estimation of the number of queued items. It is exact when
+     * called from either side while the other side is not active.
+     *
+     * @return The number of queued items.
+     */
+    std::size_t
+    size() const
+    {
+        return tail.load(std::memory_order_acquire) -
+            head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * Queue an item. Must only be called by the producer.
+     *
+     * @param item The item.
+     * @return Whether there was space for the item.
+     */
+    bool
+    push(const T &item)
+    {
+        const std::size_t pos = tail.load(std::memory_order_relaxed);
+        if (pos - head.load(std::memory_order_acquire) == items.size()) {
+            return false;
+        }
+        items[pos & mask] = item;
+        tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeue a batch of items, in order. Must only be called by the
+     * consumer.
+     *
+     * @param out Where to copy the items to.
+     * @param max_items The maximum number of items to dequeue.
+     * @return The number of items dequeued.
+     */
+    std::size_t
+    pop(T *out, std::size_t max_items)
+    {
+        const std::size_t pos = head.load(std::memory_order_relaxed);
+        const std::size_t available =
+            tail.load(std::memory_order_acquire) - pos;
+        const std::size_t num_items = std::min(available, max_items);
+        for (std::size_t i = 0; i < num_items; i++) {
+            out[i] = items[(pos + i) & mask];
+        }
+        head.store(pos + num_items, std::memory_order_release);
+        return num_items;
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_SPSC_QUEUE_HH__
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "base/spsc_queue.hh"
+
+using namespace gem5;
+
+TEST(SPSCQueueTest, CapacityIsRoundedUp)
+{
+    EXPECT_EQ(SPSCQueue<int>(1).capacity(), 1);
+    EXPECT_EQ(SPSCQueue<int>(5).capacity(), 8);
+    EXPECT_EQ(SPSCQueue<int>(8).capacity(), 8);
+}
+
+TEST(SPSCQueueTest, PushUntilFull)
+{
+    SPSCQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_EQ(queue.size(), 4);
+}
+
+TEST(SPSCQueueTest, PopInOrderAcrossWrapAround)
+{
+    SPSCQueue<int> queue(4);
+    int out[4];
+    int next_push = 0;
+    int next_pop = 0;
+    for (int round = 0; round < 10; round++) {
+        while (queue.push(next_push)) {
+            next_push++;
+        }
+        const std::size_t num_items = queue.pop(out, 3);
+        EXPECT_EQ(num_items, 3);
+        for (std::size_t i = 0; i < num_items; i++) {
+            EXPECT_EQ(out[i], next_pop++);
+        }
+    }
+    EXPECT_EQ(queue.size(), next_push - next_pop);
+}
+
+TEST(SPSCQueueTest, PopFromEmpty)
+{
+    SPSCQueue<int> queue(4);
+    int out[4];
+    EXPECT_EQ(queue.pop(out, 4), 0);
+}
+
+TEST(SPSCQueueTest, ConcurrentProducerAndConsumer)
+{
+    constexpr uint64_t num_items = 100000;
+    SPSCQueue<uint64_t> queue(64);
+
+    std::thread producer([&queue]() {
+        for (uint64_t i = 0; i < num_items; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    std::vector<uint64_t> out(16);
+    while (expected < num_items) {
+        const std::size_t num_popped = queue.pop(out.data(), out.size());
+        if (num_popped == 0) {
+            std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < num_popped; i++) {
+            ASSERT_EQ(out[i], expected++);
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
@@ -236,7 +236,7 @@ Checker<DynInstPtr>::verify(const DynInstPtr &completed_inst)
             // If not in the middle of a macro instruction
             if (!curMacroStaticInst) {
                 // set up memory request for instruction fetch
-                auto mem_req = std::make_shared<Request>(
+                auto mem_req = Request::create(
                     fetch_PC, decoder.moreBytesSize(), 0, requestorId,
                     fetch_PC, thread->contextId());
 
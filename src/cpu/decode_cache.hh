@@ -29,10 +29,14 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
+#include <cstdint>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "base/compiler.hh"
+#include "base/types.hh"
 #include "cpu/static_inst_fwd.hh"
 
 namespace gem5
@@ -42,9 +46,102 @@ GEM5_DEPRECATED_NAMESPACE(DecodeCache, decode_cache);
 namespace decode_cache
 {
 
-/// Hash for decoded instructions.
+/// Number of decodes served by each level of the decode caches.
+struct Counts
+{
+    /// Instructions found by address, without looking at their bytes.
+    uint64_t addrHits = 0;
+    /// Instructions found in the map of decoded machine instructions.
+    uint64_t instHits = 0;
+    /// Instructions that had to be decoded.
+    uint64_t misses = 0;
+};
+
+/// Hash for decoded instructions. It is an open-addressed table with
+/// linear probing, so a lookup usually touches a single cache line.
+/// Entries are never removed, so no tombstones are needed.
 template <typename EMI>
-using InstMap = std::unordered_map<EMI, StaticInstPtr>;
+class InstMap
+{
+  private:
+    struct Entry
+    {
+        EMI machInst;
+        StaticInstPtr inst;
+        bool valid = false;
+    };
+
+    static constexpr size_t InitialSize = 1024;
+
+    std::vector<Entry> table;
+    size_t numEntries = 0;
+
+    /// Spread the bits of the key hash, since std::hash of integral
+    /// encodings is usually the identity.
+    size_t
+    slotOf(const EMI &mach_inst) const
+    {
+        uint64_t h = std::hash<EMI>()(mach_inst);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h & (table.size() - 1);
+    }
+
+    /// Find the entry of a machine instruction, or the empty entry where
+    /// it would be inserted.
+    Entry &
+    probe(const EMI &mach_inst)
+    {
+        size_t slot = slotOf(mach_inst);
+        while (table[slot].valid && !(table[slot].machInst == mach_inst))
+            slot = (slot + 1) & (table.size() - 1);
+        return table[slot];
+    }
+
+    void
+    grow()
+    {
+        std::vector<Entry> old(table.size() * 2);
+        old.swap(table);
+        for (auto &entry : old) {
+            if (entry.valid)
+                probe(entry.machInst) = std::move(entry);
+        }
+    }
+
+  public:
+    InstMap() : table(InitialSize) {}
+
+    /// Look up a machine instruction.
+    /// @return The decoded instruction, or nullptr if it isn't cached.
+    StaticInstPtr *
+    find(const EMI &mach_inst)
+    {
+        Entry &entry = probe(mach_inst);
+        return entry.valid ? &entry.inst : nullptr;
+    }
+
+    /// Look up a machine instruction, adding an empty entry for it if it
+    /// isn't cached yet.
+    StaticInstPtr &
+    operator[](const EMI &mach_inst)
+    {
+        // Keep the load factor at or below one half.
+        if (2 * (numEntries + 1) > table.size())
+            grow();
+
+        Entry &entry = probe(mach_inst);
+        if (!entry.valid) {
+            entry.machInst = mach_inst;
+            entry.valid = true;
+            numEntries++;
+        }
+        return entry.inst;
+    }
+
+    size_t size() const { return numEntries; }
+};
 
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value, Addr CacheChunkShift = 12>
@@ -72,18 +169,22 @@ class AddrMap
     };
     // A map of cache chunks which allows a sparse mapping.
     typedef typename std::unordered_map<Addr, CacheChunk *> ChunkMap;
-    typedef typename ChunkMap::iterator ChunkIt;
-    // Mini cache of recent lookups.
-    ChunkIt recent[2];
     ChunkMap chunkMap;
 
-    /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
-    void
-    update(ChunkIt recentest)
+    // Direct-mapped cache of recently used chunks, checked before the
+    // chunk map.
+    static constexpr unsigned NumRecent = 16;
+    struct RecentEntry
     {
-        recent[1] = recent[0];
-        recent[0] = recentest;
+        Addr chunkAddr = MaxAddr;
+        CacheChunk *chunk = nullptr;
+    };
+    RecentEntry recent[NumRecent];
+
+    static constexpr unsigned
+    recentIndex(Addr chunk_addr)
+    {
+        return (chunk_addr >> CacheChunkShift) % NumRecent;
     }
 
     /// Attempt to find the CacheChunk which goes with a particular
@@ -96,36 +197,30 @@ class AddrMap
         Addr chunk_addr = chunkStart(addr);
 
         // Check against recent lookups.
-        if (recent[0] != chunkMap.end()) {
-            if (recent[0]->first == chunk_addr)
-                return recent[0]->second;
-            if (recent[1] != chunkMap.end() &&
-                    recent[1]->first == chunk_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
-        }
-
-        // Actually look in the hash_map.
-        ChunkIt it = chunkMap.find(chunk_addr);
-        if (it != chunkMap.end()) {
-            update(it);
-            return it->second;
-        }
-
-        // Didn't find an existing chunk, so add a new one.
-        CacheChunk *newChunk = new CacheChunk;
-        typename ChunkMap::value_type to_insert(chunk_addr, newChunk);
-        update(chunkMap.insert(to_insert).first);
-        return newChunk;
+        RecentEntry &entry = recent[recentIndex(chunk_addr)];
+        if (entry.chunkAddr == chunk_addr)
+            return entry.chunk;
+
+        // Actually look in the hash_map, adding a new chunk if there
+        // isn't one already.
+        CacheChunk *&chunk = chunkMap[chunk_addr];
+        if (!chunk)
+            chunk = new CacheChunk;
+
+        entry.chunkAddr = chunk_addr;
+        entry.chunk = chunk;
+        return chunk;
     }
 
   public:
-    /// Constructor
-    AddrMap()
+    AddrMap() = default;
+    AddrMap(const AddrMap &) = delete;
+    AddrMap &operator=(const AddrMap &) = delete;
+
+    ~AddrMap()
     {
-        recent[0] = recent[1] = chunkMap.end();
+        for (auto &chunk : chunkMap)
+            delete chunk.second;
     }
 
     Value &
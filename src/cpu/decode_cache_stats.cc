@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/decode_cache_stats.hh"
+
+#include "arch/generic/decoder.hh"
+
+namespace gem5
+{
+
+DecodeCacheStats::DecodeCacheStats(statistics::Group *parent,
+                                   const char *name, InstDecoder &decoder)
+    : statistics::Group(parent, name),
+      decoder(decoder),
+      ADD_STAT(addrHits, statistics::units::Count::get(),
+               "Number of instructions found in the decode cache by address"),
+      ADD_STAT(instHits, statistics::units::Count::get(),
+               "Number of instructions found in the decode cache by "
+               "machine instruction"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Number of instructions that had to be decoded"),
+      ADD_STAT(hitRate, statistics::units::Ratio::get(),
+               "Fraction of instructions found in the decode cache")
+{
+    decode_cache::Counts &counts = decoder.decodeCounts();
+    addrHits.scalar(counts.addrHits);
+    instHits.scalar(counts.instHits);
+    misses.scalar(counts.misses);
+
+    hitRate.precision(6);
+    hitRate = (addrHits + instHits) / (addrHits + instHits + misses);
+}
+
+void
+DecodeCacheStats::resetStats()
+{
+    statistics::Group::resetStats();
+    decoder.decodeCounts() = decode_cache::Counts();
+}
+
+} // namespace gem5
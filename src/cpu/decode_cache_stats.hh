@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_DECODE_CACHE_STATS_HH__
+#define __CPU_DECODE_CACHE_STATS_HH__
+
+#include "base/statistics.hh"
+
+namespace gem5
+{
+
+class InstDecoder;
+
+/**
+ * Exposes the decode cache counters of a decoder as statistics. The
+ * counters live in the decoder, so that the decode caches do not depend
+ * on the statistics framework, and are cleared when stats are reset.
+ */
+struct DecodeCacheStats : public statistics::Group
+{
+    DecodeCacheStats(statistics::Group *parent, const char *name,
+                     InstDecoder &decoder);
+
+    void resetStats() override;
+
+    InstDecoder &decoder;
+
+    /** Instructions found by address. */
+    statistics::Value addrHits;
+    /** Instructions found in the map of decoded machine instructions. */
+    statistics::Value instHits;
+    /** Instructions that had to be decoded. */
+    statistics::Value misses;
+    /** Fraction of instructions that did not have to be decoded. */
+    statistics::Formula hitRate;
+};
+
+} // namespace gem5
+
+#endif // __CPU_DECODE_CACHE_STATS_HH__
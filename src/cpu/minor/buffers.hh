@@ -505,6 +505,10 @@ class Queue : public Named, public Reservable
     /** Pop the head item.  Like std::queue::pop */
     void pop() { queue.pop_front(); }
 
+    /** Element index places from the head, for searches which leave
+     *  the queue as it is */
+    ElemType &operator [](unsigned int index) { return queue[index]; }
+
     /** Is the queue empty? */
     bool empty() const { return queue.empty(); }
 
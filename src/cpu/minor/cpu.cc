@@ -41,6 +41,7 @@
 #include "cpu/minor/fetch1.hh"
 #include "cpu/minor/pipeline.hh"
 #include "debug/Drain.hh"
+#include "debug/HtmCpu.hh"
 #include "debug/MinorCPU.hh"
 #include "debug/Quiesce.hh"
 
@@ -69,6 +70,9 @@ MinorCPU::MinorCPU(const MinorCPUParams &params) :
         threads.push_back(thread);
         ThreadContext *tc = thread->getTC();
         threadContexts.push_back(tc);
+
+        decodeCacheStats.emplace_back(new DecodeCacheStats(this,
+            csprintf("decode_cache.thread_%i", i).c_str(), thread->decoder));
     }
 
 
@@ -342,4 +346,58 @@ MinorCPU::totalOps() const
     return ret;
 }
 
+void
+MinorCPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
+    HtmFailureFaultCause cause)
+{
+    const Addr addr = 0x0ul;
+    const int size = 8;
+    const Request::Flags flags =
+        Request::PHYSICAL | Request::STRICT_ORDER | Request::HTM_ABORT;
+
+    DPRINTF(HtmCpu, "htmabort htmUid=%u\n", htm_uid);
+
+    /* Notify the L1 data cache (Ruby) that the core has aborted the
+     *  transaction.  The signal bypasses the LSQ queues as the
+     *  instructions of the transaction are being discarded */
+    RequestPtr req = Request::create(
+        addr, size, flags, dataRequestorId());
+
+    req->taskId(taskId());
+    req->setContext(threads[tid]->contextId());
+    req->setHtmAbortCause(cause);
+    assert(req->isHTMAbort());
+
+    PacketPtr abort_pkt = Packet::createRead(req);
+    abort_pkt->dataDynamic(new uint8_t[size]);
+    abort_pkt->setHtmTransactional(htm_uid);
+
+    if (!pipeline->getDataPort().sendTimingReq(abort_pkt))
+        panic("HTM abort signal was not sent to the memory subsystem.");
+}
+
+void
+MinorCPU::htmSendSignal(ThreadID tid, uint64_t htm_uid, Addr addr,
+    const Request::Flags flags)
+{
+    if (system->getHTM() == nullptr)
+        return;
+
+    const int size = 8;
+
+    RequestPtr req = Request::create(
+        addr, size, flags, dataRequestorId());
+
+    req->taskId(taskId());
+    req->setContext(threads[tid]->contextId());
+    assert(req->isHTMCmd());
+
+    PacketPtr pkt = Packet::createRead(req);
+    pkt->dataDynamic(new uint8_t[size]);
+    pkt->setHtmTransactional(htm_uid);
+
+    if (!pipeline->getDataPort().sendTimingReq(pkt))
+        panic("HTM signal was not sent to the memory subsystem.");
+}
+
 } // namespace gem5
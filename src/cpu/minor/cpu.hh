@@ -44,9 +44,13 @@
 #ifndef __CPU_MINOR_CPU_HH__
 #define __CPU_MINOR_CPU_HH__
 
+#include <memory>
+#include <vector>
+
 #include "base/compiler.hh"
 #include "base/random.hh"
 #include "cpu/base.hh"
+#include "cpu/decode_cache_stats.hh"
 #include "cpu/minor/activity.hh"
 #include "cpu/minor/stats.hh"
 #include "cpu/simple_thread.hh"
@@ -139,6 +143,9 @@ class MinorCPU : public BaseCPU
     /** Processor-specific statistics */
     minor::MinorStats stats;
 
+    /** Decode cache statistics, one group per thread */
+    std::vector<std::unique_ptr<DecodeCacheStats>> decodeCacheStats;
+
     /** Stats interface from SimObject (by way of BaseCPU) */
     void regStats() override;
 
@@ -146,6 +153,17 @@ class MinorCPU : public BaseCPU
     Counter totalInsts() const override;
     Counter totalOps() const override;
 
+    /** Hardware transactional memory: notify the L1 data cache that the
+     *  transaction of thread tid has aborted */
+    void htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
+                            HtmFailureFaultCause cause) override;
+
+    /** Hardware transactional memory: send an HTM command with no LSQ
+     *  state attached (e.g. HTM_ISOLATE for a retired transactional load)
+     *  to the L1 data cache */
+    void htmSendSignal(ThreadID tid, uint64_t htm_uid, Addr addr,
+                       const Request::Flags flags);
+
     void serializeThread(CheckpointOut &cp, ThreadID tid) const override;
     void unserializeThread(CheckpointIn &cp, ThreadID tid) override;
 
@@ -119,8 +119,10 @@ class ExecContext : public gem5::ExecContext
     Fault
     initiateHtmCmd(Request::Flags flags) override
     {
-        panic("ExecContext::initiateHtmCmd() not implemented on MinorCPU\n");
-        return NoFault;
+        /* HTM commands are loads to a dummy address which never leave
+         *  the LSQ before their instruction reaches the head of Execute */
+        return execute.getLSQ().pushRequest(inst, true /* load */, nullptr,
+            8, 0x0ul, flags, nullptr, nullptr, std::vector<bool>(8, true));
     }
 
     Fault
@@ -271,33 +273,26 @@ class ExecContext : public gem5::ExecContext
     uint64_t
     getHtmTransactionUid() const override
     {
-        panic("ExecContext::getHtmTransactionUid() not"
-              "implemented on MinorCPU\n");
-        return 0;
+        return thread.getHtmCheckpointPtr()->getHtmUid();
     }
 
     uint64_t
     newHtmTransactionUid() const override
     {
-        panic("ExecContext::newHtmTransactionUid() not"
-              "implemented on MinorCPU\n");
-        return 0;
+        return thread.getHtmCheckpointPtr()->newHtmUid();
     }
 
     bool
     inHtmTransactionalState() const override
     {
-        // ExecContext::inHtmTransactionalState() not
-        // implemented on MinorCPU
-        return false;
+        return (getHtmTransactionalDepth() > 0);
     }
 
     uint64_t
     getHtmTransactionalDepth() const override
     {
-        panic("ExecContext::getHtmTransactionalDepth() not"
-              "implemented on MinorCPU\n");
-        return 0;
+        assert(thread.htmTransactionStarts >= thread.htmTransactionStops);
+        return (thread.htmTransactionStarts - thread.htmTransactionStops);
     }
 
     TheISA::PCState
@@ -40,6 +40,7 @@
 #include <functional>
 
 #include "arch/locked_mem.hh"
+#include "cpu/checker/htm_checker.hh"
 #include "cpu/minor/cpu.hh"
 #include "cpu/minor/exec_context.hh"
 #include "cpu/minor/fetch1.hh"
@@ -49,11 +50,13 @@
 #include "debug/Branch.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
+#include "debug/HtmCpu.hh"
 #include "debug/MinorExecute.hh"
 #include "debug/MinorInterrupt.hh"
 #include "debug/MinorMem.hh"
 #include "debug/MinorTrace.hh"
 #include "debug/PCEvent.hh"
+#include "sim/faults.hh"
 
 namespace gem5
 {
@@ -356,7 +359,7 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
             /* Don't assign to fault */
         } else {
             /* Take the fault raised during the TLB/memory access */
-            fault = inst->translationFault;
+            fault = htmTransactionFault(inst, inst->translationFault);
 
             fault->invoke(thread, inst->staticInst);
         }
@@ -371,6 +374,29 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
             *inst);
 
         fatal("Received error response packet for inst: %s\n", *inst);
+    } else if (packet->isHtmFailedCacheAccess() && packet->isRead() &&
+        !packet->htmTransactionFailedInCache())
+    {
+        /* A transactional protocol nack.  The access must be retried so,
+         *  as O3 does, re-execute the instruction.  Nacked stores are
+         *  retried by the cache controller itself */
+        DPRINTF(HtmCpu, "Nacked memory access, re-executing inst: %s\n",
+            *inst);
+
+        if (inst->staticInst->isHtmStart())
+            cpu.threads[thread_id]->htmTransactionStarts--;
+
+        fault = std::make_shared<ReExec>();
+        fault->invoke(thread, inst->staticInst);
+
+        if (inst->traceData) {
+            delete inst->traceData;
+            inst->traceData = NULL;
+        }
+
+        lsq.popResponse(response);
+        tryToBranch(inst, fault, branch);
+        return;
     } else if (is_store || is_load || is_prefetch || is_atomic) {
         assert(packet);
 
@@ -382,14 +408,96 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
                 static_cast<unsigned int>(packet->getConstPtr<uint8_t>()[0]));
         }
 
-        /* Complete the memory access instruction */
-        fault = inst->staticInst->completeAcc(packet, &context,
-            inst->traceData);
+        if (packet->htmTransactionFailedInCache() && !packet->isWrite()) {
+            /* The transaction failed in the memory system.  Stores can't
+             *  fail here as they have already left the instruction */
+            const HtmCacheFailure htm_rc =
+                packet->getHtmTransactionFailedInCacheRC();
+            DPRINTF(HtmCpu, "HTM abortion in cache (rc=%s) detected"
+                " htmUid=%u\n", htmFailureToStr(htm_rc),
+                packet->getHtmTransactionUid());
+
+            if (htm_rc == HtmCacheFailure::FAIL_SELF) {
+                fault = std::make_shared<GenericHtmFailureFault>(
+                    context.getHtmTransactionUid(),
+                    HtmFailureFaultCause::SIZE);
+            } else if (htm_rc == HtmCacheFailure::FAIL_REMOTE) {
+                fault = std::make_shared<GenericHtmFailureFault>(
+                    context.getHtmTransactionUid(),
+                    HtmFailureFaultCause::MEMORY);
+            } else if (htm_rc == HtmCacheFailure::FAIL_OTHER) {
+                fault = std::make_shared<GenericHtmFailureFault>(
+                    context.getHtmTransactionUid(),
+                    HtmFailureFaultCause::OTHER);
+            } else {
+                panic("HTM - unhandled rc %s", htmFailureToStr(htm_rc));
+            }
+        } else if (response->htmStaleData) {
+            /* A conflicting snoop hit the block of this load before it
+             *  was isolated: reload it or abort (see O3 LSQUnit) */
+            if (cpu.system->getHTM()->params().reload_if_stale) {
+                DPRINTF(HtmCpu, "Stale transactional load, re-executing"
+                    " inst: %s\n", *inst);
+                /* As for a nack, the load has not completed and must
+                 *  not be accounted as committed */
+                fault = std::make_shared<ReExec>();
+                fault->invoke(thread, inst->staticInst);
+
+                if (inst->traceData) {
+                    delete inst->traceData;
+                    inst->traceData = NULL;
+                }
+
+                lsq.popResponse(response);
+                tryToBranch(inst, fault, branch);
+                return;
+            } else {
+                DPRINTF(HtmCpu, "Stale transactional load, aborting"
+                    " inst: %s\n", *inst);
+                fault = std::make_shared<GenericHtmFailureFault>(
+                    context.getHtmTransactionUid(),
+                    HtmFailureFaultCause::LSQ);
+            }
+        } else {
+            /* Complete the memory access instruction */
+            fault = inst->staticInst->completeAcc(packet, &context,
+                inst->traceData);
+
+            /* Isolate transactional loads as they retire for precise
+             *  tracking of the read set (see O3 Commit::commitInsts) */
+            if (fault == NoFault && is_load && !is_prefetch &&
+                response->isHtmTransactional && !response->storeForwarded &&
+                !packet->req->isHTMCmd())
+            {
+                std::vector<Addr> block_addrs;
+                response->getBlockAddrs(cpu.cacheBlockMask(), block_addrs);
+
+                for (Addr block_addr : block_addrs) {
+                    DPRINTF(HtmCpu, "Sending HTM_ISOLATE signal for block"
+                        " addr %#x\n", block_addr);
+                    cpu.htmSendSignal(thread_id, response->htmUid,
+                        block_addr, Request::HTM_ISOLATE);
+                }
+            }
+        }
+
+        /* Track the HTM stops which commit transactions */
+        if (inst->staticInst->isHtmStop()) {
+            MinorThread *minor_thread = cpu.threads[thread_id];
+
+            minor_thread->htmTransactionStops++;
+            DPRINTF(HtmCpu, "htmTransactionStops++=%u\n",
+                minor_thread->htmTransactionStops);
+
+            if (fault == NoFault && htmTransactionalDepth(thread_id) == 0)
+                cpu.htmChecker->commit(0);
+        }
 
         if (fault != NoFault) {
             /* Invoke fault created by instruction completion */
             DPRINTF(MinorMem, "Fault in memory completeAcc: %s\n",
                 fault->name());
+            fault = htmTransactionFault(inst, fault);
             fault->invoke(thread, inst->staticInst);
         } else {
             /* Stores need to be pushed into the store buffer to finish
@@ -418,7 +526,54 @@ Execute::handleMemResponse(MinorDynInstPtr inst,
 bool
 Execute::isInterrupted(ThreadID thread_id) const
 {
-    return cpu.checkInterrupts(thread_id);
+    return cpu.checkInterrupts(thread_id) && !htmDefersInterrupt(thread_id);
+}
+
+uint64_t
+Execute::htmTransactionalDepth(ThreadID thread_id) const
+{
+    const MinorThread *thread = cpu.threads[thread_id];
+
+    assert(thread->htmTransactionStarts >= thread->htmTransactionStops);
+    return thread->htmTransactionStarts - thread->htmTransactionStops;
+}
+
+bool
+Execute::htmDefersInterrupt(ThreadID thread_id) const
+{
+    if (htmTransactionalDepth(thread_id) == 0)
+        return false;
+
+    HTM *htm = cpu.system->getHTM();
+
+    /* Postpone interrupts while executing transactions unless the HTM
+     *  model asks for them to abort the transaction (as TimingSimple) */
+    if (!htm || htm->params().delay_interrupts)
+        return true;
+
+    /* A lazy commit is outstanding, the interrupt must wait */
+    return !htm->params().eager_cd && lsq.isAtHtmStop(thread_id,
+        cpu.threads[thread_id]->getHtmCheckpointPtr()->getHtmUid());
+}
+
+Fault
+Execute::htmTransactionFault(MinorDynInstPtr inst, const Fault &fault)
+{
+    ThreadID thread_id = inst->id.threadId;
+
+    if (fault == NoFault || htmTransactionalDepth(thread_id) == 0 ||
+        std::dynamic_pointer_cast<GenericHtmFailureFault>(fault) ||
+        std::dynamic_pointer_cast<ReExec>(fault))
+    {
+        return fault;
+    }
+
+    DPRINTF(HtmCpu, "Fault (%s) within transaction, converting to"
+        " GenericHtmFailureFault inst: %s\n", fault->name(), *inst);
+
+    return std::make_shared<GenericHtmFailureFault>(
+        cpu.threads[thread_id]->getHtmCheckpointPtr()->getHtmUid(),
+        HtmFailureFaultCause::EXCEPTION);
 }
 
 bool
@@ -429,6 +584,19 @@ Execute::takeInterrupt(ThreadID thread_id, BranchData &branch)
 
     Fault interrupt = cpu.getInterruptController(thread_id)->getInterrupt();
 
+    if (interrupt != NoFault && htmTransactionalDepth(thread_id) > 0) {
+        /* Abort the transaction so that the interrupt is taken from the
+         *  state it checkpointed */
+        uint64_t htm_uid =
+            cpu.threads[thread_id]->getHtmCheckpointPtr()->getHtmUid();
+
+        DPRINTF(HtmCpu, "Interrupt within transaction htmUid=%u,"
+            " aborting\n", htm_uid);
+
+        GenericHtmFailureFault(htm_uid, HtmFailureFaultCause::INTERRUPT).
+            invoke(cpu.getContext(thread_id));
+    }
+
     if (interrupt != NoFault) {
         /* The interrupt *must* set pcState */
         cpu.getInterruptController(thread_id)->updateIntrInfo();
@@ -471,6 +639,19 @@ Execute::executeMemRefInst(MinorDynInstPtr inst, BranchData &branch,
 
         DPRINTF(MinorExecute, "Initiating memRef inst: %s\n", *inst);
 
+        /* HTM starts are only issued from the head of inFlightInsts (they
+         *  never issue early) and so can safely open the transaction
+         *  before their access is made */
+        if (inst->staticInst->isHtmStart()) {
+            MinorThread *minor_thread = cpu.threads[inst->id.threadId];
+
+            if (!context.inHtmTransactionalState())
+                context.newHtmTransactionUid();
+            minor_thread->htmTransactionStarts++;
+            DPRINTF(HtmCpu, "htmTransactionStarts++=%u\n",
+                minor_thread->htmTransactionStarts);
+        }
+
         Fault init_fault = inst->staticInst->initiateAcc(&context,
             inst->traceData);
 
@@ -745,6 +926,17 @@ Execute::issue(ThreadID thread_id)
 
                                 inst->canEarlyIssue = true;
                             }
+
+                            /* Keep HTM commands and the memory refs
+                             *  which follow them in order */
+                            if (inst->staticInst->isHtmCmd()) {
+                                inst->canEarlyIssue = false;
+                                thread.lastHtmCmd = inst->id.execSeqNum;
+                            } else if (thread.lastHtmCmd >
+                                inst->instToWaitFor)
+                            {
+                                inst->instToWaitFor = thread.lastHtmCmd;
+                            }
                             /* Also queue this instruction in the memory ref
                              *  queue to ensure in-order issue to the LSQ */
                             DPRINTF(MinorExecute, "Pushing mem inst: %s\n",
@@ -919,8 +1111,8 @@ Execute::commitInst(MinorDynInstPtr inst, bool early_memory_issue,
         DPRINTF(MinorExecute, "Fault inst reached Execute: %s\n",
             inst->fault->name());
 
-        fault = inst->fault;
-        inst->fault->invoke(thread, NULL);
+        fault = htmTransactionFault(inst, inst->fault);
+        fault->invoke(thread, NULL);
 
         tryToBranch(inst, fault, branch);
     } else if (inst->staticInst->isMemRef()) {
@@ -953,6 +1145,7 @@ Execute::commitInst(MinorDynInstPtr inst, bool early_memory_issue,
             } else {
                 DPRINTF(MinorExecute, "Fault in execute: %s\n",
                     fault->name());
+                fault = htmTransactionFault(inst, fault);
                 fault->invoke(thread, NULL);
 
                 tryToBranch(inst, fault, branch);
@@ -980,8 +1173,27 @@ Execute::commitInst(MinorDynInstPtr inst, bool early_memory_issue,
 
         DPRINTF(MinorExecute, "Committing inst: %s\n", *inst);
 
-        fault = inst->staticInst->execute(&context,
-            inst->traceData);
+        if (inst->staticInst->isSyscall() &&
+            context.inHtmTransactionalState())
+        {
+            warn("Syscall within transaction at PC %s"
+                " (generating GenericHtmFailureFault)\n", inst->pc);
+            fault = std::make_shared<GenericHtmFailureFault>(
+                context.getHtmTransactionUid(),
+                HtmFailureFaultCause::EXCEPTION);
+        } else {
+            fault = inst->staticInst->execute(&context,
+                inst->traceData);
+        }
+
+        /* The transaction's stores may now drain from the store buffer
+         *  as if at the head of the LSQ */
+        if (fault == NoFault && inst->staticInst->isHtmStopFence() &&
+            context.inHtmTransactionalState())
+        {
+            lsq.setAtHtmStopHtmUid(thread_id,
+                context.getHtmTransactionUid());
+        }
 
         /* Set the predicate for tracing and dump */
         if (inst->traceData)
@@ -1001,6 +1213,7 @@ Execute::commitInst(MinorDynInstPtr inst, bool early_memory_issue,
 
             DPRINTF(MinorExecute, "Fault in execute of inst: %s fault: %s\n",
                 *inst, fault->name());
+            fault = htmTransactionFault(inst, fault);
             fault->invoke(thread, inst->staticInst);
         }
 
@@ -1636,14 +1849,13 @@ Execute::checkInterrupts(BranchData& branch, bool& interrupted)
         DPRINTF(MinorInterrupt, "[tid:%d] thread_interrupted?=%d isInbetweenInsts?=%d\n",
                 tid, thread_interrupted, isInbetweenInsts(tid));
         /* Act on interrupts */
-        if (thread_interrupted && isInbetweenInsts(tid)) {
-            if (takeInterrupt(tid, branch)) {
-                interruptPriority = tid;
-                return tid;
-            }
-        } else {
-            tid = (tid + 1) % cpu.numThreads;
+        if (thread_interrupted && isInbetweenInsts(tid) &&
+            takeInterrupt(tid, branch))
+        {
+            interruptPriority = tid;
+            return tid;
         }
+        tid = (tid + 1) % cpu.numThreads;
     } while (tid != interruptPriority);
 
     return InvalidThreadID;
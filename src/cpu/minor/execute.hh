@@ -162,7 +162,8 @@ class Execute : public Named
             instsBeingCommitted(insts_committed),
             streamSeqNum(InstId::firstStreamSeqNum),
             lastPredictionSeqNum(InstId::firstPredictionSeqNum),
-            drainState(NotDraining)
+            drainState(NotDraining),
+            lastHtmCmd(0)
         { }
 
         ExecuteThreadInfo(const ExecuteThreadInfo& other) :
@@ -171,7 +172,8 @@ class Execute : public Named
             instsBeingCommitted(other.instsBeingCommitted),
             streamSeqNum(other.streamSeqNum),
             lastPredictionSeqNum(other.lastPredictionSeqNum),
-            drainState(other.drainState)
+            drainState(other.drainState),
+            lastHtmCmd(other.lastHtmCmd)
         { }
 
         /** In-order instructions either in FUs or the LSQ */
@@ -206,6 +208,12 @@ class Execute : public Named
 
         /** State progression for draining NotDraining -> ... -> DrainAllInsts */
         DrainState drainState;
+
+        /** execSeqNum of the last issued HTM start/stop/cancel.  Those are
+         *  never issued early and no younger memory reference may be
+         *  issued to the LSQ before them, as the transactional state of
+         *  the younger access depends on them */
+        InstSeqNum lastHtmCmd;
     };
 
     std::vector<ExecuteThreadInfo> executeInfo;
@@ -261,6 +269,18 @@ class Execute : public Named
     /** Has an interrupt been raised */
     bool isInterrupted(ThreadID thread_id) const;
 
+    /** Should a pending interrupt be held back because the thread is
+     *  executing a hardware transaction? */
+    bool htmDefersInterrupt(ThreadID thread_id) const;
+
+    /** Number of nested hardware transactions the thread is in */
+    uint64_t htmTransactionalDepth(ThreadID thread_id) const;
+
+    /** Turn a fault raised within a hardware transaction into the
+     *  GenericHtmFailureFault which aborts it.  ReExec faults and faults
+     *  which already are HTM failures are returned unchanged */
+    Fault htmTransactionFault(MinorDynInstPtr inst, const Fault &fault);
+
     /** Are we between instructions?  Can we be interrupted? */
     bool isInbetweenInsts(ThreadID thread_id) const;
 
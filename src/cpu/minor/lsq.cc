@@ -49,6 +49,7 @@
 #include "cpu/minor/pipeline.hh"
 #include "cpu/utils.hh"
 #include "debug/Activity.hh"
+#include "debug/HtmCpu.hh"
 #include "debug/MinorMem.hh"
 
 namespace gem5
@@ -72,9 +73,13 @@ LSQ::LSQRequest::LSQRequest(LSQ &port_, MinorDynInstPtr inst_, bool isLoad_,
     skipped(false),
     issuedToMemory(false),
     isTranslationDelayed(false),
+    isHtmTransactional(false),
+    htmUid(0),
+    storeForwarded(false),
+    htmStaleData(false),
     state(NotIssued)
 {
-    request = std::make_shared<Request>();
+    request = Request::create();
 }
 
 void
@@ -163,6 +168,39 @@ LSQ::LSQRequest::isBarrier()
     return inst->isInst() && inst->staticInst->isFullMemBarrier();
 }
 
+void
+LSQ::LSQRequest::setHtmState(PacketPtr pkt)
+{
+    if (isHtmTransactional)
+        pkt->setHtmTransactional(htmUid);
+}
+
+void
+LSQ::LSQRequest::getBlockAddrs(Addr block_mask,
+    std::vector<Addr> &addrs) const
+{
+    if (!request->hasPaddr())
+        return;
+
+    Addr first_block = request->getPaddr() & block_mask;
+    Addr last_block =
+        (request->getPaddr() + request->getSize() - 1) & block_mask;
+
+    addrs.push_back(first_block);
+    if (last_block != first_block)
+        addrs.push_back(last_block);
+}
+
+bool
+LSQ::LSQRequest::touchesBlock(Addr block_addr, Addr block_mask) const
+{
+    std::vector<Addr> addrs;
+
+    getBlockAddrs(block_mask, addrs);
+
+    return std::find(addrs.begin(), addrs.end(), block_addr) != addrs.end();
+}
+
 bool
 LSQ::LSQRequest::needsToBeSentToStoreBuffer()
 {
@@ -306,6 +344,18 @@ LSQ::SingleDataRequest::startAddrTranslation()
     ThreadContext *thread = port.cpu.getContext(
         inst->id.threadId);
 
+    if (request->isHTMCmd()) {
+        /* Hardware transactional memory commands are modelled as loads
+         *  to a dummy physical address and need no translation */
+        DPRINTFS(MinorMem, (&port), "Not translating HTM command\n");
+
+        request->setPaddr(request->getVaddr());
+        setState(Translated);
+        makePacket();
+        port.tryToSendToTransfers(this);
+        return;
+    }
+
     const auto &byte_enable = request->getByteEnable();
     if (isAnyActiveElement(byte_enable.cbegin(), byte_enable.cend())) {
         port.numAccessesInDTLB++;
@@ -496,7 +546,7 @@ LSQ::SplitDataRequest::makeFragmentRequests()
             }
         }
 
-        RequestPtr fragment = std::make_shared<Request>();
+        RequestPtr fragment = Request::create();
         bool disabled_fragment = false;
 
         fragment->setContext(request->contextId());
@@ -569,6 +619,7 @@ LSQ::SplitDataRequest::makeFragmentPackets()
 
         PacketPtr fragment_packet =
             makePacketForRequest(fragment, isLoad, this, request_data);
+        setHtmState(fragment_packet);
 
         fragmentPackets.push_back(fragment_packet);
         /* Accumulate flags in parent request */
@@ -607,6 +658,21 @@ LSQ::SplitDataRequest::startAddrTranslation()
     }
 }
 
+void
+LSQ::SplitDataRequest::getBlockAddrs(Addr block_mask,
+    std::vector<Addr> &addrs) const
+{
+    for (unsigned int fragment_index = 0;
+         fragment_index < numTranslatedFragments;
+         fragment_index++)
+    {
+        const RequestPtr &fragment = fragmentRequests[fragment_index];
+
+        if (fragment->hasPaddr())
+            addrs.push_back(fragment->getPaddr() & block_mask);
+    }
+}
+
 PacketPtr
 LSQ::SplitDataRequest::getHeadPacket()
 {
@@ -637,6 +703,15 @@ LSQ::SplitDataRequest::retireResponse(PacketPtr response)
 
     numRetiredFragments++;
 
+    /* Hardware transactional memory: nacks and transaction failures
+     *  of any fragment apply to the whole access */
+    if (response->isHtmFailedCacheAccess())
+        packet->setHtmFailedCacheAccess(true);
+    if (response->htmTransactionFailedInCache()) {
+        packet->setHtmTransactionFailedInCache(
+            response->getHtmTransactionFailedInCacheRC());
+    }
+
     if (skipped) {
         /* Skip because we already knew the request had faulted or been
          *  skipped */
@@ -1095,7 +1170,16 @@ LSQ::tryToSendToTransfers(LSQRequestPtr request)
      * requests */
     bool do_access = true;
 
-    if (!is_llsc) {
+    if (request->request->isHTMCmd()) {
+        /* Nested transaction starts/stops never leave the core */
+        if (request->request->getFlags().isSet(Request::NO_ACCESS)) {
+            DPRINTF(MinorMem, "Not sending nested HTM command to memory\n");
+            std::memset(request->packet->getPtr<uint8_t>(), 0,
+                request->packet->getSize());
+            request->packet->makeResponse();
+            do_access = false;
+        }
+    } else if (!is_llsc) {
         /* Check for match in the store buffer */
         if (is_load) {
             unsigned int forwarding_slot = 0;
@@ -1109,6 +1193,7 @@ LSQ::tryToSendToTransfers(LSQRequestPtr request)
                  *  repurpose this request's packet into a response packet */
                 storeBuffer.forwardStoreData(request, forwarding_slot);
                 request->packet->makeResponse();
+                request->storeForwarded = true;
 
                 /* Just move between queues, no access */
                 do_access = false;
@@ -1191,6 +1276,8 @@ LSQ::tryToSend(LSQRequestPtr request)
          *  so the response can be correctly handled */
         assert(packet->findNextSenderState<LSQRequest>());
 
+        packet->setAtLSQHead(isAtLSQHead(request));
+
         if (request->request->isLocalAccess()) {
             ThreadContext *thread =
                 cpu.getContext(cpu.contextToThread(
@@ -1298,6 +1385,14 @@ LSQ::canSendToMemorySystem()
 bool
 LSQ::recvTimingResp(PacketPtr response)
 {
+    /* Hardware transactional memory abort and isolate signals are sent
+     *  by the CPU outside of any LSQRequest */
+    if (response->req->isHTMAbort() || response->req->isHTMIsolate()) {
+        DPRINTF(MinorMem, "Received HTM signal response\n");
+        delete response;
+        return true;
+    }
+
     LSQRequestPtr request =
         safe_cast<LSQRequestPtr>(response->popSenderState());
 
@@ -1427,7 +1522,8 @@ LSQ::LSQ(std::string name_, std::string dcache_port_name_,
     numStoresInTransfers(0),
     numAccessesIssuedToMemory(0),
     retryRequest(NULL),
-    cacheBlockMask(cpu.cacheBlockMask())
+    cacheBlockMask(cpu.cacheBlockMask()),
+    atHtmStopHtmUid(cpu.numThreads, 0)
 {
     if (in_memory_system_limit < 1) {
         fatal("%s: executeMaxAccessesInMemory must be >= 1 (%d)\n", name_,
@@ -1652,6 +1748,14 @@ LSQ::pushRequest(MinorDynInstPtr inst, bool isLoad, uint8_t *data,
         inst->pc.instAddr(), std::move(amo_op));
     request->request->setByteEnable(byte_enable);
 
+    /* Accesses made by an instruction inside a transaction (including
+     *  the HTM start which opens it) belong to that transaction */
+    SimpleThread &thread = *cpu.threads[inst->id.threadId];
+    if (thread.htmTransactionStarts > thread.htmTransactionStops) {
+        request->isHtmTransactional = true;
+        request->htmUid = thread.getHtmCheckpointPtr()->getHtmUid();
+    }
+
     requests.push(request);
     inst->inLSQ = true;
     request->startAddrTranslation();
@@ -1732,6 +1836,7 @@ LSQ::LSQRequest::makePacket()
         return;
 
     packet = makePacketForRequest(request, isLoad, this, data);
+    setHtmState(packet);
     /* Null the ret data so we know not to deallocate it when the
      * ret is destroyed.  The data now belongs to the ret and
      * the ret is responsible for its destruction */
@@ -1773,6 +1878,58 @@ LSQ::recvTimingSnoopReq(PacketPtr pkt)
                                       cacheBlockMask);
         }
     }
+
+    if (pkt->isInvalidate())
+        checkHtmSnoop(pkt->getAddr() & cacheBlockMask);
+}
+
+void
+LSQ::checkHtmSnoop(Addr block_addr)
+{
+    /* Only the transactional memory model in Ruby relies on the core
+     *  to detect these conflicts (precise read set tracking and
+     *  reload_if_stale), see O3 LSQUnit::checkTransactionalConflict */
+    if (cpu.system->getHTM() == nullptr)
+        return;
+
+    for (unsigned int i = 0; i < transfers.occupiedSpace(); i++) {
+        LSQRequestPtr request = transfers[i];
+
+        if (request->isLoad && request->isHtmTransactional &&
+            !request->request->isHTMCmd() &&
+            request->touchesBlock(block_addr, cacheBlockMask))
+        {
+            DPRINTF(HtmCpu, "Conflicting snoop for transactional load"
+                " addr %#x inst: %s\n", block_addr, *(request->inst));
+
+            request->htmStaleData = true;
+        }
+    }
+}
+
+bool
+LSQ::isAtLSQHead(LSQRequestPtr request)
+{
+    switch (request->state) {
+      case LSQRequest::StoreInStoreBuffer:
+      case LSQRequest::StoreBufferIssuing:
+        /* Stores only count as being at the head when they hold up the
+         *  commit of their transaction */
+        return request->isHtmTransactional &&
+            isAtHtmStop(request->inst->id.threadId, request->htmUid) &&
+            !storeBuffer.slots.empty() &&
+            storeBuffer.slots.front() == request;
+      default:
+        return request->isLoad && execute.instIsHeadInst(request->inst);
+    }
+}
+
+void
+LSQ::setAtHtmStopHtmUid(ThreadID thread_id, uint64_t htm_uid)
+{
+    assert(htm_uid >= atHtmStopHtmUid[thread_id]);
+
+    atHtmStopHtmUid[thread_id] = htm_uid;
 }
 
 void
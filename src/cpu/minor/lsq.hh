@@ -171,6 +171,21 @@ class LSQ : public Named
         /** Address translation is delayed due to table walk */
         bool isTranslationDelayed;
 
+        /** Hardware transactional memory: was this request made inside
+         *  a transaction, and which one.  Packets made for the request
+         *  are marked accordingly */
+        bool isHtmTransactional;
+        uint64_t htmUid;
+
+        /** The load was satisfied by the store buffer and so never
+         *  reached the memory system */
+        bool storeForwarded;
+
+        /** Hardware transactional memory: an invalidation snoop hit the
+         *  block of this transactional load before it was committed, so
+         *  its data may be stale */
+        bool htmStaleData;
+
         enum LSQRequestState
         {
             NotIssued, /* Newly created */
@@ -261,6 +276,18 @@ class LSQ : public Named
         /** Is this a request a barrier? */
         virtual bool isBarrier();
 
+        /** Mark the given packet as transactional if this request was
+         *  made inside a transaction */
+        void setHtmState(PacketPtr pkt);
+
+        /** Collect the addresses of the blocks touched by this request
+         *  (for requests which have been translated) */
+        virtual void getBlockAddrs(Addr block_mask,
+            std::vector<Addr> &addrs) const;
+
+        /** Does this request touch the given block? */
+        bool touchesBlock(Addr block_addr, Addr block_mask) const;
+
         /** This request, once processed by the requests/transfers
          *  queues, will need to go to the store buffer */
         bool needsToBeSentToStoreBuffer();
@@ -467,6 +494,10 @@ class LSQ : public Named
          *  response packet */
         void retireResponse(PacketPtr packet_);
 
+        /** Each translated fragment may be in a different block */
+        void getBlockAddrs(Addr block_mask,
+            std::vector<Addr> &addrs) const override;
+
         /** Part of the address translation loop, see startAddTranslation */
         void sendNextFragmentToTranslation();
     };
@@ -627,6 +658,12 @@ class LSQ : public Named
     /** Address Mask for a cache block (e.g. ~(cache_block_size-1)) */
     Addr cacheBlockMask;
 
+    /** Hardware transactional memory: uid of the latest transaction of
+     *  each thread to commit the fence preceding its HTM stop.  Stores
+     *  of that transaction draining from the store buffer head are
+     *  marked as being at the head of the LSQ (see O3 LSQUnit) */
+    std::vector<uint64_t> atHtmStopHtmUid;
+
   protected:
     /** Try and issue a memory access for a translated request at the
      *  head of the requests queue.  Also tries to move the request
@@ -650,6 +687,15 @@ class LSQ : public Named
     /** Snoop other threads monitors on memory system accesses */
     void threadSnoop(LSQRequestPtr request);
 
+    /** Hardware transactional memory: is the request the oldest access
+     *  of its thread for the purposes of nacks in the memory system? */
+    bool isAtLSQHead(LSQRequestPtr request);
+
+    /** Hardware transactional memory: mark any transactional loads
+     *  waiting to commit which are hit by an invalidation of the given
+     *  block */
+    void checkHtmSnoop(Addr block_addr);
+
   public:
     LSQ(std::string name_, std::string dcache_port_name_,
         MinorCPU &cpu_, Execute &execute_,
@@ -705,6 +751,15 @@ class LSQ : public Named
     InstSeqNum getLastMemBarrier(ThreadID thread_id) const
     { return lastMemBarrier[thread_id]; }
 
+    /** The fence before the HTM stop of the given transaction has been
+     *  committed */
+    void setAtHtmStopHtmUid(ThreadID thread_id, uint64_t htm_uid);
+
+    /** Has the fence before the HTM stop of the given transaction been
+     *  committed (and so its lazy commit is outstanding)? */
+    bool isAtHtmStop(ThreadID thread_id, uint64_t htm_uid) const
+    { return atHtmStopHtmUid[thread_id] == htm_uid; }
+
     /** Is there nothing left in the LSQ */
     bool isDrained();
 
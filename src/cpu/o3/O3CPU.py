@@ -128,6 +128,10 @@ class O3CPU(BaseCPU):
     LSQDepCheckShift = Param.Unsigned(4, "Number of places to shift addr before check")
     LSQCheckLoads = Param.Bool(True,
         "Should dependency violations be checked for loads & stores or just stores")
+    LSQIndexedChecks = Param.Bool(True,
+        "Only visit loads to matching addresses on violation and snoop checks")
+    LSQValidateIndexedChecks = Param.Bool(False,
+        "Cross-check indexed violation and snoop checks against a full scan")
     store_set_clear_period = Param.Unsigned(250000,
             "Number of load/store insts before the dep predictor should be invalidated")
     LFSTSize = Param.Unsigned(1024, "Last fetched store table size")
@@ -149,6 +149,8 @@ Commit::regProbePoints()
             cpu->getProbeManager(), "CommitStall");
     ppSquash = new ProbePointArg<DynInstPtr>(
             cpu->getProbeManager(), "Squash");
+    ppHtmAbort = new ProbePointArg<InstFaultPair>(
+            cpu->getProbeManager(), "HtmAbort");
 }
 
 Commit::CommitStats::CommitStats(CPU *cpu, Commit *commit)
@@ -1013,7 +1015,7 @@ Commit::commitInsts()
                         // Create a new DynInst from the instruction fetched.
                         ThreadID tid = commit_thread;
                         DynInstPtr inst =
-                            new DynInst(nopStaticInstPtr, nullptr,
+                            new (cpu) DynInst(nopStaticInstPtr, nullptr,
                                         pc[tid], pc[tid],
                                         youngestSeqNum[tid]+1, cpu);
                         youngestSeqNum[tid] = inst->seqNum;
@@ -1422,6 +1424,11 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
 
         assert(!thread[tid]->noSquashFromTC);
 
+        // Notify potential listeners that the transaction this instruction
+        // belongs to is aborting
+        if (std::dynamic_pointer_cast<GenericHtmFailureFault>(inst_fault))
+            ppHtmAbort->notify(std::make_pair(head_inst, inst_fault));
+
         // Mark that we're in state update mode so that the trap's
         // execution doesn't generate extra squashes.
         thread[tid]->noSquashFromTC = true;
@@ -1488,6 +1495,20 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
                 tid, head_inst->seqNum, head_inst->pcState());
     }
 
+    // hardware transactional memory
+    // Copy-on-write checkpoints: save the committed value of each
+    // register the first time the transaction remaps it. The previous
+    // physical register is not freed until rename sees this commit, so
+    // it still holds the value the commit rename map points to.
+    const auto &htm_cpt = cpu->tcBase(tid)->getHtmCheckpointPtr();
+    if (htm_cpt && htm_cpt->tracksRegWrites() &&
+        head_inst->inHtmTransactionalState()) {
+        for (int i = 0; i < head_inst->numDestRegs(); i++) {
+            htm_cpt->saveRegOnWrite(cpu->tcBase(tid),
+                                    head_inst->regs.flattenedDestIdx(i));
+        }
+    }
+
     // Update the commit rename map
     for (int i = 0; i < head_inst->numDestRegs(); i++) {
         renameMap[tid]->setEntry(head_inst->regs.flattenedDestIdx(i),
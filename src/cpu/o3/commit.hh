@@ -42,6 +42,7 @@
 #define __CPU_O3_COMMIT_HH__
 
 #include <queue>
+#include <utility>
 
 #include "base/statistics.hh"
 #include "cpu/exetrace.hh"
@@ -111,6 +112,8 @@ class Commit
         SquashAfterPending, //< Committing instructions before a squash.
     };
 
+    typedef std::pair<DynInstPtr, Fault> InstFaultPair;
+
   private:
     /** Overall commit status. */
     CommitStatus _status;
@@ -126,6 +129,9 @@ class Commit
     ProbePointArg<DynInstPtr> *ppCommitStall;
     /** To probe when an instruction is squashed */
     ProbePointArg<DynInstPtr> *ppSquash;
+    /** To probe when an instruction aborts a hardware transaction, with
+     * the HTM fault it raised */
+    ProbePointArg<InstFaultPair> *ppHtmAbort;
 
     /** Mark the thread as processing a trap. */
     void processTrapEvent(ThreadID tid);
@@ -47,6 +47,7 @@
 #include "cpu/checker/cpu.hh"
 #include "cpu/checker/thread_context.hh"
 #include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/thread_context.hh"
 #include "cpu/simple_thread.hh"
@@ -77,6 +78,11 @@ CPU::CPU(const O3CPUParams &params)
                 false, Event::CPU_Tick_Pri),
       threadExitEvent([this]{ exitThreads(); }, "O3CPU exit threads",
                 false, Event::CPU_Exit_Pri),
+      // Size the instruction pool so that a full ROB plus full fetch
+      // queues can be in flight without growing it.
+      dynInstPool(new DynInstPool(name() + ".instPool", sizeof(DynInst),
+                  params.numROBEntries +
+                  params.numThreads * params.fetchQueueSize)),
 #ifndef NDEBUG
       instcount(0),
 #endif
@@ -354,6 +360,13 @@ CPU::CPU(const O3CPUParams &params)
     }
 }
 
+CPU::~CPU()
+{
+    // Instructions still referenced by the pipeline stages are released
+    // after this point, so the pool frees itself once they are all gone.
+    dynInstPool->detach();
+}
+
 void
 CPU::regProbePoints()
 {
@@ -1736,7 +1749,7 @@ CPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
     RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+        Request::create(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(thread[tid]->contextId());
@@ -1765,7 +1778,7 @@ CPU::htmSendSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
     RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+        Request::create(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(this->thread[tid]->contextId());
@@ -87,6 +87,8 @@ namespace o3
 
 class ThreadContext;
 
+class DynInstPool;
+
 /**
  * O3CPU class, has each of the stages (fetch through commit)
  * within it, as well as all of the time buffers between stages.  The
@@ -170,6 +172,8 @@ class CPU : public BaseCPU
     /** Constructs a CPU with the given parameters. */
     CPU(const O3CPUParams &params);
 
+    ~CPU();
+
     ProbePointArg<PacketPtr> *ppInstAccessComplete;
     ProbePointArg<std::pair<DynInstPtr, PacketPtr> > *ppDataAccessComplete;
 
@@ -453,6 +457,9 @@ class CPU : public BaseCPU
     void dumpInsts();
 
   public:
+    /** Pool the dynamic instructions of this CPU are allocated from. */
+    DynInstPool *dynInstPool;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
@@ -708,7 +715,7 @@ class CPU : public BaseCPU
   public:
     // hardware transactional memory
     void htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
-                            HtmFailureFaultCause cause);
+                            HtmFailureFaultCause cause) override;
     void htmSendSignal(ThreadID tid, uint64_t htm_uid,
                        Addr addr, const Request::Flags flags);
 };
@@ -42,6 +42,7 @@
 
 #include <algorithm>
 
+#include "cpu/o3/dyn_inst_pool.hh"
 #include "debug/DynInst.hh"
 #include "debug/IQ.hh"
 #include "debug/O3PipeView.hh"
@@ -95,6 +96,26 @@ DynInst::DynInst(const StaticInstPtr &_staticInst,
     : DynInst(_staticInst, _macroop, {}, {}, 0, nullptr)
 {}
 
+void *
+DynInst::operator new(size_t count, CPU *cpu)
+{
+    if (cpu)
+        return cpu->dynInstPool->allocate(count);
+    return DynInstPool::allocateUnpooled(count);
+}
+
+void
+DynInst::operator delete(void *ptr)
+{
+    DynInstPool::release(ptr);
+}
+
+void
+DynInst::operator delete(void *ptr, CPU *cpu)
+{
+    DynInstPool::release(ptr);
+}
+
 DynInst::~DynInst()
 {
 #if TRACING_ON
@@ -89,6 +89,18 @@ class DynInst : public ExecContext, public RefCounted
 
     ~DynInst();
 
+    /**
+     * Dynamic instructions are allocated from the owning CPU's instruction
+     * pool. Instructions without a CPU fall back to the global heap.
+     */
+    static void *operator new(size_t count, CPU *cpu);
+
+    /** Return an instruction's storage to the pool it came from. */
+    static void operator delete(void *ptr);
+
+    /** Only used if the constructor throws. */
+    static void operator delete(void *ptr, CPU *cpu);
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -199,7 +211,10 @@ class DynInst : public ExecContext, public RefCounted
      * source and destination registers can vary, and storage for information
      * about them needs to be allocated dynamically. This class figures out
      * how much space is needed and allocates it all at once, and then
-     * trivially divies it up for each type of per-register array.
+     * trivially divies it up for each type of per-register array. The
+     * common case of an instruction with few operands is served from
+     * storage embedded in the instruction itself, so only instructions
+     * with unusually many operands need a separate allocation.
      */
     struct Regs
     {
@@ -227,7 +242,7 @@ class DynInst : public ExecContext, public RefCounted
         // architected destinations.
         PhysRegIdPtr *_prevDestIdx;
 
-        static inline size_t
+        static constexpr size_t
         bytesForDests(size_t num)
         {
             return (sizeof(RegId) + 2 * sizeof(PhysRegIdPtr)) * num;
@@ -239,13 +254,27 @@ class DynInst : public ExecContext, public RefCounted
         // Whether or not the source register is ready, one bit per register.
         uint8_t *_readySrcIdx;
 
-        static inline size_t
+        static constexpr size_t
         bytesForSources(size_t num)
         {
             return sizeof(PhysRegIdPtr) * num +
                 sizeof(uint8_t) * ((num + 7) / 8);
         }
 
+        /** Largest operand counts that fit in the embedded storage. */
+        static constexpr size_t MaxInlineSrcs = 6;
+        static constexpr size_t MaxInlineDests = 4;
+
+        // Same as bytesForSources() + bytesForDests(), which can't be used
+        // here as the struct is still incomplete.
+        static constexpr size_t InlineBytes =
+            sizeof(PhysRegIdPtr) * MaxInlineSrcs +
+            sizeof(uint8_t) * ((MaxInlineSrcs + 7) / 8) +
+            (sizeof(RegId) + 2 * sizeof(PhysRegIdPtr)) * MaxInlineDests;
+
+        /** Embedded storage used when the operands fit in it. */
+        alignas(PhysRegIdPtr) uint8_t inlineBuf[InlineBytes];
+
         template <class T>
         static inline void
         allocate(T *&ptr, BufCursor &cur, size_t count)
@@ -264,10 +293,14 @@ class DynInst : public ExecContext, public RefCounted
             std::fill(_readySrcIdx, _readySrcIdx + (numSrcs() + 7) / 8, 0);
         }
 
-        Regs(size_t srcs, size_t dests) : _numSrcs(srcs), _numDests(dests),
-            buf(new uint8_t[bytesForSources(srcs) + bytesForDests(dests)])
+        Regs(size_t srcs, size_t dests) : _numSrcs(srcs), _numDests(dests)
         {
-            BufCursor cur = buf.get();
+            const size_t bytes = bytesForSources(srcs) + bytesForDests(dests);
+            BufCursor cur = inlineBuf;
+            if (bytes > InlineBytes) {
+                buf.reset(new uint8_t[bytes]);
+                cur = buf.get();
+            }
             allocate(_flatDestIdx, cur, dests);
             allocate(_destIdx, cur, dests);
             allocate(_prevDestIdx, cur, dests);
@@ -277,6 +310,11 @@ class DynInst : public ExecContext, public RefCounted
             init();
         }
 
+        // The register arrays may point into the embedded storage, so the
+        // struct must stay where it was constructed.
+        Regs(const Regs &) = delete;
+        Regs &operator=(const Regs &) = delete;
+
         // Returns the flattened register index of the idx'th destination
         // register.
         const RegId &
@@ -398,6 +436,9 @@ class DynInst : public ExecContext, public RefCounted
     ssize_t sqIdx = -1;
     typename LSQUnit::SQIterator sqIt;
 
+    /** Index of the instruction in its thread's IQ instruction list. */
+    ssize_t iqIdx = -1;
+
 
     /////////////////////// TLB Miss //////////////////////
     /**
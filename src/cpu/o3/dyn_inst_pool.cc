@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/o3/dyn_inst_pool.hh"
+
+#include <cassert>
+#include <new>
+
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/DynInst.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+DynInstPool::DynInstPool(const std::string &name, size_t obj_size,
+                         size_t slab_objs)
+    : _name(name), objSize(obj_size),
+      stride(roundUp(sizeof(Header) + obj_size, alignof(std::max_align_t))),
+      slabObjs(slab_objs)
+{
+    assert(slabObjs > 0);
+    grow();
+}
+
+void
+DynInstPool::grow()
+{
+    // operator new[] returns storage suitably aligned for any fundamental
+    // type, and the stride preserves that alignment for every chunk.
+    slabs.emplace_back(new uint8_t[stride * slabObjs]);
+    uint8_t *slab = slabs.back().get();
+
+    for (size_t i = slabObjs; i > 0; --i) {
+        Header *hdr = new (slab + (i - 1) * stride) Header;
+        hdr->pool = this;
+        hdr->next = freeList;
+        freeList = hdr;
+    }
+
+    DPRINTF(DynInst, "%s: Grew instruction pool to %d entries.\n",
+            _name, capacity());
+}
+
+void *
+DynInstPool::allocate(size_t size)
+{
+    assert(size <= objSize);
+    assert(!detached);
+
+    if (!freeList)
+        grow();
+
+    Header *hdr = freeList;
+    freeList = hdr->next;
+    hdr->next = nullptr;
+    ++numOutstanding;
+
+    return hdr + 1;
+}
+
+void *
+DynInstPool::allocateUnpooled(size_t size)
+{
+    Header *hdr = new (::operator new(sizeof(Header) + size)) Header;
+    hdr->pool = nullptr;
+    hdr->next = nullptr;
+    return hdr + 1;
+}
+
+void
+DynInstPool::release(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Header *hdr = static_cast<Header *>(ptr) - 1;
+    DynInstPool *pool = hdr->pool;
+
+    if (!pool) {
+        hdr->~Header();
+        ::operator delete(hdr);
+        return;
+    }
+
+    assert(pool->numOutstanding > 0);
+    hdr->next = pool->freeList;
+    pool->freeList = hdr;
+
+    if (--pool->numOutstanding == 0 && pool->detached)
+        delete pool;
+}
+
+void
+DynInstPool::detach()
+{
+    detached = true;
+    if (numOutstanding == 0)
+        delete this;
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_DYN_INST_POOL_HH__
+#define __CPU_O3_DYN_INST_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Slab allocator for the dynamic instructions of a single CPU.
+ *
+ * Storage is carved out of large slabs of fixed-size chunks and recycled
+ * through a free list, so once the pool has grown to the number of
+ * instructions the CPU can keep in flight, fetching and squashing
+ * instructions does not call into the global allocator. Every chunk is
+ * prefixed by a small header that records its owning pool, which allows
+ * DynInst::operator delete to return the chunk without knowing the CPU.
+ *
+ * The pool is owned by the CPU but may outlive it: when the CPU goes away
+ * it detaches the pool, which is then destroyed once the last outstanding
+ * instruction has been released.
+ */
+class DynInstPool
+{
+  public:
+    /**
+     * @param name Name used in debug output.
+     * @param obj_size Size in bytes of the objects handed out.
+     * @param slab_objs Number of objects carved out of each slab. The
+     *        first slab is allocated up front.
+     */
+    DynInstPool(const std::string &name, size_t obj_size, size_t slab_objs);
+
+    DynInstPool(const DynInstPool &) = delete;
+    DynInstPool &operator=(const DynInstPool &) = delete;
+
+    /**
+     * Get storage for one object.
+     * @param size Requested size, which must not exceed the object size
+     *        the pool was created with.
+     */
+    void *allocate(size_t size);
+
+    /**
+     * Allocate storage for one object outside of any pool. The storage
+     * carries the same header as pooled storage, so it can be released
+     * through release() as well.
+     */
+    static void *allocateUnpooled(size_t size);
+
+    /** Return storage obtained from allocate() or allocateUnpooled(). */
+    static void release(void *ptr);
+
+    /**
+     * Give up ownership of the pool. It is destroyed right away if no
+     * object is outstanding, or else when the last one is released.
+     */
+    void detach();
+
+    /** Number of objects currently handed out. */
+    size_t outstanding() const { return numOutstanding; }
+
+    /** Number of objects the pool can hold without growing. */
+    size_t capacity() const { return slabs.size() * slabObjs; }
+
+    const std::string &name() const { return _name; }
+
+  private:
+    ~DynInstPool() = default;
+
+    /** Header placed in front of every chunk. */
+    struct alignas(alignof(std::max_align_t)) Header
+    {
+        /** Owning pool, or nullptr for unpooled storage. */
+        DynInstPool *pool;
+        /** Next free chunk while the chunk is on the free list. */
+        Header *next;
+    };
+
+    /** Allocate a new slab and thread its chunks onto the free list. */
+    void grow();
+
+    const std::string _name;
+
+    /** Size of the objects handed out. */
+    const size_t objSize;
+
+    /** Distance between two consecutive chunks, header included. */
+    const size_t stride;
+
+    /** Number of chunks per slab. */
+    const size_t slabObjs;
+
+    std::vector<std::unique_ptr<uint8_t[]>> slabs;
+
+    Header *freeList = nullptr;
+
+    size_t numOutstanding = 0;
+
+    /** Set once the owner has let go of the pool. */
+    bool detached = false;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_DYN_INST_POOL_HH__
@@ -41,6 +41,7 @@
 
 #include "cpu/o3/inst_queue.hh"
 
+#include <bitset>
 #include <limits>
 #include <vector>
 
@@ -89,6 +90,7 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
     : cpu(cpu_ptr),
       iewStage(iew_ptr),
       fuPool(params.fuPool),
+      instsToExecute(params.numROBEntries),
       iqPolicy(params.smtIQPolicy),
       numThreads(params.numThreads),
       numEntries(params.numIQEntries),
@@ -107,13 +109,23 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
                     params.numPhysVecPredRegs +
                     params.numPhysCCRegs;
 
-    //Create an entry for each physical register within the
-    //dependency graph.
-    dependGraph.resize(numPhysRegs);
-
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
 
+    // Instructions stay in the per-thread lists until they commit, so each
+    // list can hold at most a full ROB worth of instructions.
+    instList.reserve(MaxThreads);
+    readyInsts.resize(MaxThreads);
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        instList.emplace_back(params.numROBEntries);
+        readyInsts[tid].resize(params.numROBEntries);
+    }
+
+    // Create a row for each physical register within the wakeup matrix,
+    // with a column for every list slot of every thread.
+    wakeupMatrix.resize(numPhysRegs,
+                        SlotBitmap(numThreads * params.numROBEntries));
+
     //Initialize Mem Dependence Units
     for (ThreadID tid = 0; tid < MaxThreads; tid++) {
         memDepUnit[tid].init(params, tid, cpu_ptr);
@@ -160,11 +172,6 @@ InstructionQueue::InstructionQueue(CPU *cpu_ptr, IEW *iew_ptr,
 
 InstructionQueue::~InstructionQueue()
 {
-    dependGraph.reset();
-#ifdef DEBUG
-    cprintf("Nodes traversed: %i, removed: %i\n",
-            dependGraph.nodesTraversed, dependGraph.nodesRemoved);
-#endif
 }
 
 std::string
@@ -392,7 +399,10 @@ InstructionQueue::resetState()
     //Initialize thread IQ counts
     for (ThreadID tid = 0; tid < MaxThreads; tid++) {
         count[tid] = 0;
-        instList[tid].clear();
+        while (!instList[tid].empty()) {
+            instList[tid].front() = nullptr;
+            instList[tid].pop_front();
+        }
     }
 
     // Initialize the number of free IQ entries.
@@ -405,20 +415,18 @@ InstructionQueue::resetState()
     // unready.
     for (int i = 0; i < numPhysRegs; ++i) {
         regScoreboard[i] = false;
+        wakeupMatrix[i].reset();
     }
 
     for (ThreadID tid = 0; tid < MaxThreads; ++tid) {
         squashedSeqNum[tid] = 0;
     }
 
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        while (!readyInsts[i].empty())
-            readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
-    }
+    for (auto &ready : readyInsts)
+        ready.reset();
+    numReadyInsts = 0;
+
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -448,9 +456,9 @@ InstructionQueue::setTimeBuffer(TimeBuffer<TimeStruct> *tb_ptr)
 bool
 InstructionQueue::isDrained() const
 {
-    bool drained = dependGraph.empty() &&
-                   instsToExecute.empty() &&
-                   wbOutstanding == 0;
+    bool drained = instsToExecute.empty() && wbOutstanding == 0;
+    for (const auto &row : wakeupMatrix)
+        drained = drained && row.none();
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         drained = drained && memDepUnit[tid].isDrained();
 
@@ -460,7 +468,8 @@ InstructionQueue::isDrained() const
 void
 InstructionQueue::drainSanityCheck() const
 {
-    assert(dependGraph.empty());
+    for (GEM5_VAR_USED const auto &row : wakeupMatrix)
+        assert(row.none());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -542,17 +551,7 @@ InstructionQueue::isFull(ThreadID tid)
 bool
 InstructionQueue::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return numReadyInsts != 0;
 }
 
 void
@@ -574,6 +573,7 @@ InstructionQueue::insert(const DynInstPtr &new_inst)
     assert(freeEntries != 0);
 
     instList[new_inst->threadNumber].push_back(new_inst);
+    new_inst->iqIdx = instList[new_inst->threadNumber].tail();
 
     --freeEntries;
 
@@ -624,6 +624,7 @@ InstructionQueue::insertNonSpec(const DynInstPtr &new_inst)
     assert(freeEntries != 0);
 
     instList[new_inst->threadNumber].push_back(new_inst);
+    new_inst->iqIdx = instList[new_inst->threadNumber].tail();
 
     --freeEntries;
 
@@ -658,6 +659,7 @@ DynInstPtr
 InstructionQueue::getInstToExecute()
 {
     assert(!instsToExecute.empty());
+    // Moving out of the buffer also drops the reference it holds.
     DynInstPtr inst = std::move(instsToExecute.front());
     instsToExecute.pop_front();
     if (inst->isFloating()) {
@@ -670,55 +672,41 @@ InstructionQueue::getInstToExecute()
     return inst;
 }
 
-void
-InstructionQueue::addToOrderList(OpClass op_class)
+size_t
+InstructionQueue::slotOf(const DynInstPtr &inst) const
 {
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
+    assert(inst->iqIdx >= 0);
+    return inst->iqIdx % instList[inst->threadNumber].capacity();
+}
 
-    queue_entry.queueType = op_class;
+size_t
+InstructionQueue::columnOf(const DynInstPtr &inst) const
+{
+    return inst->threadNumber * instList[inst->threadNumber].capacity() +
+        slotOf(inst);
+}
 
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+void
+InstructionQueue::markReady(const DynInstPtr &inst)
+{
+    ThreadID tid = inst->threadNumber;
+    size_t slot = slotOf(inst);
 
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
+    assert(instList[tid][slot] == inst);
 
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
-
-        list_it++;
+    if (!readyInsts[tid].test(slot)) {
+        readyInsts[tid].set(slot);
+        ++numReadyInsts;
     }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
 }
 
 void
-InstructionQueue::moveToYoungerInst(ListOrderIt list_order_it)
+InstructionQueue::clearReady(ThreadID tid, size_t slot)
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
+    if (readyInsts[tid].test(slot)) {
+        readyInsts[tid].clear(slot);
+        --numReadyInsts;
     }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
 }
 
 void
@@ -738,12 +726,10 @@ InstructionQueue::processFUCompletion(const DynInstPtr &inst, int fu_idx)
     // of a cycle, otherwise they could add too many instructions to
     // the queue.
     issueToExecuteQueue->access(-1)->size++;
+    assert(!instsToExecute.full());
     instsToExecute.push_back(inst);
 }
 
-// @todo: Figure out a better way to remove the squashed items from the
-// lists.  Checking the top item of each list to see if it's squashed
-// wastes time and forces jumps.
 void
 InstructionQueue::scheduleReadyInsts()
 {
@@ -762,24 +748,64 @@ InstructionQueue::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
-    // FUs that handle it.
+    // Select the oldest ready instructions across all threads.  Each
+    // thread keeps a cursor with the age (distance from the head of its
+    // instruction list) of the next slot to look at, and its oldest
+    // remaining candidate.  Once an op class has no free FU, younger
+    // instructions of that class are not considered again this cycle.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    std::bitset<Num_OpClasses> fu_busy;
+    size_t cursor[MaxThreads];
+    size_t candidate[MaxThreads];
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    auto next_candidate = [&](ThreadID tid)
+    {
+        const InstQueue &insts = instList[tid];
+        candidate[tid] = SlotBitmap::NoSlot;
+        if (insts.empty())
+            return;
 
-        assert(!readyInsts[op_class].empty());
+        size_t head = insts.head() % insts.capacity();
+        size_t slot;
+        while ((slot = readyInsts[tid].findOldest(head, cursor[tid])) !=
+               SlotBitmap::NoSlot) {
+            cursor[tid] = readyInsts[tid].ageOf(head, slot) + 1;
+            if (!fu_busy[insts[slot]->opClass()]) {
+                candidate[tid] = slot;
+                return;
+            }
+        }
+    };
 
-        DynInstPtr issuing_inst = readyInsts[op_class].top();
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        cursor[tid] = 0;
+        next_candidate(tid);
+    }
+
+    while (total_issued < totalWidth) {
+        ThreadID tid = InvalidThreadID;
+        for (ThreadID t = 0; t < numThreads; ++t) {
+            if (candidate[t] != SlotBitmap::NoSlot &&
+                (tid == InvalidThreadID ||
+                 instList[t][candidate[t]]->seqNum <
+                 instList[tid][candidate[tid]]->seqNum)) {
+                tid = t;
+            }
+        }
+
+        if (tid == InvalidThreadID)
+            break;
+
+        size_t slot = candidate[tid];
+        DynInstPtr issuing_inst = instList[tid][slot];
+        OpClass op_class = issuing_inst->opClass();
+
+        // Another thread may have found this op class busy after this
+        // candidate was picked.
+        if (fu_busy[op_class]) {
+            next_candidate(tid);
+            continue;
+        }
 
         if (issuing_inst->isFloating()) {
             iqIOStats.fpInstQueueReads++;
@@ -789,19 +815,9 @@ InstructionQueue::scheduleReadyInsts()
             iqIOStats.intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            clearReady(tid, slot);
+            next_candidate(tid);
 
             ++iqStats.squashedInstsIssued;
 
@@ -810,7 +826,6 @@ InstructionQueue::scheduleReadyInsts()
 
         int idx = FUPool::NoCapableFU;
         Cycles op_latency = Cycles(1);
-        ThreadID tid = issuing_inst->threadNumber;
 
         if (op_class != No_OpClass) {
             idx = fuPool->getUnit(op_class);
@@ -831,6 +846,7 @@ InstructionQueue::scheduleReadyInsts()
         if (idx != FUPool::NoFreeFU) {
             if (op_latency == Cycles(1)) {
                 i2e_info->size++;
+                assert(!instsToExecute.full());
                 instsToExecute.push_back(issuing_inst);
 
                 // Add the FU onto the list of FU's to be freed next
@@ -862,14 +878,7 @@ InstructionQueue::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            clearReady(tid, slot);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -891,13 +900,14 @@ InstructionQueue::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             iqStats.statIssuedInstType[tid][op_class]++;
         } else {
+            fu_busy.set(op_class);
             iqStats.statFuBusy[op_class]++;
             iqStats.fuBusy[tid]++;
-            ++order_it;
         }
+
+        next_candidate(tid);
     }
 
     iqStats.numIssuedDist.sample(total_issued);
@@ -947,11 +957,10 @@ InstructionQueue::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i] Committing instructions older than [sn:%llu]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
-
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
+    while (!instList[tid].empty() &&
+           instList[tid].front()->seqNum <= inst) {
+        clearReady(tid, instList[tid].head() % instList[tid].capacity());
+        instList[tid].front() = nullptr;
         instList[tid].pop_front();
     }
 
@@ -1027,31 +1036,33 @@ InstructionQueue::wakeDependents(const DynInstPtr &completed_inst)
                 dest_reg->index(),
                 dest_reg->className());
 
-        //Go through the dependency chain, marking the registers as
-        //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
+        //Go through the register's row of the wakeup matrix, marking the
+        //register as ready within the waiting instructions.
+        const RegIndex flat_idx = dest_reg->flatIndex();
+        wakeupMatrix[flat_idx].drain([&](size_t column) {
+            const size_t cap = instList[0].capacity();
+            const DynInstPtr &dep_inst =
+                instList[column / cap][column % cap];
 
-        while (dep_inst) {
             DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
                     "PC %s.\n", dep_inst->seqNum, dep_inst->pcState());
 
-            // Might want to give more information to the instruction
-            // so that it knows which of its source registers is
-            // ready.  However that would mean that the dependency
-            // graph entries would need to hold the src_reg_idx.
-            dep_inst->markSrcRegReady();
+            // The instruction may read the register through more than
+            // one of its sources, but it only has one bit in the row.
+            for (int src_reg_idx = 0;
+                 src_reg_idx < dep_inst->numSrcRegs();
+                 src_reg_idx++)
+            {
+                if (!dep_inst->regs.readySrcIdx(src_reg_idx) &&
+                    dep_inst->regs.renamedSrcIdx(src_reg_idx)->flatIndex() ==
+                    flat_idx) {
+                    dep_inst->markSrcRegReady(src_reg_idx);
+                    ++dependents;
+                }
+            }
 
             addIfReady(dep_inst);
-
-            dep_inst = dependGraph.pop(dest_reg->flatIndex());
-
-            ++dependents;
-        }
-
-        // Reset the head node now that all of its dependents have
-        // been woken up.
-        assert(dependGraph.empty(dest_reg->flatIndex()));
-        dependGraph.clearInst(dest_reg->flatIndex());
+        });
 
         // Mark the scoreboard as having that register ready.
         regScoreboard[dest_reg->flatIndex()] = true;
@@ -1064,18 +1075,15 @@ InstructionQueue::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
+    // Squashed instructions may already have left the instruction list,
+    // so their slot cannot be marked. They would never issue anyway.
+    if (ready_inst->isSquashed()) {
+        ++iqStats.squashedInstsIssued;
+        return;
     }
 
+    markReady(ready_inst);
+
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
             ready_inst->pcState(), op_class, ready_inst->seqNum);
@@ -1180,19 +1188,18 @@ InstructionQueue::squash(ThreadID tid)
 void
 InstructionQueue::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
     DPRINTF(IQ, "[tid:%i] Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
-
-        DynInstPtr squashed_inst = (*squash_it);
+    // given, starting at the tail. Squashed instructions form a contiguous
+    // block at the tail of the list, so they are simply popped off.
+    while (!instList[tid].empty() &&
+           instList[tid].back()->seqNum > squashedSeqNum[tid]) {
+
+        clearReady(tid, instList[tid].tail() % instList[tid].capacity());
+        DynInstPtr squashed_inst = std::move(instList[tid].back());
+        instList[tid].pop_back();
         if (squashed_inst->isFloating()) {
             iqIOStats.fpInstQueueWrites++;
         } else if (squashed_inst->isVector()) {
@@ -1201,11 +1208,26 @@ InstructionQueue::doSquash(ThreadID tid)
             iqIOStats.intInstQueueWrites++;
         }
 
+        // The slot can be reused as soon as it is popped, so no register
+        // may wake it up any more.
+        for (int src_reg_idx = 0;
+             src_reg_idx < squashed_inst->numSrcRegs();
+             src_reg_idx++)
+        {
+            PhysRegIdPtr src_reg =
+                squashed_inst->regs.renamedSrcIdx(src_reg_idx);
+
+            if (!squashed_inst->regs.readySrcIdx(src_reg_idx) &&
+                !src_reg->isFixedMapping()) {
+                wakeupMatrix[src_reg->flatIndex()].clear(
+                    columnOf(squashed_inst));
+            }
+        }
+
         // Only handle the instruction if it actually is in the IQ and
         // hasn't already been squashed in the IQ.
         if (squashed_inst->threadNumber != tid ||
             squashed_inst->isSquashedInIQ()) {
-            --squash_it;
             continue;
         }
 
@@ -1221,7 +1243,7 @@ InstructionQueue::doSquash(ThreadID tid)
                           (squashed_inst->isStore() &&
                              !squashed_inst->isStoreConditional()));
 
-            // Remove the instruction from the dependency list.
+            // The instruction was already removed from the wakeup matrix.
             if (is_acq_rel ||
                 (!squashed_inst->isNonSpeculative() &&
                  !squashed_inst->isStoreConditional() &&
@@ -1229,30 +1251,8 @@ InstructionQueue::doSquash(ThreadID tid)
                  !squashed_inst->isReadBarrier() &&
                  !squashed_inst->isWriteBarrier())) {
 
-                for (int src_reg_idx = 0;
-                     src_reg_idx < squashed_inst->numSrcRegs();
-                     src_reg_idx++)
-                {
-                    PhysRegIdPtr src_reg =
-                        squashed_inst->regs.renamedSrcIdx(src_reg_idx);
-
-                    // Only remove it from the dependency graph if it
-                    // was placed there in the first place.
-
-                    // Instead of doing a linked list traversal, we
-                    // can just remove these squashed instructions
-                    // either at issue time, or when the register is
-                    // overwritten.  The only downside to this is it
-                    // leaves more room for error.
-
-                    if (!squashed_inst->regs.readySrcIdx(src_reg_idx) &&
-                        !src_reg->isFixedMapping()) {
-                        dependGraph.remove(src_reg->flatIndex(),
-                                           squashed_inst);
-                    }
-
-                    ++iqStats.squashedOperandsExamined;
-                }
+                iqStats.squashedOperandsExamined +=
+                    squashed_inst->numSrcRegs();
 
             } else if (!squashed_inst->isStoreConditional() ||
                        !squashed_inst->isCompleted()) {
@@ -1295,37 +1295,10 @@ InstructionQueue::doSquash(ThreadID tid)
             ++freeEntries;
         }
 
-        // IQ clears out the heads of the dependency graph only when
-        // instructions reach writeback stage. If an instruction is squashed
-        // before writeback stage, its head of dependency graph would not be
-        // cleared out; it holds the instruction's DynInstPtr. This
-        // prevents freeing the squashed instruction's DynInst.
-        // Thus, we need to manually clear out the squashed instructions'
-        // heads of dependency graph.
-        for (int dest_reg_idx = 0;
-             dest_reg_idx < squashed_inst->numDestRegs();
-             dest_reg_idx++)
-        {
-            PhysRegIdPtr dest_reg =
-                squashed_inst->regs.renamedDestIdx(dest_reg_idx);
-            if (dest_reg->isFixedMapping()){
-                continue;
-            }
-            assert(dependGraph.empty(dest_reg->flatIndex()));
-            dependGraph.clearInst(dest_reg->flatIndex());
-        }
-        instList[tid].erase(squash_it--);
         ++iqStats.squashedInstsExamined;
     }
 }
 
-bool
-InstructionQueue::PqCompare::operator()(
-        const DynInstPtr &lhs, const DynInstPtr &rhs) const
-{
-    return lhs->seqNum > rhs->seqNum;
-}
-
 bool
 InstructionQueue::addToDependents(const DynInstPtr &new_inst)
 {
@@ -1354,7 +1327,7 @@ InstructionQueue::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                wakeupMatrix[src_reg->flatIndex()].set(columnOf(new_inst));
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1377,9 +1350,7 @@ void
 InstructionQueue::addToProducers(const DynInstPtr &new_inst)
 {
     // Nothing really needs to be marked when an instruction becomes
-    // the producer of a register's value, but for convenience a ptr
-    // to the producing instruction will be placed in the head node of
-    // the dependency links.
+    // the producer of a register's value, other than the scoreboard.
     int8_t total_dest_regs = new_inst->numDestRegs();
 
     for (int dest_reg_idx = 0;
@@ -1394,15 +1365,13 @@ InstructionQueue::addToProducers(const DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
-            dependGraph.dump();
-            panic("Dependency graph %i (%s) (flat: %i) not empty!",
+        if (!wakeupMatrix[dest_reg->flatIndex()].none()) {
+            dumpLists();
+            panic("Wakeup matrix row %i (%s) (flat: %i) not empty!",
                   dest_reg->index(), dest_reg->className(),
                   dest_reg->flatIndex());
         }
 
-        dependGraph.setInst(dest_reg->flatIndex(), new_inst);
-
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg->flatIndex()] = false;
     }
@@ -1433,17 +1402,7 @@ InstructionQueue::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        markReady(inst);
     }
 }
 
@@ -1456,12 +1415,21 @@ InstructionQueue::countInsts()
 void
 InstructionQueue::dumpLists()
 {
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        cprintf("Ready list %i size: %i\n", i, readyInsts[i].size());
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        cprintf("[tid:%i] Ready list: ", tid);
+
+        for (auto &inst : instList[tid]) {
+            if (readyInsts[tid].test(slotOf(inst))) {
+                cprintf("%s OpClass:%i [sn:%llu] ", inst->pcState(),
+                        inst->opClass(), inst->seqNum);
+            }
+        }
 
         cprintf("\n");
     }
 
+    cprintf("Ready instructions: %i\n", numReadyInsts);
+
     cprintf("Non speculative list size: %i\n", nonSpecInsts.size());
 
     NonSpecMapIt non_spec_it = nonSpecInsts.begin();
@@ -1476,22 +1444,6 @@ InstructionQueue::dumpLists()
     }
 
     cprintf("\n");
-
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
-
-        ++list_order_it;
-        ++i;
-    }
-
-    cprintf("\n");
 }
 
 
@@ -1501,7 +1453,7 @@ InstructionQueue::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        auto inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
@@ -1541,7 +1493,7 @@ InstructionQueue::dumpInsts()
 
     int num = 0;
     int valid_num = 0;
-    ListIt inst_list_it = instsToExecute.begin();
+    auto inst_list_it = instsToExecute.begin();
 
     while (inst_list_it != instsToExecute.end())
     {
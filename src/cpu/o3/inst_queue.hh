@@ -44,17 +44,17 @@
 
 #include <list>
 #include <map>
-#include <queue>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/comm.hh"
-#include "cpu/o3/dep_graph.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/mem_dep_unit.hh"
+#include "cpu/o3/slot_bitmap.hh"
 #include "cpu/o3/store_set.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
@@ -79,9 +79,10 @@ class CPU;
 class IEW;
 
 /**
- * A standard instruction queue class.  It holds ready instructions, in
- * order, in seperate priority queues to facilitate the scheduling of
- * instructions.  The IQ uses a separate linked list to track dependencies.
+ * A standard instruction queue class.  Ready instructions are tracked in a
+ * per-thread bitmap over the instruction list, which select scans in age
+ * order.  Register dependencies are tracked in a wakeup matrix with a row
+ * per physical register and a column per instruction list slot.
  * Similar to the rename map and the free list, it expects that
  * floating point registers have their indices start after the integer
  * registers (ie with 96 int and 96 fp registers, regs 0-95 are integer
@@ -101,6 +102,9 @@ class InstructionQueue
     // Typedef of iterator through the list of instructions.
     typedef typename std::list<DynInstPtr>::iterator ListIt;
 
+    /** Fixed-capacity, in-order buffer of instructions. */
+    typedef CircularQueue<DynInstPtr> InstQueue;
+
     /** FU completion event class. */
     class FUCompletion : public Event
     {
@@ -316,11 +320,15 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /** List of all the instructions in the IQ (some of which may be issued).
+     *  Instructions stay in this list until they commit, so every thread's
+     *  buffer is sized to the ROB. Instructions are only removed from the
+     *  head (commit) or the tail (squash).
+     */
+    std::vector<InstQueue> instList;
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    InstQueue instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
@@ -335,25 +343,15 @@ class InstructionQueue
      */
     std::list<DynInstPtr> retryMemInsts;
 
-    /**
-     * Struct for comparing entries to be added to the priority queue.
-     * This gives reverse ordering to the instructions in terms of
-     * sequence numbers: the instructions with smaller sequence
-     * numbers (and hence are older) will be at the top of the
-     * priority queue.
+    /** Per-thread bitmaps of the instList slots whose instructions are
+     *  ready to issue.  Instructions in a thread's list are in program
+     *  order, so the oldest ready instruction is the first set slot
+     *  after the head of the list.
      */
-    struct PqCompare
-    {
-        bool operator()(const DynInstPtr &lhs, const DynInstPtr &rhs) const;
-    };
-
-    typedef std::priority_queue<
-        DynInstPtr, std::vector<DynInstPtr>, PqCompare> ReadyInstQueue;
+    std::vector<SlotBitmap> readyInsts;
 
-    /** List of ready instructions, per op class.  They are separated by op
-     *  class to allow for easy mapping to FUs.
-     */
-    ReadyInstQueue readyInsts[Num_OpClasses];
+    /** Number of slots set across all the ready bitmaps. */
+    unsigned numReadyInsts;
 
     /** List of non-speculative instructions that will be scheduled
      *  once the IQ gets a signal from commit.  While it's redundant to
@@ -366,42 +364,23 @@ class InstructionQueue
 
     typedef std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry
-    {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
+    /** Wakeup matrix, with a row per physical register and a column per
+     *  instList slot of every thread.  A set bit means the instruction in
+     *  that slot is waiting for the register to be written.
      */
-    std::list<ListOrderEntry> listOrder;
+    std::vector<SlotBitmap> wakeupMatrix;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    /** Returns the slot an instruction occupies in its thread's instList. */
+    size_t slotOf(const DynInstPtr &inst) const;
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
-
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
+    /** Returns the wakeup matrix column of an instruction. */
+    size_t columnOf(const DynInstPtr &inst) const;
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
-
-    /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
-     */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    /** Marks an instruction as ready to issue. */
+    void markReady(const DynInstPtr &inst);
 
-    DependencyGraph<DynInstPtr> dependGraph;
+    /** Clears the ready bit of a slot, if it is set. */
+    void clearReady(ThreadID tid, size_t slot);
 
     //////////////////////////////////////
     // Various parameters
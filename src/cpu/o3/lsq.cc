@@ -846,7 +846,7 @@ LSQ::pushRequest(const DynInstPtr& inst, bool isLoad, uint8_t *data,
             inst->effAddrValid(true);
 
             if (cpu->checker) {
-                inst->reqToVerify = std::make_shared<Request>(*req->request());
+                inst->reqToVerify = Request::create(*req->request());
             }
             Fault fault;
             if (isLoad)
@@ -1010,7 +1010,7 @@ LSQ::SplitDataRequest::initiateTranslation()
     Addr final_addr = addrBlockAlign(_addr + _size, cacheLineSize);
     uint32_t size_so_far = 0;
 
-    mainReq = std::make_shared<Request>(base_addr,
+    mainReq = Request::create(base_addr,
                 _size, _flags, _inst->requestorId(),
                 _inst->instAddr(), _inst->contextId());
     mainReq->setByteEnable(_byteEnable);
@@ -1123,7 +1123,7 @@ LSQ::LSQRequest::addRequest(Addr addr, unsigned size,
            const std::vector<bool>& byte_enable)
 {
     if (isAnyActiveElement(byte_enable.begin(), byte_enable.end())) {
-        auto request = std::make_shared<Request>(
+        auto request = Request::create(
                 addr, size, _flags, _inst->requestorId(),
                 _inst->instAddr(), _inst->contextId(),
                 std::move(_amo_op));
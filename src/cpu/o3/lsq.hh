@@ -407,6 +407,7 @@ class LSQ
 
         uint32_t taskId() const { return _taskId; }
         RequestPtr request(int idx = 0) { return _requests.at(idx); }
+        size_t numRequests() const { return _requests.size(); }
 
         const RequestPtr
         request(int idx = 0) const
@@ -244,8 +244,13 @@ LSQUnit::init(CPU *cpu_ptr, IEW *iew_ptr, const O3CPUParams &params,
 
     depCheckShift = params.LSQDepCheckShift;
     checkLoads = params.LSQCheckLoads;
+    indexedChecks = params.LSQIndexedChecks;
+    validateIndex = params.LSQValidateIndexedChecks;
     needsTSO = params.needsTSO;
 
+    indexedLoads.resize(loadQueue.capacity());
+    loadsToCheck.reserve(loadQueue.capacity());
+
     resetState();
 }
 
@@ -264,6 +269,11 @@ LSQUnit::resetState()
     retryPkt = NULL;
     memDepViolator = NULL;
 
+    loadGranuleIndex.clear();
+    loadBlockIndex.clear();
+    for (auto &rec : indexedLoads)
+        rec.valid = false;
+
     stalled = false;
 
     cacheBlockMask = cpu->cacheBlockMask();
@@ -577,12 +587,13 @@ LSQUnit::checkSnoop(PacketPtr pkt)
 
     bool force_squash = false;
 
-    while (++iter != loadQueue.end()) {
-        ld_inst = iter->instruction();
+    auto check_load = [&](LQEntry &entry)
+    {
+        ld_inst = entry.instruction();
         assert(ld_inst);
-        req = iter->request();
+        req = entry.request();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered())
-            continue;
+            return;
 
         DPRINTF(LSQUnit, "-- inst [sn:%lli] to pktAddr:%#x\n",
                     ld_inst->seqNum, invalidate_addr);
@@ -621,8 +632,43 @@ LSQUnit::checkSnoop(PacketPtr pkt)
                 ld_inst->hitExternalSnoop(true);
             }
         }
+    };
+
+    if (!indexedChecks) {
+        while (++iter != loadQueue.end())
+            check_load(*iter);
+        return;
+    }
+
+    // Only visit the younger loads that touch the invalidated block. Under
+    // TSO, every load younger than the first one hit has to be visited as
+    // well, so fall back to walking the queue from there on.
+    loadsToCheck.clear();
+    loadBlockIndex.find(invalidate_addr, loadQueue.head() + 1, loadsToCheck);
+    std::sort(loadsToCheck.begin(), loadsToCheck.end());
+
+    if (validateIndex) {
+        for (auto it = iter; ++it != loadQueue.end(); ) {
+            const DynInstPtr &inst = it->instruction();
+            panic_if(inst->effAddrValid() && !inst->strictlyOrdered() &&
+                     it->request()->isCacheBlockHit(invalidate_addr,
+                                                    cacheBlockMask) &&
+                     !std::binary_search(loadsToCheck.begin(),
+                                         loadsToCheck.end(), it.idx()),
+                     "Snoop to %#x missed indexed load [sn:%lli].\n",
+                     invalidate_addr, inst->seqNum);
+        }
+    }
+
+    for (auto idx : loadsToCheck) {
+        check_load(loadQueue[idx]);
+        if (force_squash) {
+            iter = loadQueue.getIterator(idx);
+            while (++iter != loadQueue.end())
+                check_load(*iter);
+            break;
+        }
     }
-    return;
 }
 
 Fault
@@ -637,10 +683,45 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
      * all instructions that will execute before the store writes back. Thus,
      * like the implementation that came before it, we're overly conservative.
      */
-    while (loadIt != loadQueue.end()) {
-        DynInstPtr ld_inst = loadIt->instruction();
+    loadsToCheck.clear();
+    if (indexedChecks) {
+        // Only visit the younger loads that touch the same granules.
+        Addr first_granule, last_granule;
+        granuleRange(inst->effAddr, inst->effSize,
+                     first_granule, last_granule);
+        for (Addr granule = first_granule; granule <= last_granule;
+             ++granule) {
+            loadGranuleIndex.find(granule, loadIt.idx(), loadsToCheck);
+        }
+        std::sort(loadsToCheck.begin(), loadsToCheck.end());
+        loadsToCheck.erase(
+            std::unique(loadsToCheck.begin(), loadsToCheck.end()),
+            loadsToCheck.end());
+
+        if (validateIndex) {
+            for (auto it = loadIt; it != loadQueue.end(); ++it) {
+                const DynInstPtr &ld_inst = it->instruction();
+                if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered())
+                    continue;
+                Addr ld_eff_addr1 = ld_inst->effAddr >> depCheckShift;
+                Addr ld_eff_addr2 =
+                    (ld_inst->effAddr + ld_inst->effSize - 1) >> depCheckShift;
+                panic_if(inst_eff_addr2 >= ld_eff_addr1 &&
+                         inst_eff_addr1 <= ld_eff_addr2 &&
+                         !std::binary_search(loadsToCheck.begin(),
+                                             loadsToCheck.end(), it.idx()),
+                         "Inst [sn:%lli] missed indexed load [sn:%lli].\n",
+                         inst->seqNum, ld_inst->seqNum);
+            }
+        }
+    } else {
+        for (auto it = loadIt; it != loadQueue.end(); ++it)
+            loadsToCheck.push_back(it.idx());
+    }
+
+    for (auto idx : loadsToCheck) {
+        DynInstPtr ld_inst = loadQueue[idx].instruction();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
-            ++loadIt;
             continue;
         }
 
@@ -696,12 +777,83 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
                     inst->seqNum, ld_inst->seqNum, ld_eff_addr1);
             }
         }
-
-        ++loadIt;
     }
     return NoFault;
 }
 
+void
+LSQUnit::granuleRange(Addr addr, unsigned size, Addr &first,
+                      Addr &last) const
+{
+    first = addr >> depCheckShift;
+    last = (addr + size - 1) >> depCheckShift;
+    // An empty access aligned to a granule ends in the granule before
+    // the one it starts in, and the overlap check then matches accesses
+    // spanning both of them.
+    if (size == 0) {
+        last = first;
+        if (first > 0)
+            --first;
+    }
+}
+
+void
+LSQUnit::indexLoad(size_t lq_idx)
+{
+    if (!indexedChecks)
+        return;
+
+    // Loads are indexed every time they are sent, as a replayed load may
+    // come back with a different request.
+    unindexLoad(lq_idx);
+
+    LQEntry &entry = loadQueue[lq_idx];
+    const DynInstPtr &inst = entry.instruction();
+    LSQRequest *req = entry.request();
+    IndexedLoad &rec = indexedLoads[lq_idx % indexedLoads.size()];
+
+    rec.valid = true;
+    rec.lqIdx = lq_idx;
+    granuleRange(inst->effAddr, inst->effSize,
+                 rec.firstGranule, rec.lastGranule);
+    for (Addr granule = rec.firstGranule; granule <= rec.lastGranule;
+         ++granule) {
+        loadGranuleIndex.insert(granule, lq_idx);
+    }
+
+    assert(rec.blocks.empty());
+    for (size_t i = 0; i < req->numRequests(); ++i) {
+        const RequestPtr &r = req->request(i);
+        if (!r->hasPaddr())
+            continue;
+        Addr block = r->getPaddr() & cacheBlockMask;
+        if (std::find(rec.blocks.begin(), rec.blocks.end(), block) ==
+                rec.blocks.end()) {
+            rec.blocks.push_back(block);
+            loadBlockIndex.insert(block, lq_idx);
+        }
+    }
+}
+
+void
+LSQUnit::unindexLoad(size_t lq_idx)
+{
+    IndexedLoad &rec = indexedLoads[lq_idx % indexedLoads.size()];
+    if (!rec.valid)
+        return;
+
+    assert(rec.lqIdx == lq_idx);
+    for (Addr granule = rec.firstGranule; granule <= rec.lastGranule;
+         ++granule) {
+        loadGranuleIndex.erase(granule, lq_idx);
+    }
+    for (auto block : rec.blocks)
+        loadBlockIndex.erase(block, lq_idx);
+
+    rec.blocks.clear();
+    rec.valid = false;
+}
+
 
 
 
@@ -841,6 +993,7 @@ LSQUnit::commitLoad()
                     inst->lastWakeDependents - inst->firstIssue));
     }
 
+    unindexLoad(loadQueue.head());
     loadQueue.front().clear();
     loadQueue.pop_front();
 
@@ -1075,6 +1228,7 @@ LSQUnit::squash(const InstSeqNum &squashed_num)
         }
         // Clear the smart pointer to make sure it is decremented.
         loadQueue.back().instruction()->setSquashed();
+        unindexLoad(loadQueue.tail());
         loadQueue.back().clear();
 
         --loads;
@@ -1451,6 +1605,8 @@ LSQUnit::read(LSQRequest *req, int load_idx)
             load_inst->seqNum, load_inst->pcState());
     }
 
+    indexLoad(load_idx);
+
     DPRINTF(LSQUnit, "Read called, load idx: %i, store idx: %i, "
             "storeHead: %i addr: %#x%s\n",
             load_idx - 1, load_inst->sqIt._idx, storeQueue.head() - 1,
@@ -47,6 +47,8 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/generic/vec_reg.hh"
@@ -200,6 +202,68 @@ class LSQUnit
     };
     using LQEntry = LSQEntry;
 
+    /**
+     * Hashed index from addresses to the load queue entries that access
+     * them, so that ordering violation and snoop checks only visit the
+     * loads that may match. The index may hold entries that no longer
+     * satisfy the checks (e.g. loads that have been rescheduled), so
+     * callers must still test every load they get back.
+     */
+    class LoadAddrIndex
+    {
+      private:
+        std::unordered_map<Addr, std::vector<size_t>> buckets;
+
+      public:
+        void
+        insert(Addr key, size_t lq_idx)
+        {
+            buckets[key].push_back(lq_idx);
+        }
+
+        void
+        erase(Addr key, size_t lq_idx)
+        {
+            auto it = buckets.find(key);
+            assert(it != buckets.end());
+            auto &idxs = it->second;
+            auto pos = std::find(idxs.begin(), idxs.end(), lq_idx);
+            assert(pos != idxs.end());
+            *pos = idxs.back();
+            idxs.pop_back();
+            if (idxs.empty())
+                buckets.erase(it);
+        }
+
+        /** Append the indices at or after min_idx mapped to key. */
+        void
+        find(Addr key, size_t min_idx, std::vector<size_t> &out) const
+        {
+            auto it = buckets.find(key);
+            if (it == buckets.end())
+                return;
+            for (auto idx : it->second) {
+                if (idx >= min_idx)
+                    out.push_back(idx);
+            }
+        }
+
+        void clear() { buckets.clear(); }
+    };
+
+    /** What was recorded in the indices for a load queue slot. */
+    struct IndexedLoad
+    {
+        bool valid = false;
+        /** The load queue index the slot was indexed with. */
+        size_t lqIdx = 0;
+        /** First and last dependence check granule of the access. */
+        Addr firstGranule = 0;
+        Addr lastGranule = 0;
+        /** Physical cache blocks touched by the access. */
+        std::vector<Addr> blocks;
+    };
+
     /** Coverage of one address range with another */
     enum class AddrRangeCoverage
     {
@@ -266,6 +330,16 @@ class LSQUnit
      */
     void checkSnoop(PacketPtr pkt);
 
+    /** Add a load that has been sent to memory to the address indices. */
+    void indexLoad(size_t lq_idx);
+
+    /** Remove a load from the address indices, if it was indexed. */
+    void unindexLoad(size_t lq_idx);
+
+    /** Get the first and last dependence check granule of an access. */
+    void granuleRange(Addr addr, unsigned size, Addr &first,
+                      Addr &last) const;
+
     /** Executes a load instruction. */
     Fault executeLoad(const DynInstPtr &inst);
 
@@ -512,6 +586,28 @@ class LSQUnit
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
+    /** Use the address indices for violation and snoop checks. */
+    bool indexedChecks;
+
+    /** Cross-check the indexed lookups against a full load queue scan. */
+    bool validateIndex;
+
+    /** Loads indexed by dependence check granule of their virtual
+     * address, used for memory ordering violation checks.
+     */
+    LoadAddrIndex loadGranuleIndex;
+
+    /** Loads indexed by the physical cache blocks they access, used for
+     * snoop checks.
+     */
+    LoadAddrIndex loadBlockIndex;
+
+    /** Index bookkeeping for every load queue slot. */
+    std::vector<IndexedLoad> indexedLoads;
+
+    /** Scratch buffer for the load queue indices to check. */
+    std::vector<size_t> loadsToCheck;
+
     /** The number of load instructions in the LQ. */
     int loads;
     /** The number of store instructions in the SQ. */
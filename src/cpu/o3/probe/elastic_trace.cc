@@ -43,7 +43,9 @@
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/reg_class.hh"
 #include "debug/ElasticTrace.hh"
+#include "mem/htm.hh"
 #include "mem/packet.hh"
+#include "sim/faults.hh"
 
 namespace gem5
 {
@@ -51,6 +53,8 @@ namespace gem5
 namespace o3
 {
 
+std::unordered_map<Addr, ElasticTrace::SyncDep> ElasticTrace::lastWriter;
+
 ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
     :  ProbeListenerObject(params),
        regEtraceListenersEvent([this]{ regEtraceListeners(); }, name()),
@@ -62,9 +66,11 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
        startTraceInst(params.startTraceInst),
        allProbesReg(false),
        traceVirtAddr(params.traceVirtAddr),
+       inHtm(false),
        stats(this)
 {
     cpu = dynamic_cast<CPU *>(params.manager);
+    coreId = cpu->cpuId();
     const BaseISA::RegClasses &regClasses =
         cpu->getContext(0)->getIsaPtr()->regClasses();
     zeroReg = regClasses.at(IntRegClass).zeroReg();
@@ -98,6 +104,7 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams &params)
     data_rec_header.set_obj_id(name());
     data_rec_header.set_tick_freq(sim_clock::Frequency);
     data_rec_header.set_window_size(depWindowSize);
+    data_rec_header.set_core_id(coreId);
     dataTraceStream->write(data_rec_header);
     // Register a callback to flush trace records and close the output streams.
     registerExitCallback([this]() {  flushTraces(); });
@@ -147,6 +154,8 @@ ElasticTrace::regEtraceListeners()
     listeners.push_back(new ProbeListenerArg<ElasticTrace,
             DynInstConstPtr>(this, "Commit",
                 &ElasticTrace::addCommittedInst));
+    listeners.push_back(new ProbeListenerArg<ElasticTrace, InstFaultPair>(
+                        this, "HtmAbort", &ElasticTrace::addHtmAbort));
     allProbesReg = true;
 }
 
@@ -378,6 +387,11 @@ ElasticTrace::addCommittedInst(const DynInstConstPtr& head_inst)
                     "skip adding it to the trace\n",
                     (head_inst->isMemRef() ? "Load/store" : "Comp inst."),
                     head_inst->seqNum);
+        } else if (head_inst->isHtmCmd() &&
+                   (head_inst->memReqFlags & Request::NO_ACCESS)) {
+            DPRINTF(ElasticTrace, "Nested HTM command [sn:%lli] never "
+                    "leaves the core so skip adding it to the trace\n",
+                    head_inst->seqNum);
         } else if (head_inst->isMemRef() && !head_inst->hasRequest()) {
             DPRINTF(ElasticTrace, "Load/store [sn:%lli]  has no request so "
                     "skip adding it to the trace\n", head_inst->seqNum);
@@ -396,6 +410,62 @@ ElasticTrace::addCommittedInst(const DynInstConstPtr& head_inst)
     clearTempStoreUntil(head_inst);
 }
 
+void
+ElasticTrace::addHtmAbort(const InstFaultPair &inst_fault)
+{
+    const DynInstPtr &head_inst = inst_fault.first;
+
+    // Only transactions whose start made it into the trace are closed by an
+    // abort record
+    if (!inHtm) {
+        DPRINTF(ElasticTrace, "HTM abort at [sn:%lli] outside of a traced "
+                "transaction, skipping.\n", head_inst->seqNum);
+        return;
+    }
+
+    auto htm_fault = std::dynamic_pointer_cast<GenericHtmFailureFault>(
+        inst_fault.second);
+    assert(htm_fault);
+
+    // The faulting instruction is squashed rather than committed, so its
+    // sequence number is free to identify the abort record. Nothing depends
+    // on the record and the replay discards the aborted attempt, hence no
+    // dependencies and no computational delay.
+    TraceInfo* new_record = new TraceInfo;
+    traceInfoMap[head_inst->seqNum] = new_record;
+    new_record->instNum = head_inst->seqNum;
+    new_record->commit = true;
+    new_record->type = Record::HTM_ABORT;
+    new_record->htmUid = htm_fault->getHtmUid();
+    new_record->reqFlags =
+        static_cast<Request::FlagsType>(htm_fault->getHtmFailureFaultCause());
+    new_record->physAddr = 0;
+    new_record->virtAddr = 0;
+    new_record->size = 0;
+    new_record->pc = head_inst->instAddr();
+    new_record->executeTick = curTick();
+    new_record->toCommitTick = curTick();
+    new_record->commitTick = curTick();
+    new_record->numDepts = 0;
+    new_record->compDelay = 0;
+
+    // The aborted transaction's stores never became visible
+    inHtm = false;
+    htmWriteSet.clear();
+    ++stats.numHtmAborts;
+
+    depTrace.push_back(new_record);
+    DPRINTF(ElasticTrace, "Added HTM abort %lli (uid %lli, %s) to "
+            "DepTrace.\n", new_record->instNum, new_record->htmUid,
+            htmFailureToStr(htm_fault->getHtmFailureFaultCause()));
+
+    if (depTrace.size() == 2 * depWindowSize) {
+        DPRINTF(ElasticTrace, "Writing out trace...\n");
+        writeDepTrace(depWindowSize);
+        firstWin = false;
+    }
+}
+
 void
 ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
                                 InstExecInfo* exec_info_ptr, bool commit)
@@ -408,9 +478,17 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     // Assign fields from the instruction
     new_record->instNum = head_inst->seqNum;
     new_record->commit = commit;
-    new_record->type = head_inst->isLoad() ? Record::LOAD :
-                        (head_inst->isStore() ? Record::STORE :
-                        Record::COMP);
+    if (head_inst->isHtmStart()) {
+        new_record->type = Record::HTM_START;
+    } else if (head_inst->isHtmStop()) {
+        new_record->type = Record::HTM_COMMIT;
+    } else {
+        new_record->type = head_inst->isLoad() ? Record::LOAD :
+                            (head_inst->isStore() ? Record::STORE :
+                            Record::COMP);
+    }
+    if (head_inst->inHtmTransactionalState())
+        new_record->htmUid = head_inst->getHtmTransactionUid();
 
     // Assign fields for creating a request in case of a load/store
     new_record->reqFlags = head_inst->memReqFlags;
@@ -429,6 +507,9 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     new_record->numDepts = 0;
     new_record->compDelay = -1;
 
+    if (commit)
+        updateSyncDep(new_record);
+
     // The physical register dependency set of the first instruction is
     // empty. Since there are no records in the depTrace at this point, the
     // case of adding an ROB dependency by using a reverse iterator is not
@@ -704,7 +785,8 @@ ElasticTrace::compDelayRob(TraceInfo* past_record, TraceInfo* new_record)
         }
     } else if (past_record->isStore()) {
         completion_tick = past_record->commitTick;
-    } else if (past_record->isComp()){
+    } else {
+        // Comp and HTM records complete when they are ready to commit
         completion_tick = past_record->toCommitTick;
     }
     assert(execution_tick >= completion_tick);
@@ -764,6 +846,47 @@ ElasticTrace::compDelayPhysRegDep(TraceInfo* past_record,
             new_record->compDelay);
 }
 
+void
+ElasticTrace::updateSyncDep(TraceInfo* new_record)
+{
+    const Addr line_addr =
+        new_record->physAddr & ~(Addr)(cpu->cacheLineSize() - 1);
+
+    if (new_record->isLoad()) {
+        auto writer_itr = lastWriter.find(line_addr);
+        if (writer_itr == lastWriter.end() ||
+            writer_itr->second.core == coreId) {
+            return;
+        }
+        const SyncDep &writer = writer_itr->second;
+        InstSeqNum &last_dep = lastSyncDep[writer.core];
+        if (writer.seqNum > last_dep) {
+            DPRINTF(ElasticTrace, "Load %lli has sync dependency on %lli of "
+                    "core %d\n", new_record->instNum, writer.seqNum,
+                    writer.core);
+            new_record->syncDeps.push_back(writer);
+            last_dep = writer.seqNum;
+            ++stats.numSyncDep;
+        }
+    } else if (new_record->isStore()) {
+        if (inHtm) {
+            htmWriteSet.push_back(line_addr);
+        } else {
+            lastWriter[line_addr] = {coreId, new_record->instNum};
+        }
+    } else if (new_record->type == Record::HTM_START) {
+        inHtm = true;
+        htmWriteSet.clear();
+    } else if (new_record->type == Record::HTM_COMMIT) {
+        // Transactional stores become visible all at once at commit
+        for (auto addr : htmWriteSet) {
+            lastWriter[addr] = {coreId, new_record->instNum};
+        }
+        inHtm = false;
+        htmWriteSet.clear();
+    }
+}
+
 Tick
 ElasticTrace::TraceInfo::getExecuteTick() const
 {
@@ -843,6 +966,20 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
                 if (traceVirtAddr)
                     dep_pkt.set_v_addr(temp_ptr->virtAddr);
                 dep_pkt.set_size(temp_ptr->size);
+            } else if (temp_ptr->isHtm()) {
+                DPRINTFR(ElasticTrace, "\tbelongs to transaction %lli\n",
+                         temp_ptr->htmUid);
+                dep_pkt.set_htm_uid(temp_ptr->htmUid);
+                // The flags of an abort record hold the abort cause
+                if (temp_ptr->type == Record::HTM_ABORT)
+                    dep_pkt.set_flags(temp_ptr->reqFlags);
+            }
+            for (const auto &sync_dep : temp_ptr->syncDeps) {
+                DPRINTFR(ElasticTrace, "\thas sync dependency on %lli of "
+                         "core %d\n", sync_dep.seqNum, sync_dep.core);
+                auto sync_pkt = dep_pkt.add_sync_dep();
+                sync_pkt->set_core(sync_dep.core);
+                sync_pkt->set_seq_num(sync_dep.seqNum);
             }
             dep_pkt.set_comp_delay(temp_ptr->compDelay);
             if (temp_ptr->robDepList.empty()) {
@@ -905,6 +1042,11 @@ ElasticTrace::ElasticTraceStats::ElasticTraceStats(statistics::Group *parent)
                "dependency because they were dependency-free"),
       ADD_STAT(numFilteredNodes, statistics::units::Count::get(),
                "No. of nodes filtered out before writing the output trace"),
+      ADD_STAT(numHtmAborts, statistics::units::Count::get(),
+               "Number of transaction aborts recorded during tracing"),
+      ADD_STAT(numSyncDep, statistics::units::Count::get(),
+               "Number of sync dependencies on records of other cores "
+               "recorded during tracing"),
       ADD_STAT(maxNumDependents, statistics::units::Count::get(),
                "Maximum number or dependents on any instruction"),
       ADD_STAT(maxTempStoreSize, statistics::units::Count::get(),
@@ -49,6 +49,7 @@
 #include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
@@ -89,12 +90,20 @@ class CPU;
  * a protobuf format output file.
  *
  * The output trace can be read in and played back by the TraceCPU.
+ *
+ * Hardware transactions are written as HTM_START and HTM_COMMIT records
+ * around their body, and attempts that abort end with an HTM_ABORT record.
+ * When several cores are traced, a load that reads a cache line last written
+ * by another core gets a sync dependency on that core's store, or on its
+ * HTM_COMMIT record if the store was transactional, so that the replay can
+ * preserve the order of cross-core communication.
  */
 class ElasticTrace : public ProbeListenerObject
 {
 
   public:
     typedef typename std::pair<InstSeqNum, RegIndex> SeqNumRegPair;
+    typedef typename std::pair<DynInstPtr, Fault> InstFaultPair;
 
     /** Trace record types corresponding to instruction node types */
     typedef ProtoMessage::InstDepRecord::RecordType RecordType;
@@ -179,6 +188,14 @@ class ElasticTrace : public ProbeListenerObject
      */
     void addCommittedInst(const DynInstConstPtr& head_inst);
 
+    /**
+     * Add an HTM_ABORT record for the transaction that the instruction at
+     * the head of the ROB has aborted.
+     *
+     * @param inst_fault the instruction and the HTM fault it raised
+     */
+    void addHtmAbort(const InstFaultPair &inst_fault);
+
     /** Event to trigger registering this listener for all probe points. */
     EventFunctionWrapper regEtraceListenersEvent;
 
@@ -245,6 +262,15 @@ class ElasticTrace : public ProbeListenerObject
      */
     std::unordered_map<RegIndex, InstSeqNum> physRegDepMap;
 
+    /** A dependency on a trace record of another core. */
+    struct SyncDep
+    {
+        /** Id of the core that wrote the record */
+        uint32_t core;
+        /** Sequence number of the record in that core's trace */
+        InstSeqNum seqNum;
+    };
+
     /**
      * @defgroup TraceInfo Struct for a record in the instruction dependency
      * trace. All information required to process and calculate the
@@ -294,9 +320,13 @@ class ElasticTrace : public ProbeListenerObject
         Addr virtAddr;
         /* Request size in case of a load/store instruction */
         unsigned size;
+        /* Transaction id in case of an HTM record */
+        uint64_t htmUid;
+        /* Dependencies on records of other cores */
+        std::vector<SyncDep> syncDeps;
         /** Default Constructor */
         TraceInfo()
-          : type(Record::INVALID)
+          : type(Record::INVALID), htmUid(0)
         { }
         /** Is the record a load */
         bool isLoad() const { return (type == Record::LOAD); }
@@ -304,6 +334,13 @@ class ElasticTrace : public ProbeListenerObject
         bool isStore() const { return (type == Record::STORE); }
         /** Is the record a fetch triggering an Icache request */
         bool isComp() const { return (type == Record::COMP); }
+        /** Is the record a transaction start, commit or abort */
+        bool
+        isHtm() const
+        {
+            return (type == Record::HTM_START || type == Record::HTM_COMMIT ||
+                    type == Record::HTM_ABORT);
+        }
         /** Return string specifying the type of the node */
         const std::string& typeToStr() const;
         /** @} */
@@ -373,6 +410,30 @@ class ElasticTrace : public ProbeListenerObject
     /** Pointer to the O3CPU that is this listener's parent a.k.a. manager */
     CPU *cpu;
 
+    /** Id of the traced core, recorded in the trace header. */
+    uint32_t coreId;
+
+    /** Whether a traced transaction is open, i.e. started but not ended. */
+    bool inHtm;
+
+    /**
+     * Cache lines written by the open transaction. They become visible to
+     * other cores, and thus a source of sync dependencies, at its commit.
+     */
+    std::vector<Addr> htmWriteSet;
+
+    /**
+     * The latest record of each remote core that this core has a sync
+     * dependency on. Older records of that core are ordered by it already.
+     */
+    std::unordered_map<uint32_t, InstSeqNum> lastSyncDep;
+
+    /**
+     * The last record to make each cache line visible to other cores, shared
+     * by the elastic traces of all cores.
+     */
+    static std::unordered_map<Addr, SyncDep> lastWriter;
+
     /**
      * Add a record to the dependency trace depTrace which is a sequential
      * container. A record is inserted per committed instruction and in the same
@@ -419,6 +480,15 @@ class ElasticTrace : public ProbeListenerObject
      */
     void compDelayPhysRegDep(TraceInfo* past_record, TraceInfo* new_record);
 
+    /**
+     * Track the cache lines a new committed record makes visible to other
+     * cores and add a sync dependency if it is a load of a line last written
+     * by another core.
+     *
+     * @param new_record    pointer to new committed record
+     */
+    void updateSyncDep(TraceInfo* new_record);
+
     /**
      * Write out given number of records to the trace starting with the first
      * record in depTrace and iterating through the trace in sequence. A
@@ -544,6 +614,12 @@ class ElasticTrace : public ProbeListenerObject
         /** Number of filtered nodes */
         statistics::Scalar numFilteredNodes;
 
+        /** Number of transaction aborts recorded */
+        statistics::Scalar numHtmAborts;
+
+        /** Number of sync dependencies on records of other cores */
+        statistics::Scalar numSyncDep;
+
         /** Maximum number of dependents on any instruction */
         statistics::Scalar maxNumDependents;
 
@@ -45,6 +45,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
@@ -73,7 +74,8 @@ class ROB
 {
   public:
     typedef std::pair<RegIndex, RegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef CircularQueue<DynInstPtr> InstQueue;
+    typedef typename InstQueue::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status
@@ -286,8 +288,12 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[MaxThreads];
 
-    /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /** ROB List of Instructions. Each thread's instructions are held in a
+     *  fixed-capacity circular buffer sized to the whole ROB, as
+     *  instructions only ever leave the ROB from the head (retire) while
+     *  squashed instructions are drained through commit.
+     */
+    std::vector<InstQueue> instList;
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
@@ -309,7 +315,8 @@ class ROB
      *  when squashing, the instructions are marked as squashed but not
      *  immediately removed, meaning the tail iterator remains the same before
      *  and after a squash.
-     *  This will always be set to cpu->instList.end() if it is invalid.
+     *  This will always be set to a default constructed (null) iterator if
+     *  it is invalid.
      */
     InstIt squashIt[MaxThreads];
 
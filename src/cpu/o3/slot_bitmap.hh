@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_O3_SLOT_BITMAP_HH__
+#define __CPU_O3_SLOT_BITMAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Bitmap over the slots of a circular buffer. Besides plain set, clear
+ * and test, it can find the oldest set slot relative to the buffer's
+ * head, and enumerate all set slots, one word at a time.
+ */
+class SlotBitmap
+{
+  public:
+    static constexpr size_t NoSlot = static_cast<size_t>(-1);
+
+    SlotBitmap() = default;
+    explicit SlotBitmap(size_t slots) { resize(slots); }
+
+    void
+    resize(size_t slots)
+    {
+        numSlots = slots;
+        words.assign((slots + WordBits - 1) / WordBits, 0);
+    }
+
+    size_t size() const { return numSlots; }
+
+    void
+    set(size_t slot)
+    {
+        assert(slot < numSlots);
+        words[slot / WordBits] |= bit(slot);
+    }
+
+    void
+    clear(size_t slot)
+    {
+        assert(slot < numSlots);
+        words[slot / WordBits] &= ~bit(slot);
+    }
+
+    bool
+    test(size_t slot) const
+    {
+        assert(slot < numSlots);
+        return words[slot / WordBits] & bit(slot);
+    }
+
+    void
+    reset()
+    {
+        for (auto &word : words)
+            word = 0;
+    }
+
+    bool
+    none() const
+    {
+        for (auto word : words) {
+            if (word)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Find the oldest set slot that is at least age entries younger than
+     * head.
+     * @param head Slot holding the oldest entry of the circular buffer.
+     * @param age Number of entries after head to skip.
+     * @return The slot found, or NoSlot if there is none.
+     */
+    size_t
+    findOldest(size_t head, size_t age = 0) const
+    {
+        assert(head < numSlots);
+        if (age >= numSlots)
+            return NoSlot;
+
+        size_t start = head + age;
+        if (start < numSlots) {
+            size_t slot = findInRange(start, numSlots);
+            if (slot != NoSlot)
+                return slot;
+            return findInRange(0, head);
+        }
+        return findInRange(start - numSlots, head);
+    }
+
+    /** Number of entries between head and slot in the circular buffer. */
+    size_t
+    ageOf(size_t head, size_t slot) const
+    {
+        return slot >= head ? slot - head : slot + numSlots - head;
+    }
+
+    /** Call f on every set slot, in slot order, and clear them all. */
+    template <class F>
+    void
+    drain(F f)
+    {
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            words[w] = 0;
+            while (word) {
+                int b = ctz64(word);
+                word &= word - 1;
+                f(w * WordBits + b);
+            }
+        }
+    }
+
+  private:
+    static constexpr size_t WordBits = 64;
+
+    static uint64_t bit(size_t slot) { return 1ULL << (slot % WordBits); }
+
+    /** First set slot in [lo, hi), or NoSlot. */
+    size_t
+    findInRange(size_t lo, size_t hi) const
+    {
+        if (lo >= hi)
+            return NoSlot;
+
+        size_t w = lo / WordBits;
+        uint64_t word = words[w] & (~0ULL << (lo % WordBits));
+        const size_t last_w = (hi - 1) / WordBits;
+        while (true) {
+            if (word) {
+                size_t slot = w * WordBits + ctz64(word);
+                return slot < hi ? slot : NoSlot;
+            }
+            if (++w > last_w)
+                return NoSlot;
+            word = words[w];
+        }
+    }
+
+    size_t numSlots = 0;
+    std::vector<uint64_t> words;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_SLOT_BITMAP_HH__
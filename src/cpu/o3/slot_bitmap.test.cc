@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cpu/o3/slot_bitmap.hh"
+
+using namespace gem5;
+using o3::SlotBitmap;
+
+TEST(SlotBitmapTest, Empty)
+{
+    SlotBitmap bm(130);
+
+    ASSERT_EQ(bm.size(), 130);
+    ASSERT_TRUE(bm.none());
+    ASSERT_EQ(bm.findOldest(0), SlotBitmap::NoSlot);
+    ASSERT_EQ(bm.findOldest(77), SlotBitmap::NoSlot);
+}
+
+TEST(SlotBitmapTest, SetClearTest)
+{
+    SlotBitmap bm(130);
+
+    bm.set(0);
+    bm.set(64);
+    bm.set(129);
+    ASSERT_TRUE(bm.test(0));
+    ASSERT_TRUE(bm.test(64));
+    ASSERT_TRUE(bm.test(129));
+    ASSERT_FALSE(bm.test(1));
+    ASSERT_FALSE(bm.none());
+
+    bm.clear(64);
+    ASSERT_FALSE(bm.test(64));
+
+    bm.reset();
+    ASSERT_TRUE(bm.none());
+}
+
+/** The oldest slot is searched starting at the head and wrapping around. */
+TEST(SlotBitmapTest, FindOldestWraps)
+{
+    SlotBitmap bm(130);
+
+    bm.set(3);
+    bm.set(100);
+
+    ASSERT_EQ(bm.findOldest(0), 3);
+    ASSERT_EQ(bm.findOldest(4), 100);
+    ASSERT_EQ(bm.findOldest(101), 3);
+    ASSERT_EQ(bm.findOldest(100), 100);
+    ASSERT_EQ(bm.findOldest(3), 3);
+}
+
+/** Skipping entries from the head moves past the older slots. */
+TEST(SlotBitmapTest, FindOldestWithAge)
+{
+    SlotBitmap bm(130);
+
+    bm.set(3);
+    bm.set(100);
+    bm.set(120);
+
+    ASSERT_EQ(bm.findOldest(90, 0), 100);
+    ASSERT_EQ(bm.findOldest(90, 11), 120);
+    ASSERT_EQ(bm.findOldest(90, 31), 3);
+    ASSERT_EQ(bm.findOldest(90, 40), 3);
+    ASSERT_EQ(bm.findOldest(90, 54), SlotBitmap::NoSlot);
+    ASSERT_EQ(bm.findOldest(90, 130), SlotBitmap::NoSlot);
+
+    ASSERT_EQ(bm.ageOf(90, 100), 10);
+    ASSERT_EQ(bm.ageOf(90, 3), 43);
+}
+
+/** Compare the age ordered search against a brute force search. */
+TEST(SlotBitmapTest, FindOldestMatchesScan)
+{
+    const size_t size = 200;
+    SlotBitmap bm(size);
+    std::vector<bool> ref(size, false);
+
+    for (size_t i = 0; i < size; i += 7) {
+        bm.set(i);
+        ref[i] = true;
+    }
+
+    for (size_t head = 0; head < size; ++head) {
+        for (size_t age = 0; age < size; age += 5) {
+            size_t expected = SlotBitmap::NoSlot;
+            for (size_t a = age; a < size; ++a) {
+                if (ref[(head + a) % size]) {
+                    expected = (head + a) % size;
+                    break;
+                }
+            }
+            ASSERT_EQ(bm.findOldest(head, age), expected);
+        }
+    }
+}
+
+TEST(SlotBitmapTest, Drain)
+{
+    SlotBitmap bm(130);
+
+    bm.set(5);
+    bm.set(70);
+    bm.set(128);
+
+    std::vector<size_t> slots;
+    bm.drain([&](size_t slot) { slots.push_back(slot); });
+
+    ASSERT_EQ(slots, std::vector<size_t>({5, 70, 128}));
+    ASSERT_TRUE(bm.none());
+}
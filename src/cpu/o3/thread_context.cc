@@ -317,6 +317,12 @@ ThreadContext::getHtmCheckpointPtr()
 void
 ThreadContext::setHtmCheckpointPtr(BaseHTMCheckpointPtr new_cpt)
 {
+    // Commit reports each register remapped within a transaction (see
+    // Commit::commitHead), so checkpoints can be saved copy-on-write
+    HTM *htm = cpu->system->getHTM();
+    if (new_cpt)
+        new_cpt->setCopyOnWrite(!htm || htm->params().cow_register_checkpoint);
+
     thread->htmCheckpoint = std::move(new_cpt);
 }
 
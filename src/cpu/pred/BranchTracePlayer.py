@@ -0,0 +1,45 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import SimObject
+from m5.params import *
+
+class BranchTracePlayer(SimObject):
+    """Replays a branch trace captured by the BranchTrace probe through a
+    branch predictor, in commit order and without wrong-path effects, and
+    reports its mispredictions. Players can run in parallel on separate
+    event queues to evaluate many predictor configurations at once."""
+
+    type = 'BranchTracePlayer'
+    cxx_class = 'gem5::branch_prediction::BranchTracePlayer'
+    cxx_header = "cpu/pred/branch_trace_player.hh"
+
+    numThreads = Param.Unsigned(1, "Number of threads in the trace")
+    trace_file = Param.String("Branch trace (input) file")
+    branch_pred = Param.BranchPredictor("Branch predictor to evaluate")
+    batch_size = Param.Unsigned(10000, "Branches replayed per event")
+    max_insts = Param.UInt64(0, "Stop after replaying this number of "
+        "instructions (0 to replay the whole trace)")
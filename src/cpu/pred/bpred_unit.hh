@@ -44,6 +44,7 @@
 
 #include <deque>
 
+#include "base/random.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/pred/btb.hh"
@@ -319,6 +320,13 @@ class BPredUnit : public SimObject
     /** Number of bits to shift instructions by for predictor addresses. */
     const unsigned instShiftAmt;
 
+    /**
+     * Random numbers of the predictor. Each predictor has its own
+     * generator, so that its results don't depend on other users of
+     * random numbers, and predictors can run on separate host threads.
+     */
+    Random rng;
+
     /**
      * @{
      * @name PMU Probe points.
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace_player.hh"
+
+#include "base/logging.hh"
+#include "proto/branch.pb.h"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace
+{
+
+/**
+ * Stand-in for a traced control instruction. It only carries the
+ * control flags the predictors look at.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint32_t trace_flags)
+        : StaticInst("trace_branch", No_OpClass)
+    {
+        const bool cond = trace_flags & ProtoMessage::Branch::COND;
+        const bool direct = trace_flags & ProtoMessage::Branch::DIRECT;
+
+        flags[IsControl] = true;
+        flags[IsCondControl] = cond;
+        flags[IsUncondControl] = !cond;
+        flags[IsDirectControl] = direct;
+        flags[IsIndirectControl] = !direct;
+        flags[IsCall] = trace_flags & ProtoMessage::Branch::CALL;
+        flags[IsReturn] = trace_flags & ProtoMessage::Branch::RETURN;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Traced branches can't be executed");
+    }
+
+    void
+    advancePC(TheISA::PCState &pc_state) const override
+    {
+        pc_state.advance();
+    }
+
+    /** Calls are traced with their fall-through as next PC */
+    TheISA::PCState
+    buildRetPC(const TheISA::PCState &cur_pc,
+               const TheISA::PCState &call_pc) const override
+    {
+        TheISA::PCState ret_pc = call_pc;
+        ret_pc.advance();
+        return ret_pc;
+    }
+
+    std::string
+    generateDisassembly(Addr pc,
+                        const loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+std::atomic<unsigned> BranchTracePlayer::activePlayers(0);
+
+BranchTracePlayer::BranchTracePlayer(const BranchTracePlayerParams &p)
+    : SimObject(p), bpred(p.branch_pred), trace(p.trace_file),
+      numThreads(p.numThreads), batchSize(p.batch_size),
+      maxInsts(p.max_insts), seqNum(0), replayedInsts(0),
+      replayEvent([this]{ replay(); }, name()),
+      stats(this)
+{
+    fatal_if(batchSize == 0, "%s: batch_size must be positive", name());
+
+    ProtoMessage::BranchTraceHeader header;
+    fatal_if(!trace.read(header), "%s: failed to read the header of %s",
+             name(), p.trace_file);
+    fatal_if(header.ver() != 0, "%s: unsupported branch trace version %d",
+             name(), header.ver());
+    inform("%s: replaying the trace of %s", name(), header.obj_id());
+
+    ++activePlayers;
+}
+
+void
+BranchTracePlayer::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+const StaticInstPtr &
+BranchTracePlayer::branchInst(uint32_t flags)
+{
+    StaticInstPtr &inst = insts[flags & (insts.size() - 1)];
+    if (!inst)
+        inst = new TraceBranchInst(flags);
+    return inst;
+}
+
+void
+BranchTracePlayer::replay()
+{
+    ProtoMessage::Branch branch;
+    for (unsigned i = 0; i < batchSize; i++) {
+        if ((maxInsts && replayedInsts >= maxInsts) || !trace.read(branch)) {
+            done();
+            return;
+        }
+
+        const uint32_t flags = branch.flags();
+        const bool mispredicted = replayBranch(branch);
+
+        replayedInsts += branch.insts();
+        stats.insts += branch.insts();
+        ++stats.branches;
+        if (flags & ProtoMessage::Branch::COND)
+            ++stats.condBranches;
+
+        if (mispredicted) {
+            ++stats.mispredicted;
+            if (flags & ProtoMessage::Branch::COND)
+                ++stats.condMispredicted;
+            if (flags & ProtoMessage::Branch::RETURN)
+                ++stats.returnMispredicted;
+            else if (!(flags & ProtoMessage::Branch::DIRECT))
+                ++stats.indirectMispredicted;
+        }
+    }
+
+    schedule(replayEvent, curTick() + 1);
+}
+
+bool
+BranchTracePlayer::replayBranch(const ProtoMessage::Branch &branch)
+{
+    const ThreadID tid = branch.tid();
+    fatal_if(tid >= numThreads, "%s: branch of thread %d, but the trace "
+             "has %d threads", name(), tid, numThreads);
+
+    const StaticInstPtr &inst = branchInst(branch.flags());
+    const Addr fall_through = branch.pc() + branch.size();
+    const bool taken = branch.flags() & ProtoMessage::Branch::TAKEN;
+    const Addr next_pc = taken ? branch.target() : fall_through;
+
+    // Predict the branch as fetched, whose next PC is the fall-through,
+    // then resolve and commit it straight away
+    TheISA::PCState pc(branch.pc());
+    pc.npc(fall_through);
+
+    ++seqNum;
+    bpred->predict(inst, seqNum, pc, tid);
+
+    const bool mispredicted = pc.instAddr() != next_pc;
+    if (mispredicted)
+        bpred->squash(seqNum, TheISA::PCState(next_pc), taken, tid);
+    bpred->update(seqNum, tid);
+
+    return mispredicted;
+}
+
+void
+BranchTracePlayer::done()
+{
+    inform("%s: %d instructions, %d branches, %d mispredicted "
+           "(%.3f MPKI)", name(), replayedInsts, stats.branches.value(),
+           stats.mispredicted.value(), stats.mpki.total());
+
+    // Players on other event queues may still be running
+    if (--activePlayers == 0)
+        exitSimLoop("branch trace replay complete");
+}
+
+BranchTracePlayer::BranchTracePlayerStats::BranchTracePlayerStats(
+        statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(insts, statistics::units::Count::get(),
+               "Number of instructions replayed"),
+      ADD_STAT(branches, statistics::units::Count::get(),
+               "Number of branches replayed"),
+      ADD_STAT(condBranches, statistics::units::Count::get(),
+               "Number of conditional branches replayed"),
+      ADD_STAT(mispredicted, statistics::units::Count::get(),
+               "Number of mispredicted branches"),
+      ADD_STAT(condMispredicted, statistics::units::Count::get(),
+               "Number of mispredicted conditional branches"),
+      ADD_STAT(indirectMispredicted, statistics::units::Count::get(),
+               "Number of mispredicted indirect branches (but returns)"),
+      ADD_STAT(returnMispredicted, statistics::units::Count::get(),
+               "Number of mispredicted returns"),
+      ADD_STAT(mpki, statistics::units::Ratio::get(),
+               "Mispredicted branches per thousand instructions",
+               mispredicted * 1000 / insts),
+      ADD_STAT(mispredictRate, statistics::units::Ratio::get(),
+               "Fraction of branches mispredicted",
+               mispredicted / branches)
+{
+    mpki.precision(3);
+    mispredictRate.precision(4);
+}
+
+} // namespace branch_prediction
+} // namespace gem5
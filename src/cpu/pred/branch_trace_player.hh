@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_PLAYER_HH__
+#define __CPU_PRED_BRANCH_TRACE_PLAYER_HH__
+
+#include <array>
+#include <atomic>
+
+#include "base/statistics.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/static_inst.hh"
+#include "params/BranchTracePlayer.hh"
+#include "proto/protoio.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace ProtoMessage
+{
+class Branch;
+}
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Replays a branch trace captured by the BranchTrace probe through a
+ * branch predictor, to evaluate predictor configurations without
+ * simulating the CPU. Branches are predicted, squashed when
+ * mispredicted and updated in commit order, as in a simple CPU, so
+ * there are no wrong-path effects.
+ *
+ * The predictor sees synthetic static instructions carrying the control
+ * flags of the traced ones. The trace is replayed in batches of events,
+ * and the simulation loop exits once all the players in the system are
+ * done, so that players on different event queues run in parallel.
+ * Each predictor has its own random number generator, so parallel
+ * players get the same results as a lone one.
+ */
+class BranchTracePlayer : public SimObject
+{
+  public:
+    BranchTracePlayer(const BranchTracePlayerParams &p);
+
+    void startup() override;
+
+  private:
+    /** Replay a batch of branches */
+    void replay();
+
+    /** Replay a branch, returns whether it was mispredicted */
+    bool replayBranch(const ProtoMessage::Branch &branch);
+
+    /** Static instruction for the given trace flags */
+    const StaticInstPtr &branchInst(uint32_t flags);
+
+    /** Called once the trace is over */
+    void done();
+
+    BPredUnit *bpred;
+    ProtoInputStream trace;
+    const unsigned numThreads;
+    const unsigned batchSize;
+    const uint64_t maxInsts;
+
+    /** Sequence number of the last branch replayed */
+    InstSeqNum seqNum;
+    /** Instructions replayed so far */
+    uint64_t replayedInsts;
+
+    /** Static instructions per combination of control flags */
+    std::array<StaticInstPtr, 16> insts;
+
+    EventFunctionWrapper replayEvent;
+
+    /** Number of players still replaying their traces */
+    static std::atomic<unsigned> activePlayers;
+
+    struct BranchTracePlayerStats : public statistics::Group
+    {
+        BranchTracePlayerStats(statistics::Group *parent);
+
+        statistics::Scalar insts;
+        statistics::Scalar branches;
+        statistics::Scalar condBranches;
+        statistics::Scalar mispredicted;
+        statistics::Scalar condMispredicted;
+        statistics::Scalar indirectMispredicted;
+        statistics::Scalar returnMispredicted;
+        statistics::Formula mpki;
+        statistics::Formula mispredictRate;
+    } stats;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_BRANCH_TRACE_PLAYER_HH__
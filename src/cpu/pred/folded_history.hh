@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_FOLDED_HISTORY_HH__
+#define __CPU_PRED_FOLDED_HISTORY_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Folded (compressed) global histories of a set of tables, to mix with
+ * the instruction PC to index and tag partially tagged tables.
+ *
+ * They are kept as a structure of arrays so that a new history bit
+ * updates all of them in a single loop the compiler can vectorize.
+ * Entries that are never initialized stay zero.
+ */
+struct FoldedHistories
+{
+    std::vector<unsigned> comp;
+    std::vector<int> compLength;
+    std::vector<int> origLength;
+    std::vector<int> outpoint;
+    std::vector<unsigned> compMask;
+
+    void
+    resize(unsigned size)
+    {
+        comp.assign(size, 0);
+        compLength.assign(size, 0);
+        origLength.assign(size, 0);
+        outpoint.assign(size, 0);
+        compMask.assign(size, 0);
+    }
+
+    unsigned size() const { return comp.size(); }
+
+    void
+    init(unsigned i, int original_length, int compressed_length)
+    {
+        origLength[i] = original_length;
+        compLength[i] = compressed_length;
+        outpoint[i] = original_length % compressed_length;
+        compMask[i] = (1ULL << compressed_length) - 1;
+    }
+
+    /**
+     * Shifts the most recent outcome in and the one leaving each history
+     * out.
+     * @param h Global history, most recent outcome first
+     */
+    void
+    update(const uint8_t *h)
+    {
+        const unsigned n = size();
+        unsigned *c = comp.data();
+        const int *comp_length = compLength.data();
+        const int *orig_length = origLength.data();
+        const int *out_point = outpoint.data();
+        const unsigned *mask = compMask.data();
+        const unsigned newest = h[0];
+
+        for (unsigned i = 0; i < n; i++) {
+            unsigned v = (c[i] << 1) | newest;
+            v ^= unsigned(h[orig_length[i]]) << out_point[i];
+            v ^= v >> comp_length[i];
+            c[i] = v & mask[i];
+        }
+    }
+};
+
+/**
+ * Per table constants of the TAGE index hash, computed once instead of
+ * on every lookup. Entry 0, the bimodal table, is left zero.
+ */
+struct TageIndexConstants
+{
+    /** Bits of the path history hashed into the index of each table */
+    std::vector<int> pathHistLengths;
+    /** Shift of the PC folded onto itself in the index of each table */
+    std::vector<int> pcShifts;
+
+    void
+    init(int num_tables, const int *hist_lengths,
+         const int *log_table_sizes, int path_hist_bits)
+    {
+        pathHistLengths.assign(num_tables + 1, 0);
+        pcShifts.assign(num_tables + 1, 0);
+        for (int i = 1; i <= num_tables; i++) {
+            pathHistLengths[i] = std::min(hist_lengths[i], path_hist_bits);
+            pcShifts[i] = std::abs(log_table_sizes[i] - i) + 1;
+        }
+    }
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_FOLDED_HISTORY_HH__
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/folded_history.hh"
+
+using namespace gem5;
+using branch_prediction::FoldedHistories;
+using branch_prediction::TageIndexConstants;
+
+namespace
+{
+
+/** One folded history updated on its own, as TAGE used to */
+struct ReferenceFoldedHistory
+{
+    unsigned comp = 0;
+    int compLength;
+    int origLength;
+    int outpoint;
+
+    ReferenceFoldedHistory(int original_length, int compressed_length)
+        : compLength(compressed_length), origLength(original_length),
+          outpoint(original_length % compressed_length)
+    {}
+
+    void
+    update(const uint8_t *h)
+    {
+        comp = (comp << 1) | h[0];
+        comp ^= h[origLength] << outpoint;
+        comp ^= (comp >> compLength);
+        comp &= (1ULL << compLength) - 1;
+    }
+};
+
+/** Shifts an outcome into a global history, most recent first */
+void
+pushOutcome(std::vector<uint8_t> &hist, bool taken)
+{
+    hist.pop_back();
+    hist.insert(hist.begin(), taken);
+}
+
+/** A TAGE configuration, with the parameters its hashes depend on */
+struct TageConfig
+{
+    int nHistoryTables;
+    int minHist;
+    int maxHist;
+    std::vector<int> tagTableTagWidths;
+    std::vector<int> logTagTableSizes;
+    int pathHistBits;
+    int instShiftAmt;
+
+    std::vector<int> histLengths;
+
+    /** Geometric history lengths, as TAGEBase::calculateParameters */
+    void
+    calculateParameters()
+    {
+        histLengths.assign(nHistoryTables + 1, 0);
+        histLengths[1] = minHist;
+        histLengths[nHistoryTables] = maxHist;
+        for (int i = 2; i <= nHistoryTables; i++) {
+            histLengths[i] = (int) (((double) minHist *
+                pow((double) (maxHist) / (double) minHist,
+                    (double) (i - 1) / (double) ((nHistoryTables - 1))))
+                + 0.5);
+        }
+    }
+
+    /** Path history hash, as TAGEBase::F */
+    int
+    F(int A, int size, int bank) const
+    {
+        int A1, A2;
+
+        A = A & ((1ULL << size) - 1);
+        A1 = (A & ((1ULL << logTagTableSizes[bank]) - 1));
+        A2 = (A >> logTagTableSizes[bank]);
+        A2 = ((A2 << bank) & ((1ULL << logTagTableSizes[bank]) - 1))
+           + (A2 >> (logTagTableSizes[bank] - bank));
+        A = A1 ^ A2;
+        A = ((A << bank) & ((1ULL << logTagTableSizes[bank]) - 1))
+          + (A >> (logTagTableSizes[bank] - bank));
+        return (A);
+    }
+};
+
+/**
+ * The folded histories and hashes of TAGE as they were computed before
+ * FoldedHistories and TageIndexConstants, one history at a time
+ */
+struct ReferenceTage
+{
+    const TageConfig &cfg;
+    std::vector<ReferenceFoldedHistory> computeIndices;
+    std::vector<ReferenceFoldedHistory> computeTags[2];
+
+    ReferenceTage(const TageConfig &c)
+        : cfg(c)
+    {
+        // Table 0 is the bimodal one, whose histories are never used
+        computeIndices.emplace_back(1, 1);
+        computeTags[0].emplace_back(1, 1);
+        computeTags[1].emplace_back(1, 1);
+        for (int i = 1; i <= cfg.nHistoryTables; i++) {
+            computeIndices.emplace_back(cfg.histLengths[i],
+                                        cfg.logTagTableSizes[i]);
+            computeTags[0].emplace_back(computeIndices[i].origLength,
+                                        cfg.tagTableTagWidths[i]);
+            computeTags[1].emplace_back(computeIndices[i].origLength,
+                                        cfg.tagTableTagWidths[i] - 1);
+        }
+    }
+
+    void
+    update(const uint8_t *h)
+    {
+        for (int i = 1; i <= cfg.nHistoryTables; i++) {
+            computeIndices[i].update(h);
+            computeTags[0][i].update(h);
+            computeTags[1][i].update(h);
+        }
+    }
+
+    int
+    gindex(Addr pc, int path_hist, int bank) const
+    {
+        int index;
+        int hlen = (cfg.histLengths[bank] > cfg.pathHistBits) ?
+            cfg.pathHistBits : cfg.histLengths[bank];
+        const unsigned int shiftedPc = pc >> cfg.instShiftAmt;
+        index =
+            shiftedPc ^
+            (shiftedPc >>
+             ((int) abs(cfg.logTagTableSizes[bank] - bank) + 1)) ^
+            computeIndices[bank].comp ^
+            cfg.F(path_hist, hlen, bank);
+
+        return (index & ((1ULL << (cfg.logTagTableSizes[bank])) - 1));
+    }
+
+    uint16_t
+    gtag(Addr pc, int bank) const
+    {
+        int tag = (pc >> cfg.instShiftAmt) ^
+                  computeTags[0][bank].comp ^
+                  (computeTags[1][bank].comp << 1);
+
+        return (tag & ((1ULL << cfg.tagTableTagWidths[bank]) - 1));
+    }
+};
+
+/** The folded histories and hashes of TAGEBase as they are now */
+struct Tage
+{
+    const TageConfig &cfg;
+    FoldedHistories computeIndices;
+    FoldedHistories computeTags[2];
+    TageIndexConstants indexConstants;
+
+    Tage(const TageConfig &c)
+        : cfg(c)
+    {
+        computeIndices.resize(cfg.nHistoryTables + 1);
+        computeTags[0].resize(cfg.nHistoryTables + 1);
+        computeTags[1].resize(cfg.nHistoryTables + 1);
+        for (int i = 1; i <= cfg.nHistoryTables; i++) {
+            computeIndices.init(
+                i, cfg.histLengths[i], cfg.logTagTableSizes[i]);
+            computeTags[0].init(
+                i, cfg.histLengths[i], cfg.tagTableTagWidths[i]);
+            computeTags[1].init(
+                i, cfg.histLengths[i], cfg.tagTableTagWidths[i] - 1);
+        }
+        indexConstants.init(cfg.nHistoryTables, cfg.histLengths.data(),
+                            cfg.logTagTableSizes.data(), cfg.pathHistBits);
+    }
+
+    void
+    update(const uint8_t *h)
+    {
+        computeIndices.update(h);
+        computeTags[0].update(h);
+        computeTags[1].update(h);
+    }
+
+    int
+    gindex(Addr pc, int path_hist, int bank) const
+    {
+        int index;
+        const unsigned int shiftedPc = pc >> cfg.instShiftAmt;
+        index =
+            shiftedPc ^
+            (shiftedPc >> indexConstants.pcShifts[bank]) ^
+            computeIndices.comp[bank] ^
+            cfg.F(path_hist, indexConstants.pathHistLengths[bank], bank);
+
+        return (index & ((1ULL << (cfg.logTagTableSizes[bank])) - 1));
+    }
+
+    uint16_t
+    gtag(Addr pc, int bank) const
+    {
+        int tag = (pc >> cfg.instShiftAmt) ^
+                  computeTags[0].comp[bank] ^
+                  (computeTags[1].comp[bank] << 1);
+
+        return (tag & ((1ULL << cfg.tagTableTagWidths[bank]) - 1));
+    }
+};
+
+/**
+ * Runs a fixed branch stream, a few loops and data dependent branches,
+ * through both TAGE hashes and checks they index and tag the same
+ * entries of every table
+ */
+void
+checkTageHashes(TageConfig cfg)
+{
+    cfg.calculateParameters();
+    ReferenceTage reference(cfg);
+    Tage tage(cfg);
+
+    std::vector<uint8_t> ghist(cfg.maxHist + 1, 0);
+    int path_hist = 0;
+
+    std::mt19937 gen(0x7a6e);
+    std::uniform_int_distribution<int> site(0, 63);
+    std::bernoulli_distribution data_taken(0.3);
+    for (int n = 0; n < 20000; n++) {
+        const int s = site(gen);
+        const Addr pc = 0x400000 + s * 0x34;
+        const bool taken = (s < 16) ? (n % (s + 2)) != 0 : data_taken(gen);
+
+        for (int bank = 1; bank <= cfg.nHistoryTables; bank++) {
+            ASSERT_EQ(tage.gindex(pc, path_hist, bank),
+                      reference.gindex(pc, path_hist, bank));
+            ASSERT_EQ(tage.gtag(pc, bank), reference.gtag(pc, bank));
+        }
+
+        // As TAGEBase::updateHistories
+        pushOutcome(ghist, taken);
+        path_hist = (path_hist << 1) + ((pc >> cfg.instShiftAmt) & 1);
+        path_hist = path_hist & ((1ULL << cfg.pathHistBits) - 1);
+        tage.update(ghist.data());
+        reference.update(ghist.data());
+    }
+}
+
+} // anonymous namespace
+
+TEST(FoldedHistoriesTest, Empty)
+{
+    FoldedHistories histories;
+    histories.resize(4);
+
+    const std::vector<uint8_t> hist(16, 1);
+    for (int i = 0; i < 10; i++)
+        histories.update(hist.data());
+
+    // Uninitialized entries stay zero
+    for (unsigned i = 0; i < histories.size(); i++)
+        ASSERT_EQ(histories.comp[i], 0);
+}
+
+TEST(FoldedHistoriesTest, MatchesReference)
+{
+    // Geometric history lengths folded into index and tag widths, like
+    // those of the TAGE configurations
+    const std::vector<int> orig_lengths =
+        {4, 6, 10, 16, 25, 40, 64, 101, 160, 254, 403, 640, 1016, 2000};
+    const std::vector<int> comp_lengths =
+        {10, 10, 11, 11, 12, 12, 13, 13, 16, 16, 15, 15, 23, 8};
+
+    FoldedHistories histories;
+    histories.resize(orig_lengths.size() + 1);
+    std::vector<ReferenceFoldedHistory> reference;
+    for (int i = 0; i < orig_lengths.size(); i++) {
+        histories.init(i + 1, orig_lengths[i], comp_lengths[i]);
+        reference.emplace_back(orig_lengths[i], comp_lengths[i]);
+    }
+
+    std::vector<uint8_t> hist(orig_lengths.back() + 1, 0);
+    std::mt19937 gen(0x7a6e);
+    std::bernoulli_distribution taken(0.6);
+    for (int n = 0; n < 20000; n++) {
+        pushOutcome(hist, taken(gen));
+        histories.update(hist.data());
+        for (auto &ref : reference)
+            ref.update(hist.data());
+
+        ASSERT_EQ(histories.comp[0], 0);
+        for (int i = 0; i < reference.size(); i++)
+            ASSERT_EQ(histories.comp[i + 1], reference[i].comp);
+    }
+}
+
+TEST(FoldedHistoriesTest, TageIndexConstants)
+{
+    const int hist_lengths[] = {0, 5, 9, 16, 40};
+    const int log_sizes[] = {13, 9, 3, 10, 4};
+
+    TageIndexConstants constants;
+    constants.init(4, hist_lengths, log_sizes, 16);
+
+    const std::vector<int> path_hist_lengths = {0, 5, 9, 16, 16};
+    const std::vector<int> pc_shifts = {0, 9, 2, 8, 1};
+    ASSERT_EQ(constants.pathHistLengths, path_hist_lengths);
+    ASSERT_EQ(constants.pcShifts, pc_shifts);
+}
+
+TEST(FoldedHistoriesTest, TageHashesMatchReference)
+{
+    // TAGE
+    checkTageHashes({7, 5, 130, {0, 9, 9, 10, 10, 11, 11, 12},
+                     {13, 9, 9, 9, 9, 9, 9, 9}, 16, 2});
+}
+
+TEST(FoldedHistoriesTest, LTageHashesMatchReference)
+{
+    // LTAGE_TAGE
+    checkTageHashes({12, 4, 640,
+                     {0, 7, 7, 8, 8, 9, 10, 11, 12, 12, 13, 14, 15},
+                     {14, 10, 10, 11, 11, 11, 11, 10, 10, 10, 10, 9, 9},
+                     16, 2});
+}
@@ -34,6 +34,7 @@
 #ifndef __CPU_PRED_LOOP_PREDICTOR_HH__
 #define __CPU_PRED_LOOP_PREDICTOR_HH__
 
+#include "base/random.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "sim/sim_object.hh"
@@ -49,6 +50,9 @@ namespace branch_prediction
 class LoopPredictor : public SimObject
 {
   protected:
+    /** Random numbers of this loop predictor, see BPredUnit::rng. */
+    mutable Random rng;
+
     const unsigned logSizeLoopPred;
     const unsigned loopTableAgeBits;
     const unsigned loopTableConfidenceBits;
@@ -38,7 +38,8 @@
 
 #include "cpu/pred/multiperspective_perceptron.hh"
 
-#include "base/random.hh"
+#include <algorithm>
+
 #include "debug/Branch.hh"
 
 namespace gem5
@@ -150,6 +151,13 @@ MultiperspectivePerceptron::init()
     for (auto &spec : specs) {
         // initial assignation of values
         table_sizes.push_back(spec->size);
+
+        // apply the transfer function and the coefficient once
+        if (spec->width == 5) {
+            featureSums.addTable(spec->coeff, xlat4, 16);
+        } else {
+            featureSums.addTable(spec->coeff, xlat, 32);
+        }
     }
 
     // Update bit requirements and runtime values
@@ -332,9 +340,15 @@ MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
     // branch
     findBest(tid, best_preds);
 
-    // begin computation of the sum for low-confidence branch
-    int bestval = 0;
+    // mark the good features, whose values also go into bestval
+    featureSums.clearBest();
+    if (threshold >= 0) {
+        featureSums.markBest(best_preds,
+                             std::min(nbest, (int) best_preds.size()));
+    }
 
+    // gather the value of each feature
+    const unsigned sign_bit = bi.getHPC() % n_sign_bits;
     for (int i = 0; i < specs.size(); i += 1) {
         HistorySpec const &spec = *specs[i];
         // get the hash to index the table
@@ -342,28 +356,14 @@ MultiperspectivePerceptron::computeOutput(ThreadID tid, MPPBranchInfo &bi)
         // add the weight; first get the weight's magnitude
         int counter = threadData[tid]->tables[i][hashed_idx];
         // get the sign
-        bool sign =
-          threadData[tid]->sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
-        // apply the transfer function and multiply by a coefficient
-        int weight = spec.coeff * ((spec.width == 5) ?
-                                   xlat4[counter] : xlat[counter]);
-        // apply the sign
-        int val = sign ? -weight : weight;
-        // add the value
-        bi.yout += val;
-        // if this is one of those good features, add the value to bestval
-        if (threshold >= 0) {
-            for (int j = 0;
-                 j < std::min(nbest, (int) best_preds.size());
-                 j += 1)
-            {
-                if (best_preds[j] == i) {
-                    bestval += val;
-                    break;
-                }
-            }
-        }
+        bool sign = threadData[tid]->sign_bits[i][hashed_idx][sign_bit];
+        // apply the transfer function, the coefficient and the sign
+        featureSums.set(i, counter, sign);
     }
+
+    // then add them up
+    int bestval;
+    bi.yout += featureSums.sum(bestval);
     // apply a fudge factor to affect when training is triggered
     bi.yout *= fudge;
     return bestval;
@@ -428,8 +428,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
             unsigned int hashed_idx = getIndex(tid, bi, spec, i);
             bool sign = sign_bits[i][hashed_idx][bi.getHPC() % n_sign_bits];
             int counter = tables[i][hashed_idx];
-            int weight = spec.coeff * ((spec.width == 5) ?
-                                       xlat4[counter] : xlat[counter]);
+            int weight = featureSums.weight(i, counter);
             if (sign) weight = -weight;
             bool pred = weight >= 1;
             if (pred != taken) {
@@ -501,7 +500,7 @@ MultiperspectivePerceptron::train(ThreadID tid, MPPBranchInfo &bi, bool taken)
             do {
                 // udpate a random weight
                 int besti = -1;
-                int nrand = random_mt.random<int>() % specs.size();
+                int nrand = rng.random<int>() % specs.size();
                 int pout;
                 found = false;
                 for (int j = 0; j < specs.size(); j += 1) {
@@ -663,7 +662,7 @@ MultiperspectivePerceptron::update(ThreadID tid, Addr instPC, bool taken,
         // filter, blow a random filter entry away
         if (decay && transition &&
             ((threadData[tid]->occupancy > decay) || (decay == 1))) {
-            int rnd = random_mt.random<int>() %
+            int rnd = rng.random<int>() %
                       threadData[tid]->filterTable.size();
             FilterEntry &frand = threadData[tid]->filterTable[rnd];
             if (frand.seenTaken && frand.seenUntaken) {
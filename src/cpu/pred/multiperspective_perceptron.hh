@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/perceptron_sums.hh"
 #include "params/MultiperspectivePerceptron.hh"
 
 namespace gem5
@@ -361,6 +362,8 @@ class MultiperspectivePerceptron : public BPredUnit
     /** Predictor tables */
     std::vector<HistorySpec *> specs;
     std::vector<int> table_sizes;
+    /** Sums of the weights the features select */
+    PerceptronSums featureSums;
 
     /** runtime values and data used to count the size in bits */
     bool doing_local;
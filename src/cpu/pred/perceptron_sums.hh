@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PRED_PERCEPTRON_SUMS_HH__
+#define __CPU_PRED_PERCEPTRON_SUMS_HH__
+
+#include <algorithm>
+#include <vector>
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+/**
+ * Adds up the weights selected by the features of a perceptron, and
+ * those of the subset of features used for low-confidence branches.
+ *
+ * The signed weights are gathered into an array first, and then reduced
+ * with a mask marking the subset, in a loop the compiler can vectorize.
+ * The transfer function of each table is scaled by its coefficient once,
+ * when the table is added.
+ */
+class PerceptronSums
+{
+  public:
+    /**
+     * Adds a table whose counters select coeff * weights[counter]
+     * @param coeff Coefficient of the table
+     * @param weights Transfer function, indexed by counter
+     * @param num_weights Number of counter values
+     */
+    void
+    addTable(double coeff, const int *weights, int num_weights)
+    {
+        scaledWeights.emplace_back(num_weights);
+        for (int i = 0; i < num_weights; i += 1) {
+            scaledWeights.back()[i] = coeff * weights[i];
+        }
+        values.push_back(0);
+        bestMask.push_back(0);
+    }
+
+    unsigned size() const { return values.size(); }
+
+    /** Scaled weight a counter of table i selects, before the sign */
+    int
+    weight(unsigned i, int counter) const
+    {
+        return scaledWeights[i][counter];
+    }
+
+    /** Leaves all the features out of the low-confidence sum */
+    void clearBest() { std::fill(bestMask.begin(), bestMask.end(), 0); }
+
+    /** Adds the first num_best features listed to the low-confidence sum */
+    void
+    markBest(const std::vector<int> &best, int num_best)
+    {
+        for (int j = 0; j < num_best; j += 1) {
+            bestMask[best[j]] = ~0;
+        }
+    }
+
+    /** Sets the value of feature i from its counter and sign */
+    void
+    set(unsigned i, int counter, bool sign)
+    {
+        const int w = weight(i, counter);
+        values[i] = sign ? -w : w;
+    }
+
+    /**
+     * Adds up the values of the features
+     * @param bestval Sum of the values of the best features
+     * @return Sum of the values of all the features
+     */
+    int
+    sum(int &bestval) const
+    {
+        const unsigned n = size();
+        const int *v = values.data();
+        const int *mask = bestMask.data();
+        int total = 0;
+        int best = 0;
+        for (unsigned i = 0; i < n; i += 1) {
+            total += v[i];
+            best += v[i] & mask[i];
+        }
+        bestval = best;
+        return total;
+    }
+
+  private:
+    /** Transfer function of each table, scaled by its coefficient */
+    std::vector<std::vector<int>> scaledWeights;
+    /** Signed weight selected by each feature in the last prediction */
+    std::vector<int> values;
+    /** All ones for the features used for low-confidence branches */
+    std::vector<int> bestMask;
+};
+
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_PERCEPTRON_SUMS_HH__
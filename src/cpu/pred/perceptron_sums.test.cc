@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "cpu/pred/perceptron_sums.hh"
+
+using namespace gem5;
+using branch_prediction::PerceptronSums;
+
+namespace
+{
+
+// Transfer functions of MultiperspectivePerceptron
+const int xlat[] =
+    {1,3,4,5,7,8,9,11,12,14,15,17,19,21,23,25,27,29,32,34,37,41,45,49,53,58,63,
+     69,76,85,94,106,};
+const int xlat4[] =
+    {0,4,5,7,9,11,12,14,16,17,19,22,28,33,39,45,};
+
+struct Table
+{
+    double coeff;
+    int width;
+};
+
+/** Features of a prediction, as MultiperspectivePerceptron sees them */
+struct Features
+{
+    std::vector<int> counters;
+    std::vector<std::vector<bool>> signBits;
+    unsigned hpc;
+    std::vector<int> bestPreds;
+};
+
+/**
+ * The sums of MultiperspectivePerceptron::computeOutput, as they were
+ * computed before PerceptronSums, table by table
+ */
+int
+referenceOutput(const std::vector<Table> &tables, const Features &f,
+                int threshold, int nbest, int n_sign_bits, int &yout)
+{
+    int bestval = 0;
+    for (int i = 0; i < tables.size(); i += 1) {
+        const Table &spec = tables[i];
+        int counter = f.counters[i];
+        bool sign = f.signBits[i][f.hpc % n_sign_bits];
+        int weight = spec.coeff * ((spec.width == 5) ?
+                                   xlat4[counter] : xlat[counter]);
+        int val = sign ? -weight : weight;
+        yout += val;
+        if (threshold >= 0) {
+            for (int j = 0;
+                 j < std::min(nbest, (int) f.bestPreds.size());
+                 j += 1)
+            {
+                if (f.bestPreds[j] == i) {
+                    bestval += val;
+                    break;
+                }
+            }
+        }
+    }
+    return bestval;
+}
+
+/** The sums as computeOutput gets them from PerceptronSums */
+int
+perceptronOutput(PerceptronSums &sums, const Features &f, int threshold,
+                 int nbest, int n_sign_bits, int &yout)
+{
+    sums.clearBest();
+    if (threshold >= 0) {
+        sums.markBest(f.bestPreds,
+                      std::min(nbest, (int) f.bestPreds.size()));
+    }
+    const unsigned sign_bit = f.hpc % n_sign_bits;
+    for (int i = 0; i < sums.size(); i += 1)
+        sums.set(i, f.counters[i], f.signBits[i][sign_bit]);
+
+    int bestval;
+    yout += sums.sum(bestval);
+    return bestval;
+}
+
+} // anonymous namespace
+
+TEST(PerceptronSumsTest, ScaledWeights)
+{
+    PerceptronSums sums;
+    sums.addTable(1.0, xlat, 32);
+    sums.addTable(0.75, xlat4, 16);
+    ASSERT_EQ(sums.size(), 2);
+
+    for (int c = 0; c < 32; c++)
+        ASSERT_EQ(sums.weight(0, c), xlat[c]);
+    // Scaled weights are truncated, as they used to be on every use
+    for (int c = 0; c < 16; c++)
+        ASSERT_EQ(sums.weight(1, c), int(0.75 * xlat4[c]));
+}
+
+TEST(PerceptronSumsTest, NoBestFeatures)
+{
+    PerceptronSums sums;
+    for (int i = 0; i < 4; i++)
+        sums.addTable(1.0, xlat, 32);
+    for (int i = 0; i < 4; i++)
+        sums.set(i, 31, i & 1);
+
+    int bestval = 1;
+    ASSERT_EQ(sums.sum(bestval), 0);
+    ASSERT_EQ(bestval, 0);
+
+    sums.markBest({2, 0}, 2);
+    ASSERT_EQ(sums.sum(bestval), 0);
+    ASSERT_EQ(bestval, 2 * xlat[31]);
+
+    sums.clearBest();
+    sums.sum(bestval);
+    ASSERT_EQ(bestval, 0);
+}
+
+/**
+ * Runs a fixed stream of predictions through the sums computeOutput
+ * used to compute and through PerceptronSums, with tables of both
+ * widths and fractional coefficients, as the MPP configurations have
+ */
+TEST(PerceptronSumsTest, MatchesReference)
+{
+    const int n_sign_bits = 2;
+    const int nbest = 20;
+    std::mt19937 gen(0x3f1a);
+
+    std::vector<Table> tables;
+    PerceptronSums sums;
+    std::uniform_int_distribution<int> coeff_dist(1, 40);
+    for (int i = 0; i < 37; i++) {
+        Table t{coeff_dist(gen) / 16.0, (i % 3) ? 6 : 5};
+        tables.push_back(t);
+        if (t.width == 5)
+            sums.addTable(t.coeff, xlat4, 16);
+        else
+            sums.addTable(t.coeff, xlat, 32);
+    }
+
+    std::bernoulli_distribution coin(0.5);
+    std::uniform_int_distribution<unsigned> hpc_dist;
+    for (int n = 0; n < 10000; n++) {
+        Features f;
+        f.hpc = hpc_dist(gen);
+        for (const auto &t : tables) {
+            const int num_weights = (t.width == 5) ? 16 : 32;
+            f.counters.push_back(gen() % num_weights);
+            f.signBits.push_back({coin(gen), coin(gen)});
+        }
+        // findBest ranks all the tables by their mispredictions
+        f.bestPreds.resize(tables.size());
+        for (int i = 0; i < tables.size(); i++)
+            f.bestPreds[i] = i;
+        std::shuffle(f.bestPreds.begin(), f.bestPreds.end(), gen);
+
+        // A negative threshold disables the low-confidence sum
+        const int threshold = (n % 5) ? 1 : -1;
+
+        int ref_yout = n;
+        const int ref_bestval = referenceOutput(tables, f, threshold, nbest,
+                                                n_sign_bits, ref_yout);
+        int yout = n;
+        const int bestval = perceptronOutput(sums, f, threshold, nbest,
+                                             n_sign_bits, yout);
+
+        ASSERT_EQ(yout, ref_yout);
+        ASSERT_EQ(bestval, ref_bestval);
+    }
+}
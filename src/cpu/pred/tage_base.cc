@@ -126,10 +126,13 @@ TAGEBase::init()
     // implementation
     assert(tagTableTagWidths[0] == 0);
 
+    indexConstants.init(nHistoryTables, histLengths,
+                        logTagTableSizes.data(), pathHistBits);
+
     for (auto& history : threadHistory) {
-        history.computeIndices = new FoldedHistory[nHistoryTables+1];
-        history.computeTags[0] = new FoldedHistory[nHistoryTables+1];
-        history.computeTags[1] = new FoldedHistory[nHistoryTables+1];
+        history.computeIndices.resize(nHistoryTables + 1);
+        history.computeTags[0].resize(nHistoryTables + 1);
+        history.computeTags[1].resize(nHistoryTables + 1);
 
         initFoldedHistories(history);
     }
@@ -151,12 +154,12 @@ void
 TAGEBase::initFoldedHistories(ThreadHistory & history)
 {
     for (int i = 1; i <= nHistoryTables; i++) {
-        history.computeIndices[i].init(
-            histLengths[i], (logTagTableSizes[i]));
-        history.computeTags[0][i].init(
-            history.computeIndices[i].origLength, tagTableTagWidths[i]);
-        history.computeTags[1][i].init(
-            history.computeIndices[i].origLength, tagTableTagWidths[i]-1);
+        history.computeIndices.init(
+            i, histLengths[i], (logTagTableSizes[i]));
+        history.computeTags[0].init(
+            i, histLengths[i], tagTableTagWidths[i]);
+        history.computeTags[1].init(
+            i, histLengths[i], tagTableTagWidths[i]-1);
         DPRINTF(Tage, "HistLength:%d, TTSize:%d, TTTWidth:%d\n",
                 histLengths[i], logTagTableSizes[i], tagTableTagWidths[i]);
     }
@@ -193,13 +196,11 @@ TAGEBase::btbUpdate(ThreadID tid, Addr branch_pc, BranchInfo* &bi)
         assert(tHist.gHist == &tHist.globalHistory[tHist.ptGhist]);
         tHist.gHist[0] = 0;
         for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].comp = bi->ci[i];
-            tHist.computeTags[0][i].comp = bi->ct0[i];
-            tHist.computeTags[1][i].comp = bi->ct1[i];
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
+            tHist.computeIndices.comp[i] = bi->ci[i];
+            tHist.computeTags[0].comp[i] = bi->ct0[i];
+            tHist.computeTags[1].comp[i] = bi->ct1[i];
         }
+        tHist.updateFoldedHistories();
     }
 }
 
@@ -230,14 +231,13 @@ int
 TAGEBase::gindex(ThreadID tid, Addr pc, int bank) const
 {
     int index;
-    int hlen = (histLengths[bank] > pathHistBits) ? pathHistBits :
-                                                    histLengths[bank];
     const unsigned int shiftedPc = pc >> instShiftAmt;
     index =
         shiftedPc ^
-        (shiftedPc >> ((int) abs(logTagTableSizes[bank] - bank) + 1)) ^
-        threadHistory[tid].computeIndices[bank].comp ^
-        F(threadHistory[tid].pathHist, hlen, bank);
+        (shiftedPc >> indexConstants.pcShifts[bank]) ^
+        threadHistory[tid].computeIndices.comp[bank] ^
+        F(threadHistory[tid].pathHist,
+          indexConstants.pathHistLengths[bank], bank);
 
     return (index & ((1ULL << (logTagTableSizes[bank])) - 1));
 }
@@ -248,8 +248,8 @@ uint16_t
 TAGEBase::gtag(ThreadID tid, Addr pc, int bank) const
 {
     int tag = (pc >> instShiftAmt) ^
-              threadHistory[tid].computeTags[0][bank].comp ^
-              (threadHistory[tid].computeTags[1][bank].comp << 1);
+              threadHistory[tid].computeTags[0].comp[bank] ^
+              (threadHistory[tid].computeTags[1].comp[bank] << 1);
 
     return (tag & ((1ULL << tagTableTagWidths[bank]) - 1));
 }
@@ -607,17 +607,14 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
     }
 
     //prepare next index and tag computations for user branchs
-    for (int i = 1; i <= nHistoryTables; i++)
-    {
-        if (speculative) {
-            bi->ci[i]  = tHist.computeIndices[i].comp;
-            bi->ct0[i] = tHist.computeTags[0][i].comp;
-            bi->ct1[i] = tHist.computeTags[1][i].comp;
+    if (speculative) {
+        for (int i = 1; i <= nHistoryTables; i++) {
+            bi->ci[i]  = tHist.computeIndices.comp[i];
+            bi->ct0[i] = tHist.computeTags[0].comp[i];
+            bi->ct1[i] = tHist.computeTags[1].comp[i];
         }
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    tHist.updateFoldedHistories();
     DPRINTF(Tage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
@@ -642,13 +639,11 @@ TAGEBase::squash(ThreadID tid, bool taken, TAGEBase::BranchInfo *bi,
     tHist.gHist = &(tHist.globalHistory[tHist.ptGhist]);
     tHist.gHist[0] = (taken ? 1 : 0);
     for (int i = 1; i <= nHistoryTables; i++) {
-        tHist.computeIndices[i].comp = bi->ci[i];
-        tHist.computeTags[0][i].comp = bi->ct0[i];
-        tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
+        tHist.computeIndices.comp[i] = bi->ci[i];
+        tHist.computeTags[0].comp[i] = bi->ct0[i];
+        tHist.computeTags[1].comp[i] = bi->ct1[i];
     }
+    tHist.updateFoldedHistories();
 }
 
 void
@@ -50,8 +50,10 @@
 
 #include <vector>
 
+#include "base/random.hh"
 #include "base/statistics.hh"
 #include "cpu/null_static_inst.hh"
+#include "cpu/pred/folded_history.hh"
 #include "cpu/static_inst.hh"
 #include "params/TAGEBase.hh"
 #include "sim/sim_object.hh"
@@ -69,6 +71,9 @@ class TAGEBase : public SimObject
     void init() override;
 
   protected:
+    /** Random numbers of this TAGE, see BPredUnit::rng. */
+    Random rng;
+
     // Prediction Structures
 
     // Tage Entry
@@ -80,38 +85,6 @@ class TAGEBase : public SimObject
         TageEntry() : ctr(0), tag(0), u(0) { }
     };
 
-    // Folded History Table - compressed history
-    // to mix with instruction PC to index partially
-    // tagged tables.
-    struct FoldedHistory
-    {
-        unsigned comp;
-        int compLength;
-        int origLength;
-        int outpoint;
-        int bufferSize;
-
-        FoldedHistory()
-        {
-            comp = 0;
-        }
-
-        void init(int original_length, int compressed_length)
-        {
-            origLength = original_length;
-            compLength = compressed_length;
-            outpoint = original_length % compressed_length;
-        }
-
-        void update(uint8_t * h)
-        {
-            comp = (comp << 1) | h[0];
-            comp ^= h[origLength] << outpoint;
-            comp ^= (comp >> compLength);
-            comp &= (1ULL << compLength) - 1;
-        }
-    };
-
   public:
 
     // provider type
@@ -456,9 +429,18 @@ class TAGEBase : public SimObject
         // Index to most recent branch outcome
         int ptGhist;
 
-        // Speculative folded histories.
-        FoldedHistory *computeIndices;
-        FoldedHistory *computeTags[2];
+        // Speculative folded histories, one entry per table.
+        FoldedHistories computeIndices;
+        FoldedHistories computeTags[2];
+
+        /** Shifts the most recent outcome into all folded histories */
+        void
+        updateFoldedHistories()
+        {
+            computeIndices.update(gHist);
+            computeTags[0].update(gHist);
+            computeTags[1].update(gHist);
+        }
     };
 
     std::vector<ThreadHistory> threadHistory;
@@ -469,6 +451,8 @@ class TAGEBase : public SimObject
     virtual void initFoldedHistories(ThreadHistory & history);
 
     int *histLengths;
+    // Per table constants of the index hash
+    TageIndexConstants indexConstants;
     int *tableIndices;
     int *tableTags;
 
@@ -60,6 +60,17 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    warmup_batch_size = Param.Unsigned(0, "Read data and instructions "
+        "functionally, and replay these accesses to the caches in batches "
+        "of this size, only to warm up their tags (0 to disable)")
+    max_block_insts = Param.Unsigned(0, "Keep executing up to this many "
+        "instructions in a tick event while no other event is due before "
+        "they would run (0 to disable)")
+    cache_fetch_translation = Param.Bool(False, "Reuse the last "
+        "instruction fetch translation while fetching from the same page")
+    block_cache = Param.Bool(False, "Cache the instructions decoded in a "
+        "row, and replay them without fetching or decoding them again "
+        "until their code is written or the MMU is flushed")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
@@ -51,6 +51,11 @@ class NonCachingSimpleCPU(AtomicSimpleCPU):
 
     numThreads = 1
 
+    parallel = Param.Bool(False, "Run on an event queue (and host thread) "
+        "of its own. Data accesses go straight to the backing store of "
+        "memory, and host locks keep guest locked accesses atomic with "
+        "respect to the CPUs on other host threads")
+
     @classmethod
     def memory_mode(cls):
         return 'atomic_noncaching'
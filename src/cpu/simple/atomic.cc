@@ -41,7 +41,12 @@
 
 #include "cpu/simple/atomic.hh"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+
 #include "arch/locked_mem.hh"
+#include "base/intmath.hh"
 #include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/exetrace.hh"
@@ -60,6 +65,38 @@
 namespace gem5
 {
 
+namespace
+{
+
+/**
+ * Physical pages the block cache of any CPU, including those on other
+ * host threads, has read code from, one bit per page modulo the size of
+ * the map. Writes to a marked page bump the code write generation, and
+ * the CPUs drop their blocks once they see it change.
+ */
+const unsigned codePageShift = 12;
+std::array<std::atomic<uint64_t>, 16384> codePageMarks;
+std::atomic<uint64_t> codeWriteGen(0);
+
+std::atomic<uint64_t> &
+codePageWord(Addr page, uint64_t &bit)
+{
+    const Addr index = page % (codePageMarks.size() * 64);
+    bit = 1ULL << (index % 64);
+    return codePageMarks[index / 64];
+}
+
+void
+markCodePage(Addr paddr)
+{
+    uint64_t bit;
+    std::atomic<uint64_t> &word = codePageWord(paddr >> codePageShift, bit);
+    if (!(word.load(std::memory_order_relaxed) & bit))
+        word.fetch_or(bit);
+}
+
+} // anonymous namespace
+
 void
 AtomicSimpleCPU::init()
 {
@@ -79,16 +116,24 @@ AtomicSimpleCPU::AtomicSimpleCPU(const AtomicSimpleCPUParams &p)
       width(p.width), locked(false),
       simulate_data_stalls(p.simulate_data_stalls),
       simulate_inst_stalls(p.simulate_inst_stalls),
+      maxBlockInsts(p.max_block_insts),
+      cacheFetchTranslation(p.cache_fetch_translation),
+      blockCache(p.block_cache), threadBlocks(numThreads),
+      blocksCached(false), codeWriteGeneration(0),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
-      ppCommit(nullptr)
+      warmupBatchSize(p.warmup_batch_size)
 {
     _status = Idle;
-    ifetch_req = std::make_shared<Request>();
-    data_read_req = std::make_shared<Request>();
-    data_write_req = std::make_shared<Request>();
-    data_amo_req = std::make_shared<Request>();
+    ifetch_req = Request::create();
+    data_read_req = Request::create();
+    data_write_req = Request::create();
+    data_amo_req = Request::create();
+
+    fatal_if(blockCache && warmupBatchSize,
+             "%s: the block cache doesn't fetch the instructions it caches, "
+             "so it can't warm up the caches.", name());
 }
 
 
@@ -115,6 +160,7 @@ AtomicSimpleCPU::drain()
         if (tickEvent.scheduled())
             deschedule(tickEvent);
 
+        flushWarmup();
         activeThreads.clear();
         DPRINTF(Drain, "Not executing microcode, no need to drain.\n");
         return DrainState::Drained;
@@ -149,6 +195,8 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    invalidateFetchState();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -183,6 +231,7 @@ AtomicSimpleCPU::tryCompleteDrain()
         return false;
 
     DPRINTF(Drain, "CPU done draining, processing drain event\n");
+    flushWarmup();
     signalDrainDone();
 
     return true;
@@ -197,6 +246,8 @@ AtomicSimpleCPU::switchOut()
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isCpuDrained());
+
+    invalidateFetchState();
 }
 
 
@@ -231,7 +282,13 @@ AtomicSimpleCPU::activateContext(ThreadID thread_num)
 
     if (!tickEvent.scheduled()) {
         //Make sure ticks are still on multiples of cycles
-        schedule(tickEvent, clockEdge(Cycles(0)));
+        Tick when = clockEdge(Cycles(0));
+        // Wake-ups from CPUs on other host threads (e.g. futex wakes)
+        // only reach this CPU's event queue at the next quantum
+        // barrier, so they can't be scheduled before it
+        if (inParallelMode && curEventQueue() != eventQueue())
+            when += roundUp(simQuantum, clockPeriod());
+        schedule(tickEvent, when);
     }
     _status = BaseSimpleCPU::Running;
     if (std::find(activeThreads.begin(), activeThreads.end(), thread_num) ==
@@ -261,7 +318,11 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
     if (activeThreads.empty()) {
         _status = Idle;
 
-        if (tickEvent.scheduled()) {
+        // CPUs on other host threads (e.g. exiting a thread group)
+        // can't remove events from this CPU's queue, tick() notices
+        // the idle status instead
+        if (tickEvent.scheduled() &&
+            (!inParallelMode || curEventQueue() == eventQueue())) {
             deschedule(tickEvent);
         }
     }
@@ -272,9 +333,40 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
 Tick
 AtomicSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
+    const RequestPtr &req = pkt->req;
+    if (warmupBatchSize && pkt->cmd == MemCmd::ReadReq &&
+        !req->isUncacheable() && !req->isLLSC() && !req->isLockedRMW()) {
+        // the data is read functionally, and the caches only see the
+        // access later on, as part of a batch that warms them up
+        port.sendFunctional(pkt);
+
+        WarmAccessBatch &batch =
+            &port == &icachePort ? icacheWarmup : dcacheWarmup;
+        batch.emplace_back(pkt->getAddr(), pkt->isSecure(),
+                           req->requestorId());
+        if (batch.size() >= warmupBatchSize) {
+            port.sendAtomicWarmup(batch);
+            batch.clear();
+        }
+        return 0;
+    }
+
     return port.sendAtomic(pkt);
 }
 
+void
+AtomicSimpleCPU::flushWarmup()
+{
+    if (!icacheWarmup.empty()) {
+        icachePort.sendAtomicWarmup(icacheWarmup);
+        icacheWarmup.clear();
+    }
+    if (!dcacheWarmup.empty()) {
+        dcachePort.sendAtomicWarmup(dcacheWarmup);
+        dcacheWarmup.clear();
+    }
+}
+
 Tick
 AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
 {
@@ -300,6 +392,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         for (auto &t_info : cpu->threadInfo) {
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
+        noteCodeWrite(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -327,6 +420,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
     }
+
+    if (pkt->isInvalidate() || pkt->isWrite())
+        noteCodeWrite(pkt->getAddr(), pkt->getSize());
 }
 
 bool
@@ -502,6 +598,7 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                         req->localAccessor(thread->getTC(), &pkt);
                 } else {
                     dcache_latency += sendPacket(dcachePort, &pkt);
+                    noteCodeWrite(req->getPaddr(), req->getSize());
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
@@ -592,6 +689,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
             dcache_latency += req->localAccessor(thread->getTC(), &pkt);
         } else {
             dcache_latency += sendPacket(dcachePort, &pkt);
+            noteCodeWrite(req->getPaddr(), req->getSize());
         }
 
         dcache_access = true;
@@ -608,11 +706,56 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
     return fault;
 }
 
+namespace
+{
+
+/** Whether an instruction writes miscellaneous (control) registers */
+bool
+writesMiscReg(const StaticInstPtr &inst)
+{
+    for (int i = 0; i < inst->numDestRegs(); i++) {
+        if (inst->destRegIdx(i).is(MiscRegClass))
+            return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 void
 AtomicSimpleCPU::tick()
 {
     DPRINTF(SimpleCPU, "Tick\n");
 
+    unsigned block_insts = 0;
+    while (true) {
+        Tick latency = tickWidth();
+
+        if (tryCompleteDrain() || _status == Idle)
+            return;
+
+        // instruction takes at least one cycle
+        if (latency < clockPeriod())
+            latency = clockPeriod();
+
+        // Nothing else can happen until the next event, so carry on
+        // with the next instructions if they would run before it
+        block_insts += width;
+        const Tick next_tick = curTick() + latency;
+        if (block_insts < maxBlockInsts && !eventQueue()->empty() &&
+            next_tick < eventQueue()->nextTick()) {
+            eventQueue()->setCurTick(next_tick);
+            continue;
+        }
+
+        reschedule(tickEvent, next_tick, true);
+        return;
+    }
+}
+
+Tick
+AtomicSimpleCPU::tickWidth()
+{
     // Change thread if multi-threaded
     swapActiveThread();
 
@@ -636,15 +779,16 @@ AtomicSimpleCPU::tick()
         updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
         if (!curStaticInst || !curStaticInst->isDelayedCommit()) {
+            // Taking an interrupt may change the translation regime
+            if (hasFetchState() && checkInterrupts(curThread))
+                invalidateFetchState();
             checkForInterrupts();
             checkPcEventQueue();
         }
 
         // We must have just got suspended by a PC event
-        if (_status == Idle) {
-            tryCompleteDrain();
-            return;
-        }
+        if (_status == Idle)
+            return latency;
 
         serviceInstCountEvents();
 
@@ -654,19 +798,26 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
-        if (needToFetch) {
-            ifetch_req->taskId(taskId());
-            setupFetchRequest(ifetch_req);
-            fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
-                                                 BaseMMU::Execute);
+
+        // Instructions decoded earlier are neither fetched nor decoded
+        const CachedBlock::Inst *cached = nullptr;
+        if (blockCache && needToFetch && t_info.fetchOffset == 0) {
+            cached = cachedInst(thread, pcState);
+            needToFetch = !cached;
         }
 
+        if (needToFetch)
+            fault = translateFetch(thread);
+
         if (fault == NoFault) {
             Tick icache_latency = 0;
             bool icache_access = false;
             dcache_access = false; // assume no dcache access
 
             if (needToFetch) {
+                if (blockCache)
+                    recordFetch();
+
                 // This is commented out because the decoder would act like
                 // a tiny cache otherwise. It wouldn't be flushed when needed
                 // like the I cache. It should be flushed, and when that works
@@ -679,7 +830,13 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            if (cached) {
+                preExecute(cached->inst, cached->decodedPC);
+            } else {
+                preExecute();
+                if (blockCache && needToFetch)
+                    recordInst(thread, pcState);
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -688,11 +845,13 @@ AtomicSimpleCPU::tick()
                 // keep an instruction count
                 if (fault == NoFault) {
                     countInst();
-                    ppCommit->notify(std::make_pair(thread, curStaticInst));
                 } else if (traceData) {
                     traceFault();
                 }
 
+                if (fault != NoFault)
+                    abortLockedRMW();
+
                 if (fault != NoFault &&
                     std::dynamic_pointer_cast<SyscallRetryFault>(fault)) {
                     // Retry execution of system calls after a delay.
@@ -702,6 +861,16 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                // So may faults and writes to control registers, while
+                // system calls and other non-speculative instructions
+                // may also write code without storing to it
+                if (hasFetchState() &&
+                    (fault != NoFault || writesMiscReg(curStaticInst) ||
+                     curStaticInst->isSyscall() ||
+                     curStaticInst->isNonSpeculative())) {
+                    invalidateFetchState();
+                }
             }
 
             // @todo remove me after debugging with legion done
@@ -729,15 +898,188 @@ AtomicSimpleCPU::tick()
             advancePC(fault);
     }
 
-    if (tryCompleteDrain())
+    return latency;
+}
+
+Fault
+AtomicSimpleCPU::translateFetch(SimpleThread *thread)
+{
+    ifetch_req->taskId(taskId());
+    setupFetchRequest(ifetch_req);
+
+    if (!cacheFetchTranslation) {
+        return thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
+                                            BaseMMU::Execute);
+    }
+
+    const Addr vaddr = ifetch_req->getVaddr();
+    const Addr vpage = roundDown(vaddr, system->getPageBytes());
+    FetchTranslation &ft = fetchTranslation;
+    if (ft.valid && ft.tid == curThread && ft.vpage == vpage &&
+        ft.flushCount == thread->mmu->flushCount()) {
+        ifetch_req->setFlags(ft.flags);
+        ifetch_req->setPaddr(ft.ppage + (vaddr - vpage));
+        return NoFault;
+    }
+
+    Fault fault = thread->mmu->translateAtomic(ifetch_req, thread->getTC(),
+                                               BaseMMU::Execute);
+
+    ft.valid = fault == NoFault && !ifetch_req->isLocalAccess();
+    if (ft.valid) {
+        ft.tid = curThread;
+        ft.vpage = vpage;
+        ft.ppage = ifetch_req->getPaddr() - (vaddr - vpage);
+        ft.flags = ifetch_req->getFlags();
+        ft.flushCount = thread->mmu->flushCount();
+    }
+    return fault;
+}
+
+const AtomicSimpleCPU::CachedBlock::Inst *
+AtomicSimpleCPU::cachedInst(SimpleThread *thread, const TheISA::PCState &pc)
+{
+    ThreadBlocks &tb = threadBlocks[curThread];
+
+    // The blocks go stale once mappings or code change
+    const uint64_t write_gen = codeWriteGen.load();
+    if (tb.flushCount != thread->mmu->flushCount() ||
+        codeWriteGeneration != write_gen) {
+        flushBlocks();
+        tb.flushCount = thread->mmu->flushCount();
+        codeWriteGeneration = write_gen;
+    }
+
+    auto starts_at = [&pc](const CachedBlock *block) {
+        return block && !block->insts.empty() && block->insts[0].pc == pc;
+    };
+
+    // Carry on with the block being replayed
+    CachedBlock *block = tb.block;
+    if (block && !tb.recording && tb.pos < block->insts.size() &&
+        block->insts[tb.pos].pc == pc) {
+        tb.decoderBypassed = true;
+        return &block->insts[tb.pos++];
+    }
+
+    // Or move on to the block that followed it the last time, or else to
+    // the one cached at this PC
+    CachedBlock *next = block ? block->next : nullptr;
+    if (!starts_at(next)) {
+        auto it = tb.blocks.find(pc.instAddr());
+        next = it == tb.blocks.end() ? nullptr : &it->second;
+    }
+    if (starts_at(next)) {
+        if (block)
+            block->next = next;
+        tb.block = next;
+        tb.pos = 1;
+        tb.recording = false;
+        tb.decoderBypassed = true;
+        return &next->insts[0];
+    }
+
+    // The decoder takes over from the last instruction it decoded
+    if (tb.decoderBypassed) {
+        thread->decoder.reset();
+        tb.decoderBypassed = false;
+    }
+
+    // Record a new block from here, unless still recording one
+    if (tb.recording && block->insts.size() < maxCachedBlockInsts)
+        return nullptr;
+
+    CachedBlock &new_block = tb.blocks[pc.instAddr()];
+    if (new_block.uncacheable) {
+        tb.block = nullptr;
+        tb.recording = false;
+        return nullptr;
+    }
+
+    DPRINTF(SimpleCPU, "Recording a block at %s\n", pc);
+    if (block && block != &new_block)
+        block->next = &new_block;
+    new_block.insts.clear();
+    new_block.next = nullptr;
+    tb.block = &new_block;
+    tb.pos = 0;
+    tb.recording = true;
+    blocksCached = true;
+    return nullptr;
+}
+
+void
+AtomicSimpleCPU::recordFetch()
+{
+    ThreadBlocks &tb = threadBlocks[curThread];
+    if (!tb.recording)
+        return;
+
+    // Code read from devices may change without being written to
+    if (ifetch_req->isUncacheable() || ifetch_req->isLocalAccess()) {
+        tb.block->uncacheable = tb.block->insts.empty();
+        tb.recording = false;
+        return;
+    }
+
+    // Marked before reading the code, so that any later write to it is
+    // seen to change a code page
+    markCodePage(ifetch_req->getPaddr());
+}
+
+void
+AtomicSimpleCPU::recordInst(SimpleThread *thread, const TheISA::PCState &pc)
+{
+    ThreadBlocks &tb = threadBlocks[curThread];
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    if (!tb.recording || t_info.stayAtPC || !curStaticInst)
         return;
 
-    // instruction takes at least one cycle
-    if (latency < clockPeriod())
-        latency = clockPeriod();
+    const StaticInstPtr &inst =
+        curMacroStaticInst ? curMacroStaticInst : curStaticInst;
+    CachedBlock *block = tb.block;
+    block->insts.push_back({pc, thread->pcState(), inst});
+    tb.pos = block->insts.size();
+
+    // Control instructions end blocks, which then chain to one another
+    if (inst->isControl() || block->insts.size() >= maxCachedBlockInsts)
+        tb.recording = false;
+}
+
+void
+AtomicSimpleCPU::flushBlocks()
+{
+    if (!blocksCached)
+        return;
+
+    DPRINTF(SimpleCPU, "Dropping the cached blocks\n");
+    for (ThreadBlocks &tb : threadBlocks) {
+        tb.blocks.clear();
+        tb.block = nullptr;
+        tb.recording = false;
+    }
+    blocksCached = false;
+}
+
+void
+AtomicSimpleCPU::invalidateFetchState()
+{
+    fetchTranslation.valid = false;
+    flushBlocks();
+}
 
-    if (_status != Idle)
-        reschedule(tickEvent, curTick() + latency, true);
+void
+AtomicSimpleCPU::noteCodeWrite(Addr paddr, unsigned size)
+{
+    const Addr first = paddr >> codePageShift;
+    const Addr last = (paddr + std::max(size, 1U) - 1) >> codePageShift;
+    for (Addr page = first; page <= last; page++) {
+        uint64_t bit;
+        if (codePageWord(page, bit).load() & bit) {
+            codeWriteGen++;
+            return;
+        }
+    }
 }
 
 Tick
@@ -757,15 +1099,6 @@ AtomicSimpleCPU::fetchInstMem()
     return latency;
 }
 
-void
-AtomicSimpleCPU::regProbePoints()
-{
-    BaseCPU::regProbePoints();
-
-    ppCommit = new ProbePointArg<std::pair<SimpleThread*, const StaticInstPtr>>
-                                (getProbeManager(), "Commit");
-}
-
 void
 AtomicSimpleCPU::printAddr(Addr a)
 {
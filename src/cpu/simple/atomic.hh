@@ -41,9 +41,13 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <unordered_map>
+#include <vector>
+
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
 #include "mem/request.hh"
+#include "mem/warm_access.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
 
@@ -67,9 +71,134 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
+    /**
+     * Instructions a tick event may execute, as long as no other event
+     * is due before each of them would have been executed by its own.
+     */
+    const unsigned maxBlockInsts;
+
+    /** Last instruction fetch translation, reused within its page */
+    struct FetchTranslation
+    {
+        bool valid = false;
+        ThreadID tid;
+        Addr vpage;
+        Addr ppage;
+        Request::Flags flags;
+        /** Flush count of the MMU when translated */
+        uint64_t flushCount;
+    };
+
+    const bool cacheFetchTranslation;
+    FetchTranslation fetchTranslation;
+
+    /**
+     * Instructions decoded in a row at their first execution, replayed
+     * without fetching or decoding them again as long as the PC goes
+     * through them in the same order.
+     */
+    struct CachedBlock
+    {
+        struct Inst
+        {
+            /** PC state before decoding the instruction */
+            TheISA::PCState pc;
+            /** PC state the decoder left */
+            TheISA::PCState decodedPC;
+            /** The instruction, a macroop for microcoded ones */
+            StaticInstPtr inst;
+        };
+
+        std::vector<Inst> insts;
+        /** Block that followed this one the last time */
+        CachedBlock *next = nullptr;
+        /** Fetched from memory that must be fetched every time */
+        bool uncacheable = false;
+    };
+
+    /** Longest block recorded */
+    static const unsigned maxCachedBlockInsts = 64;
+
+    /** Block cache state of a thread */
+    struct ThreadBlocks
+    {
+        /** Blocks by the address of their first instruction */
+        std::unordered_map<Addr, CachedBlock> blocks;
+        /** Block being replayed or recorded */
+        CachedBlock *block = nullptr;
+        /** Next instruction of the block to replay */
+        unsigned pos = 0;
+        bool recording = false;
+        /** The decoder was bypassed since it last decoded */
+        bool decoderBypassed = false;
+        /** Flush count of the MMU the blocks were decoded under */
+        uint64_t flushCount = 0;
+    };
+
+    const bool blockCache;
+    std::vector<ThreadBlocks> threadBlocks;
+    /** Some thread has cached blocks */
+    bool blocksCached;
+    /** Code write generation the blocks were decoded at */
+    uint64_t codeWriteGeneration;
+
     // main simulation loop (one cycle)
     void tick();
 
+    /**
+     * Execute the instructions of one cycle.
+     * @return Their latency
+     */
+    Tick tickWidth();
+
+    /**
+     * Translate the fetch request of the current thread, reusing the last
+     * translation if it is still valid.
+     */
+    Fault translateFetch(SimpleThread *thread);
+
+    /**
+     * Look up the block cache at the start of an instruction of the
+     * current thread, starting to record a block if nothing is cached.
+     *
+     * @return The instruction decoded earlier at this PC, if any.
+     */
+    const CachedBlock::Inst *cachedInst(SimpleThread *thread,
+                                        const TheISA::PCState &pc);
+
+    /**
+     * Note the fetch about to be sent for the block being recorded, if
+     * any, before its code is read.
+     */
+    void recordFetch();
+
+    /**
+     * Add the instruction just fetched and decoded to the block being
+     * recorded, if any.
+     *
+     * @param pc The PC state before decoding it.
+     */
+    void recordInst(SimpleThread *thread, const TheISA::PCState &pc);
+
+    /** Drop the cached blocks of all the threads. */
+    void flushBlocks();
+
+    /** Drop the fetch translation and all the cached blocks. */
+    void invalidateFetchState();
+
+    /** Whether any fetch state would be dropped by invalidating it */
+    bool
+    hasFetchState() const
+    {
+        return fetchTranslation.valid || blocksCached;
+    }
+
+    /**
+     * Record that a write went to physical memory, dropping the cached
+     * blocks of all the CPUs if it may have changed their code.
+     */
+    static void noteCodeWrite(Addr paddr, unsigned size);
+
     /**
      * Check if a system is in a drained state.
      *
@@ -106,6 +235,13 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     virtual Tick sendPacket(RequestPort &port, const PacketPtr &pkt);
     virtual Tick fetchInstMem();
 
+    /**
+     * Called when an instruction faults. If this happens between the
+     * read and the write of a locked RMW access, the access is abandoned
+     * and will start over from the read when the instruction restarts.
+     */
+    virtual void abortLockedRMW() { locked = false; }
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
@@ -170,8 +306,19 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     bool dcache_access;
     Tick dcache_latency;
 
-    /** Probe Points. */
-    ProbePointArg<std::pair<SimpleThread *, const StaticInstPtr>> *ppCommit;
+    /**
+     * Number of loads and instruction fetches replayed at once to the
+     * caches when warming them up, 0 if these accesses go through the
+     * regular atomic path.
+     */
+    const unsigned warmupBatchSize;
+
+    /** Warm-up accesses not yet replayed to the caches. */
+    WarmAccessBatch icacheWarmup;
+    WarmAccessBatch dcacheWarmup;
+
+    /** Replay all pending warm-up accesses to the caches. */
+    void flushWarmup();
 
   protected:
 
@@ -231,7 +378,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     }
 
     void
-    htmSendAbortSignal(HtmFailureFaultCause cause) override
+    htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
+                       HtmFailureFaultCause cause) override
     {
         panic("htmSendAbortSignal() is for timing accesses, and should "
               "never be called on AtomicSimpleCPU.\n");
@@ -245,8 +393,6 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     Fault amoMem(Addr addr, uint8_t *data, unsigned size,
                  Request::Flags flags, AtomicOpFunctorPtr amo_op) override;
 
-    void regProbePoints() override;
-
     /**
      * Print state of address in memory system via PrintReq (for
      * debugging).
@@ -86,7 +86,9 @@ BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
       branchPred(p.branchPred),
       zeroReg(p.isa[0]->regClasses().at(IntRegClass).zeroReg()),
       traceData(NULL),
-      _status(Idle)
+      _status(Idle),
+      ppCommit(nullptr),
+      ppBranch(nullptr)
 {
     SimpleThread *thread;
 
@@ -118,6 +120,17 @@ BaseSimpleCPU::BaseSimpleCPU(const BaseSimpleCPUParams &p)
     }
 }
 
+void
+BaseSimpleCPU::regProbePoints()
+{
+    BaseCPU::regProbePoints();
+
+    ppCommit = new ProbePointArg<std::pair<SimpleThread*, const StaticInstPtr>>
+                                (getProbeManager(), "Commit");
+    ppBranch = new ProbePointArg<CommittedBranch>(getProbeManager(),
+                                                  "Branch");
+}
+
 void
 BaseSimpleCPU::init()
 {
@@ -168,6 +181,8 @@ BaseSimpleCPU::countInst()
     }
     t_info.numOp++;
     t_info.execContextStats.numOps++;
+
+    ppCommit->notify(std::make_pair(t_info.thread, curStaticInst));
 }
 
 Counter
@@ -310,7 +325,7 @@ BaseSimpleCPU::serviceInstCountEvents()
 }
 
 void
-BaseSimpleCPU::preExecute()
+BaseSimpleCPU::startPreExecute()
 {
     SimpleExecContext &t_info = *threadInfo[curThread];
     SimpleThread* thread = t_info.thread;
@@ -321,6 +336,15 @@ BaseSimpleCPU::preExecute()
     // resets predicates
     t_info.setPredicate(true);
     t_info.setMemAccPredicate(true);
+}
+
+void
+BaseSimpleCPU::preExecute()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
+    startPreExecute();
 
     // decode the instruction
     TheISA::PCState pcState = thread->pcState();
@@ -367,6 +391,38 @@ BaseSimpleCPU::preExecute()
         curStaticInst = curMacroStaticInst->fetchMicroop(pcState.microPC());
     }
 
+    finishPreExecute();
+}
+
+void
+BaseSimpleCPU::preExecute(const StaticInstPtr &inst,
+                          const TheISA::PCState &decoded_pc)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
+    startPreExecute();
+
+    t_info.stayAtPC = false;
+    thread->pcState(decoded_pc);
+
+    if (inst->isMacroop()) {
+        curMacroStaticInst = inst;
+        curStaticInst =
+            curMacroStaticInst->fetchMicroop(decoded_pc.microPC());
+    } else {
+        curStaticInst = inst;
+    }
+
+    finishPreExecute();
+}
+
+void
+BaseSimpleCPU::finishPreExecute()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
     //If we decoded an instruction this "tick", record information about it.
     if (curStaticInst) {
 #if TRACING_ON
@@ -375,6 +431,9 @@ BaseSimpleCPU::preExecute()
 #endif // TRACING_ON
     }
 
+    if (curStaticInst && curStaticInst->isControl())
+        t_info.branchPC = thread->pcState();
+
     if (branchPred && curStaticInst &&
         curStaticInst->isControl()) {
         // Use a fake sequence number since we only have one
@@ -504,6 +563,12 @@ BaseSimpleCPU::advancePC(const Fault &fault)
             ++t_info.execContextStats.numBranchMispred;
         }
     }
+
+    if (fault == NoFault && curStaticInst && curStaticInst->isControl()) {
+        ppBranch->notify(CommittedBranch{thread, curStaticInst,
+                                         t_info.branchPC, thread->pcState(),
+                                         branching});
+    }
 }
 
 } // namespace gem5
@@ -122,6 +122,28 @@ class BaseSimpleCPU : public BaseCPU
 
     Status _status;
 
+  public:
+    /**
+     * A committed control instruction, as notified by the Branch probe
+     * point.
+     */
+    struct CommittedBranch
+    {
+        SimpleThread *thread;
+        StaticInstPtr inst;
+        /** PC state the instruction was fetched with, whose next PC is
+         * the fall-through path */
+        TheISA::PCState pc;
+        /** PC state control was transferred to */
+        TheISA::PCState target;
+        bool taken;
+    };
+
+  protected:
+    /** Probe Points. */
+    ProbePointArg<std::pair<SimpleThread *, const StaticInstPtr>> *ppCommit;
+    ProbePointArg<CommittedBranch> *ppBranch;
+
     /**
      * Handler used when encountering a fault; its purpose is to
      * tear down the InstRecord. If a fault is meant to be traced,
@@ -130,16 +152,33 @@ class BaseSimpleCPU : public BaseCPU
      */
     void traceFault();
 
+    /** Reset the state an instruction starts executing with. */
+    void startPreExecute();
+
+    /** Trace and predict the instruction about to execute, if any. */
+    void finishPreExecute();
+
   public:
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
     void serviceInstCountEvents();
     void preExecute();
+    /**
+     * Prepare an instruction decoded earlier rather than fetching and
+     * decoding it again.
+     *
+     * @param inst The instruction, a macroop for microcoded ones.
+     * @param decoded_pc The PC state the decoder left at the time.
+     */
+    void preExecute(const StaticInstPtr &inst,
+                    const TheISA::PCState &decoded_pc);
     void postExecute();
     void advancePC(const Fault &fault);
 
     void haltContext(ThreadID thread_num) override;
 
+    void regProbePoints() override;
+
     // statistics
     void resetStats() override;
 
@@ -191,16 +230,6 @@ class BaseSimpleCPU : public BaseCPU
      * neither really (true) loads nor stores. For this reason the interface
      * is extended and initiateHtmCmd() is used to instigate the command. */
     virtual Fault initiateHtmCmd(Request::Flags flags) = 0;
-
-    /** This function is used to instruct the memory subsystem that a
-     * transaction should be aborted and the speculative state should be
-     * thrown away.  This is called in the transaction's very last breath in
-     * the core.  Afterwards, the core throws away its speculative state and
-     * resumes execution at the point the transaction started, i.e. reverses
-     * time.  When instruction execution resumes, the core expects the
-     * memory subsystem to be in a stable, i.e. pre-speculative, state as
-     * well. */
-    virtual void htmSendAbortSignal(HtmFailureFaultCause cause) = 0;
 };
 
 } // namespace gem5
@@ -45,6 +45,7 @@
 #include "base/types.hh"
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
+#include "cpu/decode_cache_stats.hh"
 #include "cpu/exec_context.hh"
 #include "cpu/reg_class.hh"
 #include "cpu/simple/base.hh"
@@ -71,6 +72,8 @@ class SimpleExecContext : public ExecContext
 
     // Branch prediction
     TheISA::PCState predPC;
+    // PC state the current control instruction was fetched with
+    TheISA::PCState branchPC;
 
     /** PER-THREAD STATS */
     Counter numInst;
@@ -153,7 +156,8 @@ class SimpleExecContext : public ExecContext
               ADD_STAT(numBranchMispred, statistics::units::Count::get(),
                        "Number of branch mispredictions"),
               ADD_STAT(statExecutedInstType, statistics::units::Count::get(),
-                       "Class of executed instruction.")
+                       "Class of executed instruction."),
+              decodeCache(this, "decode_cache", thread->decoder)
         {
             numCCRegReads
                 .flags(statistics::nozero);
@@ -270,6 +274,9 @@ class SimpleExecContext : public ExecContext
         // Instruction mix histogram by OpClass
         statistics::Vector statExecutedInstType;
 
+        // Decode cache hits and misses
+        DecodeCacheStats decodeCache;
+
     } execContextStats;
 
   public:
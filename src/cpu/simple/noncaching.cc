@@ -37,17 +37,84 @@
 
 #include "cpu/simple/noncaching.hh"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <thread>
+
+#include "mem/packet_access.hh"
+#include "sim/eventq.hh"
 
 namespace gem5
 {
 
+namespace
+{
+
+/**
+ * Host spin locks, striped by physical cache line, shared by all the
+ * parallel CPUs. Stores and locked accesses take the lock of their
+ * line, so that the read and write halves of a guest locked access
+ * can't be interleaved with stores from other host threads.
+ */
+std::array<std::atomic<bool>, 4096> lineLocks;
+
+void
+acquireLineLock(std::atomic<bool> &lock)
+{
+    while (lock.exchange(true, std::memory_order_acquire)) {
+        while (lock.load(std::memory_order_relaxed))
+            std::this_thread::yield();
+    }
+}
+
+void
+releaseLineLock(std::atomic<bool> &lock)
+{
+    lock.store(false, std::memory_order_release);
+}
+
+/**
+ * Holds a line lock for its lifetime, unless the CPU already holds
+ * it for an ongoing locked RMW access.
+ */
+class ScopedLineLock
+{
+  public:
+    ScopedLineLock(std::atomic<bool> &_lock, const std::atomic<bool> *held)
+        : lock(_lock), owned(&_lock != held)
+    {
+        if (owned)
+            acquireLineLock(lock);
+    }
+
+    ~ScopedLineLock()
+    {
+        if (owned)
+            releaseLineLock(lock);
+    }
+
+  private:
+    std::atomic<bool> &lock;
+    const bool owned;
+};
+
+} // anonymous namespace
+
 NonCachingSimpleCPU::NonCachingSimpleCPU(const NonCachingSimpleCPUParams &p)
-    : AtomicSimpleCPU(p)
+    : AtomicSimpleCPU(p), parallel(p.parallel), heldLineLock(nullptr),
+      lockedFragments(0), llscAddr(MaxAddr)
 {
     assert(p.numThreads == 1);
     fatal_if(!FullSystem && p.workload.size() != 1,
              "only one workload allowed");
+
+    // Static instructions are reference counted non-atomically, so they
+    // can't be shared with the decoders of the other host threads
+    if (parallel) {
+        for (auto *t_info : threadInfo)
+            t_info->thread->decoder.usePrivateCaches();
+    }
 }
 
 void
@@ -62,6 +129,29 @@ NonCachingSimpleCPU::verifyMemoryMode() const
 Tick
 NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
+    const bool locked_rmw = parallel && &port == &dcachePort &&
+        pkt->req->isLockedRMW();
+
+    if (parallel && &port == &dcachePort) {
+        // The read half of a locked RMW takes the lock of its line
+        // whichever way it goes, as the write half may take the other
+        if (locked_rmw && pkt->isRead())
+            acquireLockedRMW(pkt->getAddr());
+
+        auto bd_it = memBackdoors.contains(pkt->getAddrRange());
+        if (bd_it != memBackdoors.end() &&
+            accessBackdoor(*bd_it->second, pkt)) {
+            if (locked_rmw && pkt->isWrite())
+                releaseLockedRMW();
+            return 0;
+        }
+    }
+
+    // The memory system and devices belong to the event queue of the
+    // system, so parallel CPUs borrow it for the accesses they can't
+    // do on their own. Timing doesn't matter while fast-forwarding.
+    EventQueue::ScopedMigration migrate(system->eventQueue(), parallel);
+
     MemBackdoorPtr bd = nullptr;
     Tick latency = port.sendAtomicBackdoor(pkt, bd);
 
@@ -81,9 +171,109 @@ NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
             };
         bd->addInvalidationCallback(callback);
     }
+
+    if (locked_rmw && pkt->isWrite())
+        releaseLockedRMW();
     return latency;
 }
 
+void
+NonCachingSimpleCPU::acquireLockedRMW(Addr paddr)
+{
+    // Locked accesses split across two cache lines only lock the first
+    // one
+    std::atomic<bool> &line_lock = lineLock(paddr);
+    if (lockedFragments++ == 0) {
+        acquireLineLock(line_lock);
+        heldLineLock = &line_lock;
+    } else if (&line_lock != heldLineLock) {
+        warn_once("%s: split locked access, only the first cache line "
+                  "is locked\n", name());
+    }
+}
+
+void
+NonCachingSimpleCPU::releaseLockedRMW()
+{
+    if (lockedFragments > 0 && --lockedFragments == 0) {
+        releaseLineLock(*heldLineLock);
+        heldLineLock = nullptr;
+    }
+}
+
+void
+NonCachingSimpleCPU::abortLockedRMW()
+{
+    AtomicSimpleCPU::abortLockedRMW();
+
+    // Don't leave other threads spinning on the line until the
+    // instruction restarts
+    if (heldLineLock) {
+        releaseLineLock(*heldLineLock);
+        heldLineLock = nullptr;
+    }
+    lockedFragments = 0;
+}
+
+std::atomic<bool> &
+NonCachingSimpleCPU::lineLock(Addr paddr) const
+{
+    return lineLocks[(paddr / cacheLineSize()) % lineLocks.size()];
+}
+
+bool
+NonCachingSimpleCPU::accessBackdoor(const MemBackdoor &bd,
+                                    const PacketPtr &pkt)
+{
+    uint8_t *host_addr = bd.ptr() + (pkt->getAddr() - bd.range().start());
+    std::atomic<bool> &line_lock = lineLock(pkt->getAddr());
+
+    if (pkt->isRead() && !bd.readable())
+        return false;
+    if (pkt->isWrite() && !bd.writeable())
+        return false;
+
+    if (pkt->cmd == MemCmd::ReadReq) {
+        // The lock of a locked RMW is taken by sendPacket
+        pkt->setData(host_addr);
+    } else if (pkt->cmd == MemCmd::WriteReq && pkt->req->isLockedRMW() &&
+               heldLineLock) {
+        // Covered by the lock taken for the read half, which is released
+        // by sendPacket. The second line of a split access isn't locked,
+        // so that two CPUs never wait for each other's lines.
+        pkt->writeData(host_addr);
+    } else if (pkt->cmd == MemCmd::WriteReq) {
+        ScopedLineLock lock(line_lock, heldLineLock);
+        pkt->writeData(host_addr);
+    } else if (pkt->cmd == MemCmd::LoadLockedReq) {
+        pkt->setData(host_addr);
+        llscAddr = pkt->getAddr();
+        llscData.assign(host_addr, host_addr + pkt->getSize());
+    } else if (pkt->cmd == MemCmd::StoreCondReq) {
+        // Memory isn't watched for writes, so the store conditional
+        // succeeds if memory still holds the data the load-locked
+        // read, as a host compare-and-swap would
+        ScopedLineLock lock(line_lock, heldLineLock);
+        const bool success = llscAddr == pkt->getAddr() &&
+            llscData.size() == pkt->getSize() &&
+            std::equal(llscData.begin(), llscData.end(), host_addr);
+        if (success)
+            pkt->writeData(host_addr);
+        pkt->req->setExtraData(success ? 1 : 0);
+        llscAddr = MaxAddr;
+    } else if (pkt->isAtomicOp()) {
+        ScopedLineLock lock(line_lock, heldLineLock);
+        pkt->setData(host_addr);
+        (*(pkt->getAtomicOp()))(host_addr);
+    } else {
+        return false;
+    }
+
+    if (pkt->needsResponse())
+        pkt->makeResponse();
+    return true;
+}
+
 Tick
 NonCachingSimpleCPU::fetchInstMem()
 {
@@ -38,6 +38,9 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
+#include <atomic>
+#include <vector>
+
 #include "base/addr_range_map.hh"
 #include "cpu/simple/atomic.hh"
 #include "mem/backdoor.hh"
@@ -60,8 +63,52 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
   protected:
     AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
 
+    /**
+     * Set when the CPU runs on a host thread of its own, in parallel
+     * with other CPUs (e.g. to fast-forward multi-threaded workloads).
+     */
+    const bool parallel;
+
+    /** Host line lock held between the halves of a locked RMW access */
+    std::atomic<bool> *heldLineLock;
+    /** Number of locked RMW fragments read but not written yet */
+    int lockedFragments;
+
+    /** Address and data seen by the last load-locked access */
+    Addr llscAddr;
+    std::vector<uint8_t> llscData;
+
     Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
     Tick fetchInstMem() override;
+    void abortLockedRMW() override;
+
+    /**
+     * Take the line lock for a fragment of the read half of a locked RMW
+     * access, holding it until the write half.
+     *
+     * @param paddr Physical address of the fragment.
+     */
+    void acquireLockedRMW(Addr paddr);
+
+    /**
+     * Release the line lock once the last fragment of the write half of
+     * a locked RMW access is written.
+     */
+    void releaseLockedRMW();
+
+    /**
+     * Perform a data access directly on the backing store of memory,
+     * as done by parallel CPUs.
+     *
+     * @param bd Back door covering the whole access.
+     * @param pkt Packet to perform the access for.
+     * @return Whether the access was performed, false if this kind of
+     * access must go through the memory system.
+     */
+    bool accessBackdoor(const MemBackdoor &bd, const PacketPtr &pkt);
+
+    /** Host lock guarding the cache line of a physical address */
+    std::atomic<bool> &lineLock(Addr paddr) const;
 };
 
 } // namespace gem5
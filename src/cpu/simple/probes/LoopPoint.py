@@ -0,0 +1,60 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import SimObject
+
+class LoopPoint(SimObject):
+    """Multi-threaded region profiler and marker tracker (LoopPoint-style
+    sampling). Region boundaries are (marker PC, global execution count)
+    pairs, which, unlike per-thread instruction counts, identify the same
+    execution point regardless of thread interleaving."""
+
+    type = 'LoopPoint'
+    cxx_header = "cpu/simple/probes/looppoint.hh"
+    cxx_class = 'gem5::LoopPoint'
+
+    cpus = VectorParam.BaseCPU("CPUs whose threads are tracked")
+
+    marker_pcs = VectorParam.Addr([], "PCs of synchronization markers, "
+        "e.g. loop headers outside critical sections")
+    htm_markers = Param.Bool(True, "Also use the PCs of transaction "
+        "commit instructions as markers (profiling only)")
+
+    # Profiling (simple CPUs only)
+    profile = Param.Bool(False, "Collect per-thread BBVs and region "
+        "boundaries")
+    interval = Param.UInt64(100000000, "Minimum region size (insts "
+        "committed by all threads); regions end at the next marker")
+    profile_file = Param.String("looppoint.bb.gz", "BBV (output) file")
+    region_file = Param.String("looppoint.regions",
+        "Region boundaries (output) file")
+
+    # Markers at which the simulation loop exits, e.g. to take a
+    # checkpoint or to delimit a detailed region
+    exit_pcs = VectorParam.Addr([], "PCs of exit markers")
+    exit_counts = VectorParam.UInt64([], "Global execution count of each "
+        "exit marker at which to exit")
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/probes/branch_trace.hh"
+
+#include "base/output.hh"
+#include "proto/branch.pb.h"
+#include "sim/core.hh"
+
+namespace gem5
+{
+
+BranchTrace::BranchTrace(const BranchTraceParams &p)
+    : ProbeListenerObject(p), traceStream(nullptr)
+{
+    traceStream = new ProtoOutputStream(simout.resolve(p.trace_file));
+
+    ProtoMessage::BranchTraceHeader header;
+    header.set_obj_id(name());
+    header.set_ver(0);
+    traceStream->write(header);
+
+    // Flush the compressed stream even if the simulation doesn't end
+    // by destroying the simulated objects
+    registerExitCallback([this]() { close(); });
+}
+
+BranchTrace::~BranchTrace()
+{
+    close();
+}
+
+void
+BranchTrace::close()
+{
+    delete traceStream;
+    traceStream = nullptr;
+}
+
+void
+BranchTrace::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTrace,
+                             std::pair<SimpleThread*, StaticInstPtr>>
+        CommitListener;
+    typedef ProbeListenerArg<BranchTrace, BaseSimpleCPU::CommittedBranch>
+        BranchListener;
+
+    listeners.push_back(new CommitListener(this, "Commit",
+                                           &BranchTrace::commit));
+    listeners.push_back(new BranchListener(this, "Branch",
+                                           &BranchTrace::branch));
+}
+
+void
+BranchTrace::commit(const std::pair<SimpleThread*, StaticInstPtr> &p)
+{
+    const StaticInstPtr &inst = p.second;
+    if (inst->isMicroop() && !inst->isLastMicroop())
+        return;
+
+    const ThreadID tid = p.first->threadId();
+    if (tid >= insts.size())
+        insts.resize(tid + 1, 0);
+    ++insts[tid];
+}
+
+void
+BranchTrace::branch(const BaseSimpleCPU::CommittedBranch &b)
+{
+    const StaticInstPtr &inst = b.inst;
+    if (!traceStream || (inst->isMicroop() && !inst->isLastMicroop()))
+        return;
+
+    ProtoMessage::Branch msg;
+    const Addr pc = b.pc.instAddr();
+    msg.set_pc(pc);
+
+    uint32_t flags = 0;
+    if (inst->isCondCtrl())
+        flags |= ProtoMessage::Branch::COND;
+    if (inst->isDirectCtrl())
+        flags |= ProtoMessage::Branch::DIRECT;
+    if (inst->isCall())
+        flags |= ProtoMessage::Branch::CALL;
+    if (inst->isReturn())
+        flags |= ProtoMessage::Branch::RETURN;
+    if (b.taken) {
+        flags |= ProtoMessage::Branch::TAKEN;
+        msg.set_target(b.target.instAddr());
+    }
+    msg.set_flags(flags);
+    msg.set_size(b.pc.nextInstAddr() - pc);
+
+    // The commit probe has already counted this instruction
+    const ThreadID tid = b.thread->threadId();
+    if (tid >= insts.size())
+        insts.resize(tid + 1, 0);
+    if (insts[tid] != 1)
+        msg.set_insts(insts[tid]);
+    insts[tid] = 0;
+    if (tid != 0)
+        msg.set_tid(tid);
+
+    traceStream->write(msg);
+}
+
+} // namespace gem5
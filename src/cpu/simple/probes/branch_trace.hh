@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
+#define __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
+
+#include <utility>
+#include <vector>
+
+#include "cpu/simple/base.hh"
+#include "cpu/simple_thread.hh"
+#include "cpu/static_inst.hh"
+#include "params/BranchTrace.hh"
+#include "proto/protoio.hh"
+#include "sim/probe/probe.hh"
+
+namespace gem5
+{
+
+/**
+ * Probe capturing a trace of the control instructions committed by a
+ * simple CPU, with their PC, fall-through and target addresses, outcome
+ * and type, and the number of instructions between them. Traces use
+ * the ProtoMessage::Branch format, and the BranchTracePlayer replays
+ * them through any branch predictor configuration.
+ *
+ * Only architectural branches are traced: branches between the
+ * microops of an instruction are not.
+ */
+class BranchTrace : public ProbeListenerObject
+{
+  public:
+    BranchTrace(const BranchTraceParams &params);
+    ~BranchTrace();
+
+    void regProbeListeners() override;
+
+    /** Count committed instructions */
+    void commit(const std::pair<SimpleThread*, StaticInstPtr> &p);
+
+    /** Trace a committed control instruction */
+    void branch(const BaseSimpleCPU::CommittedBranch &b);
+
+  private:
+    /** Close the trace stream at the end of the simulation */
+    void close();
+
+    /** Output stream of the trace */
+    ProtoOutputStream *traceStream;
+
+    /** Instructions committed by each thread since its last branch */
+    std::vector<uint64_t> insts;
+};
+
+} // namespace gem5
+
+#endif // __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
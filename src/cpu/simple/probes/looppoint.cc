@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/probes/looppoint.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "cpu/base.hh"
+#include "debug/LoopPoint.hh"
+#include "sim/core.hh"
+#include "sim/serialize.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+LoopPoint::LoopPoint(const LoopPointParams &p)
+    : SimObject(p),
+      cpus(p.cpus),
+      htmMarkers(p.htm_markers),
+      profiling(p.profile),
+      intervalSize(p.interval),
+      exitPCs(p.exit_pcs),
+      exitCounts(p.exit_counts)
+{
+    fatal_if(exitPCs.size() != exitCounts.size(),
+             "%s: exit_pcs and exit_counts differ in size", name());
+    fatal_if(profiling && intervalSize == 0,
+             "%s: zero profiling interval", name());
+
+    for (Addr pc : p.marker_pcs)
+        markerCounts[pc] = 0;
+    for (Addr pc : exitPCs)
+        markerCounts[pc] = 0;
+
+    if (profiling) {
+        bbvStream = simout.create(p.profile_file, false);
+        regionStream = simout.create(p.region_file, false);
+        if (!bbvStream || !regionStream)
+            fatal("%s: unable to open profile files", name());
+        *regionStream->stream() << "# region start_pc start_count "
+            "end_pc end_count insts thread:insts...\n";
+        registerExitCallback([this]() { closeStreams(); });
+    }
+}
+
+LoopPoint::~LoopPoint()
+{
+    closeStreams();
+}
+
+void
+LoopPoint::regProbeListeners()
+{
+    for (BaseCPU *cpu : cpus) {
+        if (profiling) {
+            // Commit probe of simple CPUs: inst and thread available
+            fatal_if(!cpu->getProbeManager(), "No probe manager");
+            listeners.emplace_back(new Listener<
+                std::pair<SimpleThread*, StaticInstPtr>>(
+                    this, cpu->getProbeManager(), "Commit",
+                    &LoopPoint::profile));
+        } else if (!markerCounts.empty()) {
+            listeners.emplace_back(new Listener<uint64_t>(
+                this, cpu->getProbeManager(), "RetiredInstsPC",
+                &LoopPoint::retired));
+        }
+    }
+}
+
+LoopPoint::ThreadState &
+LoopPoint::threadState(ContextID ctx)
+{
+    assert(ctx >= 0);
+    if (ctx >= threads.size())
+        threads.resize(ctx + 1);
+    return threads[ctx];
+}
+
+void
+LoopPoint::profile(const std::pair<SimpleThread*, StaticInstPtr> &p)
+{
+    SimpleThread *thread = p.first;
+    const StaticInstPtr &inst = p.second;
+    const Addr pc = thread->pcState().instAddr();
+
+    const ContextID ctx = thread->contextId();
+    ThreadState &ts = threadState(ctx);
+
+    // Transaction commits are synchronization points for all threads
+    // (no other thread may be amid a conflicting critical section).
+    // Like any other marker, they are counted once the whole macroop
+    // has committed.
+    if (htmMarkers && inst->isHtmStop())
+        ts.htmStop = true;
+
+    if (inst->isMicroop() && !inst->isLastMicroop())
+        return;
+
+    if (ts.htmStop) {
+        markerCounts.emplace(pc, 0);
+        ts.htmStop = false;
+    }
+
+    if (!ts.currentBBInsts)
+        ts.currentBB.first = pc;
+
+    ++ts.currentBBInsts;
+    ++ts.regionInsts;
+    ++regionInsts;
+
+    // If inst is control inst, assume end of basic block.
+    if (inst->isControl()) {
+        ts.currentBB.second = pc;
+
+        auto bb_itr = bbMap.find(ts.currentBB);
+        if (bb_itr == bbMap.end()) {
+            BBInfo info;
+            info.id = bbMap.size() + 1;
+            info.insts = ts.currentBBInsts;
+            bb_itr = bbMap.emplace(ts.currentBB, info).first;
+        }
+
+        // One BBV dimension per basic block and thread, as threads
+        // running the same code in different proportions are in
+        // different phases
+        auto dim_key = std::make_pair(bb_itr->second.id, ctx);
+        auto dim_itr = dimensions.find(dim_key);
+        if (dim_itr == dimensions.end())
+            dim_itr = dimensions.emplace(dim_key,
+                                         dimensions.size() + 1).first;
+        dimensionCounts[dim_itr->second] += ts.currentBBInsts;
+        ts.currentBBInsts = 0;
+    }
+
+    auto marker_itr = markerCounts.find(pc);
+    if (marker_itr != markerCounts.end())
+        countMarker(pc, ++marker_itr->second);
+}
+
+void
+LoopPoint::retired(const uint64_t &pc)
+{
+    auto marker_itr = markerCounts.find(pc);
+    if (marker_itr != markerCounts.end())
+        countMarker(pc, ++marker_itr->second);
+}
+
+void
+LoopPoint::countMarker(Addr pc, uint64_t count)
+{
+    if (profiling && regionInsts >= intervalSize)
+        endRegion(pc, count);
+
+    for (int i = 0; i < exitPCs.size(); i++) {
+        if (exitPCs[i] == pc && exitCounts[i] == count) {
+            DPRINTF(LoopPoint, "Exit marker %d reached: %#x:%d\n",
+                    i, pc, count);
+            exitSimLoop("looppoint marker reached", i);
+        }
+    }
+}
+
+void
+LoopPoint::endRegion(Addr pc, uint64_t count)
+{
+    DPRINTF(LoopPoint, "Region %d ends at %#x:%d after %d insts\n",
+            numRegions, pc, count, regionInsts);
+
+    std::vector<std::pair<uint64_t, uint64_t>> counts(
+        dimensionCounts.begin(), dimensionCounts.end());
+    std::sort(counts.begin(), counts.end());
+
+    std::ostream &bbv = *bbvStream->stream();
+    bbv << "T";
+    for (const auto &cnt : counts) {
+        bbv << ":" << cnt.first << ":" << cnt.second << " ";
+    }
+    bbv << "\n";
+
+    std::ostream &regions = *regionStream->stream();
+    ccprintf(regions, "%d %#x %d %#x %d %d", numRegions,
+             regionStartPC, regionStartCount, pc, count, regionInsts);
+    for (ContextID ctx = 0; ctx < threads.size(); ctx++) {
+        ccprintf(regions, " %d:%d", ctx, threads[ctx].regionInsts);
+        threads[ctx].regionInsts = 0;
+    }
+    regions << "\n";
+
+    dimensionCounts.clear();
+    regionInsts = 0;
+    regionStartPC = pc;
+    regionStartCount = count;
+    numRegions++;
+}
+
+void
+LoopPoint::closeStreams()
+{
+    if (!bbvStream)
+        return;
+
+    // Last region of the run, ended by the end of the simulation
+    if (regionInsts > 0)
+        endRegion(0, 0);
+
+    simout.close(bbvStream);
+    simout.close(regionStream);
+    bbvStream = nullptr;
+    regionStream = nullptr;
+}
+
+void
+LoopPoint::serialize(CheckpointOut &cp) const
+{
+    std::vector<Addr> pcs;
+    std::vector<uint64_t> counts;
+    for (const auto &marker : markerCounts) {
+        pcs.push_back(marker.first);
+        counts.push_back(marker.second);
+    }
+    SERIALIZE_CONTAINER(pcs);
+    SERIALIZE_CONTAINER(counts);
+}
+
+void
+LoopPoint::unserialize(CheckpointIn &cp)
+{
+    std::vector<Addr> pcs;
+    std::vector<uint64_t> counts;
+    UNSERIALIZE_CONTAINER(pcs);
+    UNSERIALIZE_CONTAINER(counts);
+    panic_if(pcs.size() != counts.size(), "Corrupt marker counts");
+
+    // Only the markers tracked when the checkpoint was taken have
+    // known counts
+    for (int i = 0; i < pcs.size(); i++) {
+        auto marker_itr = markerCounts.find(pcs[i]);
+        if (marker_itr != markerCounts.end())
+            marker_itr->second = counts[i];
+    }
+    for (Addr pc : exitPCs) {
+        warn_if(std::find(pcs.begin(), pcs.end(), pc) == pcs.end(),
+                "%s: count of exit marker %#x not in checkpoint",
+                name(), pc);
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_PROBES_LOOPPOINT_HH__
+#define __CPU_SIMPLE_PROBES_LOOPPOINT_HH__
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/types.hh"
+#include "cpu/simple_thread.hh"
+#include "cpu/static_inst.hh"
+#include "params/LoopPoint.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+/**
+ * LoopPoint-style sampling support for multi-threaded workloads.
+ *
+ * Instruction counts are not a valid way to identify a point of a
+ * multi-threaded execution, as they depend on thread interleaving
+ * (spinning, aborted transactions, fallback lock waits, etc.). Regions
+ * are instead delimited by markers: a marker is a PC (e.g. a loop header
+ * or a transaction commit) and a boundary is the point where the marker
+ * has been executed a given number of times by all threads together.
+ *
+ * When profiling (simple CPUs only), the probe collects a BBV per region
+ * in SimPoint format, with one dimension per basic block and thread, and
+ * ends a region at the first marker found once the region reaches the
+ * interval size. The boundaries and per-thread instruction counts of
+ * every region are written to a separate file.
+ *
+ * On any CPU, the probe counts the executions of its markers and exits
+ * the simulation loop when an exit marker reaches its count, which is
+ * used to take checkpoints and to delimit the detailed simulation of
+ * the selected regions. Marker counts are checkpointed.
+ */
+class LoopPoint : public SimObject
+{
+  public:
+    LoopPoint(const LoopPointParams &params);
+    ~LoopPoint();
+
+    void regProbeListeners() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+    /** Profile a committed (micro-)instruction of a simple CPU */
+    void profile(const std::pair<SimpleThread*, StaticInstPtr> &p);
+
+    /** Count a retired instruction of any CPU (marker tracking only) */
+    void retired(const uint64_t &pc);
+
+  private:
+    /** Listener of a probe point of one of the tracked CPUs */
+    template <class Arg>
+    class Listener : public ProbeListenerArgBase<Arg>
+    {
+      public:
+        Listener(LoopPoint *_parent, ProbeManager *pm,
+                 const std::string &name,
+                 void (LoopPoint::*_function)(const Arg &))
+            : ProbeListenerArgBase<Arg>(pm, name),
+              parent(_parent), function(_function)
+        {}
+
+        void notify(const Arg &val) override { (parent->*function)(val); }
+
+      private:
+        LoopPoint *parent;
+        void (LoopPoint::*function)(const Arg &);
+    };
+
+    /** Start and end PCs of a basic block */
+    typedef std::pair<Addr, Addr> BasicBlockRange;
+
+    struct BasicBlockHash
+    {
+        size_t
+        operator()(const BasicBlockRange &bb) const
+        {
+            return std::hash<Addr>()(bb.first + bb.second);
+        }
+    };
+
+    /** Per-thread profiling state */
+    struct ThreadState
+    {
+        /** Basic block being executed */
+        BasicBlockRange currentBB = {0, 0};
+        /** Insts executed in the current basic block */
+        uint64_t currentBBInsts = 0;
+        /** Insts committed in the current region */
+        uint64_t regionInsts = 0;
+        /** Current macroop commits a transaction */
+        bool htmStop = false;
+    };
+
+    ThreadState &threadState(ContextID ctx);
+
+    /** Count an execution of a marker, closing regions and exiting */
+    void countMarker(Addr pc, uint64_t count);
+
+    /** Write the BBV and boundaries of the current region */
+    void endRegion(Addr pc, uint64_t count);
+
+    void closeStreams();
+
+    const std::vector<BaseCPU *> cpus;
+    const bool htmMarkers;
+    const bool profiling;
+    const uint64_t intervalSize;
+    const std::vector<Addr> exitPCs;
+    const std::vector<uint64_t> exitCounts;
+
+    std::vector<std::unique_ptr<ProbeListener>> listeners;
+
+    /** Global execution counts of markers */
+    std::unordered_map<Addr, uint64_t> markerCounts;
+
+    OutputStream *bbvStream = nullptr;
+    OutputStream *regionStream = nullptr;
+
+    struct BBInfo
+    {
+        /** Unique ID */
+        uint64_t id;
+        /** Num of static insts in BB */
+        uint64_t insts;
+    };
+
+    /** All basic blocks seen so far, by any thread */
+    std::unordered_map<BasicBlockRange, BBInfo, BasicBlockHash> bbMap;
+    /** BBV dimension of each (basic block, thread) pair */
+    std::map<std::pair<uint64_t, ContextID>, uint64_t> dimensions;
+    /** Dynamic inst count of each BBV dimension in the current region */
+    std::unordered_map<uint64_t, uint64_t> dimensionCounts;
+
+    std::vector<ThreadState> threads;
+
+    /** Insts committed by all threads in the current region */
+    uint64_t regionInsts = 0;
+    /** Number of regions written so far */
+    uint64_t numRegions = 0;
+    /** Marker that started the current region (0 at the start) */
+    Addr regionStartPC = 0;
+    uint64_t regionStartCount = 0;
+};
+
+} // namespace gem5
+
+#endif // __CPU_SIMPLE_PROBES_LOOPPOINT_HH__
@@ -412,7 +412,15 @@ TimingSimpleCPU::translationFault(const Fault &fault)
 PacketPtr
 TimingSimpleCPU::buildPacket(const RequestPtr &req, bool read)
 {
-    return read ? Packet::createRead(req) : Packet::createWrite(req);
+    PacketPtr pkt = read ? Packet::createRead(req) : Packet::createWrite(req);
+
+    // hardware transactional memory
+    // Accesses are performed one at a time, so every access is the
+    // oldest one in flight for this core. Transactional sequencers use
+    // this to stall the core when the access is nacked.
+    pkt->setAtLSQHead(true);
+
+    return pkt;
 }
 
 void
@@ -463,7 +471,7 @@ TimingSimpleCPU::initiateMemRead(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -545,7 +553,7 @@ TimingSimpleCPU::writeMem(uint8_t *data, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         addr, size, flags, dataRequestorId(), pc, thread->contextId());
     req->setByteEnable(byte_enable);
 
@@ -601,7 +609,7 @@ TimingSimpleCPU::initiateMemAMO(Addr addr, unsigned size,
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(addr, size, flags,
+    RequestPtr req = Request::create(addr, size, flags,
                             dataRequestorId(), pc, thread->contextId(),
                             std::move(amo_op));
 
@@ -699,7 +707,7 @@ TimingSimpleCPU::fetch()
 
     if (needToFetch) {
         _status = BaseSimpleCPU::Running;
-        RequestPtr ifetch_req = std::make_shared<Request>();
+        RequestPtr ifetch_req = Request::create();
         ifetch_req->taskId(taskId());
         ifetch_req->setContext(thread->contextId());
         setupFetchRequest(ifetch_req);
@@ -959,7 +967,27 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
     updateCycleCounts();
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
+    // hardware transactional memory
+    // Loads nacked by the cache controller (e.g. requester-stalls
+    // conflict resolution) are retried without involving the
+    // instruction, unless the transaction has failed meanwhile. Stores
+    // are retried by the cache controller itself.
+    if (pkt->isHtmFailedCacheAccess()) {
+        pkt->setHtmFailedCacheAccess(false);
+        if (pkt->isRead() && !pkt->htmTransactionFailedInCache()) {
+            DPRINTF(HtmCpu, "Access to %#x nacked in cache, retrying\n",
+                    pkt->getAddr());
+            // Convert the response back to a request
+            pkt->makePrevRequest();
+            handleReadPacket(pkt);
+            return;
+        }
+    }
+
+    bool was_split = false;
     if (pkt->senderState) {
+        was_split = true;
+
         // hardware transactional memory
         // There shouldn't be HtmCmds occurring in multipacket requests
         if (pkt->req->isHTMCmd()) {
@@ -985,6 +1013,12 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
             big_pkt->setHtmTransactionFailedInCache(
                 pkt->getHtmTransactionFailedInCacheRC()
             );
+        } else if (pkt->isRead() && pkt->isHtmTransactional()) {
+            // Each fragment of a transactional load isolates its own
+            // block, as the main request only carries the address of
+            // the first one
+            htmSendSignal(pkt->getAddr() & dcachePort.cacheBlockMask,
+                          Request::HTM_ISOLATE);
         }
 
         delete pkt;
@@ -1050,6 +1084,15 @@ TimingSimpleCPU::completeDataAccess(PacketPtr pkt)
     } else {
         fault = curStaticInst->completeAcc(pkt, t_info,
                                      traceData);
+
+        // Isolate transactional loads upon retirement for precise
+        // tracking of the read-set (see O3 Commit::commitInsts)
+        if (fault == NoFault && pkt->isRead() && pkt->isHtmTransactional() &&
+            !pkt->req->isHTMCmd() && !curStaticInst->isDataPrefetch() &&
+            !was_split) {
+            htmSendSignal(pkt->getAddr() & dcachePort.cacheBlockMask,
+                          Request::HTM_ISOLATE);
+        }
     }
 
     // hardware transactional memory
@@ -1120,6 +1163,13 @@ TimingSimpleCPU::DcachePort::recvTimingResp(PacketPtr pkt)
 {
     DPRINTF(SimpleCPU, "Received load/store response %#x\n", pkt->getAddr());
 
+    // hardware transactional memory
+    // Abort and isolate signals do not belong to any instruction
+    if (pkt->req->isHTMAbort() || pkt->req->isHTMIsolate()) {
+        delete pkt;
+        return true;
+    }
+
     // The timing CPU is not really ticked, instead it relies on the
     // memory system (fetch and load/store) to set the pace.
     if (!tickEvent.scheduled()) {
@@ -1225,7 +1275,7 @@ TimingSimpleCPU::initiateHtmCmd(Request::Flags flags)
     if (traceData)
         traceData->setMem(addr, size, flags);
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
@@ -1235,10 +1285,6 @@ TimingSimpleCPU::initiateHtmCmd(Request::Flags flags)
 
     assert(req->isHTMCmd());
 
-    if (system->getHTM() != nullptr) {
-        panic("Configurable HTM support not tested for TimingSimpleCPU!");
-    }
-
     // Use the payload as a sanity check,
     // the memory subsystem will clear allocated data
     uint8_t *data = new uint8_t[size];
@@ -1262,9 +1308,10 @@ TimingSimpleCPU::initiateHtmCmd(Request::Flags flags)
 }
 
 void
-TimingSimpleCPU::htmSendAbortSignal(HtmFailureFaultCause cause)
+TimingSimpleCPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
+                                    HtmFailureFaultCause cause)
 {
-    SimpleExecContext& t_info = *threadInfo[curThread];
+    SimpleExecContext& t_info = *threadInfo[tid];
     SimpleThread* thread = t_info.thread;
 
     const Addr addr = 0x0ul;
@@ -1278,7 +1325,7 @@ TimingSimpleCPU::htmSendAbortSignal(HtmFailureFaultCause cause)
 
     // notify l1 d-cache (ruby) that core has aborted transaction
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         addr, size, flags, dataRequestorId());
 
     req->setPC(pc);
@@ -1289,12 +1336,46 @@ TimingSimpleCPU::htmSendAbortSignal(HtmFailureFaultCause cause)
 
     assert(req->isHTMAbort());
 
+    DPRINTF(HtmCpu, "htmabort htmUid=%u\n", htm_uid);
+
+    // The abort signal is sent outside of the instruction's own access,
+    // which may still be waiting for its response, and is never retried
+    PacketPtr pkt = Packet::createRead(req);
     uint8_t *data = new uint8_t[size];
-    assert(data);
-    uint64_t rc = 0lu;
-    memcpy (data, &rc, size);
+    memset(data, 0, size);
+    pkt->dataDynamic<uint8_t>(data);
+    pkt->setHtmTransactional(htm_uid);
 
-    sendData(req, data, nullptr, true);
+    if (!dcachePort.sendTimingReq(pkt)) {
+        panic("HTM abort signal was not sent to the memory subsystem.");
+    }
+}
+
+void
+TimingSimpleCPU::htmSendSignal(Addr addr, const Request::Flags flags)
+{
+    if (system->getHTM() == nullptr)
+        return;
+
+    SimpleExecContext& t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
+    const int size = 8;
+
+    RequestPtr req = Request::create(addr, size, flags, dataRequestorId());
+
+    req->setContext(thread->contextId());
+    req->taskId(taskId());
+
+    assert(req->isHTMCmd());
+
+    PacketPtr pkt = Packet::createRead(req);
+    pkt->dataDynamic<uint8_t>(new uint8_t[size]);
+    pkt->setHtmTransactional(t_info.getHtmTransactionUid());
+
+    if (!dcachePort.sendTimingReq(pkt)) {
+        panic("HTM signal was not sent to the memory subsystem.");
+    }
 }
 
 } // namespace gem5
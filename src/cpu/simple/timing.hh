@@ -327,7 +327,12 @@ class TimingSimpleCPU : public BaseSimpleCPU
     /** hardware transactional memory **/
     Fault initiateHtmCmd(Request::Flags flags) override;
 
-    void htmSendAbortSignal(HtmFailureFaultCause) override;
+    void htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
+                            HtmFailureFaultCause cause) override;
+
+    /** Send an HTM signal (e.g. HTM_ISOLATE) for the given block address
+     *  of the running transaction to the memory subsystem */
+    void htmSendSignal(Addr addr, const Request::Flags flags);
 
   private:
 
@@ -50,7 +50,6 @@
 #include "config/the_isa.hh"
 #include "cpu/base.hh"
 #include "cpu/checker/htm_checker.hh"
-#include "cpu/simple/base.hh"
 #include "cpu/thread_context.hh"
 #include "mem/se_translating_port_proxy.hh"
 #include "mem/translating_port_proxy.hh"
@@ -172,10 +171,7 @@ SimpleThread::copyArchRegs(ThreadContext *src_tc)
 void
 SimpleThread::htmAbortTransaction(uint64_t htm_uid, HtmFailureFaultCause cause)
 {
-    BaseSimpleCPU *baseSimpleCpu = dynamic_cast<BaseSimpleCPU*>(baseCpu);
-    assert(baseSimpleCpu);
-
-    baseSimpleCpu->htmSendAbortSignal(cause);
+    baseCpu->htmSendAbortSignal(_threadId, htm_uid, cause);
 
     // these must be reset after the abort signal has been sent
     htmTransactionStarts = 0;
@@ -194,6 +190,12 @@ SimpleThread::getHtmCheckpointPtr()
 void
 SimpleThread::setHtmCheckpointPtr(BaseHTMCheckpointPtr new_cpt)
 {
+    // Every register write goes through this thread, so checkpoints
+    // can be saved copy-on-write
+    HTM *htm = system->getHTM();
+    if (new_cpt)
+        new_cpt->setCopyOnWrite(!htm || htm->params().cow_register_checkpoint);
+
     _htmCheckpoint = std::move(new_cpt);
 }
 
@@ -52,6 +52,7 @@
 #include "arch/isa.hh"
 #include "arch/pcstate.hh"
 #include "arch/vecregs.hh"
+#include "base/compiler.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
 #include "cpu/thread_context.hh"
@@ -115,6 +116,19 @@ class SimpleThread : public ThreadState, public ThreadContext
     /** True if the memory access should be skipped for this instruction */
     bool memAccPredicate;
 
+    /** Hardware transactional memory: let a copy-on-write checkpoint
+     *  save a register right before its first write within the
+     *  transaction */
+    void
+    htmSaveRegOnWrite(RegClass reg_class, RegIndex idx)
+    {
+        if (GEM5_UNLIKELY(_htmCheckpoint &&
+                          _htmCheckpoint->tracksRegWrites() &&
+                          htmTransactionStarts > htmTransactionStops)) {
+            _htmCheckpoint->saveRegOnWrite(this, RegId(reg_class, idx));
+        }
+    }
+
   public:
     std::string
     name() const
@@ -496,6 +510,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     void
     setIntRegFlat(RegIndex idx, RegVal val) override
     {
+        htmSaveRegOnWrite(IntRegClass, idx);
         intRegs[idx] = val;
     }
 
@@ -507,6 +522,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     void
     setFloatRegFlat(RegIndex idx, RegVal val) override
     {
+        htmSaveRegOnWrite(FloatRegClass, idx);
         floatRegs[idx] = val;
     }
 
@@ -519,12 +535,14 @@ class SimpleThread : public ThreadState, public ThreadContext
     TheISA::VecRegContainer &
     getWritableVecRegFlat(RegIndex reg) override
     {
+        htmSaveRegOnWrite(VecRegClass, reg);
         return vecRegs[reg];
     }
 
     void
     setVecRegFlat(RegIndex reg, const TheISA::VecRegContainer &val) override
     {
+        htmSaveRegOnWrite(VecRegClass, reg);
         vecRegs[reg] = val;
     }
 
@@ -538,6 +556,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     setVecElemFlat(RegIndex reg, const ElemIndex &elemIndex,
                    const TheISA::VecElem &val) override
     {
+        htmSaveRegOnWrite(VecRegClass, reg);
         vecRegs[reg].as<TheISA::VecElem>()[elemIndex] = val;
     }
 
@@ -550,6 +569,7 @@ class SimpleThread : public ThreadState, public ThreadContext
     TheISA::VecPredRegContainer &
     getWritableVecPredRegFlat(RegIndex reg) override
     {
+        htmSaveRegOnWrite(VecPredRegClass, reg);
         return vecPredRegs[reg];
     }
 
@@ -557,11 +577,17 @@ class SimpleThread : public ThreadState, public ThreadContext
     setVecPredRegFlat(RegIndex reg,
             const TheISA::VecPredRegContainer &val) override
     {
+        htmSaveRegOnWrite(VecPredRegClass, reg);
         vecPredRegs[reg] = val;
     }
 
     RegVal readCCRegFlat(RegIndex idx) const override { return ccRegs[idx]; }
-    void setCCRegFlat(RegIndex idx, RegVal val) override { ccRegs[idx] = val; }
+    void
+    setCCRegFlat(RegIndex idx, RegVal val) override
+    {
+        htmSaveRegOnWrite(CCRegClass, idx);
+        ccRegs[idx] = val;
+    }
 
     // hardware transactional memory
     void htmAbortTransaction(uint64_t htm_uid,
@@ -79,9 +79,9 @@ DmaThread::issueLoadOps()
         // for now, assert address is 4-byte aligned
         assert(address % load_size == 0);
 
-        auto req = std::make_shared<Request>(address, load_size,
-                                             0, tester->requestorId(),
-                                             0, threadId, nullptr);
+        auto req = Request::create(address, load_size,
+                                   0, tester->requestorId(),
+                                   0, threadId, nullptr);
         req->setPaddr(address);
         req->setReqInstSeqNum(tester->getActionSeqNum());
 
@@ -132,9 +132,9 @@ DmaThread::issueStoreOps()
                 curEpisode->getEpisodeId(), ruby::printAddress(address),
                 new_value);
 
-        auto req = std::make_shared<Request>(address, sizeof(Value),
-                                             0, tester->requestorId(), 0,
-                                             threadId, nullptr);
+        auto req = Request::create(address, sizeof(Value),
+                                   0, tester->requestorId(), 0,
+                                   threadId, nullptr);
         req->setPaddr(address);
         req->setReqInstSeqNum(tester->getActionSeqNum());
 
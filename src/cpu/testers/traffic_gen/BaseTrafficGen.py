@@ -74,6 +74,13 @@ class BaseTrafficGen(ClockedObject):
     max_outstanding_reqs = Param.Int(0,
                             "Maximum number of outstanding requests")
 
+    # Number of packets that may be issued by a single update event,
+    # as long as the active generator keeps asking for packets on the
+    # same tick. Batching avoids a trip through the event queue per
+    # packet when driving the memory system at saturation.
+    batch_size = Param.Unsigned(1, "Maximum number of packets issued " \
+                                "per update event")
+
     # Let the user know if we have waited for a retry and not made any
     # progress for a long period of time. The default value is
     # somewhat arbitrary and may well have to be tuned.
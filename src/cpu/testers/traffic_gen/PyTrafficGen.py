@@ -61,7 +61,11 @@ class PyTrafficGen(BaseTrafficGen):
         PyBindMethod("createDramRot"),
         PyBindMethod("createHybrid"),
         PyBindMethod("createNvm"),
-        PyBindMethod("createStrided")
+        PyBindMethod("createStrided"),
+        PyBindMethod("createPointerChase"),
+        PyBindMethod("createGatherScatter"),
+        PyBindMethod("createZipf"),
+        PyBindMethod("createBinaryTrace")
     ]
 
     @cxxMethod(override=True)
@@ -42,16 +42,20 @@
 #include "base/random.hh"
 #include "config/have_protobuf.hh"
 #include "cpu/testers/traffic_gen/base_gen.hh"
+#include "cpu/testers/traffic_gen/binary_trace_gen.hh"
 #include "cpu/testers/traffic_gen/dram_gen.hh"
 #include "cpu/testers/traffic_gen/dram_rot_gen.hh"
 #include "cpu/testers/traffic_gen/exit_gen.hh"
+#include "cpu/testers/traffic_gen/gather_scatter_gen.hh"
 #include "cpu/testers/traffic_gen/hybrid_gen.hh"
 #include "cpu/testers/traffic_gen/idle_gen.hh"
 #include "cpu/testers/traffic_gen/linear_gen.hh"
 #include "cpu/testers/traffic_gen/nvm_gen.hh"
+#include "cpu/testers/traffic_gen/pointer_chase_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
 #include "cpu/testers/traffic_gen/stream_gen.hh"
 #include "cpu/testers/traffic_gen/strided_gen.hh"
+#include "cpu/testers/traffic_gen/zipf_gen.hh"
 #include "debug/Checkpoint.hh"
 #include "debug/TrafficGen.hh"
 #include "enums/AddrMap.hh"
@@ -76,6 +80,7 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams &p)
       nextTransitionTick(0),
       nextPacketTick(0),
       maxOutstandingReqs(p.max_outstanding_reqs),
+      batchSize(p.batch_size),
       port(name() + ".port", *this),
       retryPkt(NULL),
       retryPktTick(0), blockedWaitingResp(false),
@@ -177,43 +182,25 @@ BaseTrafficGen::update()
         transition();
     } else {
         assert(curTick() >= nextPacketTick);
-        // get the next packet and try to send it
-        PacketPtr pkt = activeGenerator->getNextPacket();
-
-        // If generating stream/substream IDs are enabled,
-        // try to pick and assign them to the new packet
-        if (streamGenerator) {
-            auto sid = streamGenerator->pickStreamID();
-            auto ssid = streamGenerator->pickSubstreamID();
-
-            pkt->req->setStreamId(sid);
-
-            if (streamGenerator->ssidValid()) {
-                pkt->req->setSubstreamId(ssid);
-            }
-        }
-
-        // suppress packets that are not destined for a memory, such as
-        // device accesses that could be part of a trace
-        if (pkt && system->isMemAddr(pkt->getAddr())) {
-            stats.numPackets++;
-            // Only attempts to send if not blocked by pending responses
-            blockedWaitingResp = allocateWaitingRespSlot(pkt);
-            if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
-                retryPkt = pkt;
-                retryPktTick = curTick();
+        ++stats.numBatches;
+        issuePacket();
+
+        // keep issuing the packets that are due on this tick without
+        // going through the event queue, until the batch is full, a
+        // transition is due, or we have to wait for a retry or a response
+        for (unsigned int issued = 1;
+             issued < batchSize && retryPkt == NULL; ++issued) {
+            // leave the rest of the batch to the next state, the
+            // transition is scheduled below for this tick
+            if (nextTransitionTick <= curTick())
+                break;
+
+            nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
+            if (nextPacketTick > curTick()) {
+                scheduleUpdate();
+                return;
             }
-        } else if (pkt) {
-            DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
-                    pkt->cmdString(), pkt->getAddr());
-
-            ++stats.numSuppressed;
-            if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
-                warn("%s suppressed %d packets with non-memory addresses\n",
-                     name(), stats.numSuppressed.value());
-
-            delete pkt;
-            pkt = nullptr;
+            issuePacket();
         }
     }
 
@@ -226,6 +213,49 @@ BaseTrafficGen::update()
     }
 }
 
+void
+BaseTrafficGen::issuePacket()
+{
+    // get the next packet and try to send it
+    PacketPtr pkt = activeGenerator->getNextPacket();
+
+    // If generating stream/substream IDs are enabled,
+    // try to pick and assign them to the new packet
+    if (streamGenerator) {
+        auto sid = streamGenerator->pickStreamID();
+        auto ssid = streamGenerator->pickSubstreamID();
+
+        pkt->req->setStreamId(sid);
+
+        if (streamGenerator->ssidValid()) {
+            pkt->req->setSubstreamId(ssid);
+        }
+    }
+
+    // suppress packets that are not destined for a memory, such as
+    // device accesses that could be part of a trace
+    if (pkt && system->isMemAddr(pkt->getAddr())) {
+        stats.numPackets++;
+        // Only attempts to send if not blocked by pending responses
+        blockedWaitingResp = allocateWaitingRespSlot(pkt);
+        if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
+            retryPkt = pkt;
+            retryPktTick = curTick();
+        }
+    } else if (pkt) {
+        DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
+                pkt->cmdString(), pkt->getAddr());
+
+        ++stats.numSuppressed;
+        if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
+            warn("%s suppressed %d packets with non-memory addresses\n",
+                 name(), stats.numSuppressed.value());
+
+        delete pkt;
+        pkt = nullptr;
+    }
+}
+
 void
 BaseTrafficGen::transition()
 {
@@ -338,6 +368,8 @@ BaseTrafficGen::StatGroup::StatGroup(statistics::Group *parent)
                "Number of suppressed packets to non-memory space"),
       ADD_STAT(numPackets, statistics::units::Count::get(),
                "Number of packets generated"),
+      ADD_STAT(numBatches, statistics::units::Count::get(),
+               "Number of update events that issued packets"),
       ADD_STAT(numRetries, statistics::units::Count::get(), "Number of retries"),
       ADD_STAT(retryTicks, statistics::units::Tick::get(),
                "Time spent waiting due to back-pressure"),
@@ -542,6 +574,54 @@ BaseTrafficGen::createStrided(Tick duration,
                                                   read_percent, data_limit));
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createPointerChase(Tick duration,
+                                   Addr start_addr, Addr end_addr,
+                                   Addr blocksize, unsigned int num_chains,
+                                   Tick min_period, Tick max_period,
+                                   uint8_t read_percent, Addr data_limit)
+{
+    return std::shared_ptr<BaseGen>(
+        new PointerChaseGen(*this, requestorId, duration, start_addr,
+                            end_addr, blocksize, system->cacheLineSize(),
+                            num_chains, min_period, max_period,
+                            read_percent, data_limit));
+}
+
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createGatherScatter(Tick duration,
+                                    Addr start_addr, Addr end_addr,
+                                    Addr blocksize,
+                                    Addr index_start_addr,
+                                    Addr index_end_addr,
+                                    unsigned int vector_length,
+                                    Tick min_period, Tick max_period,
+                                    uint8_t read_percent, Addr data_limit)
+{
+    return std::shared_ptr<BaseGen>(
+        new GatherScatterGen(*this, requestorId, duration, start_addr,
+                             end_addr, blocksize, system->cacheLineSize(),
+                             index_start_addr, index_end_addr,
+                             vector_length, min_period, max_period,
+                             read_percent, data_limit));
+}
+
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createZipf(Tick duration,
+                           Addr start_addr, Addr end_addr, Addr blocksize,
+                           double alpha,
+                           Tick min_period, Tick max_period,
+                           uint8_t read_percent, Addr data_limit)
+{
+    return std::shared_ptr<BaseGen>(new ZipfGen(*this, requestorId,
+                                                duration, start_addr,
+                                                end_addr, blocksize,
+                                                system->cacheLineSize(),
+                                                alpha,
+                                                min_period, max_period,
+                                                read_percent, data_limit));
+}
+
 std::shared_ptr<BaseGen>
 BaseTrafficGen::createTrace(Tick duration,
                             const std::string& trace_file, Addr addr_offset)
@@ -554,6 +634,16 @@ BaseTrafficGen::createTrace(Tick duration,
 #endif
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createBinaryTrace(Tick duration,
+                                  const std::string& trace_file,
+                                  Addr addr_offset)
+{
+    return std::shared_ptr<BaseGen>(
+        new BinaryTraceGen(*this, requestorId, duration, trace_file,
+                           addr_offset));
+}
+
 bool
 BaseTrafficGen::recvTimingResp(PacketPtr pkt)
 {
@@ -125,6 +125,11 @@ class BaseTrafficGen : public ClockedObject
 
     const int maxOutstandingReqs;
 
+    /**
+     * Maximum number of packets issued by a single update, as long as
+     * the generator keeps asking for packets on the current tick.
+     */
+    const unsigned int batchSize;
 
     /** Request port specialisation for the traffic generator */
     class TrafficGenPort : public RequestPort
@@ -160,6 +165,12 @@ class BaseTrafficGen : public ClockedObject
      */
     void update();
 
+    /**
+     * Get the next packet from the active generator and try to send
+     * it. If it cannot be sent it becomes the retry packet.
+     */
+    void issuePacket();
+
     /** The instance of request port used by the traffic generator. */
     TrafficGenPort port;
 
@@ -204,6 +215,9 @@ class BaseTrafficGen : public ClockedObject
         /** Count the number of generated packets. */
         statistics::Scalar numPackets;
 
+        /** Count the number of update events that issued packets. */
+        statistics::Scalar numBatches;
+
         /** Count the number of retries. */
         statistics::Scalar numRetries;
 
@@ -325,10 +339,36 @@ class BaseTrafficGen : public ClockedObject
         Tick min_period, Tick max_period,
         uint8_t read_percent, Addr data_limit);
 
+    std::shared_ptr<BaseGen> createPointerChase(
+        Tick duration,
+        Addr start_addr, Addr end_addr, Addr blocksize,
+        unsigned int num_chains,
+        Tick min_period, Tick max_period,
+        uint8_t read_percent, Addr data_limit);
+
+    std::shared_ptr<BaseGen> createGatherScatter(
+        Tick duration,
+        Addr start_addr, Addr end_addr, Addr blocksize,
+        Addr index_start_addr, Addr index_end_addr,
+        unsigned int vector_length,
+        Tick min_period, Tick max_period,
+        uint8_t read_percent, Addr data_limit);
+
+    std::shared_ptr<BaseGen> createZipf(
+        Tick duration,
+        Addr start_addr, Addr end_addr, Addr blocksize,
+        double alpha,
+        Tick min_period, Tick max_period,
+        uint8_t read_percent, Addr data_limit);
+
     std::shared_ptr<BaseGen> createTrace(
         Tick duration,
         const std::string& trace_file, Addr addr_offset);
 
+    std::shared_ptr<BaseGen> createBinaryTrace(
+        Tick duration,
+        const std::string& trace_file, Addr addr_offset);
+
   protected:
     void start();
 
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/binary_trace_gen.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+#include "sim/core.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const char binaryTraceMagic[8] = { 'g', 'e', 'm', '5', 'b', 't', 'r', '1' };
+
+/** Size of the header: magic and tick frequency */
+const size_t binaryTraceHeaderSize = 16;
+
+} // anonymous namespace
+
+BinaryTraceGen::InputStream::InputStream(const std::string &_filename)
+    : filename(_filename),
+      file(filename, std::ios::in | std::ios::binary),
+      buffer(64 * 1024), bufPos(0), bufEnd(0)
+{
+    fatal_if(!file.good(), "Could not open binary trace %s\n", filename);
+    reset();
+}
+
+void
+BinaryTraceGen::InputStream::reset()
+{
+    file.clear();
+    file.seekg(0);
+    bufPos = bufEnd = 0;
+
+    uint8_t header[binaryTraceHeaderSize];
+    for (size_t i = 0; i < binaryTraceHeaderSize; i++) {
+        fatal_if(!readByte(header[i]), "%s is too short to be a binary "
+                 "trace\n", filename);
+    }
+    fatal_if(std::memcmp(header, binaryTraceMagic, sizeof(binaryTraceMagic)),
+             "%s is not a binary trace\n", filename);
+
+    uint64_t tick_freq = 0;
+    for (int i = 7; i >= 0; i--)
+        tick_freq = (tick_freq << 8) | header[sizeof(binaryTraceMagic) + i];
+    panic_if(tick_freq != sim_clock::Frequency,
+             "Trace was recorded with a different tick frequency %d\n",
+             tick_freq);
+
+    prevTick = 0;
+    prevAddr = 0;
+    prevSize = 0;
+}
+
+bool
+BinaryTraceGen::InputStream::readByte(uint8_t &byte)
+{
+    if (bufPos == bufEnd) {
+        file.read(reinterpret_cast<char *>(buffer.data()), buffer.size());
+        bufPos = 0;
+        bufEnd = file.gcount();
+        if (bufEnd == 0)
+            return false;
+    }
+    byte = buffer[bufPos++];
+    return true;
+}
+
+uint64_t
+BinaryTraceGen::InputStream::readVarint()
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        uint8_t byte;
+        fatal_if(!readByte(byte), "Truncated record in binary trace %s\n",
+                 filename);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    fatal("Malformed varint in binary trace %s\n", filename);
+}
+
+bool
+BinaryTraceGen::InputStream::read(TraceElement &element)
+{
+    uint8_t flags;
+    if (!readByte(flags))
+        return false;
+
+    prevTick += readVarint();
+
+    // undo the zigzag encoding of the signed address delta
+    const uint64_t zz = readVarint();
+    prevAddr += (zz >> 1) ^ -(zz & 1);
+
+    if (flags & SizeFlag)
+        prevSize = readVarint();
+    fatal_if(prevSize == 0, "Record without size in binary trace %s\n",
+             filename);
+
+    element.cmd = (flags & WriteFlag) ? MemCmd::WriteReq : MemCmd::ReadReq;
+    element.addr = prevAddr;
+    element.blocksize = prevSize;
+    element.tick = prevTick;
+    element.flags = (flags & ReqFlagsFlag) ? readVarint() : 0;
+    return true;
+}
+
+Tick
+BinaryTraceGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    if (traceComplete) {
+        DPRINTF(TrafficGen, "No next tick as trace is finished\n");
+        // We are at the end of the file, thus we have no more data in
+        // the trace Return MaxTick to signal that there will be no
+        // more transactions in this active period for the state.
+        return MaxTick;
+    }
+
+    assert(nextElement.isValid());
+
+    DPRINTF(TrafficGen, "Next packet tick is %d\n", tickOffset +
+            nextElement.tick);
+
+    // if the playback is supposed to be elastic, add the delay
+    if (elastic)
+        tickOffset += delay;
+
+    return std::max(tickOffset + nextElement.tick, curTick());
+}
+
+void
+BinaryTraceGen::enter()
+{
+    // update the trace offset to the time where the state was entered.
+    tickOffset = curTick();
+
+    // clear everything
+    currElement.clear();
+
+    // read the first element in the file and set the complete flag
+    traceComplete = !trace.read(nextElement);
+}
+
+PacketPtr
+BinaryTraceGen::getNextPacket()
+{
+    // shift things one step forward
+    currElement = nextElement;
+    nextElement.clear();
+
+    // read the next element and set the complete flag
+    traceComplete = !trace.read(nextElement);
+
+    // it is the responsibility of the traceComplete flag to ensure we
+    // always have a valid element here
+    assert(currElement.isValid());
+
+    DPRINTF(TrafficGen, "BinaryTraceGen::getNextPacket: %c %d %d %d 0x%x\n",
+            currElement.cmd.isRead() ? 'r' : 'w',
+            currElement.addr,
+            currElement.blocksize,
+            currElement.tick,
+            currElement.flags);
+
+    return getPacket(currElement.addr + addrOffset,
+                     currElement.blocksize,
+                     currElement.cmd, currElement.flags);
+}
+
+void
+BinaryTraceGen::exit()
+{
+    // Check if we reached the end of the trace file. If we did not
+    // then we want to generate a warning stating that not the entire
+    // trace was played.
+    if (!traceComplete) {
+        warn("Trace player %s was unable to replay the entire trace!\n",
+             name());
+    }
+
+    // Clear any flags and start over again from the beginning of the
+    // file
+    trace.reset();
+}
+
+} // namespace gem5
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the binary trace generator that replays a compact,
+ * protobuf-free packet trace.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_BINARY_TRACE_GEN_HH__
+#define __CPU_TRAFFIC_GEN_BINARY_TRACE_GEN_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+/**
+ * The binary trace generator replays a packet trace stored in a
+ * compact binary format that needs no protobuf support and is cheap
+ * to decode. The file starts with the 8-byte magic "gem5btr1" and
+ * the tick frequency as a little-endian 64-bit integer. Every record
+ * that follows is:
+ *
+ * - a flags byte: bit 0 is set for writes, bit 1 if a size follows
+ *   (otherwise the size of the previous record is reused) and bit 2
+ *   if request flags follow (otherwise they are zero);
+ * - the tick delta to the previous record as an unsigned LEB128
+ *   varint;
+ * - the address delta to the previous record, zigzag encoded as an
+ *   LEB128 varint;
+ * - the size as a varint, if present;
+ * - the request flags as a varint, if present.
+ *
+ * Typical records take 4 to 6 bytes. util/encode_binary_trace.py
+ * creates such traces from the ASCII format used by
+ * util/encode_packet_trace.py.
+ */
+class BinaryTraceGen : public BaseGen
+{
+
+  private:
+
+    /**
+     * This struct stores a line in the trace file.
+     */
+    struct TraceElement
+    {
+        /** Specifies if the request is to be a read or a write */
+        MemCmd cmd;
+
+        /** The address for the request */
+        Addr addr;
+
+        /** The size of the access for the request */
+        Addr blocksize;
+
+        /** The time at which the request should be sent */
+        Tick tick;
+
+        /** Potential request flags to use */
+        Request::FlagsType flags;
+
+        bool isValid() const { return cmd != MemCmd::InvalidCmd; }
+
+        void clear() { cmd = MemCmd::InvalidCmd; }
+    };
+
+    /**
+     * Buffered reader for the binary trace that keeps the delta
+     * decoding state.
+     */
+    class InputStream
+    {
+
+      public:
+
+        /** Record flag bits */
+        static const uint8_t WriteFlag = 0x1;
+        static const uint8_t SizeFlag = 0x2;
+        static const uint8_t ReqFlagsFlag = 0x4;
+
+        InputStream(const std::string &filename);
+
+        /** Rewind to the first record */
+        void reset();
+
+        /**
+         * Decode the next record.
+         *
+         * @param element Trace element to populate
+         * @return True if an element was read, false at end of file
+         */
+        bool read(TraceElement &element);
+
+      private:
+
+        /** Read a byte, returning false at the end of the file */
+        bool readByte(uint8_t &byte);
+
+        /** Read an unsigned LEB128 varint */
+        uint64_t readVarint();
+
+        const std::string filename;
+
+        std::ifstream file;
+
+        /** Read buffer and the window of valid bytes in it */
+        std::vector<uint8_t> buffer;
+        size_t bufPos;
+        size_t bufEnd;
+
+        /** Decoding state: previous tick, address and size */
+        Tick prevTick;
+        Addr prevAddr;
+        Addr prevSize;
+    };
+
+  public:
+
+    /**
+     * Create a binary trace generator.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param trace_file File to read the transactions from
+     * @param addr_offset Positive offset to add to trace address
+     */
+    BinaryTraceGen(SimObject &obj, RequestorID requestor_id,
+                   Tick _duration, const std::string &trace_file,
+                   Addr addr_offset)
+        : BaseGen(obj, requestor_id, _duration),
+          trace(trace_file),
+          tickOffset(0),
+          addrOffset(addr_offset),
+          traceComplete(false)
+    {
+    }
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    void exit();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+
+    /** Input stream used for reading the input trace file */
+    InputStream trace;
+
+    /** Store the current and next element in the trace */
+    TraceElement currElement;
+    TraceElement nextElement;
+
+    /**
+     * Stores the time when the state was entered. This is to add an
+     * offset to the times stored in the trace file. This is mutable
+     * to allow us to change it as part of nextPacketTick.
+     */
+    mutable Tick tickOffset;
+
+    /** Offset for memory requests. Used to shift the trace away */
+    Addr addrOffset;
+
+    /** Set to true when the trace replay for one instance is done */
+    bool traceComplete;
+};
+
+} // namespace gem5
+
+#endif
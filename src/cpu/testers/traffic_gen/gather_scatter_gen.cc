@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/gather_scatter_gen.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+namespace gem5
+{
+
+GatherScatterGen::GatherScatterGen(SimObject &obj,
+                                   RequestorID requestor_id,
+                                   Tick _duration,
+                                   Addr start_addr, Addr end_addr,
+                                   Addr _blocksize, Addr cacheline_size,
+                                   Addr index_start_addr,
+                                   Addr index_end_addr,
+                                   unsigned int vector_length,
+                                   Tick min_period, Tick max_period,
+                                   uint8_t read_percent, Addr data_limit)
+    : StochasticGen(obj, requestor_id, _duration, start_addr, end_addr,
+                    _blocksize, cacheline_size, min_period, max_period,
+                    read_percent, data_limit),
+      indexStartAddr(index_start_addr), indexEndAddr(index_end_addr),
+      vectorLength(vector_length),
+      nextIndexAddr(index_start_addr), elemsLeft(0), isGather(true),
+      dataManipulated(0)
+{
+    fatal_if(vectorLength == 0, "%s: vector length must be non-zero\n",
+             name());
+    fatal_if(indexEndAddr - indexStartAddr < blocksize,
+             "%s: index array is smaller than a block\n", name());
+    fatal_if(endAddr - startAddr < blocksize,
+             "%s: data array is smaller than an element\n", name());
+}
+
+void
+GatherScatterGen::enter()
+{
+    // reset the counter to zero and restart from the first index
+    dataManipulated = 0;
+    nextIndexAddr = indexStartAddr;
+    elemsLeft = 0;
+}
+
+PacketPtr
+GatherScatterGen::getNextPacket()
+{
+    // add the amount of data manipulated to the total
+    dataManipulated += blocksize;
+
+    if (elemsLeft == 0) {
+        // fetch the next block of indices, wrapping around at the
+        // end of the index array
+        if (nextIndexAddr + blocksize > indexEndAddr)
+            nextIndexAddr = indexStartAddr;
+        Addr addr = nextIndexAddr;
+        nextIndexAddr += blocksize;
+
+        // the indices decide the addresses of the whole vector, so
+        // also decide here whether it is a gather or a scatter
+        elemsLeft = vectorLength;
+        isGather = readPercent != 0 &&
+            (readPercent == 100 || random_mt.random(0, 100) < readPercent);
+
+        DPRINTF(TrafficGen, "GatherScatterGen::getNextPacket: index r to "
+                "addr %x, size %d\n", addr, blocksize);
+
+        return getPacket(addr, blocksize, MemCmd::ReadReq);
+    }
+
+    --elemsLeft;
+
+    // element-aligned address in the data array
+    Addr addr = random_mt.random(startAddr, endAddr - 1);
+    addr -= (addr - startAddr) % blocksize;
+    if (addr + blocksize > endAddr)
+        addr -= blocksize;
+
+    DPRINTF(TrafficGen, "GatherScatterGen::getNextPacket: %s to addr %x, "
+            "size %d\n", isGather ? "gather" : "scatter", addr, blocksize);
+
+    return getPacket(addr, blocksize,
+                     isGather ? MemCmd::ReadReq : MemCmd::WriteReq);
+}
+
+Tick
+GatherScatterGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // Check to see if we have reached the data limit. If dataLimit is
+    // zero we do not have a data limit and therefore we will keep
+    // generating requests for the entire residency in this state.
+    if (dataLimit && dataManipulated >= dataLimit) {
+        DPRINTF(TrafficGen, "Data limit for GatherScatterGen reached.\n");
+        // No more requests. Return MaxTick.
+        return MaxTick;
+    } else {
+        // return the time when the next request should take place
+        Tick wait = random_mt.random(minPeriod, maxPeriod);
+
+        // compensate for the delay experienced to not be elastic, by
+        // default the value we generate is from the time we are
+        // asked, so the elasticity happens automatically
+        if (!elastic) {
+            if (wait < delay)
+                wait = 0;
+            else
+                wait -= delay;
+        }
+
+        return curTick() + wait;
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the gather/scatter generator that models indexed
+ * vector accesses.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_GATHER_SCATTER_GEN_HH__
+#define __CPU_TRAFFIC_GEN_GATHER_SCATTER_GEN_HH__
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+/**
+ * The gather/scatter generator models indexed accesses of the form
+ * A[B[i]]. The index array B is streamed sequentially, one block at
+ * a time, and every index block is followed by a vector of element
+ * accesses to random, element-aligned addresses of the data array
+ * A. A whole vector is either a gather (reads) or a scatter (writes)
+ * according to the read percentage, while the index reads are
+ * always reads.
+ */
+class GatherScatterGen : public StochasticGen
+{
+
+  public:
+
+    /**
+     * Create a gather/scatter address sequence generator.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param start_addr Start address of the data array
+     * @param end_addr End address of the data array
+     * @param _blocksize Size of the elements and the index reads
+     * @param cacheline_size cache line size in the system
+     * @param index_start_addr Start address of the index array
+     * @param index_end_addr End address of the index array
+     * @param vector_length Number of elements per index block
+     * @param min_period Lower limit of random inter-transaction time
+     * @param max_period Upper limit of random inter-transaction time
+     * @param read_percent Percent of vectors that are gathers
+     * @param data_limit Upper limit on how much data to read/write
+     */
+    GatherScatterGen(SimObject &obj,
+                     RequestorID requestor_id, Tick _duration,
+                     Addr start_addr, Addr end_addr,
+                     Addr _blocksize, Addr cacheline_size,
+                     Addr index_start_addr, Addr index_end_addr,
+                     unsigned int vector_length,
+                     Tick min_period, Tick max_period,
+                     uint8_t read_percent, Addr data_limit);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  protected:
+    /** Start address of the index array */
+    const Addr indexStartAddr;
+
+    /** End address of the index array */
+    const Addr indexEndAddr;
+
+    /** Number of element accesses per index block */
+    const unsigned int vectorLength;
+
+    /** Address of the next index block */
+    Addr nextIndexAddr;
+
+    /** Element accesses left in the current vector */
+    unsigned int elemsLeft;
+
+    /** Whether the current vector is a gather or a scatter */
+    bool isGather;
+
+    /**
+     * Counter to determine the amount of data
+     * manipulated. Used to determine if we should continue
+     * generating requests.
+     */
+    Addr dataManipulated;
+};
+
+} // namespace gem5
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/pointer_chase_gen.hh"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+namespace gem5
+{
+
+PointerChaseGen::PointerChaseGen(SimObject &obj,
+                                 RequestorID requestor_id, Tick _duration,
+                                 Addr start_addr, Addr end_addr,
+                                 Addr _blocksize, Addr cacheline_size,
+                                 unsigned int num_chains,
+                                 Tick min_period, Tick max_period,
+                                 uint8_t read_percent, Addr data_limit)
+    : StochasticGen(obj, requestor_id, _duration, start_addr, end_addr,
+                    _blocksize, cacheline_size, min_period, max_period,
+                    read_percent, data_limit),
+      currChain(0), dataManipulated(0)
+{
+    const Addr num_blocks = (endAddr - startAddr) / blocksize;
+
+    fatal_if(num_blocks < 2, "%s: pointer chase needs at least two "
+             "blocks in the range\n", name());
+    fatal_if(num_blocks > std::numeric_limits<uint32_t>::max(),
+             "%s: pointer chase range has too many blocks (%d)\n",
+             name(), num_blocks);
+    fatal_if(num_chains == 0 || num_chains > num_blocks,
+             "%s: invalid number of chains (%d)\n", name(), num_chains);
+
+    // Sattolo's algorithm: shuffle the identity permutation while
+    // never letting an element stay in place, which yields a single
+    // cycle through all the blocks
+    std::vector<uint32_t> order(num_blocks);
+    for (uint32_t i = 0; i < num_blocks; i++)
+        order[i] = i;
+    for (uint32_t i = num_blocks - 1; i > 0; i--)
+        std::swap(order[i], order[random_mt.random<uint32_t>(0, i - 1)]);
+
+    next.resize(num_blocks);
+    for (uint32_t i = 0; i < num_blocks; i++)
+        next[order[i]] = order[(i + 1) % num_blocks];
+
+    // spread the chains evenly along the cycle so that they do not
+    // catch up with each other
+    chainStart.reserve(num_chains);
+    for (unsigned int c = 0; c < num_chains; c++)
+        chainStart.push_back(order[(num_blocks * c) / num_chains]);
+}
+
+void
+PointerChaseGen::enter()
+{
+    // reset the counter to zero and restart every chain
+    dataManipulated = 0;
+    chainPos = chainStart;
+    currChain = 0;
+}
+
+PacketPtr
+PointerChaseGen::getNextPacket()
+{
+    // choose if we generate a read or a write here
+    bool isRead = readPercent != 0 &&
+        (readPercent == 100 || random_mt.random(0, 100) < readPercent);
+
+    uint32_t &pos = chainPos[currChain];
+    Addr addr = startAddr + Addr(pos) * blocksize;
+
+    DPRINTF(TrafficGen, "PointerChaseGen::getNextPacket: chain %d %c to "
+            "addr %x, size %d\n", currChain, isRead ? 'r' : 'w', addr,
+            blocksize);
+
+    // follow the pointer and move on to the next chain
+    pos = next[pos];
+    currChain = (currChain + 1) % chainPos.size();
+
+    // add the amount of data manipulated to the total
+    dataManipulated += blocksize;
+
+    // create a new request packet
+    return getPacket(addr, blocksize,
+                     isRead ? MemCmd::ReadReq : MemCmd::WriteReq);
+}
+
+Tick
+PointerChaseGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // Check to see if we have reached the data limit. If dataLimit is
+    // zero we do not have a data limit and therefore we will keep
+    // generating requests for the entire residency in this state.
+    if (dataLimit && dataManipulated >= dataLimit) {
+        DPRINTF(TrafficGen, "Data limit for PointerChaseGen reached.\n");
+        // No more requests. Return MaxTick.
+        return MaxTick;
+    } else {
+        // return the time when the next request should take place
+        Tick wait = random_mt.random(minPeriod, maxPeriod);
+
+        // compensate for the delay experienced to not be elastic, by
+        // default the value we generate is from the time we are
+        // asked, so the elasticity happens automatically
+        if (!elastic) {
+            if (wait < delay)
+                wait = 0;
+            else
+                wait -= delay;
+        }
+
+        return curTick() + wait;
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the pointer-chase generator that follows a random
+ * cyclic permutation of the blocks in a range.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_POINTER_CHASE_GEN_HH__
+#define __CPU_TRAFFIC_GEN_POINTER_CHASE_GEN_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+/**
+ * The pointer-chase generator models linked data structure
+ * traversals. The blocks of the address range are linked in a
+ * single random cycle (Sattolo's algorithm), so that every block is
+ * visited exactly once per lap and the address stream has no stride
+ * for a prefetcher to latch on to. A number of independent chains
+ * walk the cycle from evenly spaced starting points, and are served
+ * round robin. Combined with max_outstanding_reqs equal to the
+ * number of chains this gives a dependent load stream with a
+ * controllable amount of memory-level parallelism.
+ */
+class PointerChaseGen : public StochasticGen
+{
+
+  public:
+
+    /**
+     * Create a pointer-chase address sequence generator.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param start_addr Start address
+     * @param end_addr End address
+     * @param _blocksize Size used for transactions injected
+     * @param cacheline_size cache line size in the system
+     * @param num_chains Number of chains walked in parallel
+     * @param min_period Lower limit of random inter-transaction time
+     * @param max_period Upper limit of random inter-transaction time
+     * @param read_percent Percent of transactions that are reads
+     * @param data_limit Upper limit on how much data to read/write
+     */
+    PointerChaseGen(SimObject &obj,
+                    RequestorID requestor_id, Tick _duration,
+                    Addr start_addr, Addr end_addr,
+                    Addr _blocksize, Addr cacheline_size,
+                    unsigned int num_chains,
+                    Tick min_period, Tick max_period,
+                    uint8_t read_percent, Addr data_limit);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  protected:
+    /** Successor of every block in the cycle */
+    std::vector<uint32_t> next;
+
+    /** Block index where each chain starts */
+    std::vector<uint32_t> chainStart;
+
+    /** Current block index of each chain */
+    std::vector<uint32_t> chainPos;
+
+    /** Chain that issues the next request */
+    unsigned int currChain;
+
+    /**
+     * Counter to determine the amount of data
+     * manipulated. Used to determine if we should continue
+     * generating requests.
+     */
+    Addr dataManipulated;
+};
+
+} // namespace gem5
+
+#endif
@@ -171,6 +171,16 @@ TrafficGen::parseConfig()
 
                     states[id] = createTrace(duration, traceFile, addrOffset);
                     DPRINTF(TrafficGen, "State: %d TraceGen\n", id);
+                } else if (mode == "BINARY_TRACE") {
+                    std::string traceFile;
+                    Addr addrOffset;
+
+                    is >> traceFile >> addrOffset;
+                    traceFile = resolveFile(traceFile);
+
+                    states[id] = createBinaryTrace(duration, traceFile,
+                                                   addrOffset);
+                    DPRINTF(TrafficGen, "State: %d BinaryTraceGen\n", id);
                 } else if (mode == "IDLE") {
                     states[id] = createIdle(duration);
                     DPRINTF(TrafficGen, "State: %d IdleGen\n", id);
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/zipf_gen.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/** log1p(x) / x, accurate around zero */
+double
+helper1(double x)
+{
+    if (std::fabs(x) > 1e-8)
+        return std::log1p(x) / x;
+    return 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+}
+
+/** expm1(x) / x, accurate around zero */
+double
+helper2(double x)
+{
+    if (std::fabs(x) > 1e-8)
+        return std::expm1(x) / x;
+    return 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+}
+
+} // anonymous namespace
+
+ZipfGen::ZipfGen(SimObject &obj,
+                 RequestorID requestor_id, Tick _duration,
+                 Addr start_addr, Addr end_addr,
+                 Addr _blocksize, Addr cacheline_size,
+                 double _alpha,
+                 Tick min_period, Tick max_period,
+                 uint8_t read_percent, Addr data_limit)
+    : StochasticGen(obj, requestor_id, _duration, start_addr, end_addr,
+                    _blocksize, cacheline_size, min_period, max_period,
+                    read_percent, data_limit),
+      alpha(_alpha), numBlocks((endAddr - startAddr) / blocksize),
+      dataManipulated(0)
+{
+    fatal_if(numBlocks == 0, "%s: Zipf range is smaller than a block\n",
+             name());
+    fatal_if(alpha <= 0, "%s: Zipf skew must be positive\n", name());
+
+    hIntegralX1 = hIntegral(1.5) - 1;
+    hIntegralNumBlocks = hIntegral(numBlocks + 0.5);
+    acceptWidth = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+
+    // any multiplier that is coprime with the number of blocks is a
+    // permutation of the ranks, start from the golden ratio to get a
+    // well spread hot set
+    scatter = 0x9e3779b97f4a7c15ULL % numBlocks;
+    while (std::gcd(scatter, numBlocks) != 1)
+        scatter = (scatter + 1) % numBlocks;
+}
+
+double
+ZipfGen::h(double x) const
+{
+    return std::exp(-alpha * std::log(x));
+}
+
+double
+ZipfGen::hIntegral(double x) const
+{
+    const double log_x = std::log(x);
+    return helper2((1 - alpha) * log_x) * log_x;
+}
+
+double
+ZipfGen::hIntegralInverse(double x) const
+{
+    double t = x * (1 - alpha);
+    if (t < -1)
+        t = -1;
+    return std::exp(helper1(t) * x);
+}
+
+uint64_t
+ZipfGen::sampleRank() const
+{
+    while (true) {
+        const double u = hIntegralNumBlocks + random_mt.random<double>() *
+            (hIntegralX1 - hIntegralNumBlocks);
+        const double x = hIntegralInverse(u);
+        uint64_t k = x + 0.5;
+        k = std::min(std::max(k, uint64_t(1)), numBlocks);
+        if (k - x <= acceptWidth || u >= hIntegral(k + 0.5) - h(k))
+            return k;
+    }
+}
+
+void
+ZipfGen::enter()
+{
+    // reset the counter to zero
+    dataManipulated = 0;
+}
+
+PacketPtr
+ZipfGen::getNextPacket()
+{
+    // choose if we generate a read or a write here
+    bool isRead = readPercent != 0 &&
+        (readPercent == 100 || random_mt.random(0, 100) < readPercent);
+
+    const uint64_t rank = sampleRank();
+    const uint64_t block =
+        (unsigned __int128)(rank - 1) * scatter % numBlocks;
+    Addr addr = startAddr + block * blocksize;
+
+    DPRINTF(TrafficGen, "ZipfGen::getNextPacket: %c to addr %x (rank %d), "
+            "size %d\n", isRead ? 'r' : 'w', addr, rank, blocksize);
+
+    // add the amount of data manipulated to the total
+    dataManipulated += blocksize;
+
+    // create a new request packet
+    return getPacket(addr, blocksize,
+                     isRead ? MemCmd::ReadReq : MemCmd::WriteReq);
+}
+
+Tick
+ZipfGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // Check to see if we have reached the data limit. If dataLimit is
+    // zero we do not have a data limit and therefore we will keep
+    // generating requests for the entire residency in this state.
+    if (dataLimit && dataManipulated >= dataLimit) {
+        DPRINTF(TrafficGen, "Data limit for ZipfGen reached.\n");
+        // No more requests. Return MaxTick.
+        return MaxTick;
+    } else {
+        // return the time when the next request should take place
+        Tick wait = random_mt.random(minPeriod, maxPeriod);
+
+        // compensate for the delay experienced to not be elastic, by
+        // default the value we generate is from the time we are
+        // asked, so the elasticity happens automatically
+        if (!elastic) {
+            if (wait < delay)
+                wait = 0;
+            else
+                wait -= delay;
+        }
+
+        return curTick() + wait;
+    }
+}
+
+} // namespace gem5
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the Zipf generator that concentrates its accesses
+ * on a skewed hot set of blocks.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_ZIPF_GEN_HH__
+#define __CPU_TRAFFIC_GEN_ZIPF_GEN_HH__
+
+#include <cstdint>
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+/**
+ * The Zipf generator picks blocks in the range with a Zipfian
+ * popularity: the block of rank k is accessed with a probability
+ * proportional to 1 / k^alpha. Ranks are drawn in constant time and
+ * space with the rejection-inversion method of Hörmann and
+ * Derflinger, so ranges of any size can be used. The ranks are
+ * spread over the range with a multiplicative permutation, so that
+ * the hot set is not a single contiguous region that would map to
+ * a handful of DRAM rows.
+ */
+class ZipfGen : public StochasticGen
+{
+
+  public:
+
+    /**
+     * Create a Zipfian address sequence generator.
+     *
+     * @param obj SimObject owning this sequence generator
+     * @param requestor_id RequestorID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param start_addr Start address
+     * @param end_addr End address
+     * @param _blocksize Size used for transactions injected
+     * @param cacheline_size cache line size in the system
+     * @param alpha Skew of the popularity distribution
+     * @param min_period Lower limit of random inter-transaction time
+     * @param max_period Upper limit of random inter-transaction time
+     * @param read_percent Percent of transactions that are reads
+     * @param data_limit Upper limit on how much data to read/write
+     */
+    ZipfGen(SimObject &obj,
+            RequestorID requestor_id, Tick _duration,
+            Addr start_addr, Addr end_addr,
+            Addr _blocksize, Addr cacheline_size,
+            double alpha,
+            Tick min_period, Tick max_period,
+            uint8_t read_percent, Addr data_limit);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  protected:
+    /** Draw a rank in [1, numBlocks] */
+    uint64_t sampleRank() const;
+
+    /** Unnormalised probability of rank x, 1 / x^alpha */
+    double h(double x) const;
+
+    /** Integral of h, used to invert the distribution */
+    double hIntegral(double x) const;
+
+    /** Inverse of hIntegral */
+    double hIntegralInverse(double x) const;
+
+    /** Skew of the distribution */
+    const double alpha;
+
+    /** Number of blocks in the range */
+    const uint64_t numBlocks;
+
+    /** Precomputed constants of the rejection-inversion method */
+    double hIntegralX1;
+    double hIntegralNumBlocks;
+    double acceptWidth;
+
+    /** Multiplier used to scatter the ranks over the range */
+    uint64_t scatter;
+
+    /**
+     * Counter to determine the amount of data
+     * manipulated. Used to determine if we should continue
+     * generating requests.
+     */
+    Addr dataManipulated;
+};
+
+} // namespace gem5
+
+#endif
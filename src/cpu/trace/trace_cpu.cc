@@ -39,6 +39,7 @@
 
 #include "base/compiler.hh"
 #include "sim/sim_exit.hh"
+#include "sim/system.hh"
 
 namespace gem5
 {
@@ -46,6 +47,9 @@ namespace gem5
 // Declare and initialize the static counter for number of trace CPUs.
 int TraceCPU::numTraceCPUs = 0;
 
+std::unordered_map<uint32_t, TraceCPU::ElasticDataGen*>
+    TraceCPU::ElasticDataGen::syncGens;
+
 TraceCPU::TraceCPU(const TraceCPUParams &params)
     :   BaseCPU(params),
         icachePort(this),
@@ -122,9 +126,12 @@ TraceCPU::init()
     inform("%s: Time offset (tick) found as min of both traces is %lli.",
             name(), traceOffset);
 
-    // Schedule next icache and dcache event by subtracting the offset
+    // Schedule next icache and dcache event by subtracting the offset. If
+    // no data node is ready yet, the dcache generator is waiting on other
+    // cores and gets woken up by them.
     schedule(icacheNextEvent, first_icache_tick - traceOffset);
-    schedule(dcacheNextEvent, first_dcache_tick - traceOffset);
+    if (first_dcache_tick != MaxTick)
+        schedule(dcacheNextEvent, first_dcache_tick - traceOffset);
 
     // Adjust the trace offset for the dcache generator's ready nodes
     // We don't need to do this for the icache generator as it will
@@ -243,6 +250,21 @@ ElasticDataGenStatGroup::ElasticDataGenStatGroup(statistics::Group *parent,
              "Number of strictly ordered loads"),
     ADD_STAT(numSOStores, statistics::units::Count::get(),
              "Number of strictly ordered stores"),
+    ADD_STAT(numHtmStarts, statistics::units::Count::get(),
+             "Number of transactions started"),
+    ADD_STAT(numHtmCommits, statistics::units::Count::get(),
+             "Number of transactions committed"),
+    ADD_STAT(numHtmAborts, statistics::units::Count::get(),
+             "Number of transactions aborted by the memory system"),
+    ADD_STAT(numHtmTraceAborts, statistics::units::Count::get(),
+             "Number of transaction attempts aborted during capture, which "
+             "are not replayed"),
+    ADD_STAT(numHtmNacks, statistics::units::Count::get(),
+             "Number of loads nacked by the memory system and retried"),
+    ADD_STAT(numSyncDeps, statistics::units::Count::get(),
+             "Number of sync dependencies on other cores read"),
+    ADD_STAT(numSyncStalls, statistics::units::Count::get(),
+             "Number of nodes that waited on other cores to issue"),
     ADD_STAT(dataLastTick, statistics::units::Tick::get(),
              "Last tick simulated from the elastic data trace")
 {
@@ -266,10 +288,18 @@ TraceCPU::ElasticDataGen::init()
     DPRINTF(TraceCPUData, "After 2st read, depGraph size:%d.\n",
             depGraph.size());
 
+    // The trace may start with a transaction
+    tryIssueHtmBarrier();
+
     // Print readyList
     if (debug::TraceCPUData) {
         printReadyList();
     }
+    if (readyList.empty()) {
+        DPRINTF(TraceCPUData, "No dependency free node, waiting on other "
+                "cores.\n");
+        return MaxTick;
+    }
     auto free_itr = readyList.begin();
     DPRINTF(TraceCPUData,
             "Execute tick of the first dependency free node %lli is %d.\n",
@@ -311,23 +341,49 @@ TraceCPU::ElasticDataGen::readNextWindow()
     uint32_t num_read = 0;
     while (num_read != windowSize) {
 
+        // Nodes younger than a transaction start or commit are read once it
+        // has completed, and none while a transaction is being aborted.
+        if (htmBarrier || htmAborting) {
+            DPRINTF(TraceCPUData, "\tWaiting on transaction %s.\n",
+                    htmAborting ? "abort" : htmBarrier->typeToStr());
+            break;
+        }
+
         // Create a new graph node
         GraphNode* new_node = new GraphNode;
 
         // Read the next line to get the next record. If that fails then end of
         // trace has been reached and traceComplete needs to be set in addition
         // to returning false.
-        if (!trace.read(new_node)) {
+        if (!readNode(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
             traceComplete = true;
             return false;
         }
+        lastReadSeqNum = new_node->seqNum;
+
+        if (new_node->isHtmCmd()) {
+            if (htmEnabled) {
+                // The node is issued once all older nodes have completed,
+                // which makes its own dependencies redundant
+                new_node->robDep.clear();
+                new_node->regDep.clear();
+                new_node->syncDep.clear();
+                depGraph[new_node->seqNum] = new_node;
+                htmBarrier = new_node;
+                htmBarrierIssued = false;
+                num_read++;
+                continue;
+            }
+            new_node->type = Record::COMP;
+        }
 
         // Annotate the ROB dependencies of the new node onto the parent nodes.
         addDepsOnParent(new_node, new_node->robDep);
         // Annotate the register dependencies of the new node onto the parent
         // nodes.
         addDepsOnParent(new_node, new_node->regDep);
+        elasticStats.numSyncDeps += new_node->syncDep.size();
 
         num_read++;
         // Add to map
@@ -387,6 +443,30 @@ TraceCPU::ElasticDataGen::execute()
         nextRead = false;
     }
 
+    // Send the HTM signals and retries of nacked loads first. If the port is
+    // still busy, a retry from the cache brings the control back here.
+    while (!htmPktQueue.empty()) {
+        if (!port.sendTimingReq(htmPktQueue.front())) {
+            DPRINTF(TraceCPUData, "HTM packet send failed, expecting a "
+                    "retry event from the cache.\n");
+            return;
+        }
+        htmPktQueue.pop_front();
+    }
+
+    // Attempt to issue the nodes whose dependencies on other cores have
+    // completed in the meantime
+    auto sync_itr = syncWaitList.begin();
+    while (sync_itr != syncWaitList.end()) {
+        if (syncDepsDone(*sync_itr)) {
+            const GraphNode* node_ptr = *sync_itr;
+            sync_itr = syncWaitList.erase(sync_itr);
+            checkAndIssue(node_ptr);
+        } else {
+            sync_itr++;
+        }
+    }
+
     // First attempt to issue the pending dependency-free nodes held
     // in depFreeQueue. If resources have become available for a node,
     // then issue it, i.e. add the node to readyList.
@@ -424,6 +504,10 @@ TraceCPU::ElasticDataGen::execute()
                 ++elasticStats.numRetrySucceeded;
                 retryPkt = nullptr;
             }
+        } else if (node_ptr->isHtmCmd()) {
+            // Transaction start and commit nodes complete on their response
+            // like loads
+            retryPkt = executeHtmCmd(node_ptr);
         } else if (node_ptr->isLoad() || node_ptr->isStore()) {
             // If there is no retryPkt, attempt to send a memory request in
             // case of a load or store node. If the send fails, executeMemReq()
@@ -501,8 +585,10 @@ TraceCPU::ElasticDataGen::execute()
         // load, it was not sent and all dependencies were simply
         // marked complete. Thus it is safe to delete it. For
         // stores and non load/store nodes all dependencies were
-        // marked complete so it is safe to delete it.
-        if (!node_ptr->isLoad() || node_ptr->isStrictlyOrdered()) {
+        // marked complete so it is safe to delete it. Transaction start
+        // and commit nodes are deleted on their response too.
+        if (!(node_ptr->isLoad() || node_ptr->isHtmCmd()) ||
+            node_ptr->isStrictlyOrdered()) {
             // Release all resources occupied by the completed node
             hwResource.release(node_ptr);
             // clear the dynamically allocated set of dependents
@@ -518,6 +604,11 @@ TraceCPU::ElasticDataGen::execute()
         free_itr = readyList.begin();
     } // end of while loop
 
+    // The nodes executed may have been the last ones older than a pending
+    // transaction start or commit, and other cores may wait on them
+    tryIssueHtmBarrier();
+    wakeSyncWaiters();
+
     // Print readyList, sizes of queues and resource status after updating
     if (debug::TraceCPUData) {
         printReadyList();
@@ -599,12 +690,12 @@ TraceCPU::ElasticDataGen::executeMemReq(GraphNode* node_ptr)
     }
 
     // Create a request and the packet containing request
-    auto req = std::make_shared<Request>(
+    auto req = Request::create(
         node_ptr->physAddr, node_ptr->size, node_ptr->flags, requestorId);
     req->setReqInstSeqNum(node_ptr->seqNum);
 
     // If this is not done it triggers assert in L1 cache for invalid contextId
-    req->setContext(ContextID(0));
+    req->setContext(owner.cpuId());
 
     req->setPC(node_ptr->pc);
     // If virtual address is valid, set the virtual address field
@@ -625,6 +716,8 @@ TraceCPU::ElasticDataGen::executeMemReq(GraphNode* node_ptr)
         memset(pkt_data, 0xA, req->getSize());
     }
     pkt->dataDynamic(pkt_data);
+    if (inHtm)
+        pkt->setHtmTransactional(htmUid);
 
     // Call RequestPort method to send a timing request for this packet
     bool success = port.sendTimingReq(pkt);
@@ -656,6 +749,17 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
                 node_ptr->robNum);
     }
 
+    // A node that depends on records of other cores waits for them before
+    // taking up any resources
+    if (first && !syncDepsDone(node_ptr)) {
+        DPRINTFR(TraceCPUData, "\t\tseq. num %lli waits on other cores.\n",
+                node_ptr->seqNum);
+        syncWaitList.push_back(node_ptr);
+        waitOnSyncDeps(node_ptr);
+        ++elasticStats.numSyncStalls;
+        return false;
+    }
+
     // Check if resources are available to issue the specific node
     if (hwResource.isAvailable(node_ptr)) {
         // If resources are free only then add to readyList
@@ -686,14 +790,42 @@ TraceCPU::ElasticDataGen::checkAndIssue(const GraphNode* node_ptr, bool first)
 void
 TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
 {
+    // Nothing waits on the read-set isolation of transactional loads
+    if (pkt->req->isHTMIsolate())
+        return;
+
+    // Loads nacked by the memory system are sent again without involving
+    // the node, unless the transaction has failed meanwhile. Stores are
+    // retried by the memory system itself.
+    if (pkt->isHtmFailedCacheAccess()) {
+        pkt->setHtmFailedCacheAccess(false);
+        if (pkt->isRead() && !pkt->htmTransactionFailedInCache()) {
+            DPRINTF(TraceCPUData, "Load seq. num %lli nacked, retrying.\n",
+                    pkt->req->getReqInstSeqNum());
+            PacketPtr retry_pkt = Packet::createRead(pkt->req);
+            retry_pkt->dataDynamic(new uint8_t[pkt->req->getSize()]);
+            if (pkt->isHtmTransactional())
+                retry_pkt->setHtmTransactional(pkt->getHtmTransactionUid());
+            ++elasticStats.numHtmNacks;
+            sendHtmPacket(retry_pkt);
+            owner.schedDcacheNextEvent(owner.clockEdge(Cycles(1)));
+            return;
+        }
+    }
+
     // Release the resources for this completed node.
-    if (pkt->isWrite()) {
+    if (pkt->req->isHTMAbort()) {
+        // The memory system has rolled back the transaction
+        restartTransaction();
+    } else if (pkt->isWrite()) {
         // Consider store complete.
         hwResource.releaseStoreBuffer();
         // If it is a store response then do nothing since we do not model
         // dependencies on store completion in the trace. But if we were
         // blocking execution due to store buffer fullness, we need to schedule
         // an event and attempt to progress.
+        if (pkt->htmTransactionFailedInCache())
+            beginHtmAbort(pkt->getHtmTransactionFailedInCacheRC());
     } else {
         // If it is a load response then release the dependents waiting on it.
         // Get pointer to the completed load
@@ -701,9 +833,40 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         assert(graph_itr != depGraph.end());
         GraphNode* node_ptr = graph_itr->second;
 
+        // A failed transaction squashes the dependents of the node
+        const bool htm_failed = pkt->htmTransactionFailedInCache();
+        if (htm_failed)
+            beginHtmAbort(pkt->getHtmTransactionFailedInCacheRC());
+
         // Release resources occupied by the load
         hwResource.release(node_ptr);
 
+        if (node_ptr->isHtmCmd()) {
+            assert(node_ptr == htmBarrier);
+            htmBarrier = nullptr;
+            htmBarrierIssued = false;
+            if (!htmAborting) {
+                if (node_ptr->type == Record::HTM_START) {
+                    DPRINTF(TraceCPUData, "Transaction %lli started.\n",
+                            htmUid);
+                    inHtm = true;
+                    ++elasticStats.numHtmStarts;
+                } else {
+                    DPRINTF(TraceCPUData, "Transaction %lli committed.\n",
+                            htmUid);
+                    inHtm = false;
+                    htmRecords.clear();
+                    ++elasticStats.numHtmCommits;
+                }
+            }
+        } else if (pkt->isHtmTransactional() && !htmAborting) {
+            // Track the line in the read set of the transaction, as a core
+            // does when the load retires
+            sendHtmPacket(createHtmSignal(
+                pkt->getAddr() & ~(Addr)(owner.cacheLineSize() - 1),
+                Request::HTM_ISOLATE));
+        }
+
         DPRINTF(TraceCPUData, "Load seq. num %lli response received. Waking up"
                 " dependents..\n", node_ptr->seqNum);
 
@@ -723,6 +886,12 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         depGraph.erase(graph_itr);
     }
 
+    // The response may have been the last one the abort waits on, or the
+    // last one older than a pending transaction start or commit
+    tryFinishHtmAbort();
+    tryIssueHtmBarrier();
+    wakeSyncWaiters();
+
     if (debug::TraceCPUData) {
         printReadyList();
     }
@@ -828,6 +997,302 @@ TraceCPU::ElasticDataGen::printReadyList()
     }
 }
 
+bool
+TraceCPU::ElasticDataGen::isNodeDone(NodeSeqNum seq_num) const
+{
+    // Nodes skipped when reading, e.g. aborted transaction attempts, count
+    // as done. Once the trace is complete no more nodes are to come.
+    return (seq_num <= lastReadSeqNum || traceComplete) &&
+        depGraph.find(seq_num) == depGraph.end();
+}
+
+bool
+TraceCPU::ElasticDataGen::syncDepsDone(const GraphNode* node_ptr) const
+{
+    for (const auto &sync_dep : node_ptr->syncDep) {
+        auto gen_itr = syncGens.find(sync_dep.first);
+        // Dependencies on cores that are not replayed are ignored
+        if (gen_itr != syncGens.end() && gen_itr->second != this &&
+            !gen_itr->second->isNodeDone(sync_dep.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+TraceCPU::ElasticDataGen::waitOnSyncDeps(const GraphNode* node_ptr)
+{
+    for (const auto &sync_dep : node_ptr->syncDep) {
+        auto gen_itr = syncGens.find(sync_dep.first);
+        if (gen_itr != syncGens.end() && gen_itr->second != this &&
+            !gen_itr->second->isNodeDone(sync_dep.second)) {
+            DPRINTFR(TraceCPUData, "\t\tseq. num %lli waits on %lli of "
+                     "core %d.\n", node_ptr->seqNum, sync_dep.second,
+                     sync_dep.first);
+            gen_itr->second->syncWaiters.emplace_back(sync_dep.second, this);
+        }
+    }
+}
+
+void
+TraceCPU::ElasticDataGen::wakeSyncWaiters()
+{
+    auto waiter_itr = syncWaiters.begin();
+    while (waiter_itr != syncWaiters.end()) {
+        if (isNodeDone(waiter_itr->first)) {
+            ElasticDataGen* waiter = waiter_itr->second;
+            // The waiter checks all its waiting nodes when it executes
+            waiter->owner.schedDcacheNextEvent(
+                waiter->owner.clockEdge(Cycles(1)));
+            waiter_itr = syncWaiters.erase(waiter_itr);
+        } else {
+            waiter_itr++;
+        }
+    }
+}
+
+bool
+TraceCPU::ElasticDataGen::readNode(GraphNode* new_node)
+{
+    // The records of a transaction being replayed come first
+    if (!replayQueue.empty()) {
+        *new_node = replayQueue.front();
+        replayQueue.pop_front();
+        return true;
+    }
+
+    bool found = trace.read(new_node);
+    while (found) {
+        if (new_node->type == Record::HTM_COMMIT ||
+            new_node->type == Record::HTM_ABORT) {
+            // The end of a transaction whose start was not traced
+            DPRINTF(TraceCPUData, "Skipping %s %lli outside of a "
+                    "transaction.\n", new_node->typeToStr(),
+                    new_node->seqNum);
+            found = trace.read(new_node);
+            continue;
+        }
+        if (new_node->type != Record::HTM_START)
+            return true;
+
+        // Read the transaction ahead up to its end
+        htmRecords.assign(1, *new_node);
+        GraphNode record;
+        while ((found = trace.read(&record)) &&
+               record.type != Record::HTM_START &&
+               record.type != Record::HTM_COMMIT &&
+               record.type != Record::HTM_ABORT) {
+            htmRecords.push_back(record);
+        }
+        if (!found) {
+            // The trace ends within the transaction
+            htmRecords.clear();
+            return false;
+        }
+        if (record.type == Record::HTM_COMMIT) {
+            htmRecords.push_back(record);
+            replayQueue.assign(htmRecords.begin() + 1, htmRecords.end());
+            return true;
+        }
+
+        // The attempt did not commit during capture, either it aborted or
+        // the capture missed its end, so skip it
+        DPRINTF(TraceCPUData, "Skipping aborted transaction %lli-%lli.\n",
+                htmRecords.front().seqNum, record.seqNum);
+        ++elasticStats.numHtmTraceAborts;
+        htmRecords.clear();
+        if (record.type == Record::HTM_START) {
+            *new_node = record;
+        } else {
+            found = trace.read(new_node);
+        }
+    }
+    return false;
+}
+
+void
+TraceCPU::ElasticDataGen::tryIssueHtmBarrier()
+{
+    if (!htmBarrier || htmBarrierIssued || htmAborting)
+        return;
+
+    // Wait for all older nodes to complete, stores included
+    if (depGraph.size() != 1 || !readyList.empty() || !depFreeQueue.empty() ||
+        hwResource.awaitingResponse() || retryPkt) {
+        return;
+    }
+
+    DPRINTF(TraceCPUData, "Issuing %s seq. num %lli.\n",
+            htmBarrier->typeToStr(), htmBarrier->seqNum);
+    addToSortedReadyList(htmBarrier->seqNum,
+                         owner.clockEdge() + htmBarrier->compDelay);
+    hwResource.occupy(htmBarrier);
+    htmBarrierIssued = true;
+}
+
+PacketPtr
+TraceCPU::ElasticDataGen::executeHtmCmd(GraphNode* node_ptr)
+{
+    Request::Flags flags;
+    if (node_ptr->type == Record::HTM_START) {
+        flags = Request::HTM_START;
+        ++htmUid;
+    } else {
+        flags = Request::HTM_COMMIT;
+    }
+    DPRINTF(TraceCPUData, "Executing %s %lli of transaction %lli.\n",
+            node_ptr->typeToStr(), node_ptr->seqNum, htmUid);
+
+    PacketPtr pkt = createHtmSignal(0, flags);
+    pkt->req->setReqInstSeqNum(node_ptr->seqNum);
+    pkt->req->setPC(node_ptr->pc);
+
+    bool success = port.sendTimingReq(pkt);
+    ++elasticStats.numSendAttempted;
+    if (!success) {
+        ++elasticStats.numSendFailed;
+        DPRINTF(TraceCPUData, "Send failed. Saving packet for retry.\n");
+        return pkt;
+    } else {
+        ++elasticStats.numSendSucceeded;
+        return nullptr;
+    }
+}
+
+PacketPtr
+TraceCPU::ElasticDataGen::createHtmSignal(Addr addr, Request::Flags flags)
+{
+    auto req = Request::create(addr, 8,
+        flags | Request::PHYSICAL | Request::STRICT_ORDER, requestorId);
+    req->setContext(owner.cpuId());
+    if (req->isHTMAbort())
+        req->setHtmAbortCause(htmAbortCause);
+
+    PacketPtr pkt = Packet::createRead(req);
+    pkt->dataDynamic(new uint8_t[8]);
+    pkt->setHtmTransactional(htmUid);
+    return pkt;
+}
+
+void
+TraceCPU::ElasticDataGen::sendHtmPacket(PacketPtr pkt)
+{
+    // Keep the order of the packets already waiting for the port
+    if (retryPkt || !htmPktQueue.empty() || !port.sendTimingReq(pkt)) {
+        htmPktQueue.push_back(pkt);
+    }
+}
+
+void
+TraceCPU::ElasticDataGen::beginHtmAbort(HtmCacheFailure rc)
+{
+    if (htmAborting)
+        return;
+    assert(!htmRecords.empty());
+
+    switch (rc) {
+      case HtmCacheFailure::FAIL_SELF:
+        htmAbortCause = HtmFailureFaultCause::SIZE;
+        break;
+      case HtmCacheFailure::FAIL_REMOTE:
+        htmAbortCause = HtmFailureFaultCause::MEMORY;
+        break;
+      default:
+        htmAbortCause = HtmFailureFaultCause::OTHER;
+        break;
+    }
+    DPRINTF(TraceCPUData, "Transaction %lli failed (%s), aborting.\n",
+            htmUid, htmFailureToStr(rc));
+    htmAborting = true;
+    ++elasticStats.numHtmAborts;
+
+    // The failed request, if it was waiting for a retry, is not sent again
+    if (retryPkt) {
+        delete retryPkt;
+        retryPkt = nullptr;
+    }
+
+    // Squash the nodes of the transaction that are ready but have not sent
+    // a request yet, releasing the resources they occupy
+    for (const auto &ready_node : readyList) {
+        auto graph_itr = depGraph.find(ready_node.seqNum);
+        assert(graph_itr != depGraph.end());
+        GraphNode* node_ptr = graph_itr->second;
+        hwResource.release(node_ptr);
+        if (node_ptr->isStore() && !node_ptr->isStrictlyOrdered())
+            hwResource.releaseStoreBuffer();
+        if (node_ptr == htmBarrier)
+            htmBarrier = nullptr;
+        delete node_ptr;
+        depGraph.erase(graph_itr);
+    }
+    readyList.clear();
+
+    // Nodes pending issue have not taken up resources
+    while (!depFreeQueue.empty()) {
+        depGraph.erase(depFreeQueue.front()->seqNum);
+        delete depFreeQueue.front();
+        depFreeQueue.pop();
+    }
+    for (auto node_ptr : syncWaitList) {
+        depGraph.erase(node_ptr->seqNum);
+        delete node_ptr;
+    }
+    syncWaitList.clear();
+
+    // Of the remaining nodes, those without dependencies have sent their
+    // request and are deleted on its response. The others are squashed.
+    auto graph_itr = depGraph.begin();
+    while (graph_itr != depGraph.end()) {
+        GraphNode* node_ptr = graph_itr->second;
+        if (node_ptr->robDep.empty() && node_ptr->regDep.empty() &&
+            (node_ptr != htmBarrier || htmBarrierIssued)) {
+            node_ptr->dependents.clear();
+            graph_itr++;
+        } else {
+            if (node_ptr == htmBarrier)
+                htmBarrier = nullptr;
+            delete node_ptr;
+            graph_itr = depGraph.erase(graph_itr);
+        }
+    }
+
+    // The rest of the transaction is read again on restart, and until then
+    // other cores must not consider its nodes done
+    replayQueue.clear();
+    lastReadSeqNum = htmRecords.front().seqNum - 1;
+}
+
+void
+TraceCPU::ElasticDataGen::tryFinishHtmAbort()
+{
+    if (!htmAborting || htmAbortSent)
+        return;
+    if (!depGraph.empty() || hwResource.awaitingResponse() ||
+        !htmPktQueue.empty()) {
+        return;
+    }
+
+    DPRINTF(TraceCPUData, "Signalling abort of transaction %lli.\n",
+            htmUid);
+    sendHtmPacket(createHtmSignal(0, Request::HTM_ABORT));
+    htmAbortSent = true;
+}
+
+void
+TraceCPU::ElasticDataGen::restartTransaction()
+{
+    assert(htmAborting && htmAbortSent);
+    DPRINTF(TraceCPUData, "Transaction %lli aborted, replaying it from "
+            "seq. num %lli.\n", htmUid, htmRecords.front().seqNum);
+    htmAborting = false;
+    htmAbortSent = false;
+    inHtm = false;
+    replayQueue.assign(htmRecords.begin(), htmRecords.end());
+    nextRead = true;
+}
+
 TraceCPU::ElasticDataGen::HardwareResource::HardwareResource(
         uint16_t max_rob, uint16_t max_stores, uint16_t max_loads) :
     sizeROB(max_rob),
@@ -1090,11 +1555,11 @@ TraceCPU::FixedRetryGen::send(Addr addr, unsigned size, const MemCmd& cmd,
 {
 
     // Create new request
-    auto req = std::make_shared<Request>(addr, size, flags, requestorId);
+    auto req = Request::create(addr, size, flags, requestorId);
     req->setPC(pc);
 
     // If this is not done it triggers assert in L1 cache for invalid contextId
-    req->setContext(ContextID(0));
+    req->setContext(owner.cpuId());
 
     // Embed it in a packet
     PacketPtr pkt = new Packet(req, cmd);
@@ -1198,7 +1663,8 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         const std::string& filename, const double time_multiplier) :
     trace(filename),
     timeMultiplier(time_multiplier),
-    microOpCount(0)
+    microOpCount(0),
+    coreId(-1)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::InstDepRecordHeader header_msg;
@@ -1213,6 +1679,8 @@ TraceCPU::ElasticDataGen::InputStream::InputStream(
         // Assign window size equal to the field in the trace that was recorded
         // when the data dependency trace was captured in the o3cpu model
         windowSize = header_msg.window_size();
+        if (header_msg.has_core_id())
+            coreId = header_msg.core_id();
     }
 }
 
@@ -1253,6 +1721,13 @@ TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
                 element->regDep.push_back(pkt_msg.reg_dep(i));
         }
 
+        // Repeated field syncDep
+        element->syncDep.clear();
+        for (const auto &sync_dep : pkt_msg.sync_dep()) {
+            element->syncDep.emplace_back(sync_dep.core(),
+                                          sync_dep.seq_num());
+        }
+
         // Optional fields
         if (pkt_msg.has_p_addr())
             element->physAddr = pkt_msg.p_addr();
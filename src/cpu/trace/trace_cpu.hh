@@ -39,15 +39,19 @@
 #define __CPU_TRACE_TRACE_CPU_HH__
 
 #include <cstdint>
+#include <deque>
 #include <list>
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
+#include "mem/htm.hh"
 #include "params/TraceCPU.hh"
 #include "proto/inst_dep_record.pb.h"
 #include "proto/packet.pb.h"
@@ -137,6 +141,21 @@ namespace gem5
  * A CountedExitEvent that contains a static int belonging to the Trace CPU
  * class as a down counter is used to implement multi Trace CPU simulation
  * exit.
+ *
+ * Traces of multi-threaded workloads are replayed with one Trace CPU per
+ * captured core. A node with sync dependencies on records of other cores is
+ * not issued until those records have completed in the Trace CPUs replaying
+ * them, which are looked up by the core id in the trace header.
+ *
+ * Hardware transactions are replayed against the HTM of the system. Only
+ * attempts that committed during capture are replayed, aborted ones are
+ * skipped when the trace is read. Transaction start and commit nodes are
+ * serialising: they are issued once all older nodes have completed and no
+ * younger node is read before they complete. The loads and stores in
+ * between are sent as transactional accesses. When the memory system fails
+ * the transaction, the nodes of the transaction not yet sent are squashed,
+ * the outstanding responses are drained, the abort is signalled and the
+ * transaction is replayed again from its start.
  */
 
 class TraceCPU : public BaseCPU
@@ -593,6 +612,12 @@ class TraceCPU : public BaseCPU
             /** List of order dependencies. */
             RobDepList robDep;
 
+            /**
+             * List of dependencies on records of other cores, as pairs of
+             * core id and sequence number.
+             */
+            std::vector<std::pair<uint32_t, NodeSeqNum>> syncDep;
+
             /** Computational delay */
             uint64_t compDelay;
 
@@ -618,6 +643,14 @@ class TraceCPU : public BaseCPU
             /** Is the node a compute (non load/store) node */
             bool isComp() const { return (type == Record::COMP); }
 
+            /** Is the node a transaction start or commit */
+            bool
+            isHtmCmd() const
+            {
+                return (type == Record::HTM_START ||
+                        type == Record::HTM_COMMIT);
+            }
+
             /** Remove completed instruction from register dependency array */
             bool removeRegDep(NodeSeqNum reg_dep);
 
@@ -781,6 +814,9 @@ class TraceCPU : public BaseCPU
              */
             uint32_t windowSize;
 
+            /** The core id read from the header of the protobuf trace */
+            int coreId;
+
           public:
             /**
              * Create a trace input stream for a given file name.
@@ -811,6 +847,9 @@ class TraceCPU : public BaseCPU
             /** Get window size from trace */
             uint32_t getWindowSize() const { return windowSize; }
 
+            /** Get the id of the captured core, -1 if not in the trace */
+            int getCoreId() const { return coreId; }
+
             /** Get number of micro-ops modelled in the TraceCPU replay */
             uint64_t getMicroOpCount() const { return microOpCount; }
         };
@@ -832,10 +871,33 @@ class TraceCPU : public BaseCPU
             execComplete(false),
             windowSize(trace.getWindowSize()),
             hwResource(params.sizeROB, params.sizeStoreBuffer,
-                       params.sizeLoadBuffer), elasticStats(&_owner, _name)
+                       params.sizeLoadBuffer),
+            coreId(trace.getCoreId() < 0 ? owner.cpuId() : trace.getCoreId()),
+            lastReadSeqNum(0),
+            htmEnabled(owner.system->getHTM() != nullptr),
+            htmBarrier(nullptr),
+            htmBarrierIssued(false),
+            inHtm(false),
+            htmAborting(false),
+            htmAbortSent(false),
+            htmAbortCause(HtmFailureFaultCause::INVALID),
+            htmUid(0),
+            elasticStats(&_owner, _name)
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
+            if (!syncGens.emplace(coreId, this).second) {
+                warn("%s: Core %d is replayed by more than one Trace CPU, "
+                     "sync dependencies on it are ignored.", name(), coreId);
+            }
+        }
+
+        ~ElasticDataGen()
+        {
+            // Don't leave the other generators a dangling pointer
+            auto gen_itr = syncGens.find(coreId);
+            if (gen_itr != syncGens.end() && gen_itr->second == this)
+                syncGens.erase(gen_itr);
         }
 
         /**
@@ -945,7 +1007,106 @@ class TraceCPU : public BaseCPU
         /** Get number of micro-ops modelled in the TraceCPU replay */
         uint64_t getMicroOpCount() const { return trace.getMicroOpCount(); }
 
+        /**
+         * Check if a node of the replayed trace has completed, i.e. it has
+         * been read and removed from the dependency graph. Used by the
+         * generators of other cores to resolve sync dependencies.
+         *
+         * @param seq_num seq. num of the node
+         * @return true if the node has completed
+         */
+        bool isNodeDone(NodeSeqNum seq_num) const;
+
       private:
+        /**
+         * Read the next node to add to the graph, either from the records
+         * of a transaction being replayed or from the trace. Transactions
+         * are read ahead up to their end so that attempts that aborted
+         * during capture are skipped, and the records of the others are
+         * kept in case the transaction needs to be replayed again.
+         *
+         * @param new_node node to populate
+         * @return true if a node could be read
+         */
+        bool readNode(GraphNode* new_node);
+
+        /**
+         * Check if the sync dependencies of a node have completed in the
+         * generators replaying the other cores.
+         *
+         * @param node_ptr pointer to the node
+         * @return true if the node may issue
+         */
+        bool syncDepsDone(const GraphNode* node_ptr) const;
+
+        /**
+         * Ask the generators a node has pending sync dependencies on to
+         * wake this one up when they complete.
+         *
+         * @param node_ptr pointer to the waiting node
+         */
+        void waitOnSyncDeps(const GraphNode* node_ptr);
+
+        /**
+         * Schedule an execute event for the generators of other cores that
+         * wait on nodes of this one which have completed.
+         */
+        void wakeSyncWaiters();
+
+        /**
+         * Issue the pending transaction start or commit node once all older
+         * nodes have completed.
+         */
+        void tryIssueHtmBarrier();
+
+        /**
+         * Create the request of a transaction start or commit node and send
+         * it, returning the packet if the send failed.
+         *
+         * @param node_ptr pointer to the start or commit node
+         * @return packet pointer if the request failed and nullptr if it
+         *          was sent successfully
+         */
+        PacketPtr executeHtmCmd(GraphNode* node_ptr);
+
+        /**
+         * Create a packet for an HTM signal of the current transaction.
+         *
+         * @param addr address of the signal
+         * @param flags request flags that include the HTM command
+         * @return the packet to send
+         */
+        PacketPtr createHtmSignal(Addr addr, Request::Flags flags);
+
+        /**
+         * Send a packet that no node waits on to issue, queueing it if the
+         * port is busy.
+         *
+         * @param pkt packet to send
+         */
+        void sendHtmPacket(PacketPtr pkt);
+
+        /**
+         * Start aborting the current transaction after the memory system
+         * failed it: squash the nodes that have not sent a request yet and
+         * stop reading the trace.
+         *
+         * @param rc failure reported by the memory system
+         */
+        void beginHtmAbort(HtmCacheFailure rc);
+
+        /**
+         * Signal the abort to the memory system once all the responses of
+         * the transaction have been received.
+         */
+        void tryFinishHtmAbort();
+
+        /**
+         * Replay the aborted transaction again from its start once the
+         * abort has been acknowledged.
+         */
+        void restartTransaction();
+
         /** Reference of the TraceCPU. */
         TraceCPU& owner;
 
@@ -1005,6 +1166,72 @@ class TraceCPU : public BaseCPU
         /** List of nodes that are ready to execute */
         std::list<ReadyNode> readyList;
 
+        /** Id of the replayed core, used to resolve sync dependencies. */
+        const uint32_t coreId;
+
+        /** Sequence number of the last node added to the graph. */
+        NodeSeqNum lastReadSeqNum;
+
+        /**
+         * Dependency-free nodes waiting on records of other cores before
+         * they can be issued.
+         */
+        std::list<const GraphNode*> syncWaitList;
+
+        /**
+         * Generators of other cores waiting on nodes of this one, with the
+         * sequence number each waits on.
+         */
+        std::vector<std::pair<NodeSeqNum, ElasticDataGen*>> syncWaiters;
+
+        /** The generators of all Trace CPUs by the id of their core. */
+        static std::unordered_map<uint32_t, ElasticDataGen*> syncGens;
+
+        /**
+         * Whether the system has an HTM. Without one, transaction start and
+         * commit nodes are replayed as compute nodes.
+         */
+        const bool htmEnabled;
+
+        /**
+         * The transaction start or commit node that serialises the replay,
+         * nullptr if there is none.
+         */
+        GraphNode* htmBarrier;
+
+        /** Whether the barrier node has been issued. */
+        bool htmBarrierIssued;
+
+        /** Whether a transaction has started and not yet committed. */
+        bool inHtm;
+
+        /** Whether the current transaction is being aborted. */
+        bool htmAborting;
+
+        /** Whether the abort has been signalled to the memory system. */
+        bool htmAbortSent;
+
+        /** The cause of the current abort. */
+        HtmFailureFaultCause htmAbortCause;
+
+        /** Id of the current transaction. */
+        uint64_t htmUid;
+
+        /**
+         * Records of the current transaction, from its start to its commit,
+         * kept until it commits in case it needs to be replayed again.
+         */
+        std::vector<GraphNode> htmRecords;
+
+        /** Records of the current transaction still to be read. */
+        std::deque<GraphNode> replayQueue;
+
+        /**
+         * Packets no node waits on to issue, i.e. HTM signals and retries
+         * of accesses nacked by the memory system, waiting for the port.
+         */
+        std::deque<PacketPtr> htmPktQueue;
+
       protected:
         // Defining the a stat group
         struct ElasticDataGenStatGroup : public statistics::Group
@@ -1022,6 +1249,15 @@ class TraceCPU : public BaseCPU
             statistics::Scalar numSplitReqs;
             statistics::Scalar numSOLoads;
             statistics::Scalar numSOStores;
+            /** Stats for the replay of hardware transactions. */
+            statistics::Scalar numHtmStarts;
+            statistics::Scalar numHtmCommits;
+            statistics::Scalar numHtmAborts;
+            statistics::Scalar numHtmTraceAborts;
+            statistics::Scalar numHtmNacks;
+            /** Stats for sync dependencies across cores. */
+            statistics::Scalar numSyncDeps;
+            statistics::Scalar numSyncStalls;
             /** Tick when ElasticDataGen completes execution */
             statistics::Scalar dataLastTick;
         } elasticStats;
@@ -84,6 +84,23 @@ class HTM(ClockedObject):
     " have obtained stale data (False: abort transaction)")
     delay_interrupts = Param.Bool(False, "Delay interrupts that occur "
     " during transaction until its end (False: abort transaction)")
+    # Copy-on-write register checkpoints: rather than copying the
+    # register file when a transaction begins, CPU models that see every
+    # register write (or commit, in O3) save each register right before
+    # its first write within the transaction, and aborts only restore the
+    # registers that were written.
+    cow_register_checkpoint = Param.Bool(True, "Save registers lazily"
+    " on their first write within a transaction (False: copy the whole"
+    " register file upon transaction begin)")
+    # Lock elision-style fallback: a transaction aborted because of the
+    # fallback lock (conflict on it, or explicit abort after finding it
+    # taken) subscribes to the lock, i.e. does not begin again until
+    # the lock is found free, instead of repeatedly starting and aborting
+    # while the lock is held. Requires fallbacklock_addr.
+    fallback_lock_wait = Param.Bool(False, "Transactions aborted by the"
+    " fallback lock wait for its release before starting again")
+    fallback_lock_poll_latency = Param.Cycles(20, "Cycles between checks"
+    " of a held fallback lock by waiting transactions")
 
 
     # Debugging/profiling facilities
@@ -42,6 +42,7 @@ from m5.proxy import *
 from m5.SimObject import SimObject
 
 from m5.objects.ClockedObject import ClockedObject
+from m5.objects.ReplacementPolicies import *
 
 class BaseXBar(ClockedObject):
     type = 'BaseXBar'
@@ -144,6 +145,16 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # By default the snoop filter is unbounded and precisely tracks
+    # every line held above it. Setting a number of sets turns it into
+    # a finite set-associative structure that back-invalidates the
+    # lines it evicts.
+    num_sets = Param.Unsigned(0, "Number of sets, 0 for an unbounded "
+                              "snoop filter")
+    assoc = Param.Unsigned(16, "Associativity of a finite snoop filter")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of a finite snoop filter")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -635,6 +635,79 @@ BaseCache::recvAtomic(PacketPtr pkt)
     return lat * clockPeriod();
 }
 
+void
+BaseCache::recvAtomicWarmup(WarmAccessBatch &batch)
+{
+    DPRINTF(CacheVerbose, "%s: %d accesses\n", __func__, batch.size());
+
+    // the misses, and where they are in the batch
+    WarmAccessBatch misses;
+    std::vector<size_t> miss_idx;
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const WarmAccess &access = batch[i];
+        const Addr blk_addr = access.addr & ~Addr(blkSize - 1);
+        RequestPtr req = Request::create(
+            blk_addr, blkSize, access.isSecure ? Request::SECURE : 0,
+            access.requestorId);
+        Packet pkt(req, MemCmd::ReadSharedReq);
+
+        Cycles lat;
+        if (tags->accessBlock(&pkt, lat))
+            continue;
+
+        // whether we may allocate the line is independent of whether
+        // the cache above may
+        misses.emplace_back(blk_addr, access.isSecure, access.requestorId);
+        miss_idx.push_back(i);
+    }
+
+    if (misses.empty())
+        return;
+
+    memSidePort.sendAtomicWarmup(misses);
+
+    // a line is allocated like a fill from below would, i.e., not at
+    // all in a mostly exclusive cache
+    const bool allocate = allocOnFill(MemCmd::ReadSharedReq);
+
+    PacketList writebacks;
+    for (size_t j = 0; j < misses.size(); ++j) {
+        const WarmAccess &miss = misses[j];
+        if (!miss.allocate) {
+            // if we cannot hold a clean copy, neither can the caches
+            // above
+            batch[miss_idx[j]].allocate = false;
+            continue;
+        }
+
+        // the line may have been allocated by an earlier access in
+        // the batch
+        if (!allocate || tags->findBlock(miss.addr, miss.isSecure))
+            continue;
+
+        RequestPtr req = Request::create(
+            miss.addr, blkSize, miss.isSecure ? Request::SECURE : 0,
+            miss.requestorId);
+        Packet pkt(req, MemCmd::ReadReq);
+        pkt.allocate();
+        memSidePort.sendFunctional(&pkt);
+        assert(pkt.isResponse());
+
+        CacheBlk *blk = allocateBlock(&pkt, writebacks);
+        if (blk) {
+            // only readable, a write will have to upgrade the line
+            blk->setCoherenceBits(CacheBlk::ReadableBit);
+            updateBlockData(blk, &pkt, false);
+            blk->setWhenReady(clockEdge(fillLatency));
+
+            DPRINTF(Cache, "%s: allocated %s\n", __func__, blk->print());
+        }
+
+        doWritebacksAtomic(writebacks);
+    }
+}
+
 void
 BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
 {
@@ -1622,7 +1695,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1665,7 +1738,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -1739,7 +1812,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = Request::create(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -1831,8 +1904,10 @@ BaseCache::sendMSHRQueuePacket(MSHR* mshr)
     if (mshr->isForward) {
         // not a cache block request, but a response is expected
         // make copy of current packet to forward, keep current
-        // copy for response handling
-        pkt = new Packet(tgt_pkt, false, true);
+        // copy for response handling, the two packets share a
+        // pooled payload so that the response data need not be
+        // copied back
+        pkt = new Packet(tgt_pkt, false, true, true);
         assert(!pkt->isWrite());
     }
 
@@ -2474,6 +2549,16 @@ BaseCache::CpuSidePort::recvAtomic(PacketPtr pkt)
     }
 }
 
+void
+BaseCache::CpuSidePort::recvAtomicWarmup(WarmAccessBatch &batch)
+{
+    if (cache->system->bypassCaches()) {
+        cache->memSidePort.sendAtomicWarmup(batch);
+    } else {
+        cache->recvAtomicWarmup(batch);
+    }
+}
+
 void
 BaseCache::CpuSidePort::recvFunctional(PacketPtr pkt)
 {
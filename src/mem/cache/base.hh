@@ -324,6 +324,8 @@ class BaseCache : public ClockedObject
 
         virtual Tick recvAtomic(PacketPtr pkt) override;
 
+        virtual void recvAtomicWarmup(WarmAccessBatch &batch) override;
+
         virtual void recvFunctional(PacketPtr pkt) override;
 
         virtual AddrRangeList getAddrRanges() const override;
@@ -603,6 +605,17 @@ class BaseCache : public ClockedObject
      */
     virtual Tick recvAtomicSnoop(PacketPtr pkt) = 0;
 
+    /**
+     * Replay a batch of warm-up accesses, which only update the tags
+     * and replacement data. Hits are touched, and misses are sent
+     * below as a single batch. A line that missed is then allocated
+     * in a clean state, with its data read functionally, unless
+     * somebody below found it could break coherence.
+     *
+     * @param batch The accesses to replay, in program order.
+     */
+    void recvAtomicWarmup(WarmAccessBatch &batch);
+
     /**
      * Performs the access specified by the request.
      *
@@ -0,0 +1,50 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import *
+
+class CompressionEvaluator(SimObject):
+    type = 'CompressionEvaluator'
+    cxx_class = 'gem5::compression::Evaluator'
+    cxx_header = "mem/cache/compressors/evaluator.hh"
+
+    system = Param.System(Parent.any, "System whose memory is evaluated")
+    compressors = VectorParam.BaseCacheCompressor([],
+        "Compressors to be evaluated. Each compressor is used by a single "
+        "thread, so a compressor cannot be listed twice, nor together with "
+        "a MultiCompressor that contains it. Both are rejected")
+    block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
+    trace_file = Param.String("", "Memory trace generated by a "
+        "MemTraceProbe, whose accessed lines are evaluated in access order. "
+        "If empty, every line of the memory is evaluated")
+    max_lines = Param.UInt64(0,
+        "Maximum number of lines evaluated (0 for no limit)")
+    chunk_lines = Param.UInt64(65536, "Number of lines snapshotted and "
+        "compressed at a time, which bounds the memory used by the snapshot")
+    num_threads = Param.Unsigned(0, "Number of threads that run the "
+        "compressors (0 for one per compressor)")
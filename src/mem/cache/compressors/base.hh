@@ -206,6 +206,9 @@ class Base : public SimObject
     /** The cache can only be set once. */
     virtual void setCache(BaseCache *_cache);
 
+    /** @return The size of an uncompressed cache line, in bytes. */
+    std::size_t getBlockSize() const { return blkSize; }
+
     /**
      * Apply the compression process to the cache line. Ignores compression
      * cycles.
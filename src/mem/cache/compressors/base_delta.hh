@@ -37,6 +37,8 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "mem/cache/compressors/dictionary_compressor.hh"
@@ -56,6 +58,79 @@ GEM5_DEPRECATED_NAMESPACE(Compressor, compression);
 namespace compression
 {
 
+/**
+ * Count the number of explicit bases, besides the implicit zero base, that a
+ * base-delta-immediate encoding of a sequence of values allocates. A value
+ * is encoded as a delta of any existing base it is close enough to, and
+ * becomes a new base otherwise.
+ *
+ * Only one explicit base can ever be useful, and it must be the first value
+ * that is not close to zero, so the common cases are resolved with loops
+ * that have neither early exits nor loop-carried dependencies other than
+ * reductions, which compilers vectorize. Only sequences that need more than
+ * one explicit base fall back to a sequential search.
+ *
+ * @tparam T Type of the values and bases.
+ * @tparam DeltaSizeBits Size of a signed delta, in bits.
+ * @param values The sequence of values.
+ * @param n The number of values.
+ * @return The number of explicit bases allocated.
+ */
+template <class T, std::size_t DeltaSizeBits>
+std::size_t
+countDeltaBases(const T* values, std::size_t n)
+{
+    static_assert(std::is_unsigned<T>::value, "Bases must be unsigned");
+    static_assert((DeltaSizeBits > 0) && (DeltaSizeBits < 8 * sizeof(T)),
+        "Deltas must be smaller than the bases");
+
+    // Modular arithmetic maps the signed range [-limit, limit] around the
+    // base to the unsigned range [0, 2 * limit]
+    constexpr T limit = static_cast<T>(mask(DeltaSizeBits - 1));
+    const auto is_close = [](T value, T base) {
+        return static_cast<T>(value - base + limit) <=
+            static_cast<T>(2 * limit);
+    };
+
+    // Find the first value that is not close to zero
+    std::size_t first = n;
+    for (std::size_t i = 0; i < n; i++) {
+        first = (!is_close(values[i], 0) && (i < first)) ? i : first;
+    }
+    if (first == n) {
+        return 0;
+    }
+
+    // Check whether the remaining values are close to either base
+    const T base = values[first];
+    std::size_t num_far = 0;
+    for (std::size_t i = first + 1; i < n; i++) {
+        num_far += !is_close(values[i], 0) && !is_close(values[i], base);
+    }
+    if (num_far == 0) {
+        return 1;
+    }
+
+    // More bases are needed, so they must be searched for sequentially
+    std::vector<T> bases(1, base);
+    for (std::size_t i = first + 1; i < n; i++) {
+        if (is_close(values[i], 0)) {
+            continue;
+        }
+        bool found = false;
+        for (const T b : bases) {
+            if (is_close(values[i], b)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            bases.push_back(values[i]);
+        }
+    }
+    return bases.size();
+}
+
 /**
  * Base class for all base-delta-immediate compressors. Although not proposed
  * like this in the original paper, the sub-compressors of BDI are dictionary
@@ -121,16 +196,42 @@ class BaseDelta : public DictionaryCompressor<BaseType>
 
     void addToDictionary(DictionaryEntry data) override;
 
+    /**
+     * Compressed data generated by the fast compression path. The encoding
+     * of every value is fully determined by its size and the number of
+     * bases, so only a copy of the original values is kept to be able to
+     * decompress it.
+     */
+    class DeltaCompData;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
 
+    void decompress(const Base::CompressionData* comp_data,
+        uint64_t* data) override;
+
   public:
     typedef BaseDictionaryCompressorParams Params;
     BaseDelta(const Params &p);
     ~BaseDelta() = default;
 };
 
+template <class BaseType, std::size_t DeltaSizeBits>
+class BaseDelta<BaseType, DeltaSizeBits>::DeltaCompData
+    : public Base::CompressionData
+{
+  public:
+    /** The original chunks of the line. */
+    const std::vector<Base::Chunk> chunks;
+
+    DeltaCompData(const std::vector<Base::Chunk>& chunks)
+      : Base::CompressionData(), chunks(chunks)
+    {
+    }
+    ~DeltaCompData() = default;
+};
+
 template <class BaseType, std::size_t DeltaSizeBits>
 class BaseDelta<BaseType, DeltaSizeBits>::PatternX
     : public DictionaryCompressor<BaseType>::UncompressedPattern
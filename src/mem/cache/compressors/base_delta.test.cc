@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mem/cache/compressors/base_delta_impl.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/**
+ * Reference compression of a line through the sequential dictionary
+ * search of DictionaryCompressor, using the patterns of BaseDelta. The
+ * compressor is never constructed, it only gives access to its types.
+ */
+template <class T, std::size_t DeltaSizeBits>
+class SequentialBaseDelta : public compression::BaseDelta<T, DeltaSizeBits>
+{
+    using Parent = compression::BaseDelta<T, DeltaSizeBits>;
+    using Dictionary = compression::DictionaryCompressor<T>;
+    using Entry = typename Dictionary::DictionaryEntry;
+
+  public:
+    struct Result
+    {
+        std::size_t sizeBits = 0;
+        std::size_t numX = 0;
+        std::size_t numM = 0;
+    };
+
+    static Result
+    compress(const std::vector<T> &values)
+    {
+        Result result;
+        std::vector<Entry> dictionary(1, Dictionary::toDictionaryEntry(0));
+        for (const T value : values) {
+            const Entry bytes = Dictionary::toDictionaryEntry(value);
+            auto pattern = Parent::PatternFactory::getPattern(bytes,
+                Dictionary::toDictionaryEntry(0), -1);
+            for (std::size_t i = 0; i < dictionary.size(); i++) {
+                auto temp = Parent::PatternFactory::getPattern(bytes,
+                    dictionary[i], i);
+                if (temp->getSizeBits() < pattern->getSizeBits())
+                    pattern = std::move(temp);
+            }
+            result.sizeBits += pattern->getSizeBits();
+            if (pattern->getPatternNumber() == Parent::X)
+                result.numX++;
+            else
+                result.numM++;
+            if (pattern->shouldAllocate())
+                dictionary.push_back(bytes);
+        }
+        return result;
+    }
+
+    /** The same result, as calculated by the fast path. */
+    static Result
+    fastCompress(const std::vector<T> &values)
+    {
+        Result result;
+        result.numX = compression::countDeltaBases<T, DeltaSizeBits>(
+            values.data(), values.size());
+        result.numM = values.size() - result.numX;
+        result.sizeBits =
+            typename Parent::PatternM(Entry(), 0).getSizeBits() *
+                result.numM +
+            typename Parent::PatternX(Entry(), 0).getSizeBits() *
+                result.numX;
+        return result;
+    }
+};
+
+template <class T, std::size_t DeltaSizeBits>
+void
+checkRandomLines(unsigned seed)
+{
+    using Compressor = SequentialBaseDelta<T, DeltaSizeBits>;
+    std::mt19937_64 rng(seed);
+    const std::size_t num_values = 64 / sizeof(T);
+
+    for (unsigned line = 0; line < 5000; line++) {
+        // Pick values around a few random bases, with deltas that are
+        // sometimes just in and sometimes just out of range
+        const unsigned num_bases = 1 + rng() % 4;
+        std::vector<T> bases(num_bases);
+        for (auto &base : bases)
+            base = (rng() % 3 == 0) ? 0 : static_cast<T>(rng());
+        const uint64_t range = 1ULL << (DeltaSizeBits - 1);
+
+        std::vector<T> values(num_values);
+        for (auto &value : values) {
+            const int64_t delta =
+                static_cast<int64_t>(rng() % (2 * range + 2)) - range - 1;
+            value = bases[rng() % num_bases] + static_cast<T>(delta);
+        }
+
+        const auto expected = Compressor::compress(values);
+        const auto actual = Compressor::fastCompress(values);
+        ASSERT_EQ(actual.numX, expected.numX) << "line " << line;
+        ASSERT_EQ(actual.numM, expected.numM) << "line " << line;
+        ASSERT_EQ(actual.sizeBits, expected.sizeBits) << "line " << line;
+    }
+}
+
+} // anonymous namespace
+
+TEST(BaseDeltaTest, CountBasesSimpleLines)
+{
+    const std::vector<uint64_t> zeros(8, 0);
+    ASSERT_EQ((compression::countDeltaBases<uint64_t, 8>(zeros.data(), 8)),
+              0);
+
+    const std::vector<uint64_t> one_base =
+        {0x1000, 0x1001, 0x7f, 0x0fff, 0, 0x1010, 0x107f, 0x0f81};
+    ASSERT_EQ((compression::countDeltaBases<uint64_t, 8>(one_base.data(),
+                                                         8)), 1);
+
+    const std::vector<uint64_t> two_bases =
+        {0x1000, 0x2000, 0x1001, 0x2001, 0, 0x3000, 1, 2};
+    ASSERT_EQ((compression::countDeltaBases<uint64_t, 8>(two_bases.data(),
+                                                         8)), 3);
+}
+
+TEST(BaseDeltaTest, MatchesSequentialSearch)
+{
+    checkRandomLines<uint64_t, 8>(1);
+    checkRandomLines<uint64_t, 16>(2);
+    checkRandomLines<uint64_t, 32>(3);
+    checkRandomLines<uint32_t, 8>(4);
+    checkRandomLines<uint32_t, 16>(5);
+    checkRandomLines<uint16_t, 8>(6);
+}
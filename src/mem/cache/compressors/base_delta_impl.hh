@@ -33,6 +33,7 @@
 #ifndef __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 #define __MEM_CACHE_COMPRESSORS_BASE_DELTA_IMPL_HH__
 
+#include "base/logging.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/compressors/base_delta.hh"
 #include "mem/cache/compressors/dictionary_compressor_impl.hh"
@@ -76,15 +77,52 @@ BaseDelta<BaseType, DeltaSizeBits>::compress(
     const std::vector<Base::Chunk>& chunks, Cycles& comp_lat,
     Cycles& decomp_lat)
 {
-    std::unique_ptr<Base::CompressionData> comp_data =
-        DictionaryCompressor<BaseType>::compress(chunks, comp_lat, decomp_lat);
+    std::unique_ptr<Base::CompressionData> comp_data;
+    std::size_t num_entries;
+    if (DictionaryCompressor<BaseType>::chunkSizeBits ==
+        8 * sizeof(BaseType)) {
+        // Every value is either a delta of one of the bases, or a new base,
+        // so the size of the line can be calculated from the number of
+        // bases alone, without generating the patterns
+        comp_lat = Cycles(DictionaryCompressor<BaseType>::compExtraLatency +
+            (chunks.size() /
+            DictionaryCompressor<BaseType>::compChunksPerCycle));
+        decomp_lat = Cycles(
+            DictionaryCompressor<BaseType>::decompExtraLatency +
+            (chunks.size() /
+            DictionaryCompressor<BaseType>::decompChunksPerCycle));
+
+        const std::vector<BaseType> values(chunks.begin(), chunks.end());
+        const std::size_t num_bases =
+            countDeltaBases<BaseType, DeltaSizeBits>(values.data(),
+            values.size());
+        num_entries = 1 + num_bases;
+        fatal_if(num_entries > DictionaryCompressor<BaseType>::dictionarySize,
+            "Dictionary of Base%dDelta%d is too small.\n",
+            8 * sizeof(BaseType), DeltaSizeBits);
+
+        auto& patterns =
+            DictionaryCompressor<BaseType>::dictionaryStats.patterns;
+        patterns[M] += chunks.size() - num_bases;
+        patterns[X] += num_bases;
+
+        comp_data = std::unique_ptr<Base::CompressionData>(
+            new DeltaCompData(chunks));
+        comp_data->setSizeBits(
+            PatternM(DictionaryEntry(), 0).getSizeBits() *
+            (chunks.size() - num_bases) +
+            PatternX(DictionaryEntry(), 0).getSizeBits() * num_bases);
+    } else {
+        comp_data = DictionaryCompressor<BaseType>::compress(chunks,
+            comp_lat, decomp_lat);
+        num_entries = DictionaryCompressor<BaseType>::numEntries;
+    }
 
     // If there are more bases than the maximum, the compressor failed.
     // Otherwise, we have to take into account all bases that have not
     // been used, considering that there is an implicit zero base that
     // does not need to be added to the final size.
-    const int diff = DEFAULT_MAX_NUM_BASES -
-        DictionaryCompressor<BaseType>::numEntries;
+    const int diff = DEFAULT_MAX_NUM_BASES - num_entries;
     if (diff < 0) {
         comp_data->setSizeBits(DictionaryCompressor<BaseType>::blkSize * 8);
         DPRINTF(CacheComp, "Base%dDelta%d compression failed\n",
@@ -98,6 +136,20 @@ BaseDelta<BaseType, DeltaSizeBits>::compress(
     return comp_data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+void
+BaseDelta<BaseType, DeltaSizeBits>::decompress(
+    const Base::CompressionData* comp_data, uint64_t* data)
+{
+    const DeltaCompData* delta_comp_data =
+        dynamic_cast<const DeltaCompData*>(comp_data);
+    if (delta_comp_data) {
+        Base::fromChunks(delta_comp_data->chunks, data);
+    } else {
+        DictionaryCompressor<BaseType>::decompress(comp_data, data);
+    }
+}
+
 } // namespace compression
 } // namespace gem5
 
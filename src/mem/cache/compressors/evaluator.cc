@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of an evaluator that measures the compressibility of
+ * memory contents with several compressors at once.
+ */
+
+#include "mem/cache/compressors/evaluator.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <thread>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "config/have_protobuf.hh"
+#include "debug/CacheComp.hh"
+#include "mem/cache/compressors/base.hh"
+#include "mem/cache/compressors/base_delta.hh"
+#include "mem/cache/compressors/multi.hh"
+#include "mem/physical.hh"
+#include "params/CompressionEvaluator.hh"
+#include "sim/system.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#endif
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Compressor, compression);
+namespace compression
+{
+
+namespace
+{
+
+/**
+ * Check whether a line can be compressed by a base-delta-immediate
+ * configuration with at most one explicit base.
+ *
+ * @param line The contents of the line.
+ * @param num_words The number of 64-bit words in the line.
+ * @param values Scratch space to split the line into values.
+ */
+template <class T, std::size_t DeltaSizeBits>
+bool
+isBaseDelta(const uint64_t* line, std::size_t num_words,
+    std::vector<T>& values)
+{
+    constexpr std::size_t values_per_word = sizeof(uint64_t) / sizeof(T);
+    values.resize(num_words * values_per_word);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = line[i / values_per_word] >>
+            ((i % values_per_word) * 8 * sizeof(T));
+    }
+    return countDeltaBases<T, DeltaSizeBits>(values.data(),
+        values.size()) <= 1;
+}
+
+/**
+ * Record a compressor and, for multi compressors, the compressors they
+ * contain. Each of them may only be used by one thread.
+ */
+void
+addUnique(std::set<const Base*>& unique_compressors, const Base* compressor)
+{
+    fatal_if(!unique_compressors.insert(compressor).second,
+        "%s can only be evaluated once, as compressors are not "
+        "thread safe. Check that it is not also part of a listed "
+        "MultiCompressor.", compressor->name());
+
+    if (auto multi = dynamic_cast<const Multi*>(compressor)) {
+        for (const auto& sub_compressor : multi->getCompressors())
+            addUnique(unique_compressors, sub_compressor);
+    }
+}
+
+} // anonymous namespace
+
+Evaluator::Evaluator(const Params &p)
+  : SimObject(p), system(p.system), compressors(p.compressors),
+    blkSize(p.block_size), traceFile(p.trace_file), maxLines(p.max_lines),
+    chunkLines(p.chunk_lines),
+    numThreads(std::max<std::size_t>(1,
+        p.num_threads ? p.num_threads : p.compressors.size())),
+    stats(*this)
+{
+    fatal_if(!isPowerOf2(blkSize) || (blkSize < 8),
+        "Block size must be a power of two of at least 8 bytes.");
+    fatal_if(chunkLines == 0, "Chunks must hold at least one line.");
+
+    std::set<const Base*> unique_compressors;
+    for (const auto& compressor : compressors) {
+        fatal_if(compressor->getBlockSize() != blkSize,
+            "%s does not use the block size of the evaluator.",
+            compressor->name());
+        addUnique(unique_compressors, compressor);
+    }
+
+#if !HAVE_PROTOBUF
+    fatal_if(!traceFile.empty(),
+        "Can't read memory traces without Protobuf support.");
+#endif
+}
+
+bool
+Evaluator::snapshotLine(Addr addr)
+{
+    for (const auto& entry : system->getPhysMem().getBackingStore()) {
+        if (entry.pmem && entry.range.contains(addr)) {
+            const std::size_t offset = addr - entry.range.start();
+            if (offset + blkSize > entry.range.size()) {
+                return false;
+            }
+            const std::size_t num_words = blkSize / 8;
+            lines.resize(lines.size() + num_words);
+            std::memcpy(&lines[lines.size() - num_words],
+                entry.pmem + offset, blkSize);
+            totalLines++;
+            if (numLines() >= chunkLines) {
+                evaluateChunk();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Evaluator::snapshotMemory()
+{
+    for (const auto& entry : system->getPhysMem().getBackingStore()) {
+        if (!entry.pmem) {
+            continue;
+        }
+        for (Addr addr = roundUp(entry.range.start(), blkSize);
+             (addr + blkSize <= entry.range.end()) && !full();
+             addr += blkSize) {
+            snapshotLine(addr);
+        }
+    }
+}
+
+void
+Evaluator::snapshotTrace()
+{
+#if HAVE_PROTOBUF
+    ProtoInputStream trace(traceFile);
+
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace.read(header_msg),
+        "Failed to read the header of %s.", traceFile);
+
+    ProtoMessage::Packet pkt_msg;
+    while (!full() && trace.read(pkt_msg)) {
+        // Requests may span several lines
+        const Addr end = pkt_msg.addr() + std::max(pkt_msg.size(), 1u);
+        for (Addr addr = roundDown(pkt_msg.addr(), blkSize);
+             (addr < end) && !full(); addr += blkSize) {
+            if (!snapshotLine(addr)) {
+                DPRINTF(CacheComp, "Skipping unbacked line %#x.\n", addr);
+            }
+        }
+    }
+#endif
+}
+
+double
+Evaluator::evaluate(Base* compressor, std::vector<Result>& results) const
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const std::size_t num_words = blkSize / 8;
+    results.resize(numLines());
+    for (std::size_t i = 0; i < results.size(); i++) {
+        Result& result = results[i];
+        result.sizeBits = compressor->compress(&lines[i * num_words],
+            result.compLat, result.decompLat)->getSizeBits();
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+Evaluator::LinePatterns
+Evaluator::classify(const uint64_t* line) const
+{
+    const std::size_t num_words = blkSize / 8;
+
+    uint64_t ored = 0;
+    uint64_t differences = 0;
+    for (std::size_t i = 0; i < num_words; i++) {
+        ored |= line[i];
+        differences |= line[i] ^ line[0];
+    }
+
+    LinePatterns patterns;
+    patterns.zero = (ored == 0);
+    patterns.repeated = (differences == 0);
+
+    std::vector<uint64_t> values_64;
+    std::vector<uint32_t> values_32;
+    std::vector<uint16_t> values_16;
+    patterns.baseDelta = patterns.repeated ||
+        isBaseDelta<uint64_t, 8>(line, num_words, values_64) ||
+        isBaseDelta<uint64_t, 16>(line, num_words, values_64) ||
+        isBaseDelta<uint64_t, 32>(line, num_words, values_64) ||
+        isBaseDelta<uint32_t, 8>(line, num_words, values_32) ||
+        isBaseDelta<uint32_t, 16>(line, num_words, values_32) ||
+        isBaseDelta<uint16_t, 8>(line, num_words, values_16);
+
+    return patterns;
+}
+
+void
+Evaluator::evaluateChunk()
+{
+    const std::size_t num_lines = numLines();
+    if (num_lines == 0) {
+        return;
+    }
+    DPRINTF(CacheComp, "Evaluating a chunk of %d lines.\n", num_lines);
+
+    // Every worker evaluates a disjoint subset of the compressors, so that
+    // no compressor is ever used by two threads. The last task is the
+    // classification of the lines.
+    const std::size_t num_tasks = compressors.size() + 1;
+    std::vector<std::vector<Result>> results(compressors.size());
+    std::vector<double> host_seconds(compressors.size(), 0);
+    std::vector<LinePatterns> patterns(num_lines);
+    const auto run_tasks = [&](std::size_t first_task) {
+        for (std::size_t task = first_task; task < num_tasks;
+             task += numThreads) {
+            if (task < compressors.size()) {
+                host_seconds[task] =
+                    evaluate(compressors[task], results[task]);
+            } else {
+                for (std::size_t i = 0; i < num_lines; i++) {
+                    patterns[i] = classify(&lines[i * (blkSize / 8)]);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 1; worker < numThreads; worker++) {
+        workers.emplace_back(run_tasks, worker);
+    }
+    run_tasks(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // The statistics are only updated by the main thread
+    stats.lines += num_lines;
+    for (const auto& line_patterns : patterns) {
+        stats.zeroLines += line_patterns.zero;
+        stats.repeatedLines += line_patterns.repeated;
+        stats.baseDeltaLines += line_patterns.baseDelta;
+    }
+    for (std::size_t c = 0; c < compressors.size(); c++) {
+        CompressorStats& compressor_stats = *stats.compressors[c];
+        for (const auto& result : results[c]) {
+            compressor_stats.sizeBits.sample(result.sizeBits);
+            compressor_stats.totalSizeBits += result.sizeBits;
+            compressor_stats.compLatency.sample(result.compLat);
+            compressor_stats.decompLatency.sample(result.decompLat);
+        }
+        compressor_stats.hostSeconds += host_seconds[c];
+    }
+
+    // The storage is reused by the next chunk
+    lines.clear();
+}
+
+void
+Evaluator::startup()
+{
+    SimObject::startup();
+
+    lines.reserve((maxLines ? std::min(maxLines, chunkLines) : chunkLines) *
+        (blkSize / 8));
+    if (traceFile.empty()) {
+        snapshotMemory();
+    } else {
+        snapshotTrace();
+    }
+    evaluateChunk();
+    inform("%s: evaluated %d lines with %d compressors.\n", name(),
+        totalLines, compressors.size());
+
+    // The snapshots are no longer needed
+    lines.shrink_to_fit();
+}
+
+Evaluator::CompressorStats::CompressorStats(statistics::Group* parent,
+    unsigned index, std::size_t blk_size)
+  : statistics::Group(parent, csprintf("compressor%d", index).c_str()),
+    ADD_STAT(sizeBits, statistics::units::Bit::get(),
+             "Distribution of the compressed sizes"),
+    ADD_STAT(totalSizeBits, statistics::units::Bit::get(),
+             "Total compressed data size"),
+    ADD_STAT(ratio, statistics::units::Ratio::get(),
+             "Ratio between the uncompressed and compressed data sizes"),
+    ADD_STAT(compLatency, statistics::units::Cycle::get(),
+             "Distribution of the compression latencies"),
+    ADD_STAT(decompLatency, statistics::units::Cycle::get(),
+             "Distribution of the decompression latencies"),
+    ADD_STAT(hostSeconds, statistics::units::Second::get(),
+             "Host time spent compressing")
+{
+    sizeBits.init(0, blk_size * 8, 8);
+    compLatency.init(16);
+    decompLatency.init(16);
+
+    ratio.flags(statistics::nozero | statistics::nonan);
+}
+
+Evaluator::EvaluatorStats::EvaluatorStats(Evaluator& evaluator)
+  : statistics::Group(&evaluator),
+    ADD_STAT(lines, statistics::units::Count::get(),
+             "Number of lines evaluated"),
+    ADD_STAT(zeroLines, statistics::units::Count::get(),
+             "Number of lines filled with zeros"),
+    ADD_STAT(repeatedLines, statistics::units::Count::get(),
+             "Number of lines made of a repeated 64-bit value"),
+    ADD_STAT(baseDeltaLines, statistics::units::Count::get(),
+             "Number of lines that fit a base-delta-immediate encoding")
+{
+    for (unsigned c = 0; c < evaluator.compressors.size(); c++) {
+        compressors.emplace_back(
+            new CompressorStats(this, c, evaluator.blkSize));
+        compressors.back()->ratio =
+            (lines * (evaluator.blkSize * 8)) /
+            compressors.back()->totalSizeBits;
+    }
+}
+
+} // namespace compression
+} // namespace gem5
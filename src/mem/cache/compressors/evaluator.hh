@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of an evaluator that measures the compressibility of memory
+ * contents with several compressors at once.
+ */
+
+#ifndef __MEM_CACHE_COMPRESSORS_EVALUATOR_HH__
+#define __MEM_CACHE_COMPRESSORS_EVALUATOR_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct CompressionEvaluatorParams;
+class System;
+
+GEM5_DEPRECATED_NAMESPACE(Compressor, compression);
+namespace compression
+{
+
+class Base;
+
+/**
+ * Offline evaluator of cache compressors. When the simulation starts (i.e.,
+ * after a checkpoint has been restored), it takes a snapshot of the lines
+ * of the physical memory, or of the lines accessed in a memory trace
+ * generated by a MemTraceProbe, and streams them through every compressor.
+ * The lines are processed in chunks of a bounded number of lines, each of
+ * them snapshotted, compressed by all the compressors and released before
+ * the next one, so that the whole memory is never copied at once.
+ *
+ * Compressors keep internal state and statistics, so each of them is owned
+ * by a single worker thread, and the compressors are spread among the
+ * workers. The results are gathered afterwards by the main thread, which is
+ * the only one that updates the statistics of the evaluator. The debug
+ * output of the compressors is not thread safe, and should therefore not be
+ * enabled when using more than one worker.
+ */
+class Evaluator : public SimObject
+{
+  protected:
+    /** The outcome of the compression of a line. */
+    struct Result
+    {
+        /** Compressed size, in bits. */
+        std::size_t sizeBits;
+
+        /** Compression latency, in cycles. */
+        Cycles compLat;
+
+        /** Decompression latency, in cycles. */
+        Cycles decompLat;
+    };
+
+    /** Which of the simple line patterns a line matches. */
+    struct LinePatterns
+    {
+        bool zero = false;
+        bool repeated = false;
+        bool baseDelta = false;
+    };
+
+    /** The system whose memory is evaluated. */
+    System* const system;
+
+    /** The compressors being evaluated. */
+    const std::vector<Base*> compressors;
+
+    /** Size of a line, in bytes. */
+    const std::size_t blkSize;
+
+    /** Trace whose accessed lines are evaluated; empty to use all memory. */
+    const std::string traceFile;
+
+    /** Maximum number of lines evaluated; 0 if unlimited. */
+    const uint64_t maxLines;
+
+    /** Number of lines snapshotted and evaluated at a time. */
+    const uint64_t chunkLines;
+
+    /** Number of worker threads. */
+    const unsigned numThreads;
+
+    /** The contents of the lines of the current chunk, sequentially. */
+    std::vector<uint64_t> lines;
+
+    /** Number of lines snapshotted so far, over all the chunks. */
+    uint64_t totalLines = 0;
+
+    /** @return The number of lines in the current chunk. */
+    std::size_t numLines() const { return lines.size() / (blkSize / 8); }
+
+    /** @return Whether the line limit has been reached. */
+    bool full() const { return maxLines && (totalLines >= maxLines); }
+
+    /**
+     * Copy the contents of a line from the backing store of the memory,
+     * and evaluate the current chunk if this fills it.
+     *
+     * @param addr Address of the line.
+     * @return Whether the line is backed by memory.
+     */
+    bool snapshotLine(Addr addr);
+
+    /**
+     * Compress the lines of the current chunk with every compressor,
+     * accumulate the results in the statistics, and release the chunk.
+     */
+    void evaluateChunk();
+
+    /** Snapshot every line of the memory. */
+    void snapshotMemory();
+
+    /** Snapshot the lines accessed in the trace, in access order. */
+    void snapshotTrace();
+
+    /**
+     * Compress every line with one compressor.
+     *
+     * @param compressor The compressor.
+     * @param results The results of each line.
+     * @return The host time spent, in seconds.
+     */
+    double evaluate(Base* compressor, std::vector<Result>& results) const;
+
+    /**
+     * Check which of the simple line patterns a line matches. These checks
+     * are made up of loops without early exits, so that they are vectorized
+     * by the compiler.
+     *
+     * @param line The contents of the line.
+     * @return The patterns matched.
+     */
+    LinePatterns classify(const uint64_t* line) const;
+
+    /** Statistics of a compressor, named after its index. */
+    struct CompressorStats : public statistics::Group
+    {
+        CompressorStats(statistics::Group* parent, unsigned index,
+            std::size_t blk_size);
+
+        /** Distribution of the compressed sizes, in bits. */
+        statistics::Distribution sizeBits;
+
+        /** Sum of the compressed sizes, in bits. */
+        statistics::Scalar totalSizeBits;
+
+        /** Ratio between the uncompressed and compressed sizes. */
+        statistics::Formula ratio;
+
+        /** Distribution of the compression latencies. */
+        statistics::Histogram compLatency;
+
+        /** Distribution of the decompression latencies. */
+        statistics::Histogram decompLatency;
+
+        /** Host time spent compressing, in seconds. */
+        statistics::Scalar hostSeconds;
+    };
+
+    struct EvaluatorStats : public statistics::Group
+    {
+        EvaluatorStats(Evaluator& evaluator);
+
+        /** Number of lines evaluated. */
+        statistics::Scalar lines;
+
+        /** Number of lines whose bytes are all zero. */
+        statistics::Scalar zeroLines;
+
+        /** Number of lines made of a single repeated 64-bit value. */
+        statistics::Scalar repeatedLines;
+
+        /**
+         * Number of lines that any base-delta-immediate configuration can
+         * compress with at most one explicit base.
+         */
+        statistics::Scalar baseDeltaLines;
+
+        /** Per-compressor statistics, in the order of the compressors. */
+        std::vector<std::unique_ptr<CompressorStats>> compressors;
+    } stats;
+
+  public:
+    typedef CompressionEvaluatorParams Params;
+    Evaluator(const Params &p);
+    ~Evaluator() = default;
+
+    void startup() override;
+};
+
+} // namespace compression
+} // namespace gem5
+
+#endif //__MEM_CACHE_COMPRESSORS_EVALUATOR_HH__
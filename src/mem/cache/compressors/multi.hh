@@ -108,6 +108,9 @@ class Multi : public Base
 
     void setCache(BaseCache *_cache) override;
 
+    /** @return The sub-compressors of this compressor. */
+    const std::vector<Base*>& getCompressors() const { return compressors; }
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
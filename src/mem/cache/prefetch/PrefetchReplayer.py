@@ -0,0 +1,50 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.SimObject import *
+from m5.params import *
+from m5.proxy import *
+
+class PrefetchReplayer(SimObject):
+    type = 'PrefetchReplayer'
+    cxx_class = 'gem5::prefetch::Replayer'
+    cxx_header = "mem/cache/prefetch/replayer.hh"
+
+    system = Param.System(Parent.any, "System the replayer belongs to")
+    prefetchers = VectorParam.QueuedPrefetcher([], "Prefetchers to be "
+        "evaluated. They must not be attached to a cache, and each of them "
+        "is replayed by a single thread, so it cannot be listed twice")
+    trace_file = Param.String("Trace of the misses of a cache, generated "
+        "by a MemTraceProbe")
+    max_accesses = Param.UInt64(0,
+        "Maximum number of misses replayed (0 for no limit)")
+    block_size = Param.Unsigned(Parent.cache_line_size, "Block size in bytes")
+    buffer_size = Param.Unsigned(256, "Number of prefetched blocks that can "
+        "be held until a miss uses them")
+    fill_latency = Param.Latency('50ns', "Time a prefetch takes to be "
+        "filled. Misses covered before that are late")
+    num_threads = Param.Unsigned(0, "Number of threads that replay the "
+        "prefetchers (0 for one per prefetcher)")
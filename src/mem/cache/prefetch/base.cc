@@ -188,19 +188,19 @@ Base::observeAccess(const PacketPtr &pkt, bool miss) const
 bool
 Base::inCache(Addr addr, bool is_secure) const
 {
-    return cache->inCache(addr, is_secure);
+    return (cache != nullptr) && cache->inCache(addr, is_secure);
 }
 
 bool
 Base::inMissQueue(Addr addr, bool is_secure) const
 {
-    return cache->inMissQueue(addr, is_secure);
+    return (cache != nullptr) && cache->inMissQueue(addr, is_secure);
 }
 
 bool
 Base::hasBeenPrefetched(Addr addr, bool is_secure) const
 {
-    return cache->hasBeenPrefetched(addr, is_secure);
+    return (cache != nullptr) && cache->hasBeenPrefetched(addr, is_secure);
 }
 
 bool
@@ -308,7 +308,11 @@ class Base : public ClockedObject
      */
     bool observeAccess(const PacketPtr &pkt, bool miss) const;
 
-    /** Determine if address is in cache */
+    /**
+     * Determine if address is in cache. Prefetchers that are replayed
+     * offline have no cache, so nothing is ever found in it, nor in its
+     * miss queue.
+     */
     bool inCache(Addr addr, bool is_secure) const;
 
     /** Determine if address is in cache miss queue */
@@ -373,6 +377,15 @@ class Base : public ClockedObject
 
     virtual void setCache(BaseCache *_cache);
 
+    /** @return Whether the prefetcher is attached to a cache. */
+    bool hasCache() const { return cache != nullptr; }
+
+    /** @return Whether the prefetcher listens to any probe point. */
+    bool hasListeners() const { return !listeners.empty(); }
+
+    /** @return The block size the prefetcher works with. */
+    unsigned getBlockSize() const { return blkSize; }
+
     /**
      * Notify prefetcher of cache access (may be any access or just
      * misses, depending on cache parameters.)
@@ -387,6 +400,20 @@ class Base : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
+    void
+    prefetchIssued()
+    {
+        prefetchStats.pfIssued++;
+        issuedPrefetches += 1;
+    }
+
+    void
+    prefetchUseful()
+    {
+        prefetchStats.pfUseful++;
+        usefulPrefetches += 1;
+    }
+
     void
     prefetchUnused()
     {
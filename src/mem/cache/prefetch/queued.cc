@@ -37,6 +37,7 @@
 
 #include "mem/cache/prefetch/queued.hh"
 
+#include <algorithm>
 #include <cassert>
 
 #include "arch/generic/tlb.hh"
@@ -61,8 +62,8 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size,
                                             bool tag_prefetch,
                                             Tick t) {
     /* Create a prefetch memory request */
-    RequestPtr req = std::make_shared<Request>(paddr, blk_size,
-                                                0, requestor_id);
+    RequestPtr req = Request::create(paddr, blk_size,
+                                     0, requestor_id);
 
     if (pfInfo.isSecure()) {
         req->setFlags(Request::SECURE);
@@ -227,6 +228,37 @@ Queued::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
     }
 }
 
+void
+Queued::replay(const PrefetchInfo &pfi, std::vector<Addr> &addresses)
+{
+    addresses.clear();
+
+    std::vector<AddrPriority> candidates;
+    calculatePrefetch(pfi, candidates);
+
+    const size_t max_pfs = getMaxPermittedPrefetches(candidates.size());
+    for (const AddrPriority& addr_prio : candidates) {
+        if (addresses.size() == max_pfs) {
+            break;
+        }
+
+        // Without a cache there are no translations, so page crossing
+        // prefetches cannot be generated
+        const Addr blk_addr = blockAddress(addr_prio.first);
+        if (!samePage(blk_addr, pfi.getAddr())) {
+            statsQueued.pfSpanPage += 1;
+            continue;
+        }
+
+        statsQueued.pfIdentified++;
+        if (queueFilter && (std::find(addresses.begin(), addresses.end(),
+            blk_addr) != addresses.end())) {
+            continue;
+        }
+        addresses.push_back(blk_addr);
+    }
+}
+
 PacketPtr
 Queued::getPacket()
 {
@@ -365,7 +397,7 @@ RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = Request::create(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PREFETCH);
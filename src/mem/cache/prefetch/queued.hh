@@ -196,6 +196,17 @@ class Queued : public Base
 
     void insert(const PacketPtr &pkt, PrefetchInfo &new_pfi, int32_t priority);
 
+    /**
+     * Train the prefetcher with an access replayed offline, when there is
+     * no cache, and get the blocks it would prefetch. The candidates are
+     * throttled and filtered like in notify(), but they are neither queued
+     * nor accounted as issued.
+     *
+     * @param pfi The access.
+     * @param addresses The block addresses to be prefetched.
+     */
+    void replay(const PrefetchInfo &pfi, std::vector<Addr> &addresses);
+
     virtual void calculatePrefetch(const PrefetchInfo &pfi,
                                    std::vector<AddrPriority> &addresses) = 0;
     PacketPtr getPacket() override;
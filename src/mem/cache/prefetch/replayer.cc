@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Implementation of an offline replayer of memory traces through
+ * prefetchers.
+ */
+
+#include "mem/cache/prefetch/replayer.hh"
+
+#include <chrono>
+#include <list>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/packet.hh"
+#include "params/PrefetchReplayer.hh"
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+Replayer::Replayer(const Params &p)
+  : SimObject(p), prefetchers(p.prefetchers), traceFile(p.trace_file),
+    maxAccesses(p.max_accesses), blkSize(p.block_size),
+    bufferSize(p.buffer_size), fillLatency(p.fill_latency),
+    numThreads(std::max<std::size_t>(1,
+        p.num_threads ? p.num_threads : p.prefetchers.size())),
+    requestorId(p.system->getRequestorId(this)), stats(*this)
+{
+    fatal_if(!isPowerOf2(blkSize), "Block size must be a power of two.");
+    fatal_if(bufferSize == 0, "The prefetch buffer cannot be empty.");
+
+    std::set<const Queued*> unique_prefetchers;
+    for (auto* prefetcher : prefetchers) {
+        fatal_if(!unique_prefetchers.insert(prefetcher).second,
+            "%s can only be replayed once, as prefetchers are not "
+            "thread safe.", prefetcher->name());
+        queues.emplace_back(new EventQueue(prefetcher->name() + ".replay"));
+    }
+}
+
+void
+Replayer::checkPrefetchers() const
+{
+    // The caches and probe listeners are only known once every object
+    // has been constructed and the listeners registered
+    for (const auto* prefetcher : prefetchers) {
+        fatal_if(prefetcher->hasCache(), "%s is attached to a cache, and "
+            "can't be replayed offline.", prefetcher->name());
+        fatal_if(prefetcher->hasListeners(), "%s listens to probe points, "
+            "and can't be replayed offline.", prefetcher->name());
+        fatal_if(prefetcher->getBlockSize() != blkSize, "%s uses %d-byte "
+            "blocks, but the replayer uses %d-byte ones.",
+            prefetcher->name(), prefetcher->getBlockSize(), blkSize);
+    }
+}
+
+void
+Replayer::readTrace()
+{
+    ProtoInputStream trace(traceFile);
+
+    ProtoMessage::PacketHeader header_msg;
+    fatal_if(!trace.read(header_msg),
+        "Failed to read the header of %s.", traceFile);
+
+    ProtoMessage::Packet pkt_msg;
+    while ((!maxAccesses || (accesses.size() < maxAccesses)) &&
+           trace.read(pkt_msg)) {
+        Access access;
+        access.tick = pkt_msg.tick();
+        access.addr = pkt_msg.addr();
+        access.size = pkt_msg.size();
+        access.hasPC = pkt_msg.has_pc();
+        access.pc = access.hasPC ? pkt_msg.pc() : 0;
+        access.secure = pkt_msg.has_flags() &&
+            (pkt_msg.flags() & Request::SECURE);
+        access.write = MemCmd(pkt_msg.cmd()).isWrite();
+        accesses.push_back(access);
+    }
+}
+
+void
+Replayer::replay(unsigned index)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Queued* const prefetcher = prefetchers[index];
+    EventQueue* const queue = queues[index].get();
+    PrefetcherStats& prefetcher_stats = *stats.prefetchers[index];
+    curEventQueue(queue);
+
+    // The prefetched blocks, with the tick at which they are filled
+    std::list<Addr> fifo;
+    std::unordered_map<Addr, std::pair<Tick, std::list<Addr>::iterator>>
+        buffer;
+
+    std::vector<uint8_t> data;
+    std::vector<Addr> addresses;
+    for (const auto& access : accesses) {
+        // Advance time, servicing the events of the prefetcher
+        while (!queue->empty() && (queue->nextTick() <= access.tick)) {
+            queue->serviceOne();
+        }
+        queue->setCurTick(std::max(queue->getCurTick(), access.tick));
+
+        const Addr blk_addr = roundDown(access.addr, blkSize);
+        const auto it = buffer.find(blk_addr);
+        if (it != buffer.end()) {
+            prefetcher_stats.useful++;
+            if (access.tick < it->second.first) {
+                prefetcher_stats.late++;
+            }
+            prefetcher->prefetchUseful();
+            fifo.erase(it->second.second);
+            buffer.erase(it);
+        } else {
+            prefetcher->incrDemandMhsrMisses();
+        }
+
+        // Train the prefetcher with the miss
+        Request::Flags flags = access.secure ? Request::SECURE : 0;
+        RequestPtr req = Request::create(access.addr, access.size, flags,
+            requestorId);
+        if (access.hasPC) {
+            req->setPC(access.pc);
+        }
+        Packet pkt(req, access.write ? MemCmd::WriteReq : MemCmd::ReadReq);
+        if (access.write) {
+            // The written data is not recorded in the trace
+            data.resize(std::max<std::size_t>(data.size(), access.size));
+            pkt.dataStatic(data.data());
+        }
+        Base::PrefetchInfo pfi(&pkt, access.addr, true);
+        prefetcher->replay(pfi, addresses);
+
+        for (const Addr addr : addresses) {
+            if (buffer.count(addr)) {
+                prefetcher_stats.redundant++;
+                continue;
+            }
+            prefetcher_stats.issued++;
+            prefetcher->prefetchIssued();
+
+            if (buffer.size() == bufferSize) {
+                prefetcher->prefetchUnused();
+                buffer.erase(fifo.front());
+                fifo.pop_front();
+            }
+            fifo.push_back(addr);
+            buffer.emplace(addr, std::make_pair(
+                queue->getCurTick() + fillLatency, std::prev(fifo.end())));
+        }
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    prefetcher_stats.hostSeconds += elapsed.count();
+}
+
+void
+Replayer::startup()
+{
+    SimObject::startup();
+
+    checkPrefetchers();
+
+    // Move each prefetcher to a queue of its own, so that its events can
+    // be serviced by the thread that replays it
+    for (std::size_t index = 0; index < prefetchers.size(); index++) {
+        prefetchers[index]->eventQueue(queues[index].get());
+    }
+
+    readTrace();
+    inform("%s: replaying %d misses through %d prefetchers.\n", name(),
+        accesses.size(), prefetchers.size());
+
+    // Every worker replays a disjoint subset of the prefetchers, and only
+    // updates their statistics
+    const auto run_replays = [this](std::size_t first) {
+        for (std::size_t index = first; index < prefetchers.size();
+             index += numThreads) {
+            replay(index);
+        }
+    };
+
+    EventQueue* const main_queue = curEventQueue();
+    std::vector<std::thread> workers;
+    for (std::size_t worker = 1; worker < numThreads; worker++) {
+        workers.emplace_back(run_replays, worker);
+    }
+    run_replays(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    curEventQueue(main_queue);
+
+    stats.accesses += accesses.size();
+
+    // The misses are no longer needed
+    accesses.clear();
+    accesses.shrink_to_fit();
+}
+
+Replayer::PrefetcherStats::PrefetcherStats(statistics::Group* parent,
+    unsigned index)
+  : statistics::Group(parent, csprintf("prefetcher%d", index).c_str()),
+    ADD_STAT(issued, statistics::units::Count::get(),
+             "Number of prefetches issued"),
+    ADD_STAT(redundant, statistics::units::Count::get(),
+             "Number of prefetches to blocks that were already prefetched"),
+    ADD_STAT(useful, statistics::units::Count::get(),
+             "Number of misses covered by a prefetch"),
+    ADD_STAT(late, statistics::units::Count::get(),
+             "Number of covered misses whose prefetch was not filled yet"),
+    ADD_STAT(coverage, statistics::units::Ratio::get(),
+             "Fraction of the misses that were covered"),
+    ADD_STAT(accuracy, statistics::units::Ratio::get(),
+             "Fraction of the prefetches that covered a miss"),
+    ADD_STAT(timeliness, statistics::units::Ratio::get(),
+             "Fraction of the covered misses whose prefetch was on time"),
+    ADD_STAT(hostSeconds, statistics::units::Second::get(),
+             "Host time spent replaying"),
+    ADD_STAT(accessRate, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Second>::get(),
+             "Number of misses replayed per host second")
+{
+    accuracy = useful / issued;
+    timeliness = (useful - late) / useful;
+
+    coverage.flags(statistics::nozero | statistics::nonan);
+    accuracy.flags(statistics::nozero | statistics::nonan);
+    timeliness.flags(statistics::nozero | statistics::nonan);
+    accessRate.flags(statistics::nozero | statistics::nonan);
+}
+
+Replayer::ReplayerStats::ReplayerStats(Replayer& replayer)
+  : statistics::Group(&replayer),
+    ADD_STAT(accesses, statistics::units::Count::get(),
+             "Number of misses replayed through each prefetcher")
+{
+    for (unsigned p = 0; p < replayer.prefetchers.size(); p++) {
+        prefetchers.emplace_back(new PrefetcherStats(this, p));
+        prefetchers.back()->coverage = prefetchers.back()->useful / accesses;
+        prefetchers.back()->accessRate =
+            accesses / prefetchers.back()->hostSeconds;
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
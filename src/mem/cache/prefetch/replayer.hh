@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ * Definition of an offline replayer of memory traces through prefetchers.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_REPLAYER_HH__
+#define __MEM_CACHE_PREFETCH_REPLAYER_HH__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/request.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct PrefetchReplayerParams;
+
+GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
+namespace prefetch
+{
+
+class Queued;
+
+/**
+ * Evaluates prefetchers offline, by replaying a stream of cache misses
+ * recorded by a MemTraceProbe through them, instead of attaching them to a
+ * cache. When the simulation starts, the trace is replayed through every
+ * prefetcher, and their coverage, accuracy and timeliness are measured.
+ *
+ * Each prefetcher is replayed by a single worker thread, and the
+ * prefetchers are spread among the workers. The prefetchers must not be
+ * attached to a cache nor listen to probe points, and must use the block
+ * size of the replayer. Every prefetcher is moved to a private event
+ * queue, whose time follows the ticks of the trace and which is only
+ * serviced by the thread that replays it; events scheduled by other
+ * objects the prefetcher relies on are not serviced. The debug output of
+ * the prefetchers is not thread safe, and should therefore not be enabled
+ * when using more than one worker.
+ *
+ * Prefetched blocks are held in a buffer, in FIFO order, until a miss uses
+ * them or they are evicted. A miss to a block in the buffer is covered; it
+ * is late if it happens before the prefetch would have been filled.
+ */
+class Replayer : public SimObject
+{
+  protected:
+    /** A miss of the trace. */
+    struct Access
+    {
+        Tick tick;
+        Addr addr;
+        Addr pc;
+        unsigned size;
+        bool hasPC;
+        bool secure;
+        bool write;
+    };
+
+    /** The prefetchers being evaluated. */
+    const std::vector<Queued*> prefetchers;
+
+    /** The trace of misses. */
+    const std::string traceFile;
+
+    /** Maximum number of misses replayed; 0 if unlimited. */
+    const uint64_t maxAccesses;
+
+    /** Size of a block, in bytes. */
+    const unsigned blkSize;
+
+    /** Number of prefetched blocks that can be held at once. */
+    const unsigned bufferSize;
+
+    /** Time between a prefetch being generated and its fill. */
+    const Tick fillLatency;
+
+    /** Number of worker threads. */
+    const unsigned numThreads;
+
+    /** Requestor ID of the replayed misses. */
+    const RequestorID requestorId;
+
+    /** The private event queue of each prefetcher. */
+    std::vector<std::unique_ptr<EventQueue>> queues;
+
+    /** The misses to be replayed. */
+    std::vector<Access> accesses;
+
+    /**
+     * Check that the prefetchers are standalone, i.e., neither attached
+     * to a cache nor to probe points, as they are moved to the queues of
+     * the replayer, and that they use the block size of the replayer.
+     */
+    void checkPrefetchers() const;
+
+    /** Read the misses from the trace. */
+    void readTrace();
+
+    /**
+     * Replay the misses through a prefetcher. Must be called by the thread
+     * that owns the prefetcher.
+     *
+     * @param index The index of the prefetcher.
+     */
+    void replay(unsigned index);
+
+    /** Statistics of a prefetcher, named after its index. */
+    struct PrefetcherStats : public statistics::Group
+    {
+        PrefetcherStats(statistics::Group* parent, unsigned index);
+
+        /** Number of prefetches issued. */
+        statistics::Scalar issued;
+
+        /** Number of prefetches dropped because the block was buffered. */
+        statistics::Scalar redundant;
+
+        /** Number of misses covered by a prefetch. */
+        statistics::Scalar useful;
+
+        /** Number of covered misses whose prefetch was not filled yet. */
+        statistics::Scalar late;
+
+        /** Fraction of the misses that were covered. */
+        statistics::Formula coverage;
+
+        /** Fraction of the prefetches that covered a miss. */
+        statistics::Formula accuracy;
+
+        /** Fraction of the covered misses whose prefetch was on time. */
+        statistics::Formula timeliness;
+
+        /** Host time spent replaying, in seconds. */
+        statistics::Scalar hostSeconds;
+
+        /** Number of misses replayed per host second. */
+        statistics::Formula accessRate;
+    };
+
+    struct ReplayerStats : public statistics::Group
+    {
+        ReplayerStats(Replayer& replayer);
+
+        /** Number of misses replayed through each prefetcher. */
+        statistics::Scalar accesses;
+
+        /** Per-prefetcher statistics, in the order of the prefetchers. */
+        std::vector<std::unique_ptr<PrefetcherStats>> prefetchers;
+    } stats;
+
+  public:
+    typedef PrefetchReplayerParams Params;
+    Replayer(const Params &p);
+    ~Replayer() = default;
+
+    void startup() override;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif //__MEM_CACHE_PREFETCH_REPLAYER_HH__
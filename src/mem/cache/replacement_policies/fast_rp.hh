@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Static dispatch of the calls to the most common replacement policies.
+ */
+
+#ifndef __MEM_CACHE_REPLACEMENT_POLICIES_FAST_RP_HH__
+#define __MEM_CACHE_REPLACEMENT_POLICIES_FAST_RP_HH__
+
+#include <memory>
+#include <typeinfo>
+
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
+namespace replacement_policy
+{
+
+/**
+ * Wraps a replacement policy for the tags, calling touch, reset and
+ * getVictim statically when the policy is exactly LRU or TreePLRU, and
+ * through the virtual interface otherwise. Only the exact policies have
+ * a fast path, as derived ones may override any of the calls.
+ */
+class FastRP
+{
+  private:
+    /** The replacement policies whose calls are resolved statically. */
+    enum class Kind
+    {
+        None,
+        LRU,
+        TreePLRU
+    };
+
+    /** The wrapped policy. */
+    Base *policy;
+
+    /** The wrapped policy, if it has a fast path. */
+    Kind kind;
+
+  public:
+    FastRP(Base *_policy)
+      : policy(_policy), kind(Kind::None)
+    {
+        if (!policy)
+            return;
+        const std::type_info &rp_type = typeid(*policy);
+        if (rp_type == typeid(LRU)) {
+            kind = Kind::LRU;
+        } else if (rp_type == typeid(TreePLRU)) {
+            kind = Kind::TreePLRU;
+        }
+    }
+
+    /**
+     * Update the replacement data of an accessed entry.
+     *
+     * @param replacement_data Replacement data to be touched.
+     * @param pkt The packet accessing the entry, if any.
+     */
+    void
+    touch(const std::shared_ptr<ReplacementData> &replacement_data,
+          const PacketPtr pkt = nullptr) const
+    {
+        switch (kind) {
+          case Kind::LRU:
+            static_cast<LRU *>(policy)->LRU::touch(replacement_data);
+            break;
+          case Kind::TreePLRU:
+            static_cast<TreePLRU *>(policy)->TreePLRU::touch(
+                replacement_data);
+            break;
+          default:
+            if (pkt)
+                policy->touch(replacement_data, pkt);
+            else
+                policy->touch(replacement_data);
+        }
+    }
+
+    /**
+     * Reset the replacement data of an inserted entry.
+     *
+     * @param replacement_data Replacement data to be reset.
+     * @param pkt The packet that caused the insertion, if any.
+     */
+    void
+    reset(const std::shared_ptr<ReplacementData> &replacement_data,
+          const PacketPtr pkt = nullptr) const
+    {
+        switch (kind) {
+          case Kind::LRU:
+            static_cast<LRU *>(policy)->LRU::reset(replacement_data);
+            break;
+          case Kind::TreePLRU:
+            static_cast<TreePLRU *>(policy)->TreePLRU::reset(
+                replacement_data);
+            break;
+          default:
+            if (pkt)
+                policy->reset(replacement_data, pkt);
+            else
+                policy->reset(replacement_data);
+        }
+    }
+
+    /**
+     * Choose a victim among the entries of a set.
+     *
+     * @param candidates The entries of the set.
+     * @return The victim.
+     */
+    ReplaceableEntry *
+    getVictim(const ReplacementCandidates &candidates) const
+    {
+        switch (kind) {
+          case Kind::LRU:
+            return static_cast<LRU *>(policy)->LRU::getVictim(candidates);
+          case Kind::TreePLRU:
+            return static_cast<TreePLRU *>(policy)->TreePLRU::getVictim(
+                candidates);
+          default:
+            return policy->getVictim(candidates);
+        }
+    }
+};
+
+} // namespace replacement_policy
+} // namespace gem5
+
+#endif // __MEM_CACHE_REPLACEMENT_POLICIES_FAST_RP_HH__
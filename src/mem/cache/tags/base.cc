@@ -46,6 +46,7 @@
 #include "mem/cache/tags/base.hh"
 
 #include <cassert>
+#include <typeinfo>
 
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
@@ -62,6 +63,10 @@ BaseTags::BaseTags(const Params &p)
     : ClockedObject(p), blkSize(p.block_size), blkMask(blkSize - 1),
       size(p.size), lookupLatency(p.tag_latency),
       system(p.system), indexingPolicy(p.indexing_policy),
+      plainIndexing(p.indexing_policy &&
+                    typeid(*p.indexing_policy) == typeid(SetAssociative) ?
+                    static_cast<SetAssociative *>(p.indexing_policy) :
+                    nullptr),
       warmupBound((p.warmup_percentage/100.0) * (p.size / p.block_size)),
       warmedUp(false), numBlocks(p.size / p.block_size),
       dataBlks(new uint8_t[p.size]), // Allocate data storage in one big chunk
@@ -83,8 +88,9 @@ BaseTags::findBlock(Addr addr, bool is_secure) const
     Addr tag = extractTag(addr);
 
     // Find possible entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    std::vector<ReplaceableEntry*> storage;
+    const std::vector<ReplaceableEntry*> &entries =
+        getPossibleEntries(addr, storage);
 
     // Search for block
     for (const auto& location : entries) {
@@ -50,12 +50,14 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/logging.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/cache_blk.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
 #include "mem/packet.hh"
 #include "params/BaseTags.hh"
 #include "sim/clocked_object.hh"
@@ -88,6 +90,26 @@ class BaseTags : public ClockedObject
     /** Indexing policy */
     BaseIndexingPolicy *indexingPolicy;
 
+    /**
+     * The indexing policy if it is exactly a SetAssociative one, which
+     * is the common case, or nullptr. Its sets can then be looked up
+     * without virtual calls nor copying the candidate entries.
+     */
+    const SetAssociative *plainIndexing;
+
+    /**
+     * Key of the invalid entries in the packed tag keys of the tags
+     * that keep them, which no tag can map to.
+     */
+    static constexpr Addr InvalidKey = MaxAddr;
+
+    /** Get the packed key of a tag and its secure bit. */
+    static Addr
+    tagKey(Addr tag, bool is_secure)
+    {
+        return (tag << 1) | is_secure;
+    }
+
     /**
      * The number of tags that need to be touched to meet the warmup
      * percentage.
@@ -157,6 +179,27 @@ class BaseTags : public ClockedObject
         statistics::Scalar dataAccesses;
     } stats;
 
+    /**
+     * Get the entries an address may be mapped to. With a plain set
+     * associative indexing policy the set is returned as it is, and
+     * otherwise the entries are copied into the given storage.
+     *
+     * @param addr The address to find the entries for.
+     * @param storage Storage for the entries, if they must be copied.
+     * @return The entries the address may be mapped to.
+     */
+    const std::vector<ReplaceableEntry*> &
+    getPossibleEntries(Addr addr,
+                       std::vector<ReplaceableEntry*> &storage) const
+    {
+        if (plainIndexing) {
+            return plainIndexing->getSetEntries(
+                plainIndexing->plainSet(addr));
+        }
+        storage = indexingPolicy->getPossibleEntries(addr);
+        return storage;
+    }
+
   public:
     typedef BaseTagsParams Params;
     BaseTags(const Params &p);
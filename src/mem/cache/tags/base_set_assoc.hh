@@ -56,6 +56,7 @@
 #include "mem/cache/base.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/fast_rp.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
@@ -87,6 +88,36 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** The associativity, i.e., the number of blocks in a set. */
+    const unsigned assoc;
+
+    /**
+     * The tag and secure bit of every block, in the same order as blks,
+     * or InvalidKey if the block is invalid. The keys of a set are
+     * contiguous, so that a lookup scans a few words rather than whole
+     * blocks through virtual calls. Only kept with a plain set
+     * associative indexing policy.
+     */
+    std::vector<Addr> tagKeys;
+
+    /** Statically dispatched calls to the replacement policy. */
+    replacement_policy::FastRP fastRP;
+
+    /**
+     * Update the key of a block whose tag or validity changed.
+     *
+     * @param blk The block.
+     */
+    void
+    updateTagKey(const CacheBlk *blk)
+    {
+        if (plainIndexing) {
+            tagKeys[blk->getSet() * assoc + blk->getWay()] =
+                blk->isValid() ? tagKey(blk->getTag(), blk->isSecure()) :
+                InvalidKey;
+        }
+    }
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -114,6 +145,34 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Finds the block in the cache without touching it. With a plain set
+     * associative indexing policy, only the keys of the set are scanned.
+     *
+     * @param addr The address to look for.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block.
+     */
+    CacheBlk *
+    findBlock(Addr addr, bool is_secure) const override
+    {
+        if (!plainIndexing)
+            return BaseTags::findBlock(addr, is_secure);
+
+        const uint32_t set = plainIndexing->plainSet(addr);
+        const Addr key = tagKey(plainIndexing->plainTag(addr), is_secure);
+        const Addr *keys = &tagKeys[set * assoc];
+        for (unsigned way = 0; way < assoc; way++) {
+            if (keys[way] == key) {
+                return static_cast<CacheBlk *>(
+                    plainIndexing->getEntry(set, way));
+            }
+        }
+
+        // Did not find block
+        return nullptr;
+    }
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
@@ -126,7 +185,8 @@ class BaseSetAssoc : public BaseTags
      */
     CacheBlk* accessBlock(const PacketPtr pkt, Cycles &lat) override
     {
-        CacheBlk *blk = findBlock(pkt->getAddr(), pkt->isSecure());
+        CacheBlk *blk = BaseSetAssoc::findBlock(pkt->getAddr(),
+                                                pkt->isSecure());
 
         // Access all tags in parallel, hence one in each way.  The data side
         // either accesses all blocks in parallel, or one block sequentially on
@@ -146,7 +206,7 @@ class BaseSetAssoc : public BaseTags
             blk->increaseRefCount();
 
             // Update replacement data of accessed block
-            replacementPolicy->touch(blk->replacementData, pkt);
+            fastRP.touch(blk->replacementData, pkt);
         }
 
         // The tag lookup latency is the same for a hit or a miss
@@ -170,12 +230,13 @@ class BaseSetAssoc : public BaseTags
                          std::vector<CacheBlk*>& evict_blks) override
     {
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
-            indexingPolicy->getPossibleEntries(addr);
+        std::vector<ReplaceableEntry*> storage;
+        const std::vector<ReplaceableEntry*> &entries =
+            getPossibleEntries(addr, storage);
 
         // Choose replacement victim from replacement candidates
-        CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
-                                entries));
+        CacheBlk* victim = static_cast<CacheBlk*>(
+            fastRP.getVictim(entries));
 
         // There is only one eviction for this replacement
         evict_blks.push_back(victim);
@@ -198,7 +259,9 @@ class BaseSetAssoc : public BaseTags
         stats.tagsInUse++;
 
         // Update replacement policy
-        replacementPolicy->reset(blk->replacementData, pkt);
+        fastRP.reset(blk->replacementData, pkt);
+
+        updateTagKey(blk);
     }
 
     void moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk) override;
@@ -99,6 +99,10 @@ CompressedTags::tagsInit()
         // Link block to indexing policy
         indexingPolicy->setEntry(superblock, superblock_index);
     }
+
+    if (plainIndexing) {
+        sectorKeys.assign(numSectors, InvalidKey);
+    }
 }
 
 CacheBlk*
@@ -107,8 +111,9 @@ CompressedTags::findVictim(Addr addr, const bool is_secure,
                            std::vector<CacheBlk*>& evict_blks)
 {
     // Get all possible locations of this superblock
-    const std::vector<ReplaceableEntry*> superblock_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    std::vector<ReplaceableEntry*> storage;
+    const std::vector<ReplaceableEntry*> &superblock_entries =
+        getPossibleEntries(addr, storage);
 
     // Check if the superblock this address belongs to has been allocated. If
     // so, try co-allocating
@@ -134,7 +139,7 @@ CompressedTags::findVictim(Addr addr, const bool is_secure,
     if (victim_superblock == nullptr){
         // Choose replacement victim from replacement candidates
         victim_superblock = static_cast<SuperBlk*>(
-            replacementPolicy->getVictim(superblock_entries));
+            fastRP.getVictim(superblock_entries));
 
         // The whole superblock must be evicted to make room for the new one
         for (const auto& blk : victim_superblock->blks){
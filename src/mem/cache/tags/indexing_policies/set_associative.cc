@@ -59,7 +59,7 @@ SetAssociative::SetAssociative(const Params &p)
 uint32_t
 SetAssociative::extractSet(const Addr addr) const
 {
-    return (addr >> setShift) & setMask;
+    return plainSet(addr);
 }
 
 Addr
@@ -118,6 +118,41 @@ class SetAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                      override;
 
+    /**
+     * Get the set of an address as this policy computes it, without the
+     * hashing derived policies may apply. This is not virtual, so that
+     * the tags can use it on their fast path when the indexing policy
+     * is exactly a SetAssociative one.
+     *
+     * @param addr The address to calculate the set for.
+     * @return The set index.
+     */
+    uint32_t
+    plainSet(const Addr addr) const
+    {
+        return (addr >> setShift) & setMask;
+    }
+
+    /**
+     * Get the tag of an address, without dispatching on the policy.
+     *
+     * @param addr The address to get the tag from.
+     * @return The tag of the address.
+     */
+    Addr plainTag(const Addr addr) const { return addr >> tagShift; }
+
+    /**
+     * Get the entries of a set, in way order, without copying them.
+     *
+     * @param set The set index.
+     * @return The entries of the set.
+     */
+    const std::vector<ReplaceableEntry*> &
+    getSetEntries(const uint32_t set) const
+    {
+        return sets[set];
+    }
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      *
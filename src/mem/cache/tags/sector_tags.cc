@@ -52,6 +52,7 @@ SectorTags::SectorTags(const SectorTagsParams &p)
     : BaseTags(p), allocAssoc(p.assoc),
       sequentialAccess(p.sequential_access),
       replacementPolicy(p.replacement_policy),
+      fastRP(p.replacement_policy), assoc(p.assoc),
       numBlocksPerSector(p.num_blocks_per_sector),
       numSectors(numBlocks / numBlocksPerSector),
       sectorShift(floorLog2(blkSize)), sectorMask(numBlocksPerSector - 1),
@@ -113,6 +114,10 @@ SectorTags::tagsInit()
         // Link block to indexing policy
         indexingPolicy->setEntry(sec_blk, sec_blk_index);
     }
+
+    if (plainIndexing) {
+        sectorKeys.assign(numSectors, InvalidKey);
+    }
 }
 
 void
@@ -135,6 +140,8 @@ SectorTags::invalidate(CacheBlk *blk)
 
         // Invalidate replacement data, as we're invalidating the sector
         replacementPolicy->invalidate(sector_blk->replacementData);
+
+        updateSectorKey(sector_blk);
     }
 }
 
@@ -166,7 +173,7 @@ SectorTags::accessBlock(const PacketPtr pkt, Cycles &lat)
 
         // Update replacement data of accessed block, which is shared with
         // the whole sector it belongs to
-        replacementPolicy->touch(sector_blk->replacementData, pkt);
+        fastRP.touch(sector_blk->replacementData, pkt);
     }
 
     // The tag lookup latency is the same for a hit or a miss
@@ -186,18 +193,20 @@ SectorTags::insertBlock(const PacketPtr pkt, CacheBlk *blk)
     // sector was not previously present in the cache.
     if (sector_blk->isValid()) {
         // An existing entry's replacement data is just updated
-        replacementPolicy->touch(sector_blk->replacementData, pkt);
+        fastRP.touch(sector_blk->replacementData, pkt);
     } else {
         // Increment tag counter
         stats.tagsInUse++;
         assert(stats.tagsInUse.value() <= numSectors);
 
         // A new entry resets the replacement data
-        replacementPolicy->reset(sector_blk->replacementData, pkt);
+        fastRP.reset(sector_blk->replacementData, pkt);
     }
 
     // Do common block insertion functionality
     BaseTags::insertBlock(pkt, blk);
+
+    updateSectorKey(sector_blk);
 }
 
 void
@@ -240,10 +249,13 @@ SectorTags::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
     }
 
     if (dest_was_valid) {
-        replacementPolicy->touch(dest_sector_blk->replacementData);
+        fastRP.touch(dest_sector_blk->replacementData);
     } else {
-        replacementPolicy->reset(dest_sector_blk->replacementData);
+        fastRP.reset(dest_sector_blk->replacementData);
     }
+
+    updateSectorKey(src_sector_blk);
+    updateSectorKey(dest_sector_blk);
 }
 
 CacheBlk*
@@ -256,9 +268,26 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
     // due to sectors being composed of contiguous-address entries
     const Addr offset = extractSectorOffset(addr);
 
+    if (plainIndexing) {
+        // Sectors of a set have distinct tags, so at most one key
+        // matches, and the block is then found if it is valid
+        const uint32_t set = plainIndexing->plainSet(addr);
+        const Addr key = tagKey(plainIndexing->plainTag(addr), is_secure);
+        const Addr *keys = &sectorKeys[set * assoc];
+        for (unsigned way = 0; way < assoc; way++) {
+            if (keys[way] == key) {
+                auto blk = static_cast<SectorBlk*>(
+                    plainIndexing->getEntry(set, way))->blks[offset];
+                return blk->isValid() ? blk : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    std::vector<ReplaceableEntry*> storage;
+    const std::vector<ReplaceableEntry*> &entries =
+        getPossibleEntries(addr, storage);
 
     // Search for block
     for (const auto& sector : entries) {
@@ -277,8 +306,9 @@ SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
                        std::vector<CacheBlk*>& evict_blks)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> sector_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    std::vector<ReplaceableEntry*> storage;
+    const std::vector<ReplaceableEntry*> &sector_entries =
+        getPossibleEntries(addr, storage);
 
     // Check if the sector this address belongs to has been allocated
     Addr tag = extractTag(addr);
@@ -294,7 +324,7 @@ SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
     // If the sector is not present
     if (victim_sector == nullptr){
         // Choose replacement victim from replacement candidates
-        victim_sector = static_cast<SectorBlk*>(replacementPolicy->getVictim(
+        victim_sector = static_cast<SectorBlk*>(fastRP.getVictim(
                                                 sector_entries));
     }
 
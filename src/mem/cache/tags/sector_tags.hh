@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "base/statistics.hh"
+#include "mem/cache/replacement_policies/fast_rp.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/sector_blk.hh"
 #include "mem/packet.hh"
@@ -47,13 +48,6 @@
 namespace gem5
 {
 
-GEM5_DEPRECATED_NAMESPACE(ReplacementPolicy, replacement_policy);
-namespace replacement_policy
-{
-    class Base;
-}
-class ReplaceableEntry;
-
 /**
  * A SectorTags cache tag store.
  * @sa  \ref gem5MemorySystem "gem5 Memory System"
@@ -80,6 +74,20 @@ class SectorTags : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** Statically dispatched calls to the replacement policy. */
+    replacement_policy::FastRP fastRP;
+
+    /** The associativity, i.e., the number of sectors in a set. */
+    const unsigned assoc;
+
+    /**
+     * The tag and secure bit of every sector, laid out set by set, or
+     * InvalidKey if no block of the sector is valid. A lookup scans the
+     * keys of a set rather than the sectors. Only kept with a plain set
+     * associative indexing policy.
+     */
+    std::vector<Addr> sectorKeys;
+
     /** Number of data blocks per sector. */
     const unsigned numBlocksPerSector;
 
@@ -106,6 +114,22 @@ class SectorTags : public BaseTags
         statistics::Vector evictionsReplacement;
     } sectorStats;
 
+    /**
+     * Update the key of a sector whose tag or validity changed.
+     *
+     * @param sector_blk The sector.
+     */
+    void
+    updateSectorKey(const SectorBlk *sector_blk)
+    {
+        if (plainIndexing) {
+            sectorKeys[sector_blk->getSet() * assoc + sector_blk->getWay()] =
+                sector_blk->isValid() ?
+                tagKey(sector_blk->getTag(), sector_blk->isSecure()) :
+                InvalidKey;
+        }
+    }
+
   public:
     /** Convenience typedef. */
      typedef SectorTagsParams Params;
@@ -157,7 +181,8 @@ class SectorTags : public BaseTags
 
     /**
      * Finds the given address in the cache, do not update replacement data.
-     * i.e. This is a no-side-effect find of a block.
+     * i.e. This is a no-side-effect find of a block. With a plain set
+     * associative indexing policy, only the keys of the set are scanned.
      *
      * @param addr The address to find.
      * @param is_secure True if the target memory space is secure.
@@ -45,6 +45,8 @@
 
 #include "mem/coherent_xbar.hh"
 
+#include <algorithm>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -230,6 +232,9 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
                     __func__, src_port->name(), pkt->print(),
                     sf_res.first.size(), sf_res.second);
 
+            // keep the filter inclusive if the lookup evicted a line
+            backInvalidate(true);
+
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
                 // clean evictions, there is no need to snoop up, as
@@ -428,6 +433,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
         if (snoopFilter && !system->bypassCaches()) {
             // let the snoop filter inspect the response and update its state
             snoopFilter->updateResponse(rsp_pkt, *cpuSidePorts[rsp_port_id]);
+            backInvalidate(true);
         }
 
         // we send the response after the current packet, even if the
@@ -484,6 +490,8 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     if (snoopFilter && !system->bypassCaches()) {
         // let the snoop filter inspect the response and update its state
         snoopFilter->updateResponse(pkt, *cpuSidePorts[cpu_side_port_id]);
+        // moving an overflowed line back into its set may evict another
+        backInvalidate(true);
     }
 
     // send the packet through the destination CPU-side port and pay for
@@ -668,6 +676,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
             snoopFilter->updateSnoopResponse(pkt,
                         *cpuSidePorts[cpu_side_port_id],
                         *cpuSidePorts[dest_port_id]);
+            backInvalidate(true);
         }
 
         DPRINTF(CoherentXBar, "%s: src %s packet %s FWD RESP\n", __func__,
@@ -724,6 +733,35 @@ CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_cpu_side_port_id,
     snoopFanout.sample(fanout);
 }
 
+void
+CoherentXBar::backInvalidate(bool is_timing)
+{
+    SnoopFilter::BackInvalidation binv;
+    if (!snoopFilter->takeBackInvalidation(binv))
+        return;
+
+    DPRINTF(CoherentXBar, "%s: addr %#llx to %d ports\n", __func__,
+            binv.addr, binv.ports.size());
+
+    // a clean and invalidate makes the caches above write back dirty
+    // copies of the line before dropping it
+    Request::Flags flags = Request::CLEAN | Request::INVALIDATE;
+    if (binv.isSecure)
+        flags.set(Request::SECURE);
+    RequestPtr req = Request::create(binv.addr, system->cacheLineSize(),
+                                     flags, snoopFilter->requestorId());
+    Packet pkt(req, MemCmd::CleanInvalidReq);
+    pkt.setExpressSnoop();
+
+    for (const auto& p : binv.ports) {
+        pkt.headerDelay = pkt.payloadDelay = 0;
+        if (is_timing)
+            p->sendTimingSnoopReq(&pkt);
+        else
+            p->sendAtomicSnoop(&pkt);
+    }
+}
+
 void
 CoherentXBar::recvReqRetry(PortID mem_side_port_id)
 {
@@ -766,6 +804,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
             DPRINTF(CoherentXBar, "%s: src %s packet %s SF size: %i lat: %i\n",
                     __func__, cpuSidePorts[cpu_side_port_id]->name(),
                     pkt->print(), sf_res.first.size(), sf_res.second);
+            backInvalidate(false);
 
             // let the snoop filter know about the success of the send
             // operation, and do it even before sending it onwards to
@@ -837,6 +876,11 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
         snoopFilter->updateResponse(pkt, *cpuSidePorts[cpu_side_port_id]);
     }
 
+    // the responses, including those of the snoopers, may have moved an
+    // overflowed line back into its set and evicted another
+    if (snoopFilter)
+        backInvalidate(false);
+
     // if we got a response from a snooper, restore it here
     if (snoop_response_cmd != MemCmd::InvalidCmd) {
         // no one else should have responded
@@ -885,6 +929,39 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
     return response_latency;
 }
 
+void
+CoherentXBar::recvAtomicWarmup(WarmAccessBatch &batch,
+                               PortID cpu_side_port_id)
+{
+    DPRINTF(CoherentXBar, "%s: src %s %d accesses\n", __func__,
+            cpuSidePorts[cpu_side_port_id]->name(), batch.size());
+
+    if (!system->bypassCaches()) {
+        const QueuedResponsePort *src_port = cpuSidePorts[cpu_side_port_id];
+
+        // without a snoop filter we do not know who holds what, and
+        // a clean copy is only safe if there is nobody else to snoop
+        const bool other_snoopers =
+            std::any_of(snoopPorts.begin(), snoopPorts.end(),
+                        [src_port](const QueuedResponsePort *p)
+                        { return p != src_port; });
+
+        for (auto &access : batch) {
+            if (snoopFilter) {
+                if (!snoopFilter->lookupWarmup(access.addr, access.isSecure,
+                                               *src_port)) {
+                    access.allocate = false;
+                }
+                backInvalidate(false);
+            } else if (other_snoopers) {
+                access.allocate = false;
+            }
+        }
+    }
+
+    forwardWarmup(batch);
+}
+
 Tick
 CoherentXBar::recvAtomicSnoop(PacketPtr pkt, PortID mem_side_port_id)
 {
@@ -130,6 +130,12 @@ class CoherentXBar : public BaseXBar
             return xbar.recvAtomicBackdoor(pkt, id, &backdoor);
         }
 
+        void
+        recvAtomicWarmup(WarmAccessBatch &batch) override
+        {
+            xbar.recvAtomicWarmup(batch, id);
+        }
+
         void
         recvFunctional(PacketPtr pkt) override
         {
@@ -330,10 +336,26 @@ class CoherentXBar : public BaseXBar
     void forwardTiming(PacketPtr pkt, PortID exclude_cpu_side_port_id,
                        const std::vector<QueuedResponsePort*>& dests);
 
+    /**
+     * Invalidate the line evicted from a finite snoop filter, if any,
+     * in the caches above that may still hold it. Dirty copies are
+     * cleaned on the way out.
+     *
+     * @param is_timing Send timing rather than atomic snoops
+     */
+    void backInvalidate(bool is_timing);
+
     Tick recvAtomicBackdoor(PacketPtr pkt, PortID cpu_side_port_id,
                             MemBackdoorPtr *backdoor=nullptr);
     Tick recvAtomicSnoop(PacketPtr pkt, PortID mem_side_port_id);
 
+    /**
+     * Check that the requestor of each warm-up access may allocate a
+     * clean copy of the line without breaking coherence, and forward
+     * the batch below.
+     */
+    void recvAtomicWarmup(WarmAccessBatch &batch, PortID cpu_side_port_id);
+
     /**
      * Forward an atomic packet to our snoopers, potentially excluding
      * one of the connected coherent requestors to avoid sending a packet
@@ -205,6 +205,11 @@ class CommMonitor : public SimObject
             return mon.recvAtomic(pkt);
         }
 
+        void recvAtomicWarmup(WarmAccessBatch &batch) override
+        {
+            mon.memSidePort.sendAtomicWarmup(batch);
+        }
+
         bool recvTimingReq(PacketPtr pkt)
         {
             return mon.recvTimingReq(pkt);
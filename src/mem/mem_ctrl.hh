@@ -55,6 +55,7 @@
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
+#include "mem/mem_packet_queue.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
 #include "params/MemCtrl.hh"
@@ -152,6 +153,9 @@ class MemPacket
      */
     uint8_t _qosValue;
 
+    /** Arrival order in the scheduling queue holding the packet */
+    uint64_t queueSeq;
+
     /**
      * Set the packet QoS value
      * (interface compatibility with Packet)
@@ -206,14 +210,14 @@ class MemPacket
           _requestorId(pkt->requestorId()),
           read(is_read), dram(is_dram), rank(_rank), bank(_bank), row(_row),
           bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
-          _qosValue(_pkt->qosValue())
+          _qosValue(_pkt->qosValue()), queueSeq(0)
     { }
 
 };
 
 // The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+// based on their QoS priority, each of them indexed by bank
+typedef IndexedPacketQueue<MemPacket> MemPacketQueue;
 
 
 /**
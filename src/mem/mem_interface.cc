@@ -174,116 +174,33 @@ MemInterface::decodePacket(const PacketPtr pkt, Addr pkt_addr,
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
-
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
-
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
-
-        // select optimal DRAM packet in Q
-        if (pkt->isDram()) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
-
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
-
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
-
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
-
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
-
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
-                        }
-                    }
-                }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
-            }
-        }
-    }
-
-    if (selected_pkt_it == queue.end()) {
+    // The queue indexes its DRAM packets per bank and row, so rather
+    // than checking every packet we only look at the oldest row hit
+    // and the oldest bank conflict of each bank. Search for seamless
+    // row hits first, if no seamless row hit is found then determine
+    // if there are other packets that can be issued without incurring
+    // additional bus delay due to bank timing. Will select closed rows
+    // first to enable more open row possibilies in future selections
+    auto bank_state = [this](unsigned bank_id) {
+        const Rank *rank = ranks[bank_id / banksPerRank];
+        const Bank &bank = rank->banks[bank_id % banksPerRank];
+        return MemPacketQueue::BankState{rank->inRefIdleState(),
+                                         bank.openRow,
+                                         bank.rdAllowedAt,
+                                         bank.wrAllowedAt};
+    };
+
+    auto selected = queue.chooseRowHitFirst(bank_state, min_col_at,
+        [&]() { return minBankPrep(queue, min_col_at); });
+
+    if (selected.first == queue.end()) {
         DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    } else {
+        DPRINTF(DRAM, "%s selected DRAM packet in bank %d, row %d\n",
+                __func__, (*selected.first)->bank, (*selected.first)->row);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    return selected;
 }
 
 void
@@ -617,27 +534,22 @@ DRAMInterface::doBurstAccess(MemPacket* mem_pkt, Tick next_burst_at,
         bool got_more_hits = false;
         bool got_bank_conflict = false;
 
+        // look up the bank in the index of every queue
+        // 1) if a hit is found, then both open and close adaptive
+        //    policies keep the page open
+        // 2) if no hit is found, got_bank_conflict is set to true if a
+        //    bank conflict request is waiting in the queue
+        // 3) make sure we are not considering the packet that we are
+        //    currently dealing with
         for (uint8_t i = 0; i < ctrl->numPriorities(); ++i) {
-            auto p = queue[i].begin();
-            // keep on looking until we find a hit or reach the end of the
-            // queue
-            // 1) if a hit is found, then both open and close adaptive
-            //    policies keep the page open
-            // 2) if no hit is found, got_bank_conflict is set to true if a
-            //    bank conflict request is waiting in the queue
-            // 3) make sure we are not considering the packet that we are
-            //    currently dealing with
-            while (!got_more_hits && p != queue[i].end()) {
-                if (mem_pkt != (*p)) {
-                    bool same_rank_bank = (mem_pkt->rank == (*p)->rank) &&
-                                          (mem_pkt->bank == (*p)->bank);
-
-                    bool same_row = mem_pkt->row == (*p)->row;
-                    got_more_hits |= same_rank_bank && same_row;
-                    got_bank_conflict |= same_rank_bank && !same_row;
-                }
-                ++p;
-            }
+            const unsigned same_row =
+                queue[i].rowCount(mem_pkt->bankId, mem_pkt->row);
+            const unsigned same_bank = queue[i].bankCount(mem_pkt->bankId);
+            const unsigned self =
+                queue[i].find(mem_pkt) != queue[i].end() ? 1 : 0;
+
+            got_more_hits |= same_row > self;
+            got_bank_conflict |= same_bank > same_row;
 
             if (got_more_hits)
                 break;
@@ -1060,10 +972,10 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
-            got_waiting[p->bankId] = true;
-    }
+    queue.forEachBank([&](unsigned bank_id) {
+        if (ranks[bank_id / banksPerRank]->inRefIdleState())
+            got_waiting[bank_id] = true;
+    });
 
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A memory controller scheduling queue that keeps its DRAM packets
+ * indexed by bank and row, so that the FR-FCFS scheduler can find the
+ * oldest row hit or bank conflict per bank without walking the whole
+ * queue.
+ */
+
+#ifndef __MEM_MEM_PACKET_QUEUE_HH__
+#define __MEM_MEM_PACKET_QUEUE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * A FIFO of memory packets with a per-bank index. The queue keeps the
+ * interface of the std::deque it replaces, and all insertions and
+ * removals must go through push_back() and erase() so that the index
+ * stays consistent.
+ *
+ * The packet type must provide isDram(), rank, bank, row, bankId and
+ * a writable queueSeq, which the queue uses to record the arrival
+ * order of the packet. Only DRAM packets are indexed.
+ */
+template <typename Pkt>
+class IndexedPacketQueue
+{
+  private:
+    using Container = std::deque<Pkt *>;
+
+    /** The DRAM packets queued for one bank. */
+    struct BankEntry
+    {
+        /** Number of packets to the bank. */
+        unsigned count = 0;
+
+        /** Packets to each row of the bank, in arrival order. */
+        std::unordered_map<uint32_t, std::deque<Pkt *>> rows;
+
+        /** Rows ordered by the arrival of their oldest packet. */
+        std::set<std::pair<uint64_t, uint32_t>> heads;
+    };
+
+    Container packets;
+
+    /** Index of the DRAM packets by bank id. */
+    std::vector<BankEntry> banks;
+
+    /** One bit per bank id, set if the bank has queued packets. */
+    std::vector<uint64_t> occupied;
+
+    /** Arrival number given to the next packet. */
+    uint64_t nextSeq = 0;
+
+    template <typename C>
+    static auto
+    find(C &c, const Pkt *pkt) -> decltype(c.begin())
+    {
+        auto it = std::lower_bound(c.begin(), c.end(), pkt,
+            [](const Pkt *a, const Pkt *b) {
+                return a->queueSeq < b->queueSeq;
+            });
+        return it != c.end() && *it == pkt ? it : c.end();
+    }
+
+  public:
+    using value_type = Pkt *;
+    using iterator = typename Container::iterator;
+    using const_iterator = typename Container::const_iterator;
+
+    /** Scheduling state of a bank, as seen by chooseRowHitFirst(). */
+    struct BankState
+    {
+        /** Can the rank of the bank issue a burst now? */
+        bool ready;
+        uint32_t openRow;
+        Tick rdAllowedAt;
+        Tick wrAllowedAt;
+    };
+
+    iterator begin() { return packets.begin(); }
+    iterator end() { return packets.end(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    std::size_t size() const { return packets.size(); }
+    bool empty() const { return packets.empty(); }
+
+    Pkt *front() const { return packets.front(); }
+    Pkt *back() const { return packets.back(); }
+
+    void
+    push_back(Pkt *pkt)
+    {
+        pkt->queueSeq = nextSeq++;
+        packets.push_back(pkt);
+
+        if (!pkt->isDram())
+            return;
+
+        if (pkt->bankId >= banks.size()) {
+            banks.resize(pkt->bankId + 1);
+            occupied.resize(pkt->bankId / 64 + 1, 0);
+        }
+
+        BankEntry &entry = banks[pkt->bankId];
+        auto &row = entry.rows[pkt->row];
+        if (row.empty())
+            entry.heads.emplace(pkt->queueSeq, pkt->row);
+        row.push_back(pkt);
+        if (entry.count++ == 0)
+            occupied[pkt->bankId / 64] |= mask(1) << (pkt->bankId % 64);
+    }
+
+    iterator
+    erase(iterator it)
+    {
+        Pkt *pkt = *it;
+        if (pkt->isDram()) {
+            BankEntry &entry = banks[pkt->bankId];
+            auto row_it = entry.rows.find(pkt->row);
+            assert(row_it != entry.rows.end());
+            auto &row = row_it->second;
+
+            if (row.front() == pkt) {
+                entry.heads.erase({pkt->queueSeq, pkt->row});
+                row.pop_front();
+                if (!row.empty())
+                    entry.heads.emplace(row.front()->queueSeq, pkt->row);
+            } else {
+                row.erase(std::find(row.begin(), row.end(), pkt));
+            }
+            if (row.empty())
+                entry.rows.erase(row_it);
+
+            if (--entry.count == 0)
+                occupied[pkt->bankId / 64] &= ~(mask(1) << (pkt->bankId % 64));
+        }
+        return packets.erase(it);
+    }
+
+    /**
+     * Find a packet in the queue. The queue is ordered by arrival, so
+     * this is a binary search on the arrival number.
+     */
+    iterator find(const Pkt *pkt) { return find(packets, pkt); }
+
+    const_iterator
+    find(const Pkt *pkt) const
+    {
+        return find(packets, pkt);
+    }
+
+    /** Call f(bank_id) for every bank with queued DRAM packets. */
+    template <typename F>
+    void
+    forEachBank(F f) const
+    {
+        for (std::size_t w = 0; w < occupied.size(); w++) {
+            uint64_t word = occupied[w];
+            while (word) {
+                const int bit = ctz64(word);
+                word &= word - 1;
+                f(unsigned(w * 64 + bit));
+            }
+        }
+    }
+
+    /** Number of DRAM packets to a bank. */
+    unsigned
+    bankCount(unsigned bank_id) const
+    {
+        return bank_id < banks.size() ? banks[bank_id].count : 0;
+    }
+
+    /** Number of DRAM packets to a row of a bank. */
+    unsigned
+    rowCount(unsigned bank_id, uint32_t row) const
+    {
+        if (bank_id >= banks.size())
+            return 0;
+        auto it = banks[bank_id].rows.find(row);
+        return it == banks[bank_id].rows.end() ? 0 : it->second.size();
+    }
+
+    /** The oldest DRAM packet to a row of a bank, if any. */
+    Pkt *
+    oldestHit(unsigned bank_id, uint32_t row) const
+    {
+        if (bank_id >= banks.size())
+            return nullptr;
+        auto it = banks[bank_id].rows.find(row);
+        return it == banks[bank_id].rows.end() ? nullptr : it->second.front();
+    }
+
+    /** The oldest DRAM packet to a bank not targeting a row, if any. */
+    Pkt *
+    oldestMiss(unsigned bank_id, uint32_t row) const
+    {
+        if (bank_id >= banks.size())
+            return nullptr;
+        const BankEntry &entry = banks[bank_id];
+        for (const auto &head : entry.heads) {
+            if (head.second != row)
+                return entry.rows.at(head.second).front();
+        }
+        return nullptr;
+    }
+
+    /** Is a older than b? A null packet is younger than any other. */
+    static bool
+    older(const Pkt *a, const Pkt *b)
+    {
+        return a && (!b || a->queueSeq < b->queueSeq);
+    }
+
+    /**
+     * Select a DRAM packet with the FR-FCFS row-hit-first policy. In
+     * order of preference this is the oldest row hit that can issue
+     * seamlessly at min_col_at, then the oldest row hit and the
+     * oldest packet to one of the earliest banks to prepare, the
+     * latter being preferred if the bank can be prepared without
+     * delaying the data bus.
+     *
+     * @param state Callable returning the BankState of a bank id
+     * @param min_col_at Time a column command must issue to be seamless
+     * @param earliest Callable returning a bank mask per rank of the
+     *                 earliest banks to prepare, and whether those can
+     *                 be prepared without delaying the data bus. It is
+     *                 only called if no row hit issues seamlessly.
+     * @return An iterator to the packet, or end(), and the time its
+     *         column command is allowed at
+     */
+    template <typename State, typename Earliest>
+    std::pair<iterator, Tick>
+    chooseRowHitFirst(State state, Tick min_col_at, Earliest earliest)
+    {
+        Pkt *seamless = nullptr;
+        Tick seamless_col_at = MaxTick;
+        Pkt *hit = nullptr;
+        Tick hit_col_at = MaxTick;
+        bool have_misses = false;
+
+        forEachBank([&](unsigned bank_id) {
+            const BankState bank = state(bank_id);
+            if (!bank.ready)
+                return;
+
+            Pkt *pkt = oldestHit(bank_id, bank.openRow);
+            if (banks[bank_id].rows.size() > (pkt ? 1 : 0))
+                have_misses = true;
+            if (!pkt)
+                return;
+
+            const Tick col_allowed_at = pkt->isRead() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            if (col_allowed_at <= min_col_at) {
+                if (older(pkt, seamless)) {
+                    seamless = pkt;
+                    seamless_col_at = col_allowed_at;
+                }
+            } else if (older(pkt, hit)) {
+                hit = pkt;
+                hit_col_at = col_allowed_at;
+            }
+        });
+
+        if (seamless)
+            return {find(seamless), seamless_col_at};
+
+        Pkt *prep = nullptr;
+        Tick prep_col_at = MaxTick;
+        bool hidden_bank_prep = false;
+        if (have_misses) {
+            std::vector<uint32_t> earliest_banks;
+            std::tie(earliest_banks, hidden_bank_prep) = earliest();
+
+            forEachBank([&](unsigned bank_id) {
+                const BankState bank = state(bank_id);
+                if (!bank.ready)
+                    return;
+
+                Pkt *pkt = oldestMiss(bank_id, bank.openRow);
+                if (pkt && bits(earliest_banks[pkt->rank], pkt->bank) &&
+                    older(pkt, prep)) {
+                    prep = pkt;
+                    prep_col_at = pkt->isRead() ?
+                        bank.rdAllowedAt : bank.wrAllowedAt;
+                }
+            });
+        }
+
+        // a row hit goes first, unless the bank of the oldest packet
+        // to an earliest bank can be prepared behind the scenes
+        if (prep && (hidden_bank_prep || !hit))
+            return {find(prep), prep_col_at};
+        if (hit)
+            return {find(hit), hit_col_at};
+        return {packets.end(), MaxTick};
+    }
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_MEM_PACKET_QUEUE_HH__
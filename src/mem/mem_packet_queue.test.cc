@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "mem/mem_packet_queue.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** The fields of a MemPacket the queue relies on. */
+struct FakePacket
+{
+    bool dram;
+    bool read;
+    uint8_t rank;
+    uint8_t bank;
+    uint32_t row;
+    uint16_t bankId;
+    uint64_t queueSeq = 0;
+
+    bool isDram() const { return dram; }
+    bool isRead() const { return read; }
+};
+
+using Queue = memory::IndexedPacketQueue<FakePacket>;
+
+constexpr unsigned NumRanks = 2;
+constexpr unsigned BanksPerRank = 8;
+constexpr unsigned NumRows = 4;
+
+/**
+ * The row-hit-first selection as done by walking the whole queue,
+ * used as the reference for the indexed implementation.
+ */
+std::pair<const FakePacket *, Tick>
+referenceChoice(const std::deque<FakePacket *> &queue,
+                const std::vector<Queue::BankState> &banks,
+                Tick min_col_at, const std::vector<uint32_t> &earliest,
+                bool hidden_bank_prep)
+{
+    bool found_hidden_bank = false;
+    bool found_prepped_pkt = false;
+    bool found_earliest_pkt = false;
+
+    Tick selected_col_at = MaxTick;
+    const FakePacket *selected = nullptr;
+
+    for (const FakePacket *pkt : queue) {
+        if (!pkt->isDram())
+            continue;
+        const Queue::BankState &bank = banks[pkt->bankId];
+        const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
+                                                    bank.wrAllowedAt;
+        if (!bank.ready)
+            continue;
+
+        if (bank.openRow == pkt->row) {
+            if (col_allowed_at <= min_col_at) {
+                selected = pkt;
+                selected_col_at = col_allowed_at;
+                break;
+            } else if (!found_hidden_bank && !found_prepped_pkt) {
+                selected = pkt;
+                selected_col_at = col_allowed_at;
+                found_prepped_pkt = true;
+            }
+        } else if (!found_earliest_pkt) {
+            if (bits(earliest[pkt->rank], pkt->bank, pkt->bank)) {
+                found_earliest_pkt = true;
+                found_hidden_bank = hidden_bank_prep;
+                if (hidden_bank_prep || !found_prepped_pkt) {
+                    selected = pkt;
+                    selected_col_at = col_allowed_at;
+                }
+            }
+        }
+    }
+
+    return {selected, selected_col_at};
+}
+
+/**
+ * Compare the indexed choice with the reference one for random bank
+ * states.
+ */
+template <typename Random>
+void
+checkRandomChoice(Queue &queue, const std::deque<FakePacket *> &reference,
+                  Random &random, unsigned step)
+{
+    std::vector<Queue::BankState> banks(NumRanks * BanksPerRank);
+    std::vector<bool> rank_ready(NumRanks);
+    for (unsigned r = 0; r < NumRanks; r++)
+        rank_ready[r] = random(4) != 0;
+    for (unsigned b = 0; b < banks.size(); b++) {
+        banks[b].ready = rank_ready[b / BanksPerRank];
+        banks[b].openRow = random(NumRows + 1);
+        banks[b].rdAllowedAt = random(100);
+        banks[b].wrAllowedAt = random(100);
+    }
+    const Tick min_col_at = random(100);
+
+    std::vector<uint32_t> earliest(NumRanks);
+    for (auto &mask : earliest)
+        mask = random(1 << BanksPerRank);
+    const bool hidden = random(2);
+
+    const FakePacket *expected;
+    Tick expected_col_at;
+    std::tie(expected, expected_col_at) =
+        referenceChoice(reference, banks, min_col_at, earliest, hidden);
+
+    auto chosen = queue.chooseRowHitFirst(
+        [&](unsigned bank_id) { return banks[bank_id]; }, min_col_at,
+        [&]() { return std::make_pair(earliest, hidden); });
+
+    if (!expected) {
+        ASSERT_EQ(chosen.first, queue.end()) << "step " << step;
+    } else {
+        ASSERT_NE(chosen.first, queue.end()) << "step " << step;
+        ASSERT_EQ(*chosen.first, expected) << "step " << step;
+        ASSERT_EQ(chosen.second, expected_col_at) << "step " << step;
+    }
+}
+
+} // anonymous namespace
+
+TEST(IndexedPacketQueueTest, FindAndCounts)
+{
+    Queue queue;
+    std::vector<std::unique_ptr<FakePacket>> pkts;
+    for (unsigned i = 0; i < 6; i++) {
+        pkts.emplace_back(new FakePacket{true, true, 0, uint8_t(i % 2),
+                                         i % 3, uint16_t(i % 2)});
+        queue.push_back(pkts.back().get());
+    }
+
+    ASSERT_EQ(queue.size(), 6);
+    ASSERT_EQ(queue.bankCount(0), 3);
+    ASSERT_EQ(queue.bankCount(1), 3);
+    ASSERT_EQ(queue.rowCount(0, 0), 1);
+    ASSERT_EQ(queue.rowCount(0, 2), 1);
+    ASSERT_EQ(queue.bankCount(7), 0);
+
+    ASSERT_EQ(*queue.find(pkts[3].get()), pkts[3].get());
+    queue.erase(queue.find(pkts[3].get()));
+    ASSERT_EQ(queue.find(pkts[3].get()), queue.end());
+    ASSERT_EQ(queue.bankCount(1), 2);
+
+    // pkts[1] is the oldest to bank 1, and pkts[5] targets row 2
+    ASSERT_EQ(queue.oldestHit(1, 2), pkts[5].get());
+    ASSERT_EQ(queue.oldestMiss(1, 2), pkts[1].get());
+    ASSERT_EQ(queue.oldestMiss(1, 1), pkts[5].get());
+}
+
+TEST(IndexedPacketQueueTest, RandomEquivalence)
+{
+    std::mt19937 rng(0x5eed);
+    auto random = [&](unsigned n) { return unsigned(rng() % n); };
+
+    std::vector<std::unique_ptr<FakePacket>> storage;
+    Queue queue;
+    std::deque<FakePacket *> reference;
+
+    for (unsigned step = 0; step < 20000; step++) {
+        // grow the queue to a random depth, or shrink it
+        if (queue.empty() || (queue.size() < 160 && random(3) != 0)) {
+            const uint8_t rank = random(NumRanks);
+            const uint8_t bank = random(BanksPerRank);
+            storage.emplace_back(new FakePacket{
+                random(8) != 0, true, rank, bank, random(NumRows),
+                uint16_t(rank * BanksPerRank + bank)});
+            queue.push_back(storage.back().get());
+            reference.push_back(storage.back().get());
+        } else {
+            const unsigned idx = random(queue.size());
+            ASSERT_EQ(*(queue.begin() + idx), reference[idx]);
+            queue.erase(queue.begin() + idx);
+            reference.erase(reference.begin() + idx);
+        }
+
+        checkRandomChoice(queue, reference, random, step);
+        if (HasFatalFailure())
+            return;
+    }
+}
+
+TEST(IndexedPacketQueueTest, RandomEscalation)
+{
+    std::mt19937 rng(0xe5ca1a7e);
+    auto random = [&](unsigned n) { return unsigned(rng() % n); };
+
+    // Packets move from the low to the high priority queue as in
+    // qos::MemCtrl::escalateQueues, and are served from both
+    std::vector<std::unique_ptr<FakePacket>> storage;
+    Queue queues[2];
+    std::deque<FakePacket *> references[2];
+
+    for (unsigned step = 0; step < 20000; step++) {
+        const unsigned action = random(4);
+        if (queues[0].empty() || (queues[0].size() < 96 && action == 0)) {
+            const uint8_t rank = random(NumRanks);
+            const uint8_t bank = random(BanksPerRank);
+            storage.emplace_back(new FakePacket{
+                random(8) != 0, true, rank, bank,
+                random(NumRows), uint16_t(rank * BanksPerRank + bank)});
+            queues[0].push_back(storage.back().get());
+            references[0].push_back(storage.back().get());
+        } else if (action == 1 || queues[1].empty()) {
+            const unsigned idx = random(queues[0].size());
+            FakePacket *pkt = references[0][idx];
+            ASSERT_EQ(*(queues[0].begin() + idx), pkt);
+            queues[0].erase(queues[0].begin() + idx);
+            references[0].erase(references[0].begin() + idx);
+            queues[1].push_back(pkt);
+            references[1].push_back(pkt);
+        } else {
+            const unsigned q = random(2);
+            if (queues[q].empty())
+                continue;
+            const unsigned idx = random(queues[q].size());
+            ASSERT_EQ(*(queues[q].begin() + idx), references[q][idx]);
+            queues[q].erase(queues[q].begin() + idx);
+            references[q].erase(references[q].begin() + idx);
+        }
+
+        for (unsigned q = 0; q < 2; q++) {
+            checkRandomChoice(queues[q], references[q], random, step);
+            if (HasFatalFailure())
+                return;
+        }
+    }
+}
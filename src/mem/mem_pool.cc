@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/mem_pool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+namespace gem5
+{
+
+namespace mem_pool
+{
+
+thread_local uint64_t counts[NumCounters];
+
+namespace
+{
+
+std::mutex registryMutex;
+
+/** Counters of the host threads that are still running. */
+std::vector<uint64_t *> &
+liveCounts()
+{
+    static std::vector<uint64_t *> live;
+    return live;
+}
+
+/** Counters folded in by host threads that have exited. */
+uint64_t retiredCounts[NumCounters];
+
+/** Makes the counters of a host thread visible to total(). */
+struct Registration
+{
+    Registration()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        liveCounts().push_back(counts);
+    }
+
+    ~Registration()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (int i = 0; i < NumCounters; i++)
+            retiredCounts[i] += counts[i];
+        auto &live = liveCounts();
+        live.erase(std::find(live.begin(), live.end(), counts));
+    }
+};
+
+void
+registerThread()
+{
+    thread_local Registration registration;
+    (void)registration;
+}
+
+/** Header placed in front of every payload. */
+struct alignas(16) PayloadHeader
+{
+    std::atomic<uint32_t> refs;
+    uint32_t sizeClass;
+};
+
+/** Size class of payloads that are not pooled. */
+constexpr uint32_t Unpooled = ~0U;
+
+/** Smallest pooled payload; classes double up to MaxPooledPayload. */
+constexpr std::size_t MinPooledPayload = 16;
+
+uint32_t
+sizeClassOf(std::size_t size)
+{
+    if (size > MaxPooledPayload)
+        return Unpooled;
+    uint32_t size_class = 0;
+    for (std::size_t bytes = MinPooledPayload; bytes < size; bytes <<= 1)
+        size_class++;
+    return size_class;
+}
+
+template <std::size_t Bytes>
+FreeList &
+payloadList()
+{
+    return freeList<sizeof(PayloadHeader) + Bytes>();
+}
+
+FreeList &
+payloadList(uint32_t size_class)
+{
+    switch (size_class) {
+      case 0: return payloadList<16>();
+      case 1: return payloadList<32>();
+      case 2: return payloadList<64>();
+      case 3: return payloadList<128>();
+      default:
+        assert(size_class == 4);
+        return payloadList<256>();
+    }
+}
+
+static_assert((MinPooledPayload << 4) == MaxPooledPayload,
+              "Payload size classes do not match the free lists");
+
+PayloadHeader *
+headerOf(const uint8_t *data)
+{
+    return reinterpret_cast<PayloadHeader *>(
+        const_cast<uint8_t *>(data)) - 1;
+}
+
+} // anonymous namespace
+
+FreeList::FreeList(std::size_t size)
+    : blockSize(size)
+{
+    registerThread();
+}
+
+FreeList::~FreeList()
+{
+    while (head) {
+        Block *block = head;
+        head = block->next;
+        ::operator delete(block);
+    }
+}
+
+uint64_t
+total(Counter counter)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t sum = retiredCounts[counter];
+    for (const uint64_t *thread_counts : liveCounts())
+        sum += thread_counts[counter];
+    return sum;
+}
+
+uint64_t
+allocsAvoided()
+{
+    return total(PacketReuses) + total(RequestReuses) +
+        total(PayloadReuses) + total(PayloadShares);
+}
+
+uint8_t *
+allocatePayload(std::size_t size)
+{
+    const uint32_t size_class = sizeClassOf(size);
+    void *block;
+    if (size_class == Unpooled) {
+        registerThread();
+        ++counts[PayloadAllocs];
+        block = ::operator new(sizeof(PayloadHeader) + size);
+    } else {
+        block = payloadList(size_class).allocate(PayloadAllocs,
+                                                 PayloadReuses);
+    }
+
+    PayloadHeader *header = new (block) PayloadHeader;
+    header->refs.store(1, std::memory_order_relaxed);
+    header->sizeClass = size_class;
+    return reinterpret_cast<uint8_t *>(header + 1);
+}
+
+uint8_t *
+sharePayload(uint8_t *data)
+{
+    registerThread();
+    headerOf(data)->refs.fetch_add(1, std::memory_order_relaxed);
+    ++counts[PayloadShares];
+    return data;
+}
+
+void
+releasePayload(uint8_t *data)
+{
+    PayloadHeader *header = headerOf(data);
+    if (header->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    const uint32_t size_class = header->sizeClass;
+    header->~PayloadHeader();
+    if (size_class == Unpooled)
+        ::operator delete(header);
+    else
+        payloadList(size_class).release(header);
+}
+
+unsigned
+payloadRefs(const uint8_t *data)
+{
+    return headerOf(data)->refs.load(std::memory_order_relaxed);
+}
+
+} // namespace mem_pool
+} // namespace gem5
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Host-side recycling of the objects allocated for every memory
+ * access: packets, requests and their data payloads. Each host thread
+ * keeps its own bounded free lists so that the common path never
+ * takes a lock, and the number of allocations that were satisfied
+ * from a free list (or avoided altogether by sharing a payload) is
+ * reported through the global statistics.
+ */
+
+#ifndef __MEM_MEM_POOL_HH__
+#define __MEM_MEM_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace gem5
+{
+
+namespace mem_pool
+{
+
+/** Events counted by the pools. */
+enum Counter
+{
+    PacketAllocs,
+    PacketReuses,
+    RequestAllocs,
+    RequestReuses,
+    PayloadAllocs,
+    PayloadReuses,
+    PayloadShares,
+    NumCounters
+};
+
+/** Per-thread event counters, summed by total(). */
+extern thread_local uint64_t counts[NumCounters];
+
+/** Value of a counter summed over all host threads. */
+uint64_t total(Counter counter);
+
+/**
+ * Number of host allocations that were not needed, i.e., blocks
+ * taken from a free list and payloads shared between packets.
+ */
+uint64_t allocsAvoided();
+
+/**
+ * A bounded, thread-local list of equally sized blocks. Blocks are
+ * obtained from the global operator new one at a time, so a block
+ * may be released on a different thread than the one that
+ * allocated it.
+ */
+class FreeList
+{
+  public:
+    /** Maximum number of idle blocks kept per list. */
+    static constexpr std::size_t MaxLength = 4096;
+
+    explicit FreeList(std::size_t size);
+    ~FreeList();
+
+    FreeList(const FreeList &) = delete;
+    FreeList &operator=(const FreeList &) = delete;
+
+    void *
+    allocate(Counter alloc, Counter reuse)
+    {
+        if (head) {
+            Block *block = head;
+            head = block->next;
+            --length;
+            ++counts[reuse];
+            return block;
+        }
+        ++counts[alloc];
+        return ::operator new(blockSize);
+    }
+
+    void
+    release(void *p)
+    {
+        if (length == MaxLength) {
+            ::operator delete(p);
+            return;
+        }
+        Block *block = static_cast<Block *>(p);
+        block->next = head;
+        head = block;
+        ++length;
+    }
+
+  private:
+    struct Block { Block *next; };
+
+    const std::size_t blockSize;
+    Block *head = nullptr;
+    std::size_t length = 0;
+};
+
+/** The free list of this thread for blocks of the given size. */
+template <std::size_t Size>
+FreeList &
+freeList()
+{
+    static_assert(Size >= sizeof(void *), "Pooled blocks are too small");
+    thread_local FreeList list(Size);
+    return list;
+}
+
+/**
+ * A standard allocator that serves single objects from the free
+ * lists, suitable for std::allocate_shared. The two counters
+ * identify the kind of object being pooled.
+ */
+template <typename T, Counter Alloc, Counter Reuse>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = PoolAllocator<U, Alloc, Reuse>; };
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Alloc, Reuse> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n != 1)
+            return std::allocator<T>().allocate(n);
+        void *p = freeList<sizeof(T)>().allocate(Alloc, Reuse);
+        return static_cast<T *>(p);
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        if (n != 1)
+            std::allocator<T>().deallocate(p, n);
+        else
+            freeList<sizeof(T)>().release(p);
+    }
+
+    template <typename U>
+    bool
+    operator==(const PoolAllocator<U, Alloc, Reuse> &) const
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool
+    operator!=(const PoolAllocator<U, Alloc, Reuse> &) const
+    {
+        return false;
+    }
+};
+
+/**
+ * Reference counted data buffers. A payload is a buffer preceded by
+ * a small header holding its reference count, so that a packet
+ * forwarded on behalf of another one can carry the same storage
+ * instead of allocating its own and copying the response back.
+ * Buffers of up to MaxPooledPayload bytes are recycled through
+ * per-size-class free lists.
+ */
+
+/** Largest payload served from the free lists. */
+constexpr std::size_t MaxPooledPayload = 256;
+
+/** Allocate a payload of the given size with one reference. */
+uint8_t *allocatePayload(std::size_t size);
+
+/** Add a reference to a payload and return it. */
+uint8_t *sharePayload(uint8_t *data);
+
+/** Drop a reference to a payload, freeing it with the last one. */
+void releasePayload(uint8_t *data);
+
+/** Number of references held on a payload. */
+unsigned payloadRefs(const uint8_t *data);
+
+} // namespace mem_pool
+} // namespace gem5
+
+#endif // __MEM_MEM_POOL_HH__
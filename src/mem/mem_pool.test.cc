@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "mem/mem_pool.hh"
+
+using namespace gem5;
+
+TEST(MemPoolTest, FreeListReuse)
+{
+    mem_pool::FreeList &list = mem_pool::freeList<48>();
+    const uint64_t reuses = mem_pool::counts[mem_pool::PacketReuses];
+
+    void *first = list.allocate(mem_pool::PacketAllocs,
+                                mem_pool::PacketReuses);
+    list.release(first);
+    void *second = list.allocate(mem_pool::PacketAllocs,
+                                 mem_pool::PacketReuses);
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(mem_pool::counts[mem_pool::PacketReuses], reuses + 1);
+    list.release(second);
+}
+
+TEST(MemPoolTest, PayloadSharing)
+{
+    uint8_t *data = mem_pool::allocatePayload(64);
+    std::memset(data, 0xa5, 64);
+    ASSERT_EQ(mem_pool::payloadRefs(data), 1);
+
+    uint8_t *shared = mem_pool::sharePayload(data);
+    ASSERT_EQ(shared, data);
+    ASSERT_EQ(mem_pool::payloadRefs(data), 2);
+
+    mem_pool::releasePayload(data);
+    ASSERT_EQ(mem_pool::payloadRefs(shared), 1);
+    ASSERT_EQ(shared[63], 0xa5);
+    mem_pool::releasePayload(shared);
+}
+
+TEST(MemPoolTest, PayloadSizeClasses)
+{
+    // Payloads of the same class are recycled, larger ones are not
+    uint8_t *small = mem_pool::allocatePayload(20);
+    mem_pool::releasePayload(small);
+    ASSERT_EQ(mem_pool::allocatePayload(32), small);
+    mem_pool::releasePayload(small);
+
+    uint8_t *large = mem_pool::allocatePayload(4096);
+    std::memset(large, 0, 4096);
+    mem_pool::releasePayload(large);
+}
+
+TEST(MemPoolTest, AllocsAvoided)
+{
+    const uint64_t avoided = mem_pool::allocsAvoided();
+
+    uint8_t *data = mem_pool::allocatePayload(8);
+    mem_pool::releasePayload(mem_pool::sharePayload(data));
+    mem_pool::releasePayload(data);
+
+    ASSERT_GE(mem_pool::allocsAvoided(), avoided + 1);
+}
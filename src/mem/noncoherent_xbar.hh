@@ -120,6 +120,12 @@ class NoncoherentXBar : public BaseXBar
             return xbar.recvAtomicBackdoor(pkt, id, &backdoor);
         }
 
+        void
+        recvAtomicWarmup(WarmAccessBatch &batch) override
+        {
+            xbar.forwardWarmup(batch);
+        }
+
         void
         recvFunctional(PacketPtr pkt) override
         {
@@ -60,6 +60,7 @@
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
+#include "mem/mem_pool.hh"
 #include "mem/request.hh"
 #include "sim/byteswap.hh"
 
@@ -343,6 +344,13 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The data pointer points to a reference counted payload
+        /// from the memory pools, which may be shared with other
+        /// packets. A reference is dropped when the packet is
+        /// destroyed.
+        POOLED_DATA            = 0x00004000,
+        /// Any of the above, i.e., the packet carries data
+        HAS_DATA_PTR           = 0x00007000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -944,9 +952,12 @@ class Packet : public Printable
      * *except* if the original packet's data was dynamic, don't copy
      * that, as we can't guarantee that the new packet's lifetime is
      * less than that of the original packet.  In this case the new
-     * packet should allocate its own data.
+     * packet should allocate its own data. If share_data is set,
+     * pooled data is shared rather than allocated, which is safe as
+     * long as only one of the packets receives the response.
      */
-    Packet(const PacketPtr pkt, bool clear_flags, bool alloc_data)
+    Packet(const PacketPtr pkt, bool clear_flags, bool alloc_data,
+           bool share_data=false)
         :  cmd(pkt->cmd), id(pkt->id), req(pkt->req),
            data(nullptr),
            addr(pkt->addr), _isSecure(pkt->_isSecure), size(pkt->size),
@@ -987,6 +998,9 @@ class Packet : public Printable
             if (pkt->flags.isSet(STATIC_DATA)) {
                 data = pkt->data;
                 flags.set(STATIC_DATA);
+            } else if (share_data && pkt->flags.isSet(POOLED_DATA)) {
+                data = mem_pool::sharePayload(pkt->data);
+                flags.set(POOLED_DATA);
             } else {
                 allocate();
             }
@@ -1059,6 +1073,24 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are recycled through the per-thread memory pools
+     * rather than going back to the host allocator.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        assert(size == sizeof(Packet));
+        return mem_pool::freeList<sizeof(Packet)>().allocate(
+            mem_pool::PacketAllocs, mem_pool::PacketReuses);
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        mem_pool::freeList<sizeof(Packet)>().release(p);
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1179,7 +1211,7 @@ class Packet : public Printable
     void
     dataStatic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA_PTR));
         data = (PacketDataPtr)p;
         flags.set(STATIC_DATA);
     }
@@ -1196,7 +1228,7 @@ class Packet : public Printable
     void
     dataStaticConst(const T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA_PTR));
         data = const_cast<PacketDataPtr>(p);
         flags.set(STATIC_DATA);
     }
@@ -1217,7 +1249,7 @@ class Packet : public Printable
     void
     dataDynamic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(HAS_DATA_PTR));
         data = (PacketDataPtr)p;
         flags.set(DYNAMIC_DATA);
     }
@@ -1229,7 +1261,7 @@ class Packet : public Printable
     T*
     getPtr()
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(HAS_DATA_PTR));
         assert(!isMaskedWrite());
         return (T*)data;
     }
@@ -1238,7 +1270,7 @@ class Packet : public Printable
     const T*
     getConstPtr() const
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(HAS_DATA_PTR));
         return (const T*)data;
     }
 
@@ -1298,9 +1330,11 @@ class Packet : public Printable
     setData(const uint8_t *p)
     {
         // we should never be copying data onto itself, which means we
-        // must idenfity packets with static data, as they carry the
-        // same pointer from source to destination and back
-        assert(p != getPtr<uint8_t>() || flags.isSet(STATIC_DATA));
+        // must idenfity packets with static or shared pooled data, as
+        // they carry the same pointer from source to destination and
+        // back
+        assert(p != getPtr<uint8_t>() ||
+               flags.isSet(STATIC_DATA|POOLED_DATA));
 
         if (p != getPtr<uint8_t>()) {
             // for packet with allocated dynamic data, we copy data from
@@ -1362,8 +1396,10 @@ class Packet : public Printable
     {
         if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
+        else if (flags.isSet(POOLED_DATA))
+            mem_pool::releasePayload(data);
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(HAS_DATA_PTR);
         data = NULL;
     }
 
@@ -1374,9 +1410,9 @@ class Packet : public Printable
         // if either this command or the response command has a data
         // payload, actually allocate space
         if (hasData() || hasRespData()) {
-            assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
-            flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            assert(flags.noneSet(HAS_DATA_PTR));
+            flags.set(POOLED_DATA);
+            data = mem_pool::allocatePayload(getSize());
         }
     }
 
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/packet.hh"
+#include "mem/packet_access.hh"
+#include "mem/request.hh"
+
+using namespace gem5;
+
+// Requests record their creation tick
+GTestTickHandler tickHandler;
+
+TEST(PacketTest, PooledDataAccess)
+{
+    RequestPtr req = std::make_shared<Request>(0x1000, 8, 0, 0);
+    Packet pkt(req, MemCmd::ReadReq);
+    pkt.allocate();
+
+    pkt.setLE<uint64_t>(0x0123456789abcdefULL);
+    ASSERT_EQ(pkt.getLE<uint64_t>(), 0x0123456789abcdefULL);
+    ASSERT_EQ(pkt.get<uint32_t>(ByteOrder::little), 0x89abcdefU);
+
+    pkt.set<uint16_t>(0xbeef, ByteOrder::big);
+    ASSERT_EQ(pkt.getBE<uint16_t>(), 0xbeef);
+}
+
+TEST(PacketTest, SharedPooledDataAccess)
+{
+    RequestPtr req = std::make_shared<Request>(0x1000, 8, 0, 0);
+    Packet pkt(req, MemCmd::ReadReq);
+    pkt.allocate();
+    pkt.setLE<uint64_t>(42);
+
+    // A copy sharing the pooled payload reads the same data
+    Packet copy(&pkt, false, true, true);
+    ASSERT_EQ(copy.getLE<uint64_t>(), 42);
+}
@@ -38,6 +38,7 @@
 #include "base/compiler.hh"
 #include "base/trace.hh"
 #include "debug/MMU.hh"
+#include "sim/emul_lock.hh"
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
@@ -47,6 +48,7 @@ namespace gem5
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
+    ScopedEmulationLock lock;
     bool clobber = flags & Clobber;
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
@@ -74,6 +76,7 @@ EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 void
 EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 {
+    ScopedEmulationLock lock;
     assert(pageOffset(vaddr) == 0);
     assert(pageOffset(new_vaddr) == 0);
 
@@ -103,6 +106,7 @@ EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 void
 EmulationPageTable::unmap(Addr vaddr, int64_t size)
 {
+    ScopedEmulationLock lock;
     assert(pageOffset(vaddr) == 0);
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
@@ -119,6 +123,7 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
 bool
 EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 {
+    ScopedEmulationLock lock;
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
@@ -132,6 +137,7 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
+    ScopedEmulationLock lock;
     Addr page_addr = pageAlign(vaddr);
     PTableItr iter = pTable.find(page_addr);
     if (iter == pTable.end())
@@ -92,6 +92,7 @@ class DefaultResponsePort : public ResponsePort
 
     // Atomic protocol.
     Tick recvAtomic(PacketPtr) override { blowUp(); }
+    void recvAtomicWarmup(WarmAccessBatch &) override { blowUp(); }
 
     // Timing protocol.
     bool recvTimingReq(PacketPtr) override { blowUp(); }
@@ -156,7 +157,7 @@ RequestPort::getAddrRanges() const
 void
 RequestPort::printAddr(Addr a)
 {
-    auto req = std::make_shared<Request>(
+    auto req = Request::create(
         a, 1, 0, Request::funcRequestorId);
 
     Packet pkt(req, MemCmd::PrintReq);
@@ -149,6 +149,17 @@ class RequestPort: public Port, public AtomicRequestProtocol,
      */
     Tick sendAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
 
+    /**
+     * Send a batch of warm-up accesses, which only update the state of
+     * the memory system (e.g., cache tags and replacement data) in
+     * zero time, without moving any data.
+     *
+     * @param batch Accesses to replay, in program order. On return,
+     *        the allocate flag of each access tells whether a clean
+     *        copy of the line may be allocated by the sender.
+     */
+    void sendAtomicWarmup(WarmAccessBatch &batch);
+
   public:
     /* The functional protocol. */
 
@@ -439,6 +450,12 @@ class ResponsePort : public Port, public AtomicResponseProtocol,
      */
     Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor) override;
 
+    /**
+     * By default, warm-up accesses are ignored. This is what memories
+     * and devices, which have no state worth warming up, want.
+     */
+    void recvAtomicWarmup(WarmAccessBatch &batch) override {}
+
     bool
     tryTiming(PacketPtr pkt) override
     {
@@ -481,6 +498,16 @@ RequestPort::sendAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor)
     }
 }
 
+inline void
+RequestPort::sendAtomicWarmup(WarmAccessBatch &batch)
+{
+    try {
+        AtomicRequestProtocol::sendWarmup(_responsePort, batch);
+    } catch (UnboundPortException) {
+        reportUnbound();
+    }
+}
+
 inline void
 RequestPort::sendFunctional(PacketPtr pkt) const
 {
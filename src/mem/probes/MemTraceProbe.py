@@ -45,6 +45,17 @@ class MemTraceProbe(BaseMemProbe):
     # Boolean to compress the trace or not.
     trace_compress = Param.Bool(True, "Enable trace compression")
 
+    # Lower levels are faster, but generate larger traces
+    trace_compress_level = Param.Int(-1, "Gzip compression level, from 1 "
+        "(fastest) to 9 (smallest), or -1 for the default of zlib")
+
+    # Encode and write the trace in a thread of its own, so that the
+    # simulation only has to queue the traced requests
+    async_encoding = Param.Bool(False,
+        "Encode and write the trace in a separate thread")
+    async_queue_size = Param.Unsigned(65536,
+        "Number of traced requests that can wait to be encoded")
+
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
 
@@ -0,0 +1,58 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.BaseMemProbe import BaseMemProbe
+
+class ReuseDistProbe(BaseMemProbe):
+    type = 'ReuseDistProbe'
+    cxx_header = "mem/probes/reuse_dist.hh"
+    cxx_class = 'gem5::ReuseDistProbe'
+
+    system = Param.System(Parent.any,
+                          "System to use when determining system cache "
+                          "line size and requestor names")
+
+    line_size = Param.Unsigned(Parent.cache_line_size,
+                               "Cache line size in bytes (must be larger or "
+                               "equal to the system's line size)")
+
+    # Spatial sampling of the lines, whose rate is lowered whenever more
+    # lines than the maximum are sampled
+    sampling_rate = Param.Float(0.01, "Initial fraction of the lines that "
+                                "are sampled")
+    max_sampled_lines = Param.Unsigned(8192, "Maximum number of lines "
+                                       "sampled at once (0 for no limit)")
+
+    # Cache sizes of the miss ratio curves, in steps of powers of two
+    min_cache_size = Param.MemorySize('1kB', "Smallest cache size")
+    max_cache_size = Param.MemorySize('256MB', "Largest cache size")
+
+    per_requestor = Param.Bool(True, "Build a curve for the accesses of "
+                               "each requestor, as seen by a private cache")
+
+    hist_bins = Param.Unsigned(32, "Bins in the stack distance histogram")
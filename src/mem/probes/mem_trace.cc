@@ -37,6 +37,9 @@
 
 #include "mem/probes/mem_trace.hh"
 
+#include <chrono>
+#include <vector>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "params/MemTraceProbe.hh"
@@ -52,7 +55,10 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
     : BaseMemProbe(p),
       traceStream(nullptr),
       system(p.system),
-      withPC(p.with_pc)
+      withPC(p.with_pc),
+      pendingRequests(p.async_encoding ?
+          new SPSCQueue<TracedRequest>(p.async_queue_size) : nullptr),
+      stopEncoder(false)
 {
     std::string filename;
     if (p.trace_file != "") {
@@ -74,7 +80,7 @@ MemTraceProbe::MemTraceProbe(const MemTraceProbeParams &p)
                                   (p.trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    traceStream = new ProtoOutputStream(filename, p.trace_compress_level);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -98,11 +104,21 @@ MemTraceProbe::startup()
     }
 
     traceStream->write(header_msg);
+
+    // The stream is only used by the encoder from now on
+    if (pendingRequests)
+        encoder = std::thread([this]() { encodeRequests(); });
 }
 
 void
 MemTraceProbe::closeStreams()
 {
+    // Let the encoder write the requests that are still pending
+    if (encoder.joinable()) {
+        stopEncoder = true;
+        encoder.join();
+    }
+
     if (traceStream != NULL)
         delete traceStream;
 }
@@ -110,18 +126,67 @@ MemTraceProbe::closeStreams()
 void
 MemTraceProbe::handleRequest(const probing::PacketInfo &pkt_info)
 {
-    ProtoMessage::Packet pkt_msg;
+    const TracedRequest req = {curTick(), pkt_info.cmd.toInt(),
+        pkt_info.flags, pkt_info.addr, pkt_info.size, pkt_info.pc,
+        pkt_info.id};
 
-    pkt_msg.set_tick(curTick());
-    pkt_msg.set_cmd(pkt_info.cmd.toInt());
-    pkt_msg.set_flags(pkt_info.flags);
-    pkt_msg.set_addr(pkt_info.addr);
-    pkt_msg.set_size(pkt_info.size);
-    if (withPC && pkt_info.pc != 0)
-        pkt_msg.set_pc(pkt_info.pc);
-    pkt_msg.set_pkt_id(pkt_info.id);
+    if (pendingRequests) {
+        // Wait for the encoder to catch up if it is falling behind
+        while (!pendingRequests->push(req))
+            std::this_thread::yield();
+        return;
+    }
 
+    ProtoMessage::Packet pkt_msg;
+    encode(req, pkt_msg);
     traceStream->write(pkt_msg);
 }
 
+void
+MemTraceProbe::encode(const TracedRequest &req,
+                      ProtoMessage::Packet &pkt_msg) const
+{
+    pkt_msg.set_tick(req.tick);
+    pkt_msg.set_cmd(req.cmd);
+    pkt_msg.set_flags(req.flags);
+    pkt_msg.set_addr(req.addr);
+    pkt_msg.set_size(req.size);
+    if (withPC && req.pc != 0)
+        pkt_msg.set_pc(req.pc);
+    else
+        pkt_msg.clear_pc();
+    pkt_msg.set_pkt_id(req.id);
+}
+
+void
+MemTraceProbe::encodeRequests()
+{
+    const size_t batch_size = 1024;
+    std::vector<TracedRequest> reqs(batch_size);
+    std::vector<ProtoMessage::Packet> pkt_msgs(batch_size);
+    std::vector<const google::protobuf::Message *> batch;
+    batch.reserve(batch_size);
+
+    while (true) {
+        // Check whether to stop before popping, so that nothing pushed
+        // before the stop request is left behind
+        const bool stop = stopEncoder;
+        const size_t num_reqs = pendingRequests->pop(reqs.data(),
+                                                     batch_size);
+        if (num_reqs == 0) {
+            if (stop)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+
+        batch.clear();
+        for (size_t i = 0; i < num_reqs; i++) {
+            encode(reqs[i], pkt_msgs[i]);
+            batch.push_back(&pkt_msgs[i]);
+        }
+        traceStream->write(batch);
+    }
+}
+
 } // namespace gem5
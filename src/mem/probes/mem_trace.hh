@@ -38,10 +38,20 @@
 #ifndef __MEM_PROBES_MEM_TRACE_HH__
 #define __MEM_PROBES_MEM_TRACE_HH__
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "base/spsc_queue.hh"
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "proto/protoio.hh"
 
+namespace ProtoMessage
+{
+class Packet;
+} // namespace ProtoMessage
+
 namespace gem5
 {
 
@@ -54,8 +64,36 @@ class MemTraceProbe : public BaseMemProbe
     MemTraceProbe(const MemTraceProbeParams &params);
 
   protected:
+    /** A traced request, before being encoded. */
+    struct TracedRequest
+    {
+        Tick tick;
+        int cmd;
+        Request::FlagsType flags;
+        Addr addr;
+        uint32_t size;
+        Addr pc;
+        RequestorID id;
+    };
+
     void handleRequest(const probing::PacketInfo &pkt_info) override;
 
+    /**
+     * Encode a traced request into a protobuf message.
+     *
+     * @param req The traced request.
+     * @param pkt_msg The message, which is overwritten.
+     */
+    void encode(const TracedRequest &req,
+                ProtoMessage::Packet &pkt_msg) const;
+
+    /**
+     * Body of the encoder thread, which encodes the queued requests in
+     * batches and writes them to the trace, until it is stopped and the
+     * queue is drained.
+     */
+    void encodeRequests();
+
     /**
      * Callback to flush and close all open output streams on exit. If
      * we were calling the destructor it could be done there.
@@ -75,6 +113,19 @@ class MemTraceProbe : public BaseMemProbe
 
     /** Include the Program Counter in the memory trace */
     const bool withPC;
+
+    /**
+     * Requests waiting for the encoder thread. Only used when encoding
+     * asynchronously, in which case the simulation thread is the only
+     * producer and the encoder thread is the only consumer.
+     */
+    std::unique_ptr<SPSCQueue<TracedRequest>> pendingRequests;
+
+    /** Thread that encodes the pending requests. */
+    std::thread encoder;
+
+    /** Whether the encoder must finish once the queue is drained. */
+    std::atomic<bool> stopEncoder;
 };
 
 } // namespace gem5
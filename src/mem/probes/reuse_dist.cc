@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/probes/reuse_dist.hh"
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "params/ReuseDistProbe.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+/** Name a cache size with the largest unit that divides it. */
+std::string
+cacheSizeName(uint64_t bytes)
+{
+    static const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    int unit = 0;
+    while (unit < 4 && bytes >= 1024 && bytes % 1024 == 0) {
+        bytes /= 1024;
+        unit++;
+    }
+    return csprintf("%d%s", bytes, units[unit]);
+}
+
+} // anonymous namespace
+
+ReuseDistProbe::ReuseDistProbe(const ReuseDistProbeParams &p)
+    : BaseMemProbe(p),
+      system(p.system),
+      lineSize(p.line_size),
+      samplingRate(p.sampling_rate),
+      maxSampledLines(p.max_sampled_lines),
+      perRequestor(p.per_requestor),
+      calc(p.sampling_rate, p.max_sampled_lines),
+      stats(this)
+{
+    fatal_if(p.system->cacheLineSize() > p.line_size,
+             "The reuse distance probe must use a cache line size that is "
+             "larger or equal to the system's cache line size.");
+    fatal_if(!isPowerOf2(p.min_cache_size) || !isPowerOf2(p.max_cache_size) ||
+             p.min_cache_size < lineSize ||
+             p.min_cache_size > p.max_cache_size,
+             "The cache sizes of the curves must be powers of two, between "
+             "the line size and the largest size.");
+
+    for (uint64_t size = p.min_cache_size; size <= p.max_cache_size;
+         size *= 2) {
+        cacheSizes.push_back(size / lineSize);
+    }
+}
+
+std::size_t
+ReuseDistProbe::numMisses(uint64_t distance) const
+{
+    // An access hits in a cache that holds more lines than the distinct
+    // lines accessed since the previous access to its line
+    std::size_t num_misses = 0;
+    while (num_misses < cacheSizes.size() &&
+           cacheSizes[num_misses] <= distance) {
+        num_misses++;
+    }
+    return num_misses;
+}
+
+void
+ReuseDistProbe::handleRequest(const probing::PacketInfo &pkt_info)
+{
+    // only capturing read and write requests (which allocate in the
+    // cache)
+    if (!pkt_info.cmd.isRead() && !pkt_info.cmd.isWrite())
+        return;
+
+    stats.accesses++;
+
+    const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
+
+    uint64_t distance;
+    if (calc.access(aligned_addr, distance)) {
+        stats.sampledAccesses++;
+        if (pkt_info.htm)
+            stats.htmSampledAccesses++;
+
+        if (distance == SampledStackDistCalc::Infinity)
+            stats.coldMisses++;
+        else
+            stats.distance.sample(distance);
+
+        statistics::Vector &type_misses =
+            pkt_info.htm ? stats.htmMisses : stats.nonHtmMisses;
+        for (std::size_t i = 0; i < numMisses(distance); i++) {
+            stats.misses[i]++;
+            type_misses[i]++;
+        }
+    }
+
+    if (!perRequestor)
+        return;
+
+    // Requestors registered after the statistics cannot be accounted
+    const RequestorID id = pkt_info.id;
+    if (id >= stats.requestorSampledAccesses.size()) {
+        warn_once("%s: ignoring requestors without statistics.\n", name());
+        return;
+    }
+    if (id >= requestorCalcs.size())
+        requestorCalcs.resize(id + 1);
+    if (!requestorCalcs[id]) {
+        requestorCalcs[id].reset(
+            new SampledStackDistCalc(samplingRate, maxSampledLines));
+    }
+
+    if (requestorCalcs[id]->access(aligned_addr, distance)) {
+        stats.requestorSampledAccesses[id]++;
+        for (std::size_t i = 0; i < numMisses(distance); i++)
+            stats.requestorMisses[id][i]++;
+    }
+}
+
+ReuseDistProbe::ReuseDistProbeStats::ReuseDistProbeStats(
+    ReuseDistProbe *parent)
+    : statistics::Group(parent), probe(*parent),
+      ADD_STAT(accesses, statistics::units::Count::get(),
+               "Number of read and write accesses"),
+      ADD_STAT(samplingRate, statistics::units::Ratio::get(),
+               "Fraction of the lines currently sampled"),
+      ADD_STAT(sampledAccesses, statistics::units::Count::get(),
+               "Number of sampled accesses"),
+      ADD_STAT(htmSampledAccesses, statistics::units::Count::get(),
+               "Number of sampled transactional accesses"),
+      ADD_STAT(coldMisses, statistics::units::Count::get(),
+               "Number of sampled accesses with infinite stack distance"),
+      ADD_STAT(distance, statistics::units::Count::get(),
+               "Distribution of the estimated stack distances, in lines"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Sampled accesses that miss in a cache of each size"),
+      ADD_STAT(htmMisses, statistics::units::Count::get(),
+               "Sampled transactional accesses that miss in a cache of "
+               "each size"),
+      ADD_STAT(nonHtmMisses, statistics::units::Count::get(),
+               "Sampled non-transactional accesses that miss in a cache of "
+               "each size"),
+      ADD_STAT(missRatio, statistics::units::Ratio::get(),
+               "Miss ratio of a cache of each size",
+               misses / sampledAccesses),
+      ADD_STAT(htmMissRatio, statistics::units::Ratio::get(),
+               "Miss ratio of the transactional accesses in a cache of "
+               "each size",
+               htmMisses / htmSampledAccesses),
+      ADD_STAT(nonHtmMissRatio, statistics::units::Ratio::get(),
+               "Miss ratio of the non-transactional accesses in a cache of "
+               "each size",
+               nonHtmMisses / (sampledAccesses - htmSampledAccesses)),
+      ADD_STAT(requestorSampledAccesses, statistics::units::Count::get(),
+               "Number of sampled accesses of each requestor"),
+      ADD_STAT(requestorMisses, statistics::units::Count::get(),
+               "Sampled accesses of each requestor that miss in a private "
+               "cache of each size"),
+      ADD_STAT(requestorMissRatio, statistics::units::Ratio::get(),
+               "Miss ratio of each requestor in a private cache of each "
+               "size")
+{
+    using namespace statistics;
+
+    const ReuseDistProbeParams &p =
+        dynamic_cast<const ReuseDistProbeParams &>(parent->params());
+
+    samplingRate.method(&parent->calc, &SampledStackDistCalc::samplingRate);
+
+    distance
+        .init(p.hist_bins)
+        .flags(pdf);
+
+    htmSampledAccesses.flags(nozero);
+    htmMissRatio.flags(nozero | nonan);
+}
+
+void
+ReuseDistProbe::ReuseDistProbeStats::regStats()
+{
+    using namespace statistics;
+
+    Group::regStats();
+
+    // Requestors register their IDs when they are constructed, so they
+    // are all known by now
+    System *system = probe.system;
+    const std::size_t num_requestors = system->maxRequestors();
+    const std::size_t num_sizes = probe.cacheSizes.size();
+
+    requestorSampledAccesses
+        .init(num_requestors)
+        .flags(nozero | nonan);
+    requestorMisses
+        .init(num_requestors, num_sizes)
+        .flags(nozero | nonan);
+    requestorMissRatio
+        .init(num_requestors, num_sizes)
+        .flags(nozero | nonan);
+
+    misses.init(num_sizes);
+    htmMisses.init(num_sizes).flags(nozero);
+    nonHtmMisses.init(num_sizes);
+    for (std::size_t i = 0; i < num_sizes; i++) {
+        const std::string size_name =
+            cacheSizeName(probe.cacheSizes[i] * probe.lineSize);
+        misses.subname(i, size_name);
+        htmMisses.subname(i, size_name);
+        nonHtmMisses.subname(i, size_name);
+        missRatio.subname(i, size_name);
+        htmMissRatio.subname(i, size_name);
+        nonHtmMissRatio.subname(i, size_name);
+        requestorMisses.ysubname(i, size_name);
+        requestorMissRatio.ysubname(i, size_name);
+    }
+
+    for (std::size_t i = 0; i < num_requestors; i++) {
+        const std::string &requestor = system->getRequestorName(i);
+        requestorSampledAccesses.subname(i, requestor);
+        requestorMisses.subname(i, requestor);
+        requestorMissRatio.subname(i, requestor);
+    }
+}
+
+void
+ReuseDistProbe::ReuseDistProbeStats::preDumpStats()
+{
+    Group::preDumpStats();
+
+    for (std::size_t i = 0; i < requestorSampledAccesses.size(); i++) {
+        const Counter sampled = requestorSampledAccesses[i].value();
+        for (std::size_t j = 0; j < probe.cacheSizes.size(); j++) {
+            requestorMissRatio[i][j] = sampled == 0 ? 0 :
+                requestorMisses[i][j].value() / sampled;
+        }
+    }
+}
+
+} // namespace gem5
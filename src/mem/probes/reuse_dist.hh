@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_PROBES_REUSE_DIST_HH__
+#define __MEM_PROBES_REUSE_DIST_HH__
+
+#include <memory>
+#include <vector>
+
+#include "mem/probes/base.hh"
+#include "mem/sampled_stack_dist_calc.hh"
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+struct ReuseDistProbeParams;
+class System;
+
+/**
+ * A probe that builds miss ratio curves of fully associative LRU caches
+ * of every size at once, from approximate stack distances computed with
+ * spatial sampling (SHARDS). Its cost per access and its memory are
+ * bounded, so it can be kept enabled during full runs.
+ *
+ * A curve is built for all the observed accesses, which is split between
+ * transactional and non-transactional accesses. Each requestor can also
+ * get a curve of its own, as seen by a private cache, whose stack
+ * distances only account for the accesses of that requestor.
+ */
+class ReuseDistProbe : public BaseMemProbe
+{
+  public:
+    ReuseDistProbe(const ReuseDistProbeParams &params);
+
+  protected:
+    void handleRequest(const probing::PacketInfo &pkt_info) override;
+
+    /**
+     * Get the number of cache sizes of the curves at which an access
+     * misses.
+     *
+     * @param distance The stack distance of the access.
+     * @return The number of cache sizes that are not larger than the
+     *         distance, which are the first ones.
+     */
+    std::size_t numMisses(uint64_t distance) const;
+
+    System *system;
+
+    /** Cache line size to simulate. */
+    const unsigned lineSize;
+
+    /** Initial sampling rate of every calculator. */
+    const double samplingRate;
+
+    /** Maximum number of lines tracked by every calculator. */
+    const std::size_t maxSampledLines;
+
+    /** Whether to build a curve for each requestor. */
+    const bool perRequestor;
+
+    /** Cache sizes of the curves, in lines, in increasing order. */
+    std::vector<uint64_t> cacheSizes;
+
+    /** Stack distance calculator of all the accesses. */
+    SampledStackDistCalc calc;
+
+    /** Stack distance calculators of each requestor, created on demand. */
+    std::vector<std::unique_ptr<SampledStackDistCalc>> requestorCalcs;
+
+    struct ReuseDistProbeStats : public statistics::Group
+    {
+        ReuseDistProbeStats(ReuseDistProbe *parent);
+
+        void regStats() override;
+        void preDumpStats() override;
+
+        const ReuseDistProbe &probe;
+
+        /** Number of accesses observed. */
+        statistics::Scalar accesses;
+
+        /** Current sampling rate of the calculator of all accesses. */
+        statistics::Value samplingRate;
+
+        /** Number of sampled accesses. */
+        statistics::Scalar sampledAccesses;
+
+        /** Number of sampled transactional accesses. */
+        statistics::Scalar htmSampledAccesses;
+
+        /** Number of sampled accesses that were the first to a line. */
+        statistics::Scalar coldMisses;
+
+        /** Distribution of the stack distances, in lines. */
+        statistics::Histogram distance;
+
+        /** Sampled accesses that miss in a cache of each size. */
+        statistics::Vector misses;
+        statistics::Vector htmMisses;
+        statistics::Vector nonHtmMisses;
+
+        /** Miss ratio curves. */
+        statistics::Formula missRatio;
+        statistics::Formula htmMissRatio;
+        statistics::Formula nonHtmMissRatio;
+
+        /** Number of sampled accesses of each requestor. */
+        statistics::Vector requestorSampledAccesses;
+
+        /** Sampled accesses of each requestor that miss in its cache. */
+        statistics::Vector2d requestorMisses;
+
+        /** Miss ratio curve of each requestor. */
+        statistics::Vector2d requestorMissRatio;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif //__MEM_PROBES_REUSE_DIST_HH__
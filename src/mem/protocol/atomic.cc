@@ -62,6 +62,13 @@ AtomicRequestProtocol::sendBackdoor(AtomicResponseProtocol *peer,
     return peer->recvAtomicBackdoor(pkt, backdoor);
 }
 
+void
+AtomicRequestProtocol::sendWarmup(AtomicResponseProtocol *peer,
+        WarmAccessBatch &batch)
+{
+    peer->recvAtomicWarmup(batch);
+}
+
 /* The response protocol. */
 
 Tick
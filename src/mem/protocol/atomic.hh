@@ -43,6 +43,7 @@
 
 #include "mem/backdoor.hh"
 #include "mem/packet.hh"
+#include "mem/warm_access.hh"
 
 namespace gem5
 {
@@ -80,6 +81,16 @@ class AtomicRequestProtocol
     Tick sendBackdoor(AtomicResponseProtocol *peer, PacketPtr pkt,
                       MemBackdoorPtr &backdoor);
 
+    /**
+     * Send a batch of warm-up accesses, which only update the state
+     * of the memory system (e.g., cache tags) in zero time, without
+     * moving any data.
+     *
+     * @param peer Peer to send the batch to.
+     * @param batch Accesses to replay, in program order.
+     */
+    void sendWarmup(AtomicResponseProtocol *peer, WarmAccessBatch &batch);
+
     /**
      * Receive an atomic snoop request packet from our peer.
      */
@@ -114,6 +125,11 @@ class AtomicResponseProtocol
      */
     virtual Tick recvAtomicBackdoor(
             PacketPtr pkt, MemBackdoorPtr &backdoor) = 0;
+
+    /**
+     * Receive a batch of warm-up accesses from the peer.
+     */
+    virtual void recvAtomicWarmup(WarmAccessBatch &batch) = 0;
 };
 
 } // namespace gem5
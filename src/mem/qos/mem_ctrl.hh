@@ -422,13 +422,14 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
                 writeQueueSizes[tgt_prio] += moved_entries;
             }
 
+            // Erase element from source packet queue, this will
+            // increment the iterator. It must happen before the packet
+            // is queued again, as that renumbers it.
+            it = queues[curr_prio].erase(it);
+
             // Change QoS priority and move packet
             pkt->qosValue(tgt_prio);
             queues[tgt_prio].push_back(pkt);
-
-            // Erase element from source packet queue, this will
-            // increment the iterator
-            it = queues[curr_prio].erase(it);
             panic_if(packetPriorities[id][curr_prio] < moved_entries,
                      "qos::MemCtrl::escalateQueues requestor %s negative "
                      "packets for priority %d",
@@ -54,6 +54,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
@@ -62,6 +63,7 @@
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
+#include "mem/mem_pool.hh"
 #include "sim/cur_tick.hh"
 
 namespace gem5
@@ -237,6 +239,12 @@ class Request
 
         /** The request adds an address to the Rset of a HTM transaction */
         HTM_ISOLATE                 = 0x0000100000000000,
+
+        /**
+         * The HTM_START request begins a transaction that elides a
+         * lock, e.g. x86's XACQUIRE, rather than an explicit one
+         */
+        HTM_LOCK_ELISION            = 0x0000200000000000,
         /**
          * These flags are *not* cleared when a Request object is
          * reused (assigned a new address).
@@ -502,6 +510,20 @@ class Request
 
     ~Request() {}
 
+    /**
+     * Allocate a request from the per-thread memory pools. Takes the
+     * same arguments as the constructors.
+     */
+    template <typename... Args>
+    static RequestPtr
+    create(Args&&... args)
+    {
+        using Allocator = mem_pool::PoolAllocator<Request,
+              mem_pool::RequestAllocs, mem_pool::RequestReuses>;
+        return std::allocate_shared<Request>(Allocator(),
+                                             std::forward<Args>(args)...);
+    }
+
     /**
      * Set up Context numbers.
      */
@@ -575,8 +597,8 @@ class Request
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = Request::create(*this);
+        req2 = Request::create(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -984,6 +1006,11 @@ class Request
     bool isHTMAbort() const { return _flags.isSet(HTM_ABORT); }
     bool isHTMIsolate() const { return _flags.isSet(HTM_ISOLATE); }
     bool
+    isHTMLockElision() const
+    {
+        return _flags.isSet(HTM_LOCK_ELISION);
+    }
+    bool
     isHTMCmd() const
     {
         return (isHTMStart() || isHTMCommit() ||
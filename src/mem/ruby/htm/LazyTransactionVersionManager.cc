@@ -284,7 +284,7 @@ CLASS_NS flushWriteBuffer(){
             // Create request and packet
             Request::Flags flags;
             assert(m_requestorID != Request::invldRequestorId);
-            RequestPtr req = std::make_shared<Request>(
+            RequestPtr req = Request::create(
                          addr, RubySystem::getBlockSizeBytes(),
                          flags,  m_requestorID);
             PacketPtr pkt =  new Packet(req, MemCmd::WriteReq,
@@ -93,6 +93,8 @@ TransactionInterfaceManager::TransactionInterfaceManager(const Params &p)
     m_abortCause         = HTMStats::AbortCause::Undefined;
     m_abortSourceNonTransactional = false;
     m_lastFailureCause   = HtmFailureFaultCause::INVALID;
+    m_abortedOnFallbackLock = false;
+    m_lockElision        = false;
     m_capacityAbortWriteSet = false;
     // Only supported HTM protocols by TransactionInterfaceManager
     assert(m_ruby_system->getProtocol() == "MESI_Two_Level_HTM_umu" ||
@@ -216,6 +218,8 @@ TransactionInterfaceManager::beginTransaction(PacketPtr pkt)
         }
         m_htmstart_tick = pkt->req->time();
         m_htmstart_instruction = pkt->req->getInstCount();
+        m_abortedOnFallbackLock = false;
+        m_lockElision = pkt->req->isHTMLockElision();
         if (isAborting()) {
             DPRINTF(RubyHTM, "HTM: beginTransaction found abort flag set\n");
             XACT_PROFILER->moveTo(getProcID(), AnnotatedRegion_ABORTING);
@@ -359,6 +363,10 @@ TransactionInterfaceManager::commitTransaction(PacketPtr pkt)
         m_htm_transaction_instructions.sample(
                                               transaction_instructions);
         m_htmstart_instruction = 0;
+        if (m_lockElision) {
+            m_htm_elided_locks++;
+            m_lockElision = false;
+        }
     }
 
     m_transactionLevel--;
@@ -828,6 +836,25 @@ profileHtmFailureFaultCause(HtmFailureFaultCause cause)
     m_htm_transaction_abort_cause[cause_idx]++;
     DPRINTF(RubyHTM, "htmAbort - reason=%s\n",
             htmFailureToStr(preciseFaultCause));
+
+    // Remembered until the next transaction begins, so that the
+    // sequencer can hold its start while the fallback lock is taken
+    m_abortedOnFallbackLock =
+        preciseFaultCause == HtmFailureFaultCause::MEMORY_FALLBACKLOCK ||
+        preciseFaultCause == HtmFailureFaultCause::EXPLICIT_FALLBACKLOCK;
+
+    if (m_lockElision) {
+        // The aborted acquire is re-executed taking the lock
+        m_htm_taken_locks++;
+        m_lockElision = false;
+    }
+}
+
+void
+TransactionInterfaceManager::profileFallbackLockWait(Cycles cycles)
+{
+    m_htm_fallback_lock_waits++;
+    m_htm_fallback_lock_wait_cycles += cycles;
 }
 
 HtmCacheFailure
@@ -1394,6 +1421,23 @@ TransactionInterfaceManager::regStats()
             cause_idx,
             htmFailureToStr(HtmFailureFaultCause(cause_idx)));
     }
+    m_htm_elided_locks
+        .name(name() + ".htm_elided_locks")
+        .desc("number of lock acquires elided by committed transactions")
+        ;
+    m_htm_taken_locks
+        .name(name() + ".htm_taken_locks")
+        .desc("number of elided lock acquires taken after an abort")
+        ;
+    m_htm_fallback_lock_waits
+        .name(name() + ".htm_fallback_lock_waits")
+        .desc("number of transaction begins that waited for the "
+              "fallback lock")
+        ;
+    m_htm_fallback_lock_wait_cycles
+        .name(name() + ".htm_fallback_lock_wait_cycles")
+        .desc("cycles spent waiting for the fallback lock release")
+        ;
 }
 
 std::vector<TransactionInterfaceManager*>
@@ -74,6 +74,8 @@ public:
 
   void setAbortCause(HTMStats::AbortCause cause);
   void profileHtmFailureFaultCause(HtmFailureFaultCause cause);
+  bool abortedOnFallbackLock() const { return m_abortedOnFallbackLock; }
+  void profileFallbackLockWait(Cycles cycles);
   HtmCacheFailure getHtmTransactionalReqResponseCode();
 
   AnnotatedRegion_t getWaitForRetryRegionFromPreviousAbortCause();
@@ -231,6 +233,8 @@ private:
   HTMStats::AbortCause m_abortCause;
   bool     m_abortSourceNonTransactional;
   HtmFailureFaultCause  m_lastFailureCause;  // Cause of preceding abort
+  bool     m_abortedOnFallbackLock; // Preceding abort due to fallback lock
+  bool     m_lockElision; // Current transaction elides a lock (HLE)
   bool     m_capacityAbortWriteSet; // For capacity aborts, whether Wset/Rset
   Addr     m_abortAddress;
   // Sanity checks
@@ -245,6 +249,14 @@ private:
     Stats::Histogram m_htm_transaction_instructions;
     //! Causes for HTM transaction aborts
     Stats::Vector m_htm_transaction_abort_cause;
+    //! Lock acquires elided by committed HLE transactions
+    Stats::Scalar m_htm_elided_locks;
+    //! Lock acquires re-executed non-speculatively after an HLE abort
+    Stats::Scalar m_htm_taken_locks;
+    //! Transaction begins delayed until the fallback lock was free
+    Stats::Scalar m_htm_fallback_lock_waits;
+    //! Cycles spent waiting for the fallback lock to be released
+    Stats::Scalar m_htm_fallback_lock_wait_cycles;
 };
 
 } // namespace ruby
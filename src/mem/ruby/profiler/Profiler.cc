@@ -138,7 +138,9 @@ ProfilerStats::ProfilerStats(statistics::Group *parent, Profiler *profiler)
       ADD_STAT(m_latencyHistCoalsr, ""),
       ADD_STAT(m_hitLatencyHistSeqr, ""),
       ADD_STAT(m_missLatencyHistSeqr, ""),
-      ADD_STAT(m_missLatencyHistCoalsr, "")
+      ADD_STAT(m_missLatencyHistCoalsr, ""),
+      ADD_STAT(xactRegionCycles, "cycles spent by all threads in each "
+               "annotated region (HTM profiler)")
 {
 #if 0
     if (m_xact_profiler) {
@@ -185,6 +187,14 @@ ProfilerStats::ProfilerStats(statistics::Group *parent, Profiler *profiler)
     m_missLatencyHistCoalsr
         .init(10)
         .flags(statistics::nozero | statistics::pdf | statistics::oneline);
+
+    xactRegionCycles
+        .init(AnnotatedRegion_NUM)
+        .flags(statistics::nozero | statistics::total);
+    for (int i = AnnotatedRegion_FIRST; i < AnnotatedRegion_NUM; i++) {
+        xactRegionCycles.subname(i,
+            AnnotatedRegion_to_string(AnnotatedRegion_t(i)));
+    }
 }
 
 Profiler::ProfilerStats::
@@ -419,6 +429,16 @@ Profiler::collateStats()
 
     m_ruby_cycles = m_ruby_system->curCycle() - m_ruby_system->getStartCycle();
 #endif
+    if (hasXactProfiler()) {
+        // Account the cycles spent in the current regions so far, so
+        // that stats cover the whole period being dumped (e.g. a
+        // sampled region)
+        m_xact_profiler_ptr->profileCurrentAnnotatedRegion();
+        for (int i = AnnotatedRegion_FIRST; i < AnnotatedRegion_NUM; i++) {
+            rubyProfilerStats.xactRegionCycles[i] =
+                m_xact_profiler_ptr->getRegionCycles(AnnotatedRegion_t(i));
+        }
+    }
     for (uint32_t i = 0; i < MachineType_NUM; i++) {
         for (std::map<uint32_t, AbstractController*>::iterator it =
                   m_ruby_system->m_abstract_controls[i].begin();
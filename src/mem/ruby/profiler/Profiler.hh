@@ -199,6 +199,10 @@ class Profiler
         //! miss in the controller connected to this sequencer.
         statistics::Histogram m_missLatencyHistSeqr;
         statistics::Histogram m_missLatencyHistCoalsr;
+
+        //! Cycles spent by all threads in each annotated region, as
+        //! classified by the HTM profiler
+        statistics::Vector xactRegionCycles;
     };
 
     //added by SS
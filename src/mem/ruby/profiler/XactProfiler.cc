@@ -229,6 +229,19 @@ XactProfiler::profileCurrentAnnotatedRegion()
     assert((curExecTime * num_sequencers) == totalRegionCycles);
 }
 
+uint64_t
+XactProfiler::getRegionCycles(AnnotatedRegion region) const
+{
+    // Include the cycles of the transactions still in flight, whose
+    // outcome is not known yet, so that all cycles are accounted
+    uint64_t cycles = 0;
+    for (size_t i = 0; i < m_state_cycle_count.size(); i++) {
+        cycles += m_state_cycle_count[i][region];
+        cycles += m_currentXactCyclesPerRegion[i][region];
+    }
+    return cycles;
+}
+
 void
 XactProfiler::profileCurrentTransactionalRegion(int proc_no)
 {
@@ -46,6 +46,7 @@ public:
     void endRegion(int proc_no, AnnotatedRegion region);
     void profileCurrentAnnotatedRegion();
     void profileCurrentTransactionalRegion(int proc_no);
+    uint64_t getRegionCycles(AnnotatedRegion region) const;
 
     // Destructor
     ~XactProfiler();
@@ -266,7 +266,7 @@ AbstractController::serviceMemoryQueue()
     }
 
     RequestPtr req
-        = std::make_shared<Request>(mem_msg->m_addr, req_size, 0, m_id);
+        = Request::create(mem_msg->m_addr, req_size, 0, m_id);
     PacketPtr pkt;
     if (mem_msg->getType() == MemoryRequestType_MEMORY_WB) {
         pkt = Packet::createWrite(req);
@@ -399,6 +399,13 @@ AbstractController::recvAtomic(PacketPtr pkt)
    return ticksToCycles(memoryPort.sendAtomic(pkt));
 }
 
+Tick
+AbstractController::recvAtomicBackdoor(PacketPtr pkt,
+                                       MemBackdoorPtr &backdoor)
+{
+   return ticksToCycles(memoryPort.sendAtomicBackdoor(pkt, backdoor));
+}
+
 MachineID
 AbstractController::mapAddressToMachine(Addr addr, MachineType mtype) const
 {
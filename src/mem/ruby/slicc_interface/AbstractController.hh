@@ -172,6 +172,7 @@ class AbstractController : public ClockedObject, public Consumer
 
     void recvTimingResp(PacketPtr pkt);
     Tick recvAtomic(PacketPtr pkt);
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
 
     const AddrRangeList &getAddrRanges() const { return addrRanges; }
 
@@ -178,7 +178,7 @@ class PendingWriteInst
         assert(numPendingStores == 0);
 
         // make a response packet
-        PacketPtr pkt = new Packet(std::make_shared<Request>(),
+        PacketPtr pkt = new Packet(Request::create(),
                                    MemCmd::WriteCompleteResp);
 
         if (!usingRubyTester) {
@@ -360,6 +360,27 @@ RubyPort::MemResponsePort::recvAtomic(PacketPtr pkt)
     return latency;
 }
 
+Tick
+RubyPort::MemResponsePort::recvAtomicBackdoor(PacketPtr pkt,
+                                              MemBackdoorPtr &backdoor)
+{
+    RubyPort *ruby_port = static_cast<RubyPort *>(&owner);
+
+    // Atomic (noncaching) accesses leave no state in Ruby, so the CPUs
+    // can be given a back door to the memory behind the directory
+    if (access_backing_store || !ruby_port->system->bypassCaches() ||
+        pkt->cmd == MemCmd::MemSyncReq || !isPhysMemAddress(pkt)) {
+        return recvAtomic(pkt);
+    }
+
+    MachineID id = ruby_port->m_controller->mapAddressToMachine(
+                    pkt->getAddr(), MachineType_Directory);
+    RubySystem *rs = ruby_port->m_ruby_system;
+    AbstractController *directory =
+        rs->m_abstract_controls[id.getType()][id.getNum()];
+    return directory->recvAtomicBackdoor(pkt, backdoor);
+}
+
 void
 RubyPort::MemResponsePort::addToRetryList()
 {
@@ -646,7 +667,7 @@ RubyPort::ruby_eviction_callback(Addr address)
     // Allocate the invalidate request and packet on the stack, as it is
     // assumed they will not be modified or deleted by receivers.
     // TODO: should this really be using funcRequestorId?
-    auto request = std::make_shared<Request>(
+    auto request = Request::create(
         address, RubySystem::getBlockSizeBytes(), 0,
         Request::funcRequestorId);
 
@@ -96,6 +96,8 @@ class RubyPort : public ClockedObject
         bool recvTimingReq(PacketPtr pkt);
 
         Tick recvAtomic(PacketPtr pkt);
+        Tick recvAtomicBackdoor(PacketPtr pkt,
+                                MemBackdoorPtr &backdoor) override;
 
         void recvFunctional(PacketPtr pkt);
 
@@ -30,7 +30,8 @@ TransactionalSequencer::TransactionalSequencer(const Params &p)
       m_stalled(false),
       m_lastStateBeforeStall(AnnotatedRegion_INVALID),
       writeBufferHitEvent(this),
-      lazyCommitCheckEvent(this)
+      lazyCommitCheckEvent(this),
+      fallbackLockWaitEvent(this)
 
 {
     // TransactionalSequencer is only used by UMU protocols
@@ -533,6 +534,19 @@ TransactionalSequencer::canMakeRequest(PacketPtr pkt)
 RequestStatus
 TransactionalSequencer::makeRequest(PacketPtr pkt)
 {
+    if (pkt->req->isHTMStart() && fallbackLockTaken(pkt)) {
+        // Transaction aborted by the fallback lock tries to begin
+        // again while the lock is still taken: hold the begin until
+        // the lock is released rather than starting a transaction
+        // that is bound to abort
+        assert(!fallbackLockWaitEvent.scheduled());
+        DPRINTF(RubyHTM, "HTM_START waits for fallback lock release\n");
+        m_fallbackLockWaitStart = curTick();
+        fallbackLockWaitEvent.setPacket(pkt);
+        schedule(fallbackLockWaitEvent,
+                 clockEdge(m_htm->params().fallback_lock_poll_latency));
+        return RequestStatus_Issued;
+    }
     if (pkt->req->isHTMCmd()) {
         // HTM command: Intercept and notify transaction manager
         notifyXactionEvent(pkt);
@@ -996,6 +1010,48 @@ TransactionalSequencer::lazyCommitEvent(PacketPtr pkt)
     testDrainComplete();
 }
 
+bool
+TransactionalSequencer::fallbackLockTaken(PacketPtr pkt)
+{
+    Addr lock_paddr = m_htm->getFallbackLockPAddr();
+    if (!m_htm->params().fallback_lock_wait ||
+        !m_xact_mgr->abortedOnFallbackLock() ||
+        lock_paddr == 0 ||
+        pkt->req->getFlags().isSet(Request::NO_ACCESS)) {
+        return false;
+    }
+
+    // Look the lock up in the coherent caches/memory without
+    // perturbing them, which stands in for a subscription to the lock
+    // line that is notified on its release
+    uint32_t lock_value = 0;
+    RequestPtr req = std::make_shared<Request>(lock_paddr,
+                                               sizeof(lock_value), 0,
+                                               pkt->req->requestorId());
+    Packet lock_pkt(req, MemCmd::ReadReq);
+    lock_pkt.dataStatic(&lock_value);
+    if (!m_ruby_system->functionalRead(&lock_pkt)) {
+        return false;
+    }
+    return lock_value != 0;
+}
+
+void
+TransactionalSequencer::fallbackLockEvent(PacketPtr pkt)
+{
+    if (fallbackLockTaken(pkt)) {
+        schedule(fallbackLockWaitEvent,
+                 clockEdge(m_htm->params().fallback_lock_poll_latency));
+        return;
+    }
+    fallbackLockWaitEvent.clearPacket();
+    DPRINTF(RubyHTM, "Fallback lock released, HTM_START proceeds\n");
+    m_xact_mgr->profileFallbackLockWait(
+        ticksToCycles(curTick() - m_fallbackLockWaitStart));
+    makeRequest(pkt);
+    testDrainComplete();
+}
+
 LogRequestInfo
 TransactionalSequencer::buildLogPackets(PacketPtr mainPkt,
                                         DataBlock& datablock) {
@@ -1024,16 +1080,16 @@ TransactionalSequencer::buildLogPackets(PacketPtr mainPkt,
   assert(makeLineAddress(logDataPtr) == logDataPtr);
 
   RequestPtr logDataReq =
-      std::make_shared<Request>(logDataPtr,
-                                RubySystem::getBlockSizeBytes(),
-                                Request::PHYSICAL,
-                                mainPkt->req->requestorId());
+      Request::create(logDataPtr,
+                      RubySystem::getBlockSizeBytes(),
+                      Request::PHYSICAL,
+                      mainPkt->req->requestorId());
 
   RequestPtr logAddrReq =
-      std::make_shared<Request>(logAddressPtr,
-                                sizeof(Addr),
-                                Request::PHYSICAL,
-                                mainPkt->req->requestorId());
+      Request::create(logAddressPtr,
+                      sizeof(Addr),
+                      Request::PHYSICAL,
+                      mainPkt->req->requestorId());
 
   // Create request and packets
   PacketPtr logDataPkt = Packet::createWrite(logDataReq);
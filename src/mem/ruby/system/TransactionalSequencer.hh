@@ -126,6 +126,10 @@ class TransactionalSequencer : public Sequencer
     // write buffer
     void writeBufferEvent(PacketPtr _pkt);
     void lazyCommitEvent(PacketPtr _pkt);
+    // Fallback lock subscription: HTM begin held while the lock is taken
+    bool fallbackLockTaken(PacketPtr _pkt);
+    void fallbackLockEvent(PacketPtr _pkt);
+    Tick m_fallbackLockWaitStart = 0;
     bool m_commitPending = false;
     PacketPtr m_commitPendingPkt = NULL;
     bool m_failedCallback = false;
@@ -186,6 +190,28 @@ class TransactionalSequencer : public Sequencer
         }
     };
     LazyCommitCheckEvent lazyCommitCheckEvent;
+    class FallbackLockWaitEvent : public Event
+    {
+      private:
+        TransactionalSequencer *m_sequencer_ptr;
+        PacketPtr m_pkt;
+
+      public:
+        FallbackLockWaitEvent(TransactionalSequencer *_seq) :
+            m_sequencer_ptr(_seq), m_pkt(NULL) {}
+        void setPacket(PacketPtr _pkt) {
+            assert(m_pkt ==  NULL);
+            m_pkt = _pkt;
+        }
+        void clearPacket() {
+            assert(m_pkt !=  NULL);
+            m_pkt = NULL;
+        }
+        void process() {
+            m_sequencer_ptr->fallbackLockEvent(m_pkt);
+        }
+    };
+    FallbackLockWaitEvent fallbackLockWaitEvent;
 };
 
 
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+SampledStackDistCalc::SampledStackDistCalc(double sampling_rate,
+                                           std::size_t max_lines)
+    : threshold(std::ceil(sampling_rate * Modulus)), maxLines(max_lines),
+      tree(std::max<std::size_t>(1024, 2 * max_lines), 0), now(0)
+{
+    fatal_if(sampling_rate <= 0 || sampling_rate > 1,
+             "The sampling rate must be in (0, 1].");
+}
+
+uint64_t
+SampledStackDistCalc::hash(Addr line_addr)
+{
+    // Finalizer of SplitMix64, which spreads consecutive lines evenly
+    uint64_t z = line_addr + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (z ^ (z >> 31)) & (Modulus - 1);
+}
+
+double
+SampledStackDistCalc::samplingRate() const
+{
+    return double(threshold) / Modulus;
+}
+
+void
+SampledStackDistCalc::update(uint64_t time, int delta)
+{
+    for (uint64_t i = time + 1; i <= tree.size(); i += i & -i)
+        tree[i - 1] += delta;
+}
+
+uint64_t
+SampledStackDistCalc::prefix(uint64_t time) const
+{
+    uint64_t sum = 0;
+    for (uint64_t i = time; i > 0; i -= i & -i)
+        sum += tree[i - 1];
+    return sum;
+}
+
+void
+SampledStackDistCalc::compact()
+{
+    // Keep the relative order of the last accesses, with no gaps
+    std::vector<std::pair<uint64_t, Addr>> by_time;
+    by_time.reserve(lines.size());
+    for (const auto &line : lines)
+        by_time.emplace_back(line.second.first, line.first);
+    std::sort(by_time.begin(), by_time.end());
+
+    // Make sure that at least half of the tree is free afterwards
+    tree.assign(std::max(tree.size(), 2 * by_time.size()), 0);
+    for (now = 0; now < by_time.size(); now++) {
+        lines[by_time[now].second].first = now;
+        update(now, 1);
+    }
+}
+
+void
+SampledStackDistCalc::shrink()
+{
+    while (lines.size() > maxLines) {
+        // Stop sampling the lines with the highest hash
+        threshold = linesByHash.rbegin()->first;
+        while (!linesByHash.empty() &&
+               linesByHash.rbegin()->first >= threshold) {
+            const auto it = std::prev(linesByHash.end());
+            const auto line = lines.find(it->second);
+            update(line->second.first, -1);
+            lines.erase(line);
+            linesByHash.erase(it);
+        }
+    }
+}
+
+bool
+SampledStackDistCalc::access(Addr line_addr, uint64_t &distance)
+{
+    const uint64_t line_hash = hash(line_addr);
+    if (line_hash >= threshold)
+        return false;
+
+    if (now == tree.size())
+        compact();
+
+    const auto it = lines.find(line_addr);
+    if (it == lines.end()) {
+        distance = Infinity;
+        lines.emplace(line_addr, std::make_pair(now, line_hash));
+        linesByHash.emplace(line_hash, line_addr);
+    } else {
+        // Count the distinct sampled lines accessed since the last access
+        // to this one, and scale them to the whole population
+        const uint64_t last = it->second.first;
+        const uint64_t sampled_distance = prefix(now) - prefix(last + 1);
+        distance = (sampled_distance * Modulus) / threshold;
+        update(last, -1);
+        it->second.first = now;
+    }
+    update(now, 1);
+    now++;
+
+    if (maxLines && lines.size() > maxLines)
+        shrink();
+
+    return true;
+}
+
+} // namespace gem5
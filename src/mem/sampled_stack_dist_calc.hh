@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_SAMPLED_STACK_DIST_CALC_HH__
+#define __MEM_SAMPLED_STACK_DIST_CALC_HH__
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * An approximate stack distance calculator based on spatial sampling, as
+ * described by Waldspurger et al. in "Efficient MRC Construction with
+ * SHARDS" (FAST'15). Only the lines whose hashed address falls below a
+ * threshold are tracked, and the stack distances among them are scaled by
+ * the inverse of the sampling rate.
+ *
+ * The exact distances among the sampled lines are obtained by marking the
+ * time of the last access to each line in a binary indexed tree, so that
+ * the number of distinct lines accessed since a given time is a range sum.
+ * Time is renumbered whenever the tree is exhausted.
+ *
+ * The number of tracked lines can be bounded, in which case the threshold
+ * is lowered whenever there are too many of them, and the lines that no
+ * longer pass it are discarded. This keeps both the memory and the time
+ * spent per access bounded, regardless of the footprint.
+ */
+class SampledStackDistCalc
+{
+  public:
+    /** Distance of the first access to a line. */
+    static constexpr uint64_t Infinity = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @param sampling_rate Initial fraction of the lines sampled.
+     * @param max_lines Maximum number of tracked lines; 0 if unbounded.
+     */
+    SampledStackDistCalc(double sampling_rate, std::size_t max_lines);
+
+    /**
+     * Process an access to a line.
+     *
+     * @param line_addr The address of the line.
+     * @param distance The estimated stack distance of the access, or
+     *        Infinity for the first access to the line. Only written if
+     *        the line is sampled.
+     * @return Whether the line is sampled.
+     */
+    bool access(Addr line_addr, uint64_t &distance);
+
+    /** @return The current fraction of the lines sampled. */
+    double samplingRate() const;
+
+    /** @return The number of lines being tracked. */
+    std::size_t numLines() const { return lines.size(); }
+
+  private:
+    /** Range of the hashed addresses. */
+    static constexpr uint64_t Modulus = uint64_t(1) << 24;
+
+    /** Hash of a line address, in [0, Modulus). */
+    static uint64_t hash(Addr line_addr);
+
+    /** Lines are sampled when their hash is below this threshold. */
+    uint64_t threshold;
+
+    /** Maximum number of tracked lines; 0 if unbounded. */
+    const std::size_t maxLines;
+
+    /** Time of the last access, and hash, of every tracked line. */
+    std::unordered_map<Addr, std::pair<uint64_t, uint64_t>> lines;
+
+    /** The tracked lines, ordered by hash, to lower the threshold. */
+    std::set<std::pair<uint64_t, Addr>> linesByHash;
+
+    /** Binary indexed tree marking the times of the last accesses. */
+    std::vector<uint32_t> tree;
+
+    /** Time of the next access. */
+    uint64_t now;
+
+    /** Add a value to the mark of a time. */
+    void update(uint64_t time, int delta);
+
+    /** @return The number of marks before a time. */
+    uint64_t prefix(uint64_t time) const;
+
+    /** Renumber the times of the tracked lines, growing the tree. */
+    void compact();
+
+    /** Lower the threshold until the tracked lines fit again. */
+    void shrink();
+};
+
+} // namespace gem5
+
+#endif //__MEM_SAMPLED_STACK_DIST_CALC_HH__
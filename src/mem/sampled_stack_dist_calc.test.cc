@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+#include <random>
+
+#include "mem/sampled_stack_dist_calc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Exact stack distance, using an LRU list. */
+uint64_t
+referenceDistance(std::list<Addr> &stack, Addr line_addr)
+{
+    const auto it = std::find(stack.begin(), stack.end(), line_addr);
+    uint64_t distance = SampledStackDistCalc::Infinity;
+    if (it != stack.end()) {
+        distance = std::distance(stack.begin(), it);
+        stack.erase(it);
+    }
+    stack.push_front(line_addr);
+    return distance;
+}
+
+} // anonymous namespace
+
+TEST(SampledStackDistCalcTest, SimpleSequence)
+{
+    SampledStackDistCalc calc(1.0, 0);
+    uint64_t distance;
+
+    ASSERT_TRUE(calc.access(0x0, distance));
+    EXPECT_EQ(distance, SampledStackDistCalc::Infinity);
+    ASSERT_TRUE(calc.access(0x40, distance));
+    ASSERT_TRUE(calc.access(0x80, distance));
+    ASSERT_TRUE(calc.access(0x0, distance));
+    EXPECT_EQ(distance, 2);
+    ASSERT_TRUE(calc.access(0x0, distance));
+    EXPECT_EQ(distance, 0);
+    ASSERT_TRUE(calc.access(0x40, distance));
+    EXPECT_EQ(distance, 2);
+}
+
+/** Without sampling the distances must be exact, even across renumbering. */
+TEST(SampledStackDistCalcTest, ExactWithoutSampling)
+{
+    SampledStackDistCalc calc(1.0, 0);
+    std::list<Addr> stack;
+    std::mt19937 rng(0);
+    std::geometric_distribution<int> dist(0.01);
+
+    for (int i = 0; i < 20000; i++) {
+        const Addr line_addr = dist(rng) * 64;
+        uint64_t distance;
+        ASSERT_TRUE(calc.access(line_addr, distance));
+        ASSERT_EQ(distance, referenceDistance(stack, line_addr));
+    }
+}
+
+TEST(SampledStackDistCalcTest, SamplingRate)
+{
+    SampledStackDistCalc calc(0.1, 0);
+    int sampled = 0;
+    for (Addr line = 0; line < 100000; line++) {
+        uint64_t distance;
+        sampled += calc.access(line * 64, distance);
+    }
+    EXPECT_NEAR(sampled / 100000.0, 0.1, 0.01);
+    EXPECT_EQ(calc.numLines(), sampled);
+}
+
+TEST(SampledStackDistCalcTest, BoundedLines)
+{
+    SampledStackDistCalc calc(1.0, 100);
+    for (Addr line = 0; line < 10000; line++) {
+        uint64_t distance;
+        calc.access(line * 64, distance);
+        ASSERT_LE(calc.numLines(), 100);
+    }
+    EXPECT_LT(calc.samplingRate(), 0.05);
+
+    // Lines that are no longer sampled are never sampled again
+    int sampled = 0;
+    for (Addr line = 0; line < 10000; line++) {
+        uint64_t distance;
+        sampled += calc.access(line * 64, distance);
+    }
+    EXPECT_LE(sampled, 100);
+}
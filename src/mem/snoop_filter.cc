@@ -42,6 +42,9 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,17 +55,211 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams &p)
+    : SimObject(p), numSets(p.num_sets), assoc(p.assoc),
+      replacementPolicy(p.replacement_policy),
+      _requestorId(p.num_sets ? p.system->getRequestorId(this) :
+                   Request::invldRequestorId),
+      linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
+      maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
+      lineShift(floorLog2(p.system->cacheLineSize())),
+      stats(this)
+{
+    if (!isFinite())
+        return;
+
+    fatal_if(!isPowerOf2(numSets),
+             "%s: number of sets must be a power of 2, got %d\n",
+             name(), numSets);
+    fatal_if(assoc == 0, "%s: associativity must be non-zero\n", name());
+    fatal_if(!replacementPolicy,
+             "%s: a finite snoop filter needs a replacement policy\n",
+             name());
+
+    // the entries are allocated up front, and set by set so that
+    // policies sharing state within a set see their ways in order
+    entries.resize(numSets * assoc);
+    for (unsigned set = 0; set < numSets; set++) {
+        for (unsigned way = 0; way < assoc; way++) {
+            SnoopEntry &entry = entries[set * assoc + way];
+            entry.setPosition(set, way);
+            entry.replacementData = replacementPolicy->instantiateEntry();
+        }
+    }
+}
+
+SnoopFilter::SnoopEntry *
+SnoopFilter::findEntry(Addr line_addr)
+{
+    SnoopEntry *ways = &entries[setIndex(line_addr) * assoc];
+    for (unsigned way = 0; way < assoc; way++) {
+        if (ways[way].valid && ways[way].lineAddr == line_addr)
+            return &ways[way];
+    }
+    return nullptr;
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (isFinite()) {
+        if (SnoopEntry *entry = findEntry(line_addr))
+            return &entry->item;
+        if (cachedLocations.empty())
+            return nullptr;
+    }
+    auto sf_it = cachedLocations.find(line_addr);
+    return sf_it == cachedLocations.end() ? nullptr : &sf_it->second;
+}
+
+SnoopFilter::SnoopEntry *
+SnoopFilter::findVictim(Addr set, bool can_back_invalidate)
+{
+    SnoopEntry *ways = &entries[set * assoc];
+
+    ReplacementCandidates candidates;
+    for (unsigned way = 0; way < assoc; way++) {
+        if (!ways[way].valid)
+            return &ways[way];
+        // some policies (e.g. tree PLRU) rely on seeing the whole set in
+        // way order, so unsuitable ways are only rejected after the choice
+        candidates.push_back(&ways[way]);
+    }
+
+    // lines with requests in flight must stay tracked to see their
+    // responses, and the item of the current lookup is still in use
+    auto replaceable = [&](const SnoopEntry *entry) {
+        return entry->item.requested.none() &&
+            &entry->item != reqLookupResult.item &&
+            (can_back_invalidate || entry->item.holder.none());
+    };
+
+    auto victim = static_cast<SnoopEntry *>(
+        replacementPolicy->getVictim(candidates));
+    if (replaceable(victim))
+        return victim;
+
+    for (unsigned way = 0; way < assoc; way++) {
+        if (replaceable(&ways[way]))
+            return &ways[way];
+    }
+    return nullptr;
+}
+
+void
+SnoopFilter::evictEntry(SnoopEntry *victim)
+{
+    assert(victim->valid && victim->item.requested.none());
+    stats.evictions++;
+
+    DPRINTF(SnoopFilter, "%s:   evicting %#llx SF value %x.%x\n",
+            __func__, victim->lineAddr, victim->item.requested,
+            victim->item.holder);
+
+    if (victim->item.holder.any()) {
+        // the filter is inclusive, the lines held above have to be
+        // invalidated
+        assert(!pendingBackInvalidation);
+        stats.backInvalidations++;
+        pendingBackInvalidation = true;
+        backInvalidation.addr = victim->lineAddr & ~Addr(LineSecure);
+        backInvalidation.isSecure = victim->lineAddr & LineSecure;
+        backInvalidation.ports = maskToPortList(victim->item.holder);
+    }
+    victim->valid = false;
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::allocateItem(Addr line_addr)
+{
+    if (!isFinite())
+        return &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+
+    const Addr set = setIndex(line_addr);
+    SnoopEntry *victim = findVictim(set, !pendingBackInvalidation);
+
+    if (!victim) {
+        // every way is pinned by a request in flight, the line moves
+        // into the set once one of them completes
+        DPRINTF(SnoopFilter, "%s:   set %d pinned, overflowing %#llx\n",
+                __func__, set, line_addr);
+        panic_if(cachedLocations.size() >= maxEntryCount,
+                 "snoop filter overflow exceeded capacity of %d cache "
+                 "blocks\n", maxEntryCount);
+        stats.overflows++;
+        return &cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+    }
+
+    if (victim->valid)
+        evictEntry(victim);
+
+    victim->lineAddr = line_addr;
+    victim->valid = true;
+    victim->item = SnoopItem();
+    replacementPolicy->reset(victim->replacementData);
+    return &victim->item;
+}
+
+void
+SnoopFilter::refillFromOverflow(Addr set)
+{
+    if (cachedLocations.empty())
+        return;
+
+    auto sf_it = std::find_if(cachedLocations.begin(), cachedLocations.end(),
+        [&](const auto &line) { return setIndex(line.first) == set; });
+    if (sf_it == cachedLocations.end())
+        return;
+
+    SnoopEntry *victim = findVictim(set, !pendingBackInvalidation);
+    if (!victim)
+        return;
+
+    DPRINTF(SnoopFilter, "%s:   moving %#llx back into set %d\n",
+            __func__, sf_it->first, set);
+    stats.refills++;
+
+    if (victim->valid)
+        evictEntry(victim);
+
+    victim->lineAddr = sf_it->first;
+    victim->valid = true;
+    victim->item = sf_it->second;
+    replacementPolicy->reset(victim->replacementData);
+    if (reqLookupResult.item == &sf_it->second)
+        reqLookupResult.item = &victim->item;
+    cachedLocations.erase(sf_it);
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(Addr line_addr, SnoopItem& sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
     if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+        SnoopEntry *entry = isFinite() ? findEntry(line_addr) : nullptr;
+        if (entry) {
+            entry->valid = false;
+            replacementPolicy->invalidate(entry->replacementData);
+        } else {
+            cachedLocations.erase(line_addr);
+        }
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
+
+        if (isFinite())
+            refillFromOverflow(setIndex(line_addr));
     }
 }
 
+bool
+SnoopFilter::takeBackInvalidation(BackInvalidation &binv)
+{
+    if (!pendingBackInvalidation)
+        return false;
+    binv = std::move(backInvalidation);
+    pendingBackInvalidation = false;
+    return true;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -78,21 +275,25 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    SnoopEntry *entry = isFinite() ? findEntry(line_addr) : nullptr;
+    reqLookupResult.lineAddr = line_addr;
+    reqLookupResult.item = entry ? &entry->item : findItem(line_addr);
+    bool is_hit = (reqLookupResult.item != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
-    // portlist.
-    if (!is_hit && !allocate)
+    // portlist. A finite filter may have back-invalidated the line
+    // while an eviction of it was in flight, in which case nobody
+    // else holds it either.
+    if (!is_hit && (!allocate || (isFinite() && cpkt->isEviction())))
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
-    if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
-    }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    // If no hit in snoop filter create a new element
+    if (!is_hit)
+        reqLookupResult.item = allocateItem(line_addr);
+    else if (entry)
+        replacementPolicy->touch(entry->replacementData);
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,29 +360,61 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, *reqLookupResult.item);
+        reqLookupResult.item = nullptr;
     }
 }
 
+bool
+SnoopFilter::lookupWarmup(Addr addr, bool is_secure,
+                          const ResponsePort& cpu_side_port)
+{
+    Addr line_addr = addr & ~Addr(linesize - 1);
+    if (is_secure) {
+        line_addr |= LineSecure;
+    }
+    SnoopMask req_port = portToMask(cpu_side_port);
+    SnoopEntry *entry = isFinite() ? findEntry(line_addr) : nullptr;
+    SnoopItem *sf_item = entry ? &entry->item : findItem(line_addr);
+
+    // anybody else tracking the line may own it, in which case a
+    // clean copy must not be allocated
+    if (sf_item && ((sf_item->holder | sf_item->requested) &
+                    ~req_port).any()) {
+        DPRINTF(SnoopFilter, "%s: src %s addr %#llx SF value %x.%x\n",
+                __func__, cpu_side_port.name(), addr, sf_item->requested,
+                sf_item->holder);
+        return false;
+    }
+
+    if (!sf_item)
+        sf_item = allocateItem(line_addr);
+    else if (entry)
+        replacementPolicy->touch(entry->replacementData);
+
+    sf_item->holder |= req_port;
+    return true;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupSnoop(const Packet* cpkt)
 {
@@ -193,10 +426,11 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_ptr = findItem(line_addr);
+    bool is_hit = (sf_ptr != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!is_hit && !isFinite() &&
+             (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -206,7 +440,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_ptr;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -236,7 +470,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -266,7 +500,11 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem *sf_ptr = findItem(line_addr);
+
+    // The destination has a request in, so the line is tracked
+    panic_if(!sf_ptr, "SF has no entry for %#llx\n", line_addr);
+    SnoopItem& sf_item = *sf_ptr;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -297,6 +535,9 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     assert((sf_item.requested | sf_item.holder).any());
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    // the response may have unpinned a way a line overflowed for
+    if (isFinite())
+        refillFromOverflow(setIndex(line_addr));
 }
 
 void
@@ -313,18 +554,17 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_ptr = findItem(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!sf_ptr)
         return;
 
     // If the snoop response has no sharers the line is passed in
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_ptr;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -332,7 +572,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_item);
     }
 }
 
@@ -355,12 +595,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_ptr = findItem(line_addr);
+    if (!sf_ptr)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_ptr;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -379,7 +619,6 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -388,6 +627,11 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
+    eraseIfNullEntry(line_addr, sf_item);
+
+    // the response may have unpinned a way a line overflowed for
+    if (isFinite())
+        refillFromOverflow(setIndex(line_addr));
 }
 
 SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
@@ -407,7 +651,17 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(evictions, statistics::units::Count::get(),
+               "Number of lines evicted from a finite snoop filter."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of evicted lines that had to be invalidated in the "
+               "caches above."),
+      ADD_STAT(overflows, statistics::units::Count::get(),
+               "Number of lines tracked outside a finite snoop filter "
+               "because all ways of their set had requests in flight."),
+      ADD_STAT(refills, statistics::units::Count::get(),
+               "Number of overflowed lines moved back into their set.")
 {}
 
 void
@@ -44,9 +44,13 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -85,6 +89,18 @@ namespace gem5
  *     upper cache dropped a line, making the snoop filter pessimistic for now
  * (4) ordering: there is no single point of order in the system.  Instead,
  *     requesting MSHRs track order between local requests and remote snoops
+ *
+ * By default the filter is unbounded. If given a number of sets, it is
+ * instead organised as a finite set-associative structure. Allocating
+ * a line in a full set evicts a victim chosen by the replacement
+ * policy, and the holders of the victim must be back-invalidated by
+ * the crossbar (see takeBackInvalidation) to keep the filter
+ * inclusive. Lines with outstanding requests cannot be evicted; if the
+ * policy picks such a victim another way of the set is used instead.
+ * Only when every way of the set is pinned is the new line tracked in
+ * an overflow map, and it moves back into its set as soon as a
+ * response or an erase unpins one of the ways, which bounds the
+ * overflow by the number of requests in flight.
  */
 class SnoopFilter : public SimObject
 {
@@ -95,13 +111,18 @@ class SnoopFilter : public SimObject
 
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
-        maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
-        stats(this)
+    SnoopFilter (const SnoopFilterParams &p);
+
+    /**
+     * A line evicted from a finite snoop filter, and the ports that
+     * may still hold it and have to be invalidated.
+     */
+    struct BackInvalidation
     {
-    }
+        Addr addr;
+        bool isSecure;
+        SnoopList ports;
+    };
 
     /**
      * Init a new snoop filter and tell it about all the cpu_sideports
@@ -153,6 +174,19 @@ class SnoopFilter : public SimObject
      */
     void finishRequest(bool will_retry, Addr addr, bool is_secure);
 
+    /**
+     * Lookup a warm-up access (from a CPU-side port) and, if no other
+     * CPU-side port may hold the line, record the requestor as a
+     * holder. Allocating an entry may cause a back-invalidation.
+     *
+     * @param addr          Address of the access.
+     * @param is_secure     Whether the access is to the secure space.
+     * @param cpu_side_port Response port where the access came from.
+     * @return Whether the requestor may allocate a clean copy.
+     */
+    bool lookupWarmup(Addr addr, bool is_secure,
+                      const ResponsePort& cpu_side_port);
+
     /**
      * Handle an incoming snoop from below (the memory-side port). These
      * can upgrade the tracking logic and may also benefit from
@@ -200,6 +234,19 @@ class SnoopFilter : public SimObject
      */
     void updateResponse(const Packet *cpkt, const ResponsePort& cpu_side_port);
 
+    /**
+     * Take the back-invalidation caused by an eviction in the last
+     * lookupRequest or response update, if any. The caller must send
+     * an invalidating snoop for the line to the returned ports.
+     *
+     * @param binv Filled in with the evicted line and its holders
+     * @return Whether there is a line to back-invalidate
+     */
+    bool takeBackInvalidation(BackInvalidation &binv);
+
+    /** Requestor id used for back-invalidation snoops. */
+    RequestorID requestorId() const { return _requestorId; }
+
     virtual void regStats();
 
   protected:
@@ -225,6 +272,15 @@ class SnoopFilter : public SimObject
      */
     typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
 
+    /** A way of a finite snoop filter. */
+    struct SnoopEntry : public ReplaceableEntry
+    {
+        /** Line address, including the LineSecure bit */
+        Addr lineAddr = MaxAddr;
+        bool valid = false;
+        SnoopItem item;
+    };
+
     /**
      * Simple factory methods for standard return values.
      */
@@ -258,14 +314,83 @@ class SnoopFilter : public SimObject
 
   private:
 
+    /** Is this a finite, set-associative snoop filter? */
+    bool isFinite() const { return numSets != 0; }
+
+    /** Find the way tracking a line in a finite filter, if any. */
+    SnoopEntry *findEntry(Addr line_addr);
+
+    /** Find the item tracking a line, if any. */
+    SnoopItem *findItem(Addr line_addr);
+
+    /** Set of a finite filter a line maps to. */
+    Addr setIndex(Addr line_addr) const
+    {
+        return (line_addr >> lineShift) & (numSets - 1);
+    }
+
+    /**
+     * Find a way of a set to allocate a line in. Invalid ways are
+     * preferred, then the victim of the replacement policy, then any
+     * other way the new line may replace. Ways with requests in flight
+     * are never chosen, nor is the item of the current request lookup.
+     *
+     * @param set Set to search.
+     * @param can_back_invalidate Whether a line with holders may be
+     *        chosen, i.e. the back-invalidation slot is free.
+     * @return The way to use, or nullptr if none may be replaced.
+     */
+    SnoopEntry *findVictim(Addr set, bool can_back_invalidate);
+
+    /**
+     * Evict the line in a valid way, recording the back-invalidation
+     * of its holders if there are any.
+     */
+    void evictEntry(SnoopEntry *victim);
+
+    /**
+     * Move a line of a set that overflowed back into the set, if a way
+     * may now hold it.
+     */
+    void refillFromOverflow(Addr set);
+
+    /**
+     * Allocate an item for a line that is not tracked, evicting a
+     * victim from a full set of a finite filter.
+     */
+    SnoopItem *allocateItem(Addr line_addr);
+
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, SnoopItem& sf_item);
 
-    /** Simple hash set of cached addresses. */
+    /**
+     * Simple hash set of cached addresses. This holds all lines of
+     * an unbounded filter, and the lines that overflowed a set of a
+     * finite one while all its ways were pinned.
+     */
     SnoopFilterCache cachedLocations;
 
+    /** Ways of a finite filter, stored set by set. */
+    std::vector<SnoopEntry> entries;
+
+    /** Number of sets of a finite filter, 0 if unbounded. */
+    const unsigned numSets;
+
+    /** Associativity of a finite filter. */
+    const unsigned assoc;
+
+    /** Replacement policy of a finite filter. */
+    replacement_policy::Base *replacementPolicy;
+
+    /** Line evicted by the last allocation, to be back-invalidated. */
+    bool pendingBackInvalidation = false;
+    BackInvalidation backInvalidation;
+
+    /** Requestor id of back-invalidation snoops. */
+    const RequestorID _requestorId;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -274,8 +399,9 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Line address and item found or allocated by lookupRequest. */
+        Addr lineAddr;
+        SnoopItem *item;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -284,17 +410,10 @@ class SnoopFilter : public SimObject
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
+        ReqLookupResult()
+            : lineAddr(MaxAddr), item(nullptr), retryItem{0, 0}
         {
         }
-        ReqLookupResult() = delete;
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -307,6 +426,8 @@ class SnoopFilter : public SimObject
     const Cycles lookupLatency;
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
     const unsigned maxEntryCount;
+    /** Log2 of the cache line size, to compute set indices */
+    const unsigned lineShift;
 
     /**
      * Use the lower bits of the address to keep track of the line status
@@ -329,6 +450,11 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar evictions;
+        statistics::Scalar backInvalidations;
+        statistics::Scalar overflows;
+        statistics::Scalar refills;
     } stats;
 };
 
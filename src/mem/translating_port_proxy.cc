@@ -84,7 +84,7 @@ TranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
     for (ChunkGenerator gen(addr, size, pageBytes); !gen.done();
          gen.next())
     {
-        auto req = std::make_shared<Request>(
+        auto req = Request::create(
                 gen.addr(), gen.size(), flags, Request::funcRequestorId, 0,
                 _tc->contextId());
 
@@ -106,7 +106,7 @@ TranslatingPortProxy::tryWriteBlob(
     for (ChunkGenerator gen(addr, size, pageBytes); !gen.done();
          gen.next())
     {
-        auto req = std::make_shared<Request>(
+        auto req = Request::create(
                 gen.addr(), gen.size(), flags, Request::funcRequestorId, 0,
                 _tc->contextId());
 
@@ -126,7 +126,7 @@ TranslatingPortProxy::tryMemsetBlob(Addr address, uint8_t v, int size) const
     for (ChunkGenerator gen(address, size, pageBytes); !gen.done();
          gen.next())
     {
-        auto req = std::make_shared<Request>(
+        auto req = Request::create(
                 gen.addr(), gen.size(), flags, Request::funcRequestorId, 0,
                 _tc->contextId());
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_WARM_ACCESS_HH__
+#define __MEM_WARM_ACCESS_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/request.hh"
+
+namespace gem5
+{
+
+/**
+ * A read replayed to the memory system only to warm up its state,
+ * i.e., the tags and replacement data of the caches on the way. Warm
+ * accesses are sent in batches through the atomic protocol, and carry
+ * no data: whoever generates them is expected to access the data
+ * functionally.
+ */
+struct WarmAccess
+{
+    Addr addr;
+    bool isSecure;
+    RequestorID requestorId;
+
+    /**
+     * Whether the requestor may allocate the line. This is cleared on
+     * the way down when allocating a clean copy of the line could
+     * break coherence, e.g. because another cache may own the line.
+     */
+    bool allocate;
+
+    WarmAccess(Addr _addr, bool is_secure, RequestorID requestor_id)
+        : addr(_addr), isSecure(is_secure), requestorId(requestor_id),
+          allocate(true)
+    {}
+};
+
+typedef std::vector<WarmAccess> WarmAccessBatch;
+
+} // namespace gem5
+
+#endif // __MEM_WARM_ACCESS_HH__
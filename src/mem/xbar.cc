@@ -45,6 +45,8 @@
 
 #include "mem/xbar.hh"
 
+#include <map>
+
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -359,6 +361,39 @@ BaseXBar::findPort(AddrRange addr_range)
           name());
 }
 
+void
+BaseXBar::forwardWarmup(WarmAccessBatch &batch)
+{
+    if (batch.empty())
+        return;
+
+    std::map<PortID, std::vector<size_t>> routes;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        routes[findPort(RangeSize(batch[i].addr, 1))].push_back(i);
+    }
+
+    // the common case is a single destination, which gets the batch
+    // as it is
+    if (routes.size() == 1) {
+        memSidePorts[routes.begin()->first]->sendAtomicWarmup(batch);
+        return;
+    }
+
+    for (const auto &route : routes) {
+        WarmAccessBatch sub_batch;
+        sub_batch.reserve(route.second.size());
+        for (auto i : route.second) {
+            sub_batch.push_back(batch[i]);
+        }
+
+        memSidePorts[route.first]->sendAtomicWarmup(sub_batch);
+
+        for (size_t j = 0; j < sub_batch.size(); ++j) {
+            batch[route.second[j]].allocate = sub_batch[j].allocate;
+        }
+    }
+}
+
 /** Function called by the port when the crossbar is receiving a range change.*/
 void
 BaseXBar::recvRangeChange(PortID mem_side_port_id)
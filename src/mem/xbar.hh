@@ -348,6 +348,16 @@ class BaseXBar : public ClockedObject
      */
     PortID findPort(AddrRange addr_range);
 
+    /**
+     * Forward a batch of warm-up accesses to the memory-side ports
+     * the addresses map to, splitting it if needed. The order of the
+     * accesses sent to each port is preserved, and their allocate
+     * flags are propagated back to the batch.
+     *
+     * @param batch Accesses to forward.
+     */
+    void forwardWarmup(WarmAccessBatch &batch);
+
     /**
      * Return the address ranges the crossbar is responsible for.
      *
@@ -41,7 +41,8 @@
 
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const std::string& filename) :
+ProtoOutputStream::ProtoOutputStream(const std::string& filename,
+                                     int compression_level) :
     fileStream(filename.c_str(),
             std::ios::out | std::ios::binary | std::ios::trunc),
     wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
@@ -55,7 +56,9 @@ ProtoOutputStream::ProtoOutputStream(const std::string& filename) :
     wrappedFileStream = new io::OstreamOutputStream(&fileStream);
     if (filename.find_last_of('.') != string::npos &&
         filename.substr(filename.find_last_of('.') + 1) == "gz") {
-        gzipStream = new io::GzipOutputStream(wrappedFileStream);
+        io::GzipOutputStream::Options options;
+        options.compression_level = compression_level;
+        gzipStream = new io::GzipOutputStream(wrappedFileStream, options);
         zeroCopyStream = gzipStream;
     } else {
         zeroCopyStream = wrappedFileStream;
@@ -98,6 +101,24 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
+void
+ProtoOutputStream::write(const std::vector<const Message*>& msgs)
+{
+    // Batches are short, so they stay well within the byte limit of the
+    // coded stream
+    io::CodedOutputStream codedStream(zeroCopyStream);
+
+    for (const Message* msg : msgs) {
+#       if GOOGLE_PROTOBUF_VERSION < 3001000
+            auto msg_size = msg->ByteSize();
+#       else
+            auto msg_size = msg->ByteSizeLong();
+#       endif
+        codedStream.WriteVarint32(msg_size);
+        msg->SerializeWithCachedSizes(&codedStream);
+    }
+}
+
 ProtoInputStream::ProtoInputStream(const std::string& filename) :
     fileStream(filename.c_str(), std::ios::in | std::ios::binary),
     fileName(filename), useGzip(false),
@@ -50,6 +50,7 @@
 #include <google/protobuf/message.h>
 
 #include <fstream>
+#include <vector>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -97,8 +98,11 @@ class ProtoOutputStream : public ProtoStream
      * ends with .gz then the file will be compressed accordinly.
      *
      * @param filename Path to the file to create or truncate
+     * @param compression_level Gzip compression level, from 1 (fastest)
+     *        to 9 (smallest), or -1 for the default of zlib
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename,
+                      int compression_level = -1);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -114,6 +118,15 @@ class ProtoOutputStream : public ProtoStream
      */
     void write(const google::protobuf::Message& msg);
 
+    /**
+     * Write a batch of messages to the stream, each of them prepended
+     * with its size. The result is the same as writing them one by one,
+     * but the coded stream is shared by the whole batch.
+     *
+     * @param msgs Messages to write to the stream, in order
+     */
+    void write(const std::vector<const google::protobuf::Message*>& msgs);
+
   private:
 
     /// Underlying file output stream
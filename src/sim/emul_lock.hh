@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021 Universidad de Murcia
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_EMUL_LOCK_HH__
+#define __SIM_EMUL_LOCK_HH__
+
+#include <mutex>
+
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+/**
+ * Lock protecting the emulation state that all the simulated CPUs
+ * share (the page tables and memory state of SE processes, their file
+ * descriptor and futex tables, and the simulator state updated by
+ * pseudo instructions) when CPUs execute on host threads of their own
+ * (see NonCachingSimpleCPU::parallel). It is recursive because
+ * emulated operations nest, e.g. system calls that fix up page faults.
+ */
+inline std::recursive_mutex &
+emulationMutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+/**
+ * Holds the emulation lock for its lifetime when simulating with
+ * multiple event queues, and does nothing otherwise.
+ */
+class ScopedEmulationLock
+{
+  public:
+    ScopedEmulationLock()
+        : locked(inParallelMode)
+    {
+        if (locked)
+            emulationMutex().lock();
+    }
+
+    ~ScopedEmulationLock()
+    {
+        if (locked)
+            emulationMutex().unlock();
+    }
+
+    ScopedEmulationLock(const ScopedEmulationLock &) = delete;
+    ScopedEmulationLock &operator=(const ScopedEmulationLock &) = delete;
+
+  private:
+    const bool locked;
+};
+
+} // namespace gem5
+
+#endif // __SIM_EMUL_LOCK_HH__
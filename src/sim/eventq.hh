@@ -1012,6 +1012,16 @@ class EventManager
         return eventq;
     }
 
+    /**
+     * Move the object to another event queue. None of the events of the
+     * object may be scheduled when doing so.
+     */
+    void
+    eventQueue(EventQueue *eq)
+    {
+        eventq = eq;
+    }
+
     /**
      * @ingroup api_eventq
      */
@@ -60,6 +60,7 @@
 #include "mem/se_translating_port_proxy.hh"
 #include "params/Process.hh"
 #include "sim/emul_driver.hh"
+#include "sim/emul_lock.hh"
 #include "sim/fd_array.hh"
 #include "sim/fd_entry.hh"
 #include "sim/redirect_path.hh"
@@ -358,6 +359,7 @@ Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
 bool
 Process::fixupFault(Addr vaddr)
 {
+    ScopedEmulationLock lock;
     return memState->fixupFault(vaddr);
 }
 
@@ -50,6 +50,7 @@
 #include "base/types.hh" // For Tick and Addr data types.
 #include "cpu/thread_context.hh"
 #include "debug/PseudoInst.hh"
+#include "sim/emul_lock.hh"
 #include "sim/guest_abi.hh"
 #include "sim/system.hh"
 
@@ -116,6 +117,10 @@ pseudoInstWork(ThreadContext *tc, uint8_t func, uint64_t &result)
 {
     DPRINTF(PseudoInst, "pseudo_inst::pseudoInst(%i)\n", func);
 
+    // Pseudo instructions (e.g. the HTM region markers and log setup)
+    // update simulator state shared by all CPUs
+    ScopedEmulationLock lock;
+
     result = 0;
 
     HTM *htm = tc->getSystemPtr()->getHTM();
@@ -44,6 +44,7 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/TimeSync.hh"
+#include "mem/mem_pool.hh"
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
@@ -76,9 +77,13 @@ Root::RootStats::RootStats()
              "The number of ticks simulated per host second (ticks/s)"),
     ADD_STAT(hostMemory, statistics::units::Byte::get(),
              "Number of bytes of host memory used"),
+    ADD_STAT(hostAllocsAvoided, statistics::units::Count::get(),
+             "Number of host allocations of packets, requests and "
+             "payloads avoided by the memory pools"),
 
     statTime(true),
-    startTick(0)
+    startTick(0),
+    startAllocsAvoided(0)
 {
     simFreq.scalar(sim_clock::Frequency);
     simTicks.functor([this]() { return curTick() - startTick; });
@@ -89,6 +94,10 @@ Root::RootStats::RootStats()
         .prereq(hostMemory)
         ;
 
+    hostAllocsAvoided.functor([this]() {
+            return mem_pool::allocsAvoided() - startAllocsAvoided;
+        });
+
     hostSeconds
         .functor([this]() {
                 Time now;
@@ -109,6 +118,7 @@ Root::RootStats::resetStats()
 {
     statTime.setTimer();
     startTick = curTick();
+    startAllocsAvoided = mem_pool::allocsAvoided();
 
     statistics::Group::resetStats();
 }
@@ -109,6 +109,7 @@ class Root : public SimObject
 
         statistics::Formula hostTickRate;
         statistics::Value hostMemory;
+        statistics::Value hostAllocsAvoided;
 
         static RootStats instance;
 
@@ -120,6 +121,7 @@ class Root : public SimObject
 
         Time statTime;
         Tick startTick;
+        uint64_t startAllocsAvoided;
     };
 
   public:
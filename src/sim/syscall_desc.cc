@@ -30,6 +30,7 @@
 #include "sim/syscall_desc.hh"
 
 #include "base/types.hh"
+#include "sim/emul_lock.hh"
 #include "sim/syscall_debug_macros.hh"
 
 namespace gem5
@@ -40,6 +41,10 @@ class ThreadContext;
 void
 SyscallDesc::doSyscall(ThreadContext *tc)
 {
+    // System calls update state shared by all the threads of the
+    // workload, so CPUs on different host threads take turns
+    ScopedEmulationLock lock;
+
     DPRINTF_SYSCALL(Base, "Calling %s...\n", dumper(name(), tc));
 
     SyscallReturn retval = executor(this, tc);
@@ -0,0 +1,131 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Runs a program on an AtomicSimpleCPU that runs ahead of its event queue
+or replays cached blocks, next to a plain AtomicSimpleCPU running the same
+program on an event queue of its own. The simulation repeatedly stops
+after a number of ticks and after a number of instructions of the first
+CPU. Tick-limited exits must come at their exact tick, instruction-count
+exits must come at all, and both CPUs must have executed as many
+instructions at every exit.
+'''
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+
+parser = argparse.ArgumentParser(
+    description='Compare a running-ahead AtomicSimpleCPU to a plain one')
+parser.add_argument('cmd', help='Program to run')
+parser.add_argument('--max-block-insts', type=int, default=0)
+parser.add_argument('--block-cache', action='store_true')
+parser.add_argument('--tick-step', type=int, default=123457,
+                    help='Ticks between tick-limited exits')
+parser.add_argument('--inst-step', type=int, default=97,
+                    help='Instructions between instruction-count exits')
+
+args = parser.parse_args()
+
+def make_system(cpu):
+    system = System()
+    system.clk_domain = SrcClockDomain(clock='1GHz',
+                                       voltage_domain=VoltageDomain())
+    system.mem_mode = 'atomic'
+    system.mem_ranges = [AddrRange('512MB')]
+
+    system.cpu = cpu
+    system.membus = SystemXBar()
+    system.cpu.icache_port = system.membus.cpu_side_ports
+    system.cpu.dcache_port = system.membus.cpu_side_ports
+    system.cpu.createInterruptController()
+    if m5.defines.buildEnv['TARGET_ISA'] == 'x86':
+        system.cpu.interrupts[0].pio = system.membus.mem_side_ports
+        system.cpu.interrupts[0].int_requestor = \
+            system.membus.cpu_side_ports
+        system.cpu.interrupts[0].int_responder = \
+            system.membus.mem_side_ports
+
+    system.mem_ctrl = SimpleMemory(range=system.mem_ranges[0])
+    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.system_port = system.membus.cpu_side_ports
+
+    system.workload = SEWorkload.init_compatible(args.cmd)
+    system.cpu.workload = Process(cmd=[args.cmd])
+    system.cpu.createThreads()
+    return system
+
+root = Root(full_system=False)
+root.test = make_system(AtomicSimpleCPU(
+    max_block_insts=args.max_block_insts, block_cache=args.block_cache))
+# The reference CPU is alone on its event queue, so that its events don't
+# bound how far the other one runs ahead
+root.ref = make_system(AtomicSimpleCPU())
+root.ref.eventq_index = 1
+root.sim_quantum = 1000000
+
+m5.instantiate()
+
+test_cpu = root.test.cpu
+ref_cpu = root.ref.cpu
+
+def check_insts(when):
+    test_insts = test_cpu.totalInsts()
+    ref_insts = ref_cpu.totalInsts()
+    if test_insts != ref_insts:
+        fatal('%s at tick %d, the CPU executed %d instructions instead of '
+              '%d', when, m5.curTick(), test_insts, ref_insts)
+
+inst_cause = 'instruction step'
+exits = 0
+while True:
+    start = m5.curTick()
+    exit_event = m5.simulate(args.tick_step)
+    cause = exit_event.getCause()
+    if cause != 'simulate() limit reached':
+        break
+    if m5.curTick() != start + args.tick_step:
+        fatal('Stopping after %d ticks at tick %d, reached tick %d',
+              args.tick_step, start, m5.curTick())
+    check_insts('Stopping after %d ticks' % args.tick_step)
+
+    test_cpu.scheduleInstStop(0, args.inst_step, inst_cause)
+    exit_event = m5.simulate()
+    cause = exit_event.getCause()
+    if cause != inst_cause:
+        break
+    check_insts('Stopping after %d instructions' % args.inst_step)
+    exits += 2
+
+if cause != 'exiting with last active thread context':
+    fatal('Unexpected exit at tick %d: %s', m5.curTick(), cause)
+check_insts('Exiting')
+if exits < 10:
+    fatal('The program ended after only %d checks', exits)
+
+print('The CPUs agree at every exit')
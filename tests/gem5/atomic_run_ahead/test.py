@@ -0,0 +1,61 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Runs hello on an AtomicSimpleCPU that runs ahead of its event queue,
+replays cached blocks, or both, and checks its tick-limited and
+instruction-count exits against a plain AtomicSimpleCPU, see
+run_ahead.py.
+'''
+
+from testlib import *
+
+binary = 'hello64-static'
+url = (config.resource_url + '/test-progs/hello/bin/x86/linux/' + binary)
+path = joinpath(config.bin_path, 'hello', constants.gcn3_x86_tag.lower())
+hello_program = DownloadedProgram(url, path, binary)
+
+verifiers = (
+    verifier.MatchRegex('Hello world!'),
+    verifier.MatchRegex('The CPUs agree at every exit'),
+)
+
+variants = {
+    'run-ahead': ['--max-block-insts=1000'],
+    'block-cache': ['--block-cache'],
+    'run-ahead-block-cache': ['--max-block-insts=1000', '--block-cache'],
+}
+
+for name, args in variants.items():
+    gem5_verify_config(
+        name='atomic_' + name,
+        fixtures=(hello_program,),
+        verifiers=verifiers,
+        config=joinpath(getcwd(), 'run_ahead.py'),
+        config_args=[joinpath(path, binary)] + args,
+        valid_isas=(constants.gcn3_x86_tag,),
+        length=constants.quick_tag,
+    )
@@ -0,0 +1,82 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Writes the branch trace of test.py: a loop of nine iterations, run four
+times, whose body holds a branch that is never taken. Each branch closes
+a block of five instructions.
+
+With the 2-bit counters of LocalBP, which start strongly not taken, the
+loop branch is mispredicted twice while its counter warms up, and then
+once at every loop exit: 6 mispredictions in 72 branches and 360
+instructions. The inner branch is always predicted right.
+'''
+
+import struct
+import sys
+
+COND = 1
+DIRECT = 2
+TAKEN = 16
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+def field(number, value):
+    if isinstance(value, str):
+        data = value.encode()
+        return varint(number << 3 | 2) + varint(len(data)) + data
+    return varint(number << 3) + varint(value)
+
+def branch(pc, flags, target=None):
+    msg = field(1, pc) + field(2, flags) + field(3, 4)
+    if target is not None:
+        msg += field(4, target)
+    return msg + field(5, 5)
+
+def record(msg):
+    return varint(len(msg)) + msg
+
+trace = bytearray(struct.pack('<I', 0x356d6567))
+trace += record(field(1, 'hand-written loop'))
+for _ in range(4):
+    for i in range(9):
+        trace += record(branch(0x1010, COND | DIRECT))
+        if i < 8:
+            trace += record(branch(0x1020, COND | DIRECT | TAKEN, 0x1000))
+        else:
+            trace += record(branch(0x1020, COND | DIRECT))
+
+with open(sys.argv[1], 'wb') as f:
+    f.write(trace)
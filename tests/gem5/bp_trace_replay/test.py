@@ -0,0 +1,62 @@
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Replays a hand-written branch trace, see make-trace.py, through LocalBP
+and checks its mispredictions. The trace is run again through several
+players on separate event queues, which must get the same results as a
+lone player.
+'''
+
+import re
+
+from testlib import *
+
+config_path = joinpath(config.base_dir, 'configs', 'example',
+                       'bp_trace_replay.py')
+trace_path = joinpath(getcwd(), 'loop.trc')
+
+expected = '360 instructions, 72 branches, 6 mispredicted'
+
+gem5_verify_config(
+    name='bp_trace_replay_local',
+    verifiers=(verifier.MatchRegex(re.escape(expected)),),
+    config=config_path,
+    config_args=[trace_path, '--bp-types=LocalBP', '--batch-size=4'],
+    valid_isas=(constants.x86_tag,),
+)
+
+gem5_verify_config(
+    name='bp_trace_replay_parallel',
+    verifiers=(
+        verifier.MatchRegex('players0: ' + re.escape(expected)),
+        verifier.MatchRegex('players2: ' + re.escape(expected)),
+    ),
+    config=config_path,
+    config_args=[trace_path, '--bp-types=LocalBP,TAGE,LocalBP',
+                 '--batch-size=4'],
+    valid_isas=(constants.x86_tag,),
+)
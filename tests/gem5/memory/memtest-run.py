@@ -24,11 +24,23 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import argparse
+
 import m5
 from m5.objects import *
 m5.util.addToPath('../../../configs/')
 from common.Caches import *
 
+parser = argparse.ArgumentParser()
+# A finite snoop filter much smaller than the L1s keeps its sets full,
+# and the small capacity bounds the lines it may track outside them
+parser.add_argument('--snoop-filter-sets', type=int, default=0,
+                    help='Number of sets of the L2 crossbar snoop filter, '
+                    '0 for an unbounded one')
+parser.add_argument('--snoop-filter-assoc', type=int, default=2)
+parser.add_argument('--snoop-filter-capacity', default='8KiB')
+args = parser.parse_args()
+
 #MAX CORES IS 8 with the fals sharing method
 nb_cores = 8
 cpus = [MemTest(max_loads = 1e5, progress_interval = 1e4)
@@ -49,6 +61,11 @@ system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
                                        voltage_domain = system.voltage_domain)
 
 system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+if args.snoop_filter_sets:
+    system.toL2Bus.snoop_filter = SnoopFilter(
+        lookup_latency = 0, num_sets = args.snoop_filter_sets,
+        assoc = args.snoop_filter_assoc,
+        max_capacity = args.snoop_filter_capacity)
 system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='64kB', assoc=8)
 system.l2c.cpu_side = system.toL2Bus.master
 
@@ -67,6 +67,17 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+# Keep the sets of a finite snoop filter full while the testers have
+# requests in flight, so that lines are evicted, back-invalidated and
+# overflow their set
+gem5_verify_config(
+    name='memtest_finite_snoop_filter',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'memtest-run.py'),
+    config_args = ['--snoop-filter-sets=2', '--snoop-filter-assoc=2'],
+    valid_isas=(constants.null_tag,),
+)
+
 null_tests = [
     ('garnet_synth_traffic', ['--sim-cycles', '5000000']),
     ('memcheck', ['--maxtick', '2000000000', '--prefetchers']),
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts ASCII packet traces to the compact binary trace
+# format replayed by the BinaryTraceGen traffic generator, see
+# src/cpu/testers/traffic_gen/binary_trace_gen.hh. Unlike the protobuf
+# packet traces, no protobuf support is needed to build or read them.
+#
+# The ASCII trace format uses one line per request on the format cmd,
+# addr, size, tick, optionally with the request flags before the tick
+# as printed by decode_packet_trace.py. For example:
+# r,128,64,4000
+# w,232123,64,500000
+# This trace reads 64 bytes from decimal address 128 at tick 4000,
+# then writes 64 bytes to address 232123 at tick 500000. The ticks
+# must not decrease from one request to the next.
+
+import struct
+import sys
+
+WRITE_FLAG = 0x1
+SIZE_FLAG = 0x2
+REQ_FLAGS_FLAG = 0x4
+
+def encode_varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return out
+
+def zigzag(value):
+    return (value << 1) if value >= 0 else ((-value << 1) - 1)
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <ASCII input> <binary output>")
+        exit(-1)
+
+    try:
+        ascii_in = open(sys.argv[1], 'r')
+    except IOError:
+        print("Failed to open ", sys.argv[1], " for reading")
+        exit(-1)
+
+    try:
+        binary_out = open(sys.argv[2], 'wb')
+    except IOError:
+        print("Failed to open ", sys.argv[2], " for writing")
+        exit(-1)
+
+    # Magic number and the default tick rate as 8-byte Little Endian
+    binary_out.write(b'gem5btr1')
+    binary_out.write(struct.pack('<Q', 1000000000000))
+
+    prev_tick = 0
+    prev_addr = 0
+    prev_size = 0
+    num_packets = 0
+
+    for line_no, line in enumerate(ascii_in, 1):
+        line = line.strip()
+        if not line:
+            continue
+
+        fields = line.split(',')
+        if len(fields) == 4:
+            cmd, addr, size, tick = fields
+            req_flags = 0
+        elif len(fields) == 5:
+            cmd, addr, size, req_flags, tick = fields
+            req_flags = int(req_flags)
+        else:
+            print("Malformed line %d: %s" % (line_no, line))
+            exit(-1)
+
+        addr, size, tick = int(addr), int(size), int(tick)
+        if tick < prev_tick:
+            print("Tick goes backwards on line %d" % line_no)
+            exit(-1)
+
+        flags = WRITE_FLAG if cmd == 'w' else 0
+        if size != prev_size:
+            flags |= SIZE_FLAG
+        if req_flags:
+            flags |= REQ_FLAGS_FLAG
+
+        record = bytearray([flags])
+        record += encode_varint(tick - prev_tick)
+        record += encode_varint(zigzag(addr - prev_addr))
+        if flags & SIZE_FLAG:
+            record += encode_varint(size)
+        if flags & REQ_FLAGS_FLAG:
+            record += encode_varint(req_flags)
+        binary_out.write(record)
+
+        prev_tick, prev_addr, prev_size = tick, addr, size
+        num_packets += 1
+
+    print("Encoded packets:", num_packets)
+
+    # We're done
+    ascii_in.close()
+    binary_out.close()
+
+if __name__ == "__main__":
+    main()
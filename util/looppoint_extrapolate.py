@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2021 Universidad de Murcia
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script extrapolates the statistics of a LoopPoint-sampled run
+# (see src/cpu/simple/probes/looppoint.hh and the --looppoint-*
+# options of configs/common/Options.py) to the whole execution.
+#
+# The flow is:
+#  1. Profile the workload with a simple CPU and --looppoint-profile,
+#     which writes looppoint.bb.gz and looppoint.regions.
+#  2. Cluster the regions with SimPoint 3.2, e.g.
+#     simpoint -loadFVFile looppoint.bb.gz -inputVectorsGzipped
+#       -maxK 30 -saveSimpoints simpoints -saveSimpointWeights weights
+#       -saveLabels labels
+#     (regions differ in size, so the weights are in number of regions,
+#     and labels are needed for exact per-cluster instruction counts).
+#  3. Take checkpoints with --take-looppoint-checkpoints
+#     simpoints,weights,looppoint.regions
+#  4. Simulate each checkpoint in detail with
+#     --restore-looppoint-checkpoint -r <N>, one output dir per region.
+#  5. Run this script with the region stats:
+#     looppoint_extrapolate.py looppoint.regions simpoints weights
+#       --labels labels <region>:<outdir>/stats.txt ...
+#
+# Each region is scaled by the instructions of its cluster over its own
+# instructions (as committed by all threads in the profiling run). Only
+# additive statistics are extrapolated: counts, cycles, ticks, and
+# histogram buckets. Averages, rates and ratios are skipped.
+
+import argparse
+import re
+import sys
+from collections import OrderedDict
+
+# Statistics that do not add up across regions
+non_additive = re.compile(r"(::(mean|stdev|gmean|samples|pdf|cdf)$|"
+                          r"[Rr]ate|[Rr]atio|ipc|cpi|[Aa]vg|[Bb]w|"
+                          r"[Ff]req|^host_|percent|Percent)")
+
+def parse_regions(filename):
+    regions = {}
+    for line in open(filename):
+        if line.startswith("#"):
+            continue
+        fields = line.split()
+        regions[int(fields[0])] = int(fields[5])
+    return regions
+
+def parse_pairs(filename, conv):
+    """Parses SimPoint '<value> <index>' files"""
+    pairs = {}
+    for line in open(filename):
+        fields = line.split()
+        if fields:
+            pairs[int(fields[1])] = conv(fields[0])
+    return pairs
+
+def parse_labels(filename):
+    return [int(line.split()[0]) for line in open(filename) if line.strip()]
+
+def parse_stats(filename):
+    """Returns the first stats dump, which holds the region only"""
+    stats = OrderedDict()
+    started = False
+    for line in open(filename):
+        if "Begin Simulation Statistics" in line:
+            started = True
+            continue
+        if "End Simulation Statistics" in line:
+            break
+        if not started:
+            continue
+        fields = line.split()
+        if len(fields) < 2:
+            continue
+        try:
+            stats[fields[0]] = float(fields[1])
+        except ValueError:
+            pass
+    return stats
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Extrapolate LoopPoint region statistics")
+    parser.add_argument("regions", help="looppoint.regions profile file")
+    parser.add_argument("simpoints", help="SimPoint -saveSimpoints file")
+    parser.add_argument("weights", help="SimPoint -saveSimpointWeights file")
+    parser.add_argument("stats", nargs="+",
+                        help="<region>:<stats.txt> of each detailed region")
+    parser.add_argument("--labels", help="SimPoint -saveLabels file")
+    parser.add_argument("--filter", default=".",
+                        help="Regex of the statistics to extrapolate")
+    args = parser.parse_args()
+
+    region_insts = parse_regions(args.regions)
+    total_insts = sum(region_insts.values())
+    cluster_of = {region: cluster for cluster, region in
+                  parse_pairs(args.simpoints, int).items()}
+    weights = parse_pairs(args.weights, float)
+
+    cluster_insts = {}
+    if args.labels:
+        for region, cluster in enumerate(parse_labels(args.labels)):
+            cluster_insts[cluster] = cluster_insts.get(cluster, 0) + \
+                region_insts[region]
+    else:
+        for cluster, weight in weights.items():
+            cluster_insts[cluster] = weight * total_insts
+
+    stat_filter = re.compile(args.filter)
+    totals = OrderedDict()
+    for spec in args.stats:
+        region, filename = spec.split(":", 1)
+        region = int(region)
+        if region not in cluster_of:
+            sys.exit("Region %d is not a simpoint" % region)
+        scale = cluster_insts[cluster_of[region]] / region_insts[region]
+        print("# region %d: cluster %d, weight %f, scale %f" %
+              (region, cluster_of[region], weights[cluster_of[region]],
+               scale))
+        for name, value in parse_stats(filename).items():
+            if non_additive.search(name) or not stat_filter.search(name):
+                continue
+            totals[name] = totals.get(name, 0.0) + value * scale
+
+    print("# extrapolated to %d instructions" % total_insts)
+    for name, value in totals.items():
+        print("%-60s %20.2f" % (name, value))
+
+if __name__ == "__main__":
+    main()